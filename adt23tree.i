@@ -101,6 +101,11 @@ type
         tree if needed; iterators (and pointers to nodes) are
         invalidated }
       function DeleteNode(nnode : P23TreeNode; low : Integer) : ItemType;
+      { deletes (node,low) like DeleteNode and assigns to (node,low)
+        the position of the item which followed it, or (nil,0) if it
+        was the last one; returns the deleted item }
+      function ExtractNodeAndAdvance(var node : P23TreeNode;
+                                     var low : Integer) : ItemType;
       { concatenates sub-trees of node1 and node2 and assigns the new
         tree to self; every item in the subtree of node1 must be
         smaller or equal to every item in the subtree of node2 or the
@@ -130,6 +135,10 @@ type
 {$ifdef TEST_PASCAL_ADT }
       procedure LogStatus(mName : String); override;
 {$endif TEST_PASCAL_ADT }
+{$ifdef PASCAL_ADT_STATS }
+      { adds Height }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
 
       { returns a copy of self; @complexity O(n) }
       function CopySelf(const ItemCopier :
@@ -186,6 +195,11 @@ type
         calling these two functions separately; @complexity worst-case
         O(log(n)) }
       function EqualRange(aitem : ItemType) : TSetIteratorRange; override;
+      { walk the pairs (node,low) with AdvanceNode instead of creating
+        iterators; @complexity O(n) }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
       { returns the first item according to ItemComparer }
       function First : ItemType; override;
       { removes the first item from the tree and returns it; @complexity worst-case
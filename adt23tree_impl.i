@@ -214,8 +214,12 @@ begin
       FValidSize := cont.FValidSize;
       FHeight := cont.FHeight;
       LowestItem := DefaultItem; { O.K. }
+&if (&_mcp_is_record(&ItemType&))
+      LowestItem := itemCopier.Perform(cont.LowestItem);
+&else
       if cont.LowestItem <> DefaultItem then
          LowestItem := itemCopier.Perform(cont.LowestItem);
+&endif
 
       if cont.FRoot = nil then
       begin
@@ -718,7 +722,7 @@ begin
          Assert(NodeConsistent(parent));
          Assert((node = nil) or NodeConsistent(node));
 
-         if (cnum < 3) and (aitem = itemlow) then
+         if (cnum < 3) and &_mcp_same_item(aitem, itemlow) then
          begin
             inserted := parent;
             low := cnum + 1;
@@ -805,7 +809,7 @@ begin
                   pparent^.LowItem[pnum + 1] := itemlow;
                end;
 
-               if pparent^.LowItem[pnum + 1] = aitem then
+               if &_mcp_same_item(pparent^.LowItem[pnum + 1], aitem) then
                begin
                   inserted := pparent;
                   low := pnum + 1;
@@ -839,15 +843,15 @@ begin
                if node <> nil then
                   node^.Parent := parent;
 
-               if parent^.LowItem[3] = aitem then
+               if &_mcp_same_item(parent^.LowItem[3], aitem) then
                begin
                   inserted := parent;
                   low := 3;
-               end else if parent^.LowItem[2] = aitem then
+               end else if &_mcp_same_item(parent^.LowItem[2], aitem) then
                begin
                   inserted := parent;
                   low := 2;
-               end else if pparent^.LowItem[pnum] = aitem then
+               end else if &_mcp_same_item(pparent^.LowItem[pnum], aitem) then
                begin
                   inserted := pparent;
                   low := pnum;
@@ -890,7 +894,7 @@ begin
                   StoredItems := 1;
                end;
 
-               if pnewnode^.LowItem[2] = aitem then
+               if &_mcp_same_item(pnewnode^.LowItem[2], aitem) then
                begin
                   inserted := pnewnode;
                   low := 2;
@@ -946,7 +950,7 @@ begin
       begin
          { we cannot dispose the item we insert as it is supposed to
            be left intact when an exception occurs }
-         if inserted^.LowItem[low] = aitem then
+         if &_mcp_same_item(inserted^.LowItem[low], aitem) then
          begin { should be always true, above; but no one ever
                  knows...  }
             inserted^.LowItem[low] := DefaultItem;
@@ -958,7 +962,7 @@ begin
             end;
          end;
 
-         if itemlow <> aitem then
+         if not &_mcp_same_item(itemlow, aitem) then
             DisposeItem(itemlow);
          DeleteSubTree(node);
          FValidSize := false;
@@ -1345,6 +1349,43 @@ begin
 
 end;
 
+function T23Tree.ExtractNodeAndAdvance(var node : P23TreeNode;
+                                       var low : Integer) : ItemType;
+var
+   aitem : ItemType;
+   nextNode : P23TreeNode;
+   nextLow : Integer;
+   shouldSearch : Boolean;
+begin
+   nextNode := node;
+   nextLow := low;
+   AdvanceNode(nextNode, nextLow);
+   if nextNode <> nil then
+   begin
+      shouldSearch := true;
+      aitem := nextNode^.LowItem[nextLow]
+   end else
+      shouldSearch := false;
+
+   { keep in mind that the tree is reorganised in this function, so we
+     have to find aitem in the the tree again }
+   Result := DeleteNode(node, low);
+
+   if shouldSearch then
+   begin
+      LowerBoundNode(aitem, FRoot, node, low);
+      while (node <> nil) and not &_mcp_same_item(node^.LowItem[low], aitem) do
+         AdvanceNode(node, low);
+   end else
+   begin
+      node := nil;
+      low := 0;
+   end;
+
+   { note: this function is not 100% correct with repeated items (some
+     may be visited more than once); but how to fix it?  }
+end;
+
 procedure T23Tree.Implant(node1, node2 : P23TreeNode;
                           lowitem1, lowitem2 : ItemType;
                           height1, height2 : SizeType);
@@ -1450,6 +1491,14 @@ begin
    Dispose(node);
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure T23Tree.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Height := FHeight;
+end;
+{$endif PASCAL_ADT_STATS }
+
 {$ifdef TEST_PASCAL_ADT }
 procedure T23Tree.LogStatus(mName : String);
 var
@@ -1797,6 +1846,63 @@ begin
    Result := TSetIteratorRange.Create(iter1, iter2);
 end;
 
+function T23Tree.FindIf(const pred : IUnaryPredicate;
+                        var aitem : ItemType) : Boolean;
+var
+   node : P23TreeNode;
+   low : Integer;
+begin
+   Result := false;
+   if Empty then
+      Exit;
+   if pred.Test(LowestItem) then
+   begin
+      aitem := LowestItem;
+      Result := true;
+      Exit;
+   end;
+   node := LeftMostLeafNode(FRoot);
+   low := 2;
+   while node <> nil do
+   begin
+      if pred.Test(node^.LowItem[low]) then
+      begin
+         aitem := node^.LowItem[low];
+         Result := true;
+         Exit;
+      end;
+      AdvanceNode(node, low);
+   end;
+end;
+
+function T23Tree.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   node : P23TreeNode;
+   low : Integer;
+   aitem : ItemType;
+begin
+   Result := 0;
+   if Empty then
+      Exit;
+   { (nil,1) is the position of LowestItem, (nil,0) is the finish }
+   node := nil;
+   low := 1;
+   while (node <> nil) or (low = 1) do
+   begin
+      if low = 1 then
+         aitem := LowestItem
+      else
+         aitem := node^.LowItem[low];
+      if pred.Test(aitem) then
+      begin
+         ExtractNodeAndAdvance(node, low);
+         Inc(Result);
+         DisposeItem(aitem);
+      end else
+         AdvanceNode(node, low);
+   end;
+end;
+
 function T23Tree.First : ItemType;
 begin
    Assert((FSize <> 0) or not FValidSize, msgReadEmpty);
@@ -2119,41 +2225,9 @@ begin
 end;
 
 function T23TreeIterator.Extract : ItemType;
-var
-   aitem : ItemType;
-   nextNode : P23TreeNode;
-   nextLow : Integer;
-   shouldSearch : Boolean;
 begin
    Assert(not IsFinish, msgDeletingInvalidIterator);
-
-   nextNode := FNode;
-   nextLow := FLow;
-   FTree.AdvanceNode(nextNode, nextLow);
-   if nextNode <> nil then
-   begin
-      shouldSearch := true;
-      aitem := nextNode^.LowItem[nextLow]
-   end else
-      shouldSearch := false;
-
-   { keep in mind that the tree is reorganised in this function, so we
-     have to find aitem in the the tree again }
-   Result := FTree.DeleteNode(FNode, FLow);
-
-   if shouldSearch then
-   begin
-      FTree.LowerBoundNode(aitem, FTree.FRoot, FNode, FLow);
-      while (FNode <> nil) and (FNode^.LowItem[FLow] <> aitem) do
-         FTree.AdvanceNode(FNode, FLow);
-   end else
-   begin
-      FNode := nil;
-      FLow := 0;
-   end;
-
-   { note: this function is not 100% correct with repeated items (some
-     may be visited more than once); but how to fix it?  }
+   Result := FTree.ExtractNodeAndAdvance(FNode, FLow);
 end;
 
 function T23TreeIterator.Owner : TContainerAdt;
@@ -222,12 +222,15 @@ procedure Combine(const start1, finish1, start2 : TForwardIterator;
 { ------------------------ sorting ---------------------------- }
 
 { a general sort algorithm; chooses the most suitable sorting
-  algorithm for a given set of data (depending on its size);
-  @complexity average O(n*log(n)) }
+  algorithm for a given set of data (depending on its size); uses
+  @<PdqSort> for all but the smallest ranges; @complexity
+  O(n*log(n)) }
 procedure Sort(start, finish : TRandomAccessIterator;
                const comparer : IBinaryComparer); overload;
 { a general stable sort algorithm; chooses the most suitable stable
-  sorting algorithm for given data; @complexity O(n*log(n)) }
+  sorting algorithm for given data; uses @<TimSort> for all but the
+  smallest ranges, so nearly sorted data is sorted in close to linear
+  time; @complexity O(n*log(n)) }
 procedure StableSort(start, finish : TRandomAccessIterator;
                      const comparer : IBinaryComparer); overload;
 { implements the Quick-Sort algorithm; @stable
@@ -235,10 +238,31 @@ procedure StableSort(start, finish : TRandomAccessIterator;
   @memory-usage O(log(n)) }
 procedure QuickSort(start, finish : TRandomAccessIterator;
                     const comparer : IBinaryComparer); overload;
+{ implements the pattern-defeating quick-sort (an introsort): the
+  pivot is the median of three or Tukey's ninther, the ranges are
+  partitioned in blocks so that the comparisons do not steer
+  conditional jumps, runs of items equal to the preceding pivot are
+  placed in one pass, and heap-sort is used after too many unbalanced
+  partitions; sorted, reversed and many-duplicate inputs take linear
+  time; @stable no; @complexity O(n*log(n)) in the worst case;
+  @memory-usage O(log(n)) }
+procedure PdqSort(start, finish : TRandomAccessIterator;
+                  const comparer : IBinaryComparer); overload;
 { implements the Merge-Sort algorithm; @stable yes; @complexity
   O(n*log(n)); @memory-usage O(n); }
 procedure MergeSort(start, finish : TRandomAccessIterator;
                     const comparer : IBinaryComparer); overload;
+{ implements an adaptive merge-sort in the style of Tim-Sort: the
+  range is split into maximal non-descending or strictly descending
+  runs (the latter are reversed), short runs are extended with binary
+  insertion-sort and the runs are merged in the order given by the
+  Powersort rule; each merge first skips the items already in place
+  and then copies only the shorter of the two runs into a buffer,
+  switching to galloping when one run keeps winning; @stable yes;
+  @complexity O(n*log(r)), where r is the number of runs, i.e. O(n)
+  for sorted or nearly sorted input; @memory-usage O(n/2) }
+procedure TimSort(start, finish : TRandomAccessIterator;
+                  const comparer : IBinaryComparer); overload;
 { implements the Shell-Sort algorithm; @stable no; @complexity
   worst-case O(n^1.5) }
 procedure ShellSort(start, finish : TRandomAccessIterator;
@@ -249,6 +273,22 @@ procedure InsertionSort(start, finish : TBidirectionalIterator;
                         const comparer : IBinaryComparer); overload;
 procedure InsertionSort(start, finish : TRandomAccessIterator;
                         const comparer : IBinaryComparer); overload;
+{ rearranges the items in [start,finish) so that [start,middle)
+  contains the middle - start smallest items in sorted order; the
+  order of the items in [middle,finish) is unspecified; uses a heap of
+  the middle - start items; @stable no; @complexity O(n*log(m)), where
+  m = middle - start; @memory-usage O(1) }
+procedure PartialSort(start, middle, finish : TRandomAccessIterator;
+                      const comparer : IBinaryComparer); overload;
+{ writes the min(count, n) smallest items from [start1,finish1) in
+  sorted order to start2, copied with itemCopier; the range
+  [start1,finish1) is not changed and only the items written are
+  copied; returns the number of items written; @stable no;
+  @complexity O(n*log(count)); @memory-usage O(min(count, n)) }
+function PartialSortCopy(const start1, finish1 : TForwardIterator;
+                         start2 : TOutputIterator; count : SizeType;
+                         const comparer : IBinaryComparer;
+                         const itemCopier : IUnaryFunctor) : SizeType; overload;
 
 { ------------------- other mutating algorithms -------------------------- }
 
@@ -297,6 +337,17 @@ function FindKthItem(start, finish : TRandomAccessIterator; k : SizeType;
   @complexity average O(n), worst-case O(n^2); }
 function FindKthItemHoare(start, finish : TRandomAccessIterator; k : SizeType;
                           const comparer : IBinaryComparer) : ItemType; overload;
+{ rearranges the items in [start,finish) so that the item at nth is
+  the one which would be there if the range were sorted, no item in
+  [start,nth) is greater than it and no item after nth is smaller;
+  does nothing if nth is finish; unlike FindKthItem, partitions the
+  range in place, so that the items before nth are the nth - start
+  smallest ones; implements introselect - quick-select with
+  median-of-three pivots, which falls back to PartialSort if the
+  partitions do not shrink fast enough; @complexity average O(n),
+  worst-case O(n*log(n)); @memory-usage O(1) }
+procedure NthElement(start, nth, finish : TRandomAccessIterator;
+                     const comparer : IBinaryComparer); overload;
 
 { ======================= deleting algorithms ============================== }
 { deleting algorithms do not modify any items or their order, but may
@@ -363,6 +414,34 @@ procedure Merge(start1, finish1, start2, finish2 : TForwardIterator;
 procedure MergeCopy(const start1, finish1, start2, finish2 : TForwardIterator;
                     output : TOutputIterator; const comparer : IBinaryComparer;
                     const itemCopier : IUnaryFunctor); overload;
+{ merges k sorted ranges [starts[i], finishes[i]) in a single pass
+  using a loser tree; the resulting range is moved to output; items
+  are removed from all source ranges (they become empty after
+  executing this routine); equal items are taken from the ranges in
+  the order in which the ranges are given, so the merge is stable; the
+  ranges must not overlap and, if two of them belong to the same
+  container, deleting one must not invalidate the start of the other;
+  @complexity O(n*log(k)) comparisons, each item written once }
+procedure MergeMany(const starts, finishes : array of TForwardIterator;
+                    output : TOutputIterator;
+                    const comparer : IBinaryComparer); overload;
+{ the same as above, but copies the items and leaves the source ranges
+  intact; }
+procedure MergeManyCopy(const starts, finishes : array of TForwardIterator;
+                        output : TOutputIterator;
+                        const comparer : IBinaryComparer;
+                        const itemCopier : IUnaryFunctor); overload;
+{ merges all items of <sets> in a single pass using a loser tree and
+  moves them to output; the sets are left empty; all sets should use
+  the same comparer, the one of sets[0] is used; @complexity
+  O(n*log(k)) }
+procedure MergeMany(const sets : array of TSortedSetAdt;
+                    output : TOutputIterator); overload;
+{ the same as above, but copies the items and does not modify the
+  sets; }
+procedure MergeManyCopy(const sets : array of TSortedSetAdt;
+                        output : TOutputIterator;
+                        const itemCopier : IUnaryFunctor); overload;
 
 { =========================== set algorithms =============================== }
 { set algorithms operate on whole containers, which are sets; if a
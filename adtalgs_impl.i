@@ -75,6 +75,478 @@ begin
    Result := fi;
 end;
 
+{ restores the max-heap of the items start[si..si+len-1] below the
+  relative position i }
+procedure HeapSiftDownAux(start : TRandomAccessIterator; si, i, len : IndexType;
+                          comparer : IBinaryComparer); overload;
+var
+   c : IndexType;
+begin
+   c := 2*i + 1;
+   while c < len do
+   begin
+      if (c + 1 < len) and _mcp_lt(start[si + c], start[si + c + 1], comparer) then
+         Inc(c);
+      if not _mcp_lt(start[si + i], start[si + c], comparer) then
+         break;
+      start.ExchangeItemsAt(si + i, si + c);
+      i := c;
+      c := 2*i + 1;
+   end;
+end;
+
+{ moves the mi - si smallest items of [si,fi) to [si,mi) in sorted
+  order }
+procedure PartialSortAux(start : TRandomAccessIterator; si, mi, fi : IndexType;
+                         comparer : IBinaryComparer); overload;
+var
+   i, len : IndexType;
+begin
+   len := mi - si;
+   if len = 0 then
+      Exit;
+
+   for i := len div 2 - 1 downto 0 do
+      HeapSiftDownAux(start, si, i, len, comparer);
+   { the root of the heap is the greatest of the len smallest items
+     seen so far }
+   for i := mi to fi - 1 do
+   begin
+      if _mcp_lt(start[i], start[si], comparer) then
+      begin
+         start.ExchangeItemsAt(si, i);
+         HeapSiftDownAux(start, si, 0, len, comparer);
+      end;
+   end;
+   for i := len - 1 downto 1 do
+   begin
+      start.ExchangeItemsAt(si, si + i);
+      HeapSiftDownAux(start, si, 0, i, comparer);
+   end;
+end;
+
+{ partitions [si,fi) around the median of three of its items; returns
+  cut such that no item in [si,cut) is greater and no item in [cut,fi)
+  is smaller than the pivot; si < cut < fi; fi - si must be at least
+  3 }
+function MedianPartitionAux(start : TRandomAccessIterator; si, fi : IndexType;
+                            comparer : IBinaryComparer) : IndexType; overload;
+var
+   a, b, c, m, i, j : IndexType;
+   pivot : ItemType;
+begin
+   a := si + 1;
+   b := si + (fi - si) div 2;
+   c := fi - 1;
+   if _mcp_lt(start[a], start[b], comparer) then
+   begin
+      if _mcp_lt(start[b], start[c], comparer) then
+         m := b
+      else if _mcp_lt(start[a], start[c], comparer) then
+         m := c
+      else
+         m := a;
+   end else if _mcp_lt(start[a], start[c], comparer) then
+      m := a
+   else if _mcp_lt(start[b], start[c], comparer) then
+      m := c
+   else
+      m := b;
+   start.ExchangeItemsAt(si, m);
+   pivot := start[si];
+
+   { the other two of the three items are still in [si+1,fi); one of
+     them is not smaller and the other not greater than the pivot, so
+     the scans below cannot run off the range }
+   i := si + 1;
+   j := fi - 1;
+   repeat
+      while _mcp_lt(start[i], pivot, comparer) do
+         Inc(i);
+      while _mcp_lt(pivot, start[j], comparer) do
+         Dec(j);
+      if i >= j then
+         break;
+      start.ExchangeItemsAt(i, j);
+      Inc(i);
+      Dec(j);
+   until false;
+   Result := i;
+end;
+
+{ ---------------- pattern-defeating quicksort helpers ------------------ }
+
+{ sorts the items at the positions a, b and c so that start[a] <=
+  start[b] <= start[c] }
+procedure Sort3Aux(start : TRandomAccessIterator; a, b, c : IndexType;
+                   comparer : IBinaryComparer); overload;
+begin
+   if _mcp_lt(start[b], start[a], comparer) then
+      start.ExchangeItemsAt(a, b);
+   if _mcp_lt(start[c], start[b], comparer) then
+   begin
+      start.ExchangeItemsAt(b, c);
+      if _mcp_lt(start[b], start[a], comparer) then
+         start.ExchangeItemsAt(a, b);
+   end;
+end;
+
+{ insertion-sorts [si,fi), but gives up as soon as more than
+  pdqPartialInsertionLimit items have been moved; returns true if the
+  range has been sorted }
+function PartialInsertionSortAux(start : TRandomAccessIterator;
+                                 si, fi : IndexType;
+                                 comparer : IBinaryComparer) : Boolean; overload;
+var
+   i, j, moved : IndexType;
+begin
+   moved := 0;
+   i := si + 1;
+   while i < fi do
+   begin
+      j := i;
+      while (j > si) and _mcp_lt(start[j], start[j - 1], comparer) do
+      begin
+         start.ExchangeItemsAt(j - 1, j);
+         Dec(j);
+      end;
+      Inc(moved, i - j);
+      if moved > pdqPartialInsertionLimit then
+      begin
+         Result := false;
+         Exit;
+      end;
+      Inc(i);
+   end;
+   Result := true;
+end;
+
+{ partitions [si,fi) around the pivot start[si] using the block
+  partitioning scheme: the comparisons with the pivot for a whole
+  block of items are performed first and only record the offsets of
+  the misplaced items, so that they do not depend on conditional
+  jumps; afterwards the misplaced items are exchanged in pairs; the
+  items equal to the pivot go to the right; there must be an item not
+  smaller than the pivot at fi - 1; returns the final position of the
+  pivot; alreadyPartitioned is set to true if no items had to be
+  exchanged }
+function PdqPartitionRightAux(start : TRandomAccessIterator; si, fi : IndexType;
+                              comparer : IBinaryComparer;
+                              var alreadyPartitioned : Boolean) : IndexType; overload;
+var
+   pivot : ItemType;
+   first, last, i, num, numL, numR, startL, startR : IndexType;
+   lSize, rSize, unknown : IndexType;
+   offsetsL, offsetsR : array[0..pdqBlockSize - 1] of Byte;
+begin
+   pivot := start[si];
+   first := si;
+   last := fi;
+
+   repeat
+      Inc(first);
+   until not _mcp_lt(start[first], pivot, comparer);
+   if first - 1 = si then
+   begin
+      while first < last do
+      begin
+         Dec(last);
+         if _mcp_lt(start[last], pivot, comparer) then
+            break;
+      end;
+   end else
+   begin
+      { there is an item smaller than the pivot before first }
+      repeat
+         Dec(last);
+      until _mcp_lt(start[last], pivot, comparer);
+   end;
+
+   alreadyPartitioned := first >= last;
+   if not alreadyPartitioned then
+   begin
+      start.ExchangeItemsAt(first, last);
+      Inc(first);
+      { the items in [first,last) are still to be partitioned }
+      numL := 0;
+      numR := 0;
+      startL := 0;
+      startR := 0;
+      while last - first > 2*pdqBlockSize do
+      begin
+         if numL = 0 then
+         begin
+            startL := 0;
+            for i := 0 to pdqBlockSize - 1 do
+            begin
+               offsetsL[numL] := i;
+               Inc(numL, Ord(not _mcp_lt(start[first + i], pivot, comparer)));
+            end;
+         end;
+         if numR = 0 then
+         begin
+            startR := 0;
+            for i := 0 to pdqBlockSize - 1 do
+            begin
+               offsetsR[numR] := i + 1;
+               Inc(numR, Ord(_mcp_lt(start[last - i - 1], pivot, comparer)));
+            end;
+         end;
+
+         num := numL;
+         if numR < num then
+            num := numR;
+         for i := 0 to num - 1 do
+         begin
+            start.ExchangeItemsAt(first + offsetsL[startL + i],
+                                  last - offsetsR[startR + i]);
+         end;
+         Dec(numL, num);
+         Dec(numR, num);
+         Inc(startL, num);
+         Inc(startR, num);
+         if numL = 0 then
+            Inc(first, pdqBlockSize);
+         if numR = 0 then
+            Dec(last, pdqBlockSize);
+      end;
+
+      { the remaining items do not fill two whole blocks }
+      unknown := last - first;
+      if (numL <> 0) or (numR <> 0) then
+         Dec(unknown, pdqBlockSize);
+      if numR <> 0 then
+      begin
+         lSize := unknown;
+         rSize := pdqBlockSize;
+      end else if numL <> 0 then
+      begin
+         lSize := pdqBlockSize;
+         rSize := unknown;
+      end else
+      begin
+         lSize := unknown div 2;
+         rSize := unknown - lSize;
+      end;
+
+      if (unknown <> 0) and (numL = 0) then
+      begin
+         startL := 0;
+         for i := 0 to lSize - 1 do
+         begin
+            offsetsL[numL] := i;
+            Inc(numL, Ord(not _mcp_lt(start[first + i], pivot, comparer)));
+         end;
+      end;
+      if (unknown <> 0) and (numR = 0) then
+      begin
+         startR := 0;
+         for i := 0 to rSize - 1 do
+         begin
+            offsetsR[numR] := i + 1;
+            Inc(numR, Ord(_mcp_lt(start[last - i - 1], pivot, comparer)));
+         end;
+      end;
+
+      num := numL;
+      if numR < num then
+         num := numR;
+      for i := 0 to num - 1 do
+      begin
+         start.ExchangeItemsAt(first + offsetsL[startL + i],
+                               last - offsetsR[startR + i]);
+      end;
+      Dec(numL, num);
+      Dec(numR, num);
+      Inc(startL, num);
+      Inc(startR, num);
+      if numL = 0 then
+         Inc(first, lSize);
+      if numR = 0 then
+         Dec(last, rSize);
+
+      { at most one of the blocks still contains misplaced items; move
+        them to the boundary }
+      if numL <> 0 then
+      begin
+         while numL <> 0 do
+         begin
+            Dec(numL);
+            Dec(last);
+            start.ExchangeItemsAt(first + offsetsL[startL + numL], last);
+         end;
+         first := last;
+      end;
+      if numR <> 0 then
+      begin
+         while numR <> 0 do
+         begin
+            Dec(numR);
+            start.ExchangeItemsAt(last - offsetsR[startR + numR], first);
+            Inc(first);
+         end;
+      end;
+   end;
+
+   Result := first - 1;
+   start.ExchangeItemsAt(si, Result);
+end;
+
+{ partitions [si,fi) around the pivot start[si] so that the items
+  equal to the pivot go to the left; used when the pivot is equal to
+  the item preceding the range, which is known to be not greater than
+  any item in the range, so that all the items equal to it are placed
+  at once; returns the final position of the pivot }
+function PdqPartitionLeftAux(start : TRandomAccessIterator; si, fi : IndexType;
+                             comparer : IBinaryComparer) : IndexType; overload;
+var
+   pivot : ItemType;
+   first, last : IndexType;
+begin
+   pivot := start[si];
+   first := si;
+   last := fi;
+
+   repeat
+      Dec(last);
+   until not _mcp_lt(pivot, start[last], comparer);
+   if last + 1 = fi then
+   begin
+      while first < last do
+      begin
+         Inc(first);
+         if _mcp_lt(pivot, start[first], comparer) then
+            break;
+      end;
+   end else
+   begin
+      { there is an item greater than the pivot after last }
+      repeat
+         Inc(first);
+      until _mcp_lt(pivot, start[first], comparer);
+   end;
+
+   while first < last do
+   begin
+      start.ExchangeItemsAt(first, last);
+      repeat
+         Dec(last);
+      until not _mcp_lt(pivot, start[last], comparer);
+      repeat
+         Inc(first);
+      until _mcp_lt(pivot, start[first], comparer);
+   end;
+
+   Result := last;
+   start.ExchangeItemsAt(si, Result);
+end;
+
+{ the main loop of the pattern-defeating quick-sort; badAllowed is the
+  number of highly unbalanced partitions after which heap-sort is used
+  instead; leftmost is false if the item at si - 1 is known to be not
+  greater than any item in [si,fi) }
+procedure PdqSortAux(start : TRandomAccessIterator; si, fi : IndexType;
+                     comparer : IBinaryComparer; badAllowed : IndexType;
+                     leftmost : Boolean); overload;
+var
+   size, s2, pi, lSize, rSize : IndexType;
+   alreadyPartitioned : Boolean;
+begin
+   while true do
+   begin
+      size := fi - si;
+      if size < pdqInsertionSortItems then
+      begin
+         InsertionSortAux(start, si, fi, comparer);
+         Exit;
+      end;
+
+      { choose the pivot as the median of three or, for larger ranges,
+        Tukey's ninther and move it to si; this leaves an item not
+        smaller than the pivot at fi - 1 }
+      s2 := size div 2;
+      if size > pdqNintherItems then
+      begin
+         Sort3Aux(start, si, si + s2, fi - 1, comparer);
+         Sort3Aux(start, si + 1, si + s2 - 1, fi - 2, comparer);
+         Sort3Aux(start, si + 2, si + s2 + 1, fi - 3, comparer);
+         Sort3Aux(start, si + s2 - 1, si + s2, si + s2 + 1, comparer);
+         start.ExchangeItemsAt(si, si + s2);
+      end else
+         Sort3Aux(start, si + s2, si, fi - 1, comparer);
+
+      { if the pivot is equal to the preceding item, which is not
+        greater than any item in the range, then there are many equal
+        items - put all of them in their final place at once }
+      if (not leftmost) and (not _mcp_lt(start[si - 1], start[si], comparer)) then
+      begin
+         si := PdqPartitionLeftAux(start, si, fi, comparer) + 1;
+         continue;
+      end;
+
+      pi := PdqPartitionRightAux(start, si, fi, comparer, alreadyPartitioned);
+      lSize := pi - si;
+      rSize := fi - pi - 1;
+
+      if (lSize < size div 8) or (rSize < size div 8) then
+      begin
+         { a highly unbalanced partition - fall back to heap-sort if
+           there have been too many of them, otherwise shuffle some
+           items to break the pattern which caused it }
+         Dec(badAllowed);
+         if badAllowed = 0 then
+         begin
+            PartialSortAux(start, si, fi, fi, comparer);
+            Exit;
+         end;
+
+         if lSize >= pdqInsertionSortItems then
+         begin
+            start.ExchangeItemsAt(si, si + lSize div 4);
+            start.ExchangeItemsAt(pi - 1, pi - lSize div 4);
+            if lSize > pdqNintherItems then
+            begin
+               start.ExchangeItemsAt(si + 1, si + lSize div 4 + 1);
+               start.ExchangeItemsAt(si + 2, si + lSize div 4 + 2);
+               start.ExchangeItemsAt(pi - 2, pi - lSize div 4 - 1);
+               start.ExchangeItemsAt(pi - 3, pi - lSize div 4 - 2);
+            end;
+         end;
+         if rSize >= pdqInsertionSortItems then
+         begin
+            start.ExchangeItemsAt(pi + 1, pi + 1 + rSize div 4);
+            start.ExchangeItemsAt(fi - 1, fi - rSize div 4);
+            if rSize > pdqNintherItems then
+            begin
+               start.ExchangeItemsAt(pi + 2, pi + 2 + rSize div 4);
+               start.ExchangeItemsAt(pi + 3, pi + 3 + rSize div 4);
+               start.ExchangeItemsAt(fi - 2, fi - rSize div 4 - 1);
+               start.ExchangeItemsAt(fi - 3, fi - rSize div 4 - 2);
+            end;
+         end;
+      end else if alreadyPartitioned and
+                     PartialInsertionSortAux(start, si, pi, comparer) and
+                     PartialInsertionSortAux(start, pi + 1, fi, comparer) then
+      begin
+         { the range was probably already sorted }
+         Exit;
+      end;
+
+      { recurse into the smaller part to keep the depth of the recursion
+        logarithmic }
+      if lSize < rSize then
+      begin
+         PdqSortAux(start, si, pi, comparer, badAllowed, leftmost);
+         si := pi + 1;
+         leftmost := false;
+      end else
+      begin
+         PdqSortAux(start, pi + 1, fi, comparer, badAllowed, false);
+         fi := pi;
+      end;
+   end;
+end;
+
 
 { =========================== iterators ================================ }
 
@@ -244,11 +716,32 @@ end;
 
 function Find(const start, finish : TForwardIterator;
               aitem : ItemType; const comparer : IBinaryComparer) : TForwardIterator;
+var
+   owner : TContainerAdt;
 begin
 {$ifdef DEBUG_PASCAL_ADT }
    CheckIteratorRange(start, finish);
 {$endif }
 
+   owner := start.Owner;
+   if algUseFastPaths and (comparer <> nil) and (owner is TSetAdt) and
+         (TSetAdt(owner).ItemComparer = comparer) then
+   begin
+      { the set compares the items in the same way, so it can tell
+        quickly whether there is anything to find; the items equal to
+        aitem are adjacent in a set and LowerBound returns the first
+        of them }
+      if not TSetAdt(owner).Has(aitem) then
+      begin
+         Result := CopyOf(finish);
+         Exit;
+      end else if start.IsStart and finish.IsFinish then
+      begin
+         Result := TSetAdt(owner).LowerBound(aitem);
+         Exit;
+      end;
+   end;
+
    Result := CopyOf(start);
    while (not Result.Equal(finish)) and
             (not _mcp_equal(Result.Item, aitem, comparer)) do
@@ -277,11 +770,22 @@ function Count(const start, finish : TForwardIterator;
                const pred : IUnaryPredicate) : SizeType;
 var
    iter : TForwardIterator;
+   owner : TContainerAdt;
 begin
 {$ifdef DEBUG_PASCAL_ADT }
    CheckIteratorRange(start, finish);
 {$endif }
 
+   owner := start.Owner;
+   if algUseFastPaths and ((owner is TListAdt) or (owner is TSetAdt)) and
+         start.IsStart and finish.IsFinish then
+   begin
+      { lists and sets count the items without modifying themselves,
+        most of them with a direct loop over their internal structure }
+      Result := owner.CountIf(pred);
+      Exit;
+   end;
+
    Result := 0;
    iter := CopyOf(start);
    while not iter.Equal(finish) do
@@ -494,11 +998,24 @@ procedure Copy(const start1, finish1 : TForwardIterator;
                const itemCopier : IUnaryFunctor);
 var
    iter : TForwardIterator;
+   n : SizeType;
 begin
 {$ifdef DEBUG_PASCAL_ADT }
    CheckIteratorRange(start1, finish1);
 {$endif }
 
+   if algUseFastPaths and (start1 is TArrayIterator) and
+         (finish1 is TArrayIterator) and (start2 is TArrayIterator) then
+   begin
+      n := TArrayIterator(finish1).Index - TArrayIterator(start1).Index;
+      TArray(start2.Owner).CopyItems(TArray(start1.Owner),
+                                     TArrayIterator(start1).Index,
+                                     TArrayIterator(start2).Index,
+                                     n, itemCopier);
+      TArrayIterator(start2).Advance(n);
+      Exit;
+   end;
+
    iter := CopyOf(start1);
    while not iter.Equal(finish1) do
    begin
@@ -619,7 +1136,7 @@ begin
    if finish.Index - start.Index <= qsMinItems then
       InsertionSort(start, finish, comparer)
    else
-      QuickSort(start, finish, comparer);
+      PdqSort(start, finish, comparer);
 end;
 
 procedure StableSort(start, finish : TRandomAccessIterator;
@@ -632,7 +1149,7 @@ begin
    if finish.Index - start.Index <= msMinItems then
       InsertionSort(start, finish, comparer)
    else
-      MergeSort(start, finish, comparer);
+      TimSort(start, finish, comparer);
 end;
 
 procedure QuickSort(start, finish : TRandomAccessIterator;
@@ -709,6 +1226,20 @@ begin
    InsertionSort(start, finish, comparer);
 end;
 
+procedure PdqSort(start, finish : TRandomAccessIterator;
+                  const comparer : IBinaryComparer);
+var
+   n : IndexType;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   n := finish.Index - start.Index;
+   if n > 1 then
+      PdqSortAux(start, 0, n, comparer, FloorLog2(n), true);
+end;
+
 procedure MergeSort(start, finish : TRandomAccessIterator;
                     const comparer : IBinaryComparer);
 var
@@ -760,90 +1291,567 @@ begin
                Inc(m);
             end;
 
-            while (k < i + 2*n) and (k < fi) do
-            begin
-               buffer[m] := start[k];
-               Inc(k);
-               Inc(m);
-            end;
+            while (k < i + 2*n) and (k < fi) do
+            begin
+               buffer[m] := start[k];
+               Inc(k);
+               Inc(m);
+            end;
+
+            i := i + 2*n;
+         end; { end while i + n < fi }
+         { copy the tail }
+         while i < fi do
+         begin
+            buffer[i] := start[i];
+            Inc(i);
+         end;
+         n := 2*n;
+
+         invalidContainer := true; { exception handling }
+         if n < fi then
+         begin
+            { now merge the sequences in the buffer and put them into
+              the proper array }
+            i := 0;
+            while i + n < fi do
+            begin
+               j := i;
+               k := i + n;
+               m := i;
+               while (j < i + n) and (k < fi) and (k < i + 2*n) do
+               begin
+                  if _mcp_lte(buffer[j], buffer[k], comparer) then
+                  begin
+                     start[m] := buffer[j];
+                     Inc(j);
+                  end else
+                  begin
+                     start[m] := buffer[k];
+                     Inc(k);
+                  end;
+                  Inc(m);
+               end; { end while end of sequence not reached }
+
+               while j < i + n do
+               begin
+                  start[m] := buffer[j];
+                  Inc(j);
+                  Inc(m);
+               end;
+
+               while (k < i + 2*n) and (k < fi) do
+               begin
+                  start[m] := buffer[k];
+                  Inc(k);
+                  Inc(m);
+               end;
+
+               i := i + 2*n;
+            end; { end while i + n < fi }
+            { copy the tail }
+            while i < fi do
+            begin
+               start[i] := buffer[i];
+               Inc(i);
+            end;
+            n := 2*n;
+
+         end else
+         begin
+            { copy items from the buffer to the container }
+            for i := 0 to fi - 1 do
+               start[i] := buffer[i];
+         end; { end not if n < fi }
+         invalidContainer := false;
+      end; { end while n < fi }
+
+   finally
+      if invalidContainer then
+      begin
+         { the exception was raised in the second part of the loop
+           when items are copied from the buffer to the container;
+           just copy all of them back into the container not to leak
+           anything }
+         for i := 0 to fi - 1 do
+            start[i] := buffer[i];
+      end;
+      owner.OwnsItems := owns;
+   end;
+end;
+
+procedure TimSort(start, finish : TRandomAccessIterator;
+                  const comparer : IBinaryComparer);
+var
+   buffer : array of ItemType;
+   runBase, runLen, runPower : array of IndexType;
+   n, lo, len, force, top, p, m, r, minRun : IndexType;
+   owner : TContainerAdt;
+   owns : Boolean;
+   { the state of the merge in progress: mergeMode is 1 while the
+     items buffer[bufi..bufLen-1] belong at start[dest..], 2 while
+     buffer[0..bi] belong at start[ai+1..dest] and 0 otherwise }
+   mergeMode : Integer;
+   dest, bufi, bufLen, ai, bi : IndexType;
+
+   { returns the number of items in [base,base+alen) of the buffer, if
+     inBuffer, or of the range, otherwise, that precede <key>, i.e.
+     are smaller than it or, if afterEqual, not greater than it; the
+     exponential search starts at the right end if fromRight }
+   function Gallop(const key : ItemType; inBuffer : Boolean;
+                   base, alen : IndexType;
+                   afterEqual, fromRight : Boolean) : IndexType;
+   var
+      l, h, ofs, mid : IndexType;
+
+      function Precedes(i : IndexType) : Boolean;
+      var
+         aitem : ItemType;
+      begin
+         if inBuffer then
+            aitem := buffer[i]
+         else
+            aitem := start[i];
+         if afterEqual then
+            Result := not _mcp_lt(key, aitem, comparer)
+         else
+            Result := _mcp_lt(aitem, key, comparer);
+      end;
+
+   begin
+      { the items at [base,base+l) precede key and the ones at
+        [base+h,base+alen) do not }
+      l := 0;
+      h := alen;
+      ofs := 1;
+      if fromRight then
+      begin
+         while (ofs <= alen) and not Precedes(base + alen - ofs) do
+         begin
+            h := alen - ofs;
+            ofs := 2*ofs;
+         end;
+         if ofs <= alen then
+            l := alen - ofs + 1;
+      end else
+      begin
+         while (ofs <= alen) and Precedes(base + ofs - 1) do
+         begin
+            l := ofs;
+            ofs := 2*ofs;
+         end;
+         if ofs <= alen then
+            h := ofs - 1;
+      end;
+
+      while l < h do
+      begin
+         mid := l + (h - l) div 2;
+         if Precedes(base + mid) then
+            l := mid + 1
+         else
+            h := mid;
+      end;
+      Result := l;
+   end;
+
+   { returns the length of the run starting at first; a strictly
+     descending run is reversed, which keeps the sort stable }
+   function CountRun(first : IndexType) : IndexType;
+   var
+      hi, i, j : IndexType;
+   begin
+      hi := first + 1;
+      if hi < n then
+      begin
+         if _mcp_lt(start[hi], start[first], comparer) then
+         begin
+            Inc(hi);
+            while (hi < n) and _mcp_lt(start[hi], start[hi - 1], comparer) do
+               Inc(hi);
+            i := first;
+            j := hi - 1;
+            while i < j do
+            begin
+               start.ExchangeItemsAt(i, j);
+               Inc(i);
+               Dec(j);
+            end;
+         end else
+         begin
+            Inc(hi);
+            while (hi < n) and not _mcp_lt(start[hi], start[hi - 1], comparer) do
+               Inc(hi);
+         end;
+      end;
+      Result := hi - first;
+   end;
+
+   { inserts the items at [sorted,hi) into the sorted run [first,sorted) }
+   procedure BinaryInsertionSort(first, sorted, hi : IndexType);
+   var
+      i, j, l, h, mid : IndexType;
+      aitem : ItemType;
+   begin
+      for i := sorted to hi - 1 do
+      begin
+         aitem := start[i];
+         { find the first item greater than aitem }
+         l := first;
+         h := i;
+         while l < h do
+         begin
+            mid := l + (h - l) div 2;
+            if _mcp_lt(aitem, start[mid], comparer) then
+               h := mid
+            else
+               l := mid + 1;
+         end;
+         for j := i downto l + 1 do
+            start[j] := start[j - 1];
+         start[l] := aitem;
+      end;
+   end;
+
+   { returns the depth in the Powersort merge tree of the node joining
+     the runs [s1,s1+n1) and [s1+n1,s1+n1+n2) }
+   function NodePower(s1, n1, n2 : IndexType) : IndexType;
+   var
+      a, b : IndexType;
+   begin
+      { a/2n and b/2n are the midpoints of the runs }
+      a := 2*s1 + n1;
+      b := a + n1 + n2;
+      Result := 0;
+      repeat
+         Inc(Result);
+         if a >= n then
+         begin
+            Dec(a, n);
+            Dec(b, n);
+         end else if b >= n then
+            break;
+         a := 2*a;
+         b := 2*b;
+      until false;
+   end;
+
+   procedure ReserveBuffer(alen : IndexType);
+   var
+      newLen : IndexType;
+   begin
+      if Length(buffer) < alen then
+      begin
+         newLen := 2*Length(buffer);
+         if newLen < alen then
+            newLen := alen;
+         if newLen > n div 2 then
+            newLen := n div 2;
+         { the buffer holds nothing between the merges }
+         SetLength(buffer, 0);
+         SetLength(buffer, newLen); { may raise }
+      end;
+   end;
+
+   { merges [base1,base2) with [base2,base2+len2) by moving the first
+     run to the buffer and merging from the left }
+   procedure MergeLow(base1, base2, len2 : IndexType);
+   var
+      k, kEnd, countA, countB, i : IndexType;
+   begin
+      bufLen := base2 - base1;
+      for i := 0 to bufLen - 1 do
+         buffer[i] := start[base1 + i];
+      dest := base1;
+      bufi := 0;
+      k := base2;
+      kEnd := base2 + len2;
+      mergeMode := 1;
+
+      while (bufi < bufLen) and (k < kEnd) do
+      begin
+         countA := 0;
+         countB := 0;
+         while (bufi < bufLen) and (k < kEnd) and
+                  (countA < tsMinGallop) and (countB < tsMinGallop) do
+         begin
+            if _mcp_lt(start[k], buffer[bufi], comparer) then
+            begin
+               start[dest] := start[k];
+               Inc(k);
+               Inc(countB);
+               countA := 0;
+            end else
+            begin
+               start[dest] := buffer[bufi];
+               Inc(bufi);
+               Inc(countA);
+               countB := 0;
+            end;
+            Inc(dest);
+         end;
+
+         { one of the runs keeps winning - find the ends of the
+           winning streaks with exponential searches until they
+           become short again }
+         while (bufi < bufLen) and (k < kEnd) do
+         begin
+            countA := Gallop(start[k], true, bufi, bufLen - bufi, true, false);
+            for i := 1 to countA do
+            begin
+               start[dest] := buffer[bufi];
+               Inc(dest);
+               Inc(bufi);
+            end;
+            if bufi = bufLen then
+               break;
+            start[dest] := start[k];
+            Inc(dest);
+            Inc(k);
+            if k = kEnd then
+               break;
+
+            countB := Gallop(buffer[bufi], false, k, kEnd - k, false, false);
+            for i := 1 to countB do
+            begin
+               start[dest] := start[k];
+               Inc(dest);
+               Inc(k);
+            end;
+            if k = kEnd then
+               break;
+            start[dest] := buffer[bufi];
+            Inc(dest);
+            Inc(bufi);
+
+            if (countA < tsMinGallop) and (countB < tsMinGallop) then
+               break;
+         end;
+      end;
+
+      { the rest of the second run is already in place }
+      while bufi < bufLen do
+      begin
+         start[dest] := buffer[bufi];
+         Inc(dest);
+         Inc(bufi);
+      end;
+      mergeMode := 0;
+   end;
+
+   { merges [base1,base2) with [base2,base2+len2) by moving the second
+     run to the buffer and merging from the right }
+   procedure MergeHigh(base1, base2, len2 : IndexType);
+   var
+      countA, countB, i : IndexType;
+   begin
+      for i := 0 to len2 - 1 do
+         buffer[i] := start[base2 + i];
+      dest := base2 + len2 - 1;
+      ai := base2 - 1;
+      bi := len2 - 1;
+      mergeMode := 2;
+
+      while (bi >= 0) and (ai >= base1) do
+      begin
+         countA := 0;
+         countB := 0;
+         while (bi >= 0) and (ai >= base1) and
+                  (countA < tsMinGallop) and (countB < tsMinGallop) do
+         begin
+            if _mcp_lt(buffer[bi], start[ai], comparer) then
+            begin
+               start[dest] := start[ai];
+               Dec(ai);
+               Inc(countA);
+               countB := 0;
+            end else
+            begin
+               start[dest] := buffer[bi];
+               Dec(bi);
+               Inc(countB);
+               countA := 0;
+            end;
+            Dec(dest);
+         end;
+
+         while (bi >= 0) and (ai >= base1) do
+         begin
+            { the items of the first run greater than the last
+              remaining item of the second one }
+            countA := ai - base1 + 1 -
+                        Gallop(buffer[bi], false, base1, ai - base1 + 1, true, true);
+            for i := 1 to countA do
+            begin
+               start[dest] := start[ai];
+               Dec(dest);
+               Dec(ai);
+            end;
+            if ai < base1 then
+               break;
+            start[dest] := buffer[bi];
+            Dec(dest);
+            Dec(bi);
+            if bi < 0 then
+               break;
+
+            { the items of the second run not smaller than the last
+              remaining item of the first one }
+            countB := bi + 1 - Gallop(start[ai], true, 0, bi + 1, false, true);
+            for i := 1 to countB do
+            begin
+               start[dest] := buffer[bi];
+               Dec(dest);
+               Dec(bi);
+            end;
+            if bi < 0 then
+               break;
+            start[dest] := start[ai];
+            Dec(dest);
+            Dec(ai);
+
+            if (countA < tsMinGallop) and (countB < tsMinGallop) then
+               break;
+         end;
+      end;
+
+      { the rest of the first run is already in place }
+      while bi >= 0 do
+      begin
+         start[dest] := buffer[bi];
+         Dec(dest);
+         Dec(bi);
+      end;
+      mergeMode := 0;
+   end;
+
+   { merges the i-th and the i+1-th pending runs }
+   procedure MergeAt(i : IndexType);
+   var
+      base1, len1, base2, len2, k : IndexType;
+   begin
+      base1 := runBase[i];
+      len1 := runLen[i];
+      base2 := runBase[i + 1];
+      len2 := runLen[i + 1];
+      runLen[i] := len1 + len2;
+
+      { the items of the first run not greater than the first item of
+        the second one are already in place, and so are the items of
+        the second run not smaller than the last item of the first
+        one }
+      k := Gallop(start[base2], false, base1, len1, true, false);
+      Inc(base1, k);
+      Dec(len1, k);
+      if len1 = 0 then
+         Exit;
+      len2 := Gallop(start[base2 - 1], false, base2, len2, false, true);
+      if len2 = 0 then
+         Exit;
+
+      if len1 <= len2 then
+      begin
+         ReserveBuffer(len1);
+         MergeLow(base1, base2, len2);
+      end else
+      begin
+         ReserveBuffer(len2);
+         MergeHigh(base1, base2, len2);
+      end;
+   end;
+
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   n := finish.Index - start.Index;
+   if n < 2 then
+      Exit;
+
+   owner := start.Owner;
+   owns := owner.OwnsItems;
+   owner.OwnsItems := false;
+
+   mergeMode := 0;
+   try
+      { the minimal run length; chosen so that n/minRun is a power of
+        2 or slightly less than it }
+      m := n;
+      r := 0;
+      while m >= tsMinMerge do
+      begin
+         r := r or (m and 1);
+         m := m shr 1;
+      end;
+      minRun := m + r;
 
-            i := i + 2*n;
-         end; { end while i + n < fi }
-         { copy the tail }
-         while i < fi do
+      top := 0;
+      lo := 0;
+      while lo < n do
+      begin
+         len := CountRun(lo);
+         if len < minRun then
          begin
-            buffer[i] := start[i];
-            Inc(i);
+            force := minRun;
+            if force > n - lo then
+               force := n - lo;
+            BinaryInsertionSort(lo, lo + len, lo + force);
+            len := force;
          end;
-         n := 2*n;
 
-         invalidContainer := true; { exception handling }
-         if n < fi then
+         { merge the pending runs whose joining nodes lie deeper in
+           the merge tree than the node joining the top run with the
+           new one }
+         p := 0;
+         if top > 0 then
          begin
-            { now merge the sequences in the buffer and put them into
-              the proper array }
-            i := 0;
-            while i + n < fi do
-            begin
-               j := i;
-               k := i + n;
-               m := i;
-               while (j < i + n) and (k < fi) and (k < i + 2*n) do
-               begin
-                  if _mcp_lte(buffer[j], buffer[k], comparer) then
-                  begin
-                     start[m] := buffer[j];
-                     Inc(j);
-                  end else
-                  begin
-                     start[m] := buffer[k];
-                     Inc(k);
-                  end;
-                  Inc(m);
-               end; { end while end of sequence not reached }
-
-               while j < i + n do
-               begin
-                  start[m] := buffer[j];
-                  Inc(j);
-                  Inc(m);
-               end;
-
-               while (k < i + 2*n) and (k < fi) do
-               begin
-                  start[m] := buffer[k];
-                  Inc(k);
-                  Inc(m);
-               end;
-
-               i := i + 2*n;
-            end; { end while i + n < fi }
-            { copy the tail }
-            while i < fi do
+            p := NodePower(runBase[top - 1], runLen[top - 1], len);
+            while (top > 1) and (runPower[top - 1] > p) do
             begin
-               start[i] := buffer[i];
-               Inc(i);
+               MergeAt(top - 2);
+               Dec(top);
             end;
-            n := 2*n;
+         end;
 
-         end else
+         if top = Length(runBase) then
          begin
-            { copy items from the buffer to the container }
-            for i := 0 to fi - 1 do
-               start[i] := buffer[i];
-         end; { end not if n < fi }
-         invalidContainer := false;
-      end; { end while n < fi }
+            SetLength(runBase, top + 8); { may raise }
+            SetLength(runLen, top + 8);
+            SetLength(runPower, top + 8);
+         end;
+         runBase[top] := lo;
+         runLen[top] := len;
+         runPower[top] := p;
+         Inc(top);
+         Inc(lo, len);
+      end;
 
-   finally
-      if invalidContainer then
+      while top > 1 do
       begin
-         { the exception was raised in the second part of the loop
-           when items are copied from the buffer to the container;
-           just copy all of them back into the container not to leak
-           anything }
-         for i := 0 to fi - 1 do
-            start[i] := buffer[i];
+         MergeAt(top - 2);
+         Dec(top);
+      end;
+
+   finally
+      { the comparer raised an exception during a merge; put the items
+        from the buffer back into the gap they left not to leak
+        anything }
+      case mergeMode of
+         1:
+            while bufi < bufLen do
+            begin
+               start[dest] := buffer[bufi];
+               Inc(dest);
+               Inc(bufi);
+            end;
+         2:
+            while bi >= 0 do
+            begin
+               start[dest] := buffer[bi];
+               Dec(dest);
+               Dec(bi);
+            end;
       end;
       owner.OwnsItems := owns;
    end;
@@ -932,6 +1940,111 @@ begin
    InsertionSortAux(start, 0, finish.Index - start.Index, comparer);
 end;
 
+procedure PartialSort(start, middle, finish : TRandomAccessIterator;
+                      const comparer : IBinaryComparer);
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, middle);
+   CheckIteratorRange(middle, finish);
+{$endif }
+
+   PartialSortAux(start, 0, middle.Index - start.Index,
+                  finish.Index - start.Index, comparer);
+end;
+
+function PartialSortCopy(const start1, finish1 : TForwardIterator;
+                         start2 : TOutputIterator; count : SizeType;
+                         const comparer : IBinaryComparer;
+                         const itemCopier : IUnaryFunctor) : SizeType;
+var
+   heap : array of ItemType;
+   iter : TForwardIterator;
+   aitem : ItemType;
+   n, i : IndexType;
+
+   { restores the max-heap heap[0..len-1] below i }
+   procedure SiftDown(i, len : IndexType);
+   var
+      c : IndexType;
+      aitem : ItemType;
+   begin
+      aitem := heap[i];
+      c := 2*i + 1;
+      while c < len do
+      begin
+         if (c + 1 < len) and _mcp_lt(heap[c], heap[c + 1], comparer) then
+            Inc(c);
+         if not _mcp_lt(aitem, heap[c], comparer) then
+            break;
+         heap[i] := heap[c];
+         i := c;
+         c := 2*i + 1;
+      end;
+      heap[i] := aitem;
+   end;
+
+   procedure SiftUp(i : IndexType);
+   var
+      p : IndexType;
+      aitem : ItemType;
+   begin
+      aitem := heap[i];
+      while i > 0 do
+      begin
+         p := (i - 1) div 2;
+         if not _mcp_lt(heap[p], aitem, comparer) then
+            break;
+         heap[i] := heap[p];
+         i := p;
+      end;
+      heap[i] := aitem;
+   end;
+
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start1, finish1);
+{$endif }
+
+   { the heap holds the items of the range, not their copies; only the
+     items finally written are copied }
+   n := 0;
+   iter := CopyOf(start1);
+   while not iter.Equal(finish1) do
+   begin
+      aitem := iter.Item;
+      if n < count then
+      begin
+         if n = Length(heap) then
+         begin
+            if count - n > n + 16 then
+               SetLength(heap, 2*n + 16)
+            else
+               SetLength(heap, count);
+         end;
+         heap[n] := aitem;
+         SiftUp(n);
+         Inc(n);
+      end else if (count > 0) and _mcp_lt(aitem, heap[0], comparer) then
+      begin
+         heap[0] := aitem;
+         SiftDown(0, n);
+      end;
+      iter.Advance;
+   end;
+   iter.Destroy;
+
+   for i := n - 1 downto 1 do
+   begin
+      aitem := heap[0];
+      heap[0] := heap[i];
+      heap[i] := aitem;
+      SiftDown(0, i);
+   end;
+   for i := 0 to n - 1 do
+      start2.Write(itemCopier.Perform(heap[i]));
+   Result := n;
+end;
+
 { ------------------- other mutating algorithms -------------------------- }
 
 procedure Rotate(start, newstart, finish : TForwardIterator);
@@ -947,6 +2060,18 @@ begin
    if start.Equal(newstart) or newstart.Equal(finish) then
       Exit;
 
+   if algUseFastPaths and (start is TCircularDequeIterator) and
+         (newstart is TCircularDequeIterator) and
+         start.IsStart and finish.IsFinish then
+   begin
+      { the iterators into a circular deque are indices, so they keep
+        pointing at the same positions }
+      TCircularDeque(start.Owner).Rotate(
+         TCircularDequeIterator(newstart).Index -
+            TCircularDequeIterator(start).Index);
+      Exit;
+   end;
+
    src := nil; { will be set in the loop }
    dest := CopyOf(newstart);
 //   newstart := CopyOf(newstart);
@@ -1044,6 +2169,12 @@ begin
    CheckIteratorRange(start, finish);
 {$endif }
 
+   if algUseFastPaths and (start is TDoubleListIterator) then
+   begin
+      TDoubleList(start.Owner).Reverse(start, finish);
+      Exit;
+   end;
+
    while not start.Equal(finish) do
    begin
       finish.Retreat;
@@ -1422,6 +2553,44 @@ begin
    end;
 end;
 
+procedure NthElement(start, nth, finish : TRandomAccessIterator;
+                     const comparer : IBinaryComparer);
+var
+   si, fi, k, cut : IndexType;
+   depth : SizeType;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, nth);
+   CheckIteratorRange(nth, finish);
+{$endif }
+
+   si := 0;
+   fi := finish.Index - start.Index;
+   k := nth.Index - start.Index;
+   Assert((k >= 0) and (k <= fi), msgInvalidIterator);
+   if k = fi then
+      Exit;
+
+   { a good pivot at least halves the range, so this many steps suffice
+     unless the pivots are consistently bad }
+   depth := 2*FloorLog2(fi);
+   while fi - si > qsMinItems do
+   begin
+      if depth = 0 then
+      begin
+         PartialSortAux(start, si, k + 1, fi, comparer);
+         Exit;
+      end;
+      Dec(depth);
+      cut := MedianPartitionAux(start, si, fi, comparer);
+      if cut <= k then
+         si := cut
+      else
+         fi := cut;
+   end;
+   InsertionSortAux(start, si, fi, comparer);
+end;
+
 
 { ======================== deleting algorithms =========================== }
 
@@ -1531,7 +2700,8 @@ function InterpolationFind(const start, finish : TRandomAccessIterator;
 var
    si, fi, i, d : IndexType;
 begin
-&if (&ItemType != Real && &ItemType != Integer && &ItemType != Cardinal)
+&if (&ItemType != Real && &ItemType != Integer && &ItemType != Cardinal &&
+        &ItemType != Double)
    Assert(diff <> nil);
 &endif
 {$ifdef DEBUG_PASCAL_ADT }
@@ -1754,6 +2924,245 @@ begin
    s2.Free;
 end;
 
+{ merges the sorted ranges [iters[i], finishes[i]) with a loser tree
+  and writes their items to output, copied with itemCopier if it is
+  not nil; advances iters[i] past the items written and stores their
+  number in counts[i]. The tree has k - 1 internal nodes numbered from
+  1 and k leaves numbered k..2k-1, leaf k + i standing for range
+  i. Each internal node holds the loser of the match played there, so
+  after the winner is advanced only the matches on the path from its
+  leaf to the root are replayed. An exhausted range loses to any
+  other; equal items are won by the range with the lower index. }
+procedure MergeManyAux(const iters, finishes : array of TForwardIterator;
+                       output : TOutputIterator;
+                       const comparer : IBinaryComparer;
+                       const itemCopier : IUnaryFunctor;
+                       var counts : array of SizeType); overload;
+var
+   tree, winners : array of IndexType;
+   keys : array of ItemType;
+   alive : array of Boolean;
+   k, i, node, a, b, w, t : IndexType;
+
+   function Beats(x, y : IndexType) : Boolean;
+   begin
+      if not alive[x] then
+         Result := false
+      else if not alive[y] then
+         Result := true
+      else if x < y then
+         Result := not _mcp_lt(keys[y], keys[x], comparer)
+      else
+         Result := _mcp_lt(keys[x], keys[y], comparer);
+   end;
+
+   function Winner(n : IndexType) : IndexType;
+   begin
+      if n >= k then
+         Result := n - k
+      else
+         Result := winners[n];
+   end;
+
+begin
+   k := Length(iters);
+   if k = 0 then
+      Exit;
+
+   SetLength(keys, k);
+   SetLength(alive, k);
+   for i := 0 to k - 1 do
+   begin
+      counts[i] := 0;
+      alive[i] := not iters[i].Equal(finishes[i]);
+      if alive[i] then
+         keys[i] := iters[i].Item;
+   end;
+
+   { play the initial tournament bottom-up }
+   SetLength(tree, k);
+   SetLength(winners, k);
+   for node := k - 1 downto 1 do
+   begin
+      a := Winner(2*node);
+      b := Winner(2*node + 1);
+      if Beats(a, b) then
+      begin
+         winners[node] := a;
+         tree[node] := b;
+      end else
+      begin
+         winners[node] := b;
+         tree[node] := a;
+      end;
+   end;
+   if k > 1 then
+      w := winners[1]
+   else
+      w := 0;
+
+   while alive[w] do
+   begin
+      if itemCopier <> nil then
+         output.Write(itemCopier.Perform(keys[w]))
+      else
+         output.Write(keys[w]);
+      iters[w].Advance;
+      Inc(counts[w]);
+      alive[w] := not iters[w].Equal(finishes[w]);
+      if alive[w] then
+         keys[w] := iters[w].Item;
+
+      node := (w + k) div 2;
+      while node > 0 do
+      begin
+         if Beats(tree[node], w) then
+         begin
+            t := tree[node];
+            tree[node] := w;
+            w := t;
+         end;
+         node := node div 2;
+      end;
+   end;
+end;
+
+procedure MergeMany(const starts, finishes : array of TForwardIterator;
+                    output : TOutputIterator;
+                    const comparer : IBinaryComparer);
+var
+   iters : array of TForwardIterator;
+   counts : array of SizeType;
+   owns : Boolean;
+   i : IndexType;
+begin
+   Assert(Length(starts) = Length(finishes), msgInvalidArgument);
+{$ifdef DEBUG_PASCAL_ADT }
+   for i := 0 to Length(starts) - 1 do
+      CheckIteratorRange(starts[i], finishes[i]);
+{$endif }
+
+   SetLength(iters, Length(starts));
+   SetLength(counts, Length(starts));
+   for i := 0 to Length(starts) - 1 do
+      iters[i] := nil;
+   try
+      for i := 0 to Length(starts) - 1 do
+         iters[i] := CopyOf(starts[i]);
+      MergeManyAux(iters, finishes, output, comparer, nil, counts);
+   finally
+      for i := 0 to Length(iters) - 1 do
+         iters[i].Free;
+   end;
+
+   for i := 0 to Length(starts) - 1 do
+   begin
+      owns := starts[i].Owner.OwnsItems;
+      starts[i].Owner.OwnsItems := false;
+      try
+         Delete(starts[i], counts[i]);
+      finally
+         starts[i].Owner.OwnsItems := owns;
+      end;
+   end;
+end;
+
+procedure MergeManyCopy(const starts, finishes : array of TForwardIterator;
+                        output : TOutputIterator;
+                        const comparer : IBinaryComparer;
+                        const itemCopier : IUnaryFunctor);
+var
+   iters : array of TForwardIterator;
+   counts : array of SizeType;
+   i : IndexType;
+begin
+   Assert(Length(starts) = Length(finishes), msgInvalidArgument);
+   Assert(itemCopier <> nil, msgInvalidArgument);
+{$ifdef DEBUG_PASCAL_ADT }
+   for i := 0 to Length(starts) - 1 do
+      CheckIteratorRange(starts[i], finishes[i]);
+{$endif }
+
+   SetLength(iters, Length(starts));
+   SetLength(counts, Length(starts));
+   for i := 0 to Length(starts) - 1 do
+      iters[i] := nil;
+   try
+      for i := 0 to Length(starts) - 1 do
+         iters[i] := CopyOf(starts[i]);
+      MergeManyAux(iters, finishes, output, comparer, itemCopier, counts);
+   finally
+      for i := 0 to Length(iters) - 1 do
+         iters[i].Free;
+   end;
+end;
+
+{ merges the items of <sets> to output, copied with itemCopier if it
+  is not nil }
+procedure MergeManySetsAux(const sets : array of TSortedSetAdt;
+                           output : TOutputIterator;
+                           const itemCopier : IUnaryFunctor); overload;
+var
+   starts, finishes : array of TForwardIterator;
+   counts : array of SizeType;
+   i : IndexType;
+begin
+   if Length(sets) = 0 then
+      Exit;
+
+   SetLength(starts, Length(sets));
+   SetLength(finishes, Length(sets));
+   SetLength(counts, Length(sets));
+   for i := 0 to Length(sets) - 1 do
+   begin
+      starts[i] := nil;
+      finishes[i] := nil;
+   end;
+   try
+      for i := 0 to Length(sets) - 1 do
+      begin
+         starts[i] := sets[i].Start;
+         finishes[i] := sets[i].Finish;
+      end;
+      MergeManyAux(starts, finishes, output, sets[0].ItemComparer,
+                   itemCopier, counts);
+   finally
+      for i := 0 to Length(sets) - 1 do
+      begin
+         starts[i].Free;
+         finishes[i].Free;
+      end;
+   end;
+end;
+
+procedure MergeMany(const sets : array of TSortedSetAdt;
+                    output : TOutputIterator);
+var
+   owns : Boolean;
+   i : IndexType;
+begin
+   MergeManySetsAux(sets, output, nil);
+
+   for i := 0 to Length(sets) - 1 do
+   begin
+      owns := sets[i].OwnsItems;
+      sets[i].OwnsItems := false;
+      try
+         sets[i].Clear;
+      finally
+         sets[i].OwnsItems := owns;
+      end;
+   end;
+end;
+
+procedure MergeManyCopy(const sets : array of TSortedSetAdt;
+                        output : TOutputIterator;
+                        const itemCopier : IUnaryFunctor);
+begin
+   Assert(itemCopier <> nil, msgInvalidArgument);
+   MergeManySetsAux(sets, output, itemCopier);
+end;
+
 { ----------------------------- set algorithms ------------------------------ }
 
 function SetUnion(set1, set2 : TSetAdt) : TSetAdt;
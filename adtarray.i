@@ -69,6 +69,10 @@ type
                            IUnaryFunctor) : TContainerAdt; override;
       { swaps self with <cont>; @see TContainerAdt.Swap }
       procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Capacity, LoadFactor and Resizes }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       { returns the element at the given index }
       function GetItem(index : IndexType) : ItemType; override;
       { sets the element at the given index }
@@ -115,6 +119,35 @@ type
       function HighIndex : IndexType; override;
       { sets the lowest (first) index; returns the old one; }
       function SetLowIndex(ind : IndexType) : IndexType;
+      { loop directly over the underlying array }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { moves the items which are kept towards the front in a single
+        pass and removes the rest of the array at the end;
+        @complexity O(n) }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { copies <n> items of <src> starting at <srcIndex> to self
+        starting at <destIndex>, passing each of them through
+        <itemCopier>; the items overwritten are disposed and the ones
+        which do not fit before the end of self are pushed at the
+        back; <src> may be self, in which case the items are copied
+        from the front to the back, exactly as the Copy algorithm from
+        @<adtalgs> does; when <itemCopier> is the shared identity
+        functor and nothing needs to be disposed the items are moved
+        as one block of memory; the Copy algorithm calls this for two
+        TArrays; @complexity O(n) }
+      procedure CopyItems(src : TArray; srcIndex, destIndex : IndexType;
+                          n : SizeType; const itemCopier : IUnaryFunctor);
+      { all the items form a single slice }
+      function GetSlice(index : IndexType; n : SizeType) : TSlice; override;
+      { makes room for all the items with one move of the items after
+        <index> and then copies them in as one block }
+      procedure InsertBlock(index : IndexType; const buffer : array of ItemType;
+                            n : SizeType); override;
    end;
       
    TArrayIterator = class (TRandomAccessContainerIterator)
@@ -207,6 +240,20 @@ type
         amortized or worst-case O(1) and never more than worst-case
         O(n). }
       function Size : SizeType; override;
+      { all the items form a single slice }
+      function GetSlice(index : IndexType; n : SizeType) : TSlice; override;
+      { loop directly over the underlying array }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { moves the items which are kept towards the front in a single
+        pass and removes the rest of the array at the end;
+        @complexity O(n) }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { resizes the array once and copies the items in as one block }
+      procedure InsertBlock(index : IndexType; const buffer : array of ItemType;
+                            n : SizeType); override;
       property PascalArray : TPascalArrayType read FPascalArray;
    end;
    
@@ -219,3 +266,145 @@ type
    end;
    
 
+   { ------------------------- TTieredVector ----------------------------- }
+
+   TTieredVectorIterator = class;
+
+   { a single segment of a TTieredVector; the segment is a circular
+     buffer - the item at the logical position i within the segment is
+     stored at Buffer^.Items[(StartIndex + i) and (capacity - 1)] }
+   TTieredVectorSegment = record
+      Buffer : TDynamicBuffer;
+      StartIndex : IndexType;
+   end;
+   TTieredVectorSegmentArray = array of TTieredVectorSegment;
+
+   { An array implemented as a tiered vector - a sequence of circular
+     segments of equal capacity, which is a power of two. All segments
+     except the last one are full, so the item at a given index is
+     found with a shift and a mask. Inserting or deleting an item in
+     the middle moves only the items within one segment, and then
+     passes one item between each pair of consecutive segments up to
+     the end, so it takes O(sqrt(n)) instead of O(n). The capacity of
+     the segments is doubled or halved as the array grows or shrinks,
+     so that the number of segments is kept within a constant factor
+     of it. }
+   TTieredVector = class (TArrayAdt)
+   private
+      FSegments : TTieredVectorSegmentArray;
+      { the number of segments holding items; the buffers of the
+        segments beyond are kept for reuse }
+      FSegCount : SizeType;
+      FSize : SizeType;
+      { the capacity of each segment is 1 shl FShift }
+      FShift : IndexType;
+      FMask : IndexType;
+{$ifdef PASCAL_ADT_STATS }
+      FResizes : SizeType;
+{$endif PASCAL_ADT_STATS }
+
+      { moves the <n> items at the logical positions [first,first+n)
+        in the segment <seg> one position rightwards }
+      procedure SegmentShiftRight(seg, first : IndexType; n : SizeType);
+      { moves the <n> items at the logical positions [first,first+n)
+        in the segment <seg> one position leftwards }
+      procedure SegmentShiftLeft(seg, first : IndexType; n : SizeType);
+      { redistributes the items among segments with the capacity
+        1 shl <newShift>; @complexity O(n) }
+      procedure Restructure(newShift : IndexType);
+      { makes sure there is room for one more item at the back }
+      procedure MakeRoom;
+
+   protected
+      { returns the current capacity of the container }
+      function GetCapacity : SizeType; override;
+      { allocates the segments needed to hold <cap> items, but only if
+        <cap> is bigger than the current capacity }
+      procedure SetCapacity(cap : SizeType); override;
+
+   public
+      constructor Create; overload;
+      { creates a copy of <cont>; if <itemCopier> = nil then does not
+        copy the items }
+      constructor CreateCopy(const cont : TTieredVector;
+                             const itemCopier : IUnaryFunctor); overload;
+      { destroyes the container }
+      destructor Destroy; override;
+      { returns an iterator pointing to the first element }
+      function RandomAccessStart : TRandomAccessIterator; override;
+      { returns an iterator to the one beyond last element }
+      function RandomAccessFinish : TRandomAccessIterator; override;
+      { returns the start iterator }
+      function Start : TTieredVectorIterator;
+      { returns the finish iterator }
+      function Finish : TTieredVectorIterator;
+      { returns a copy of self }
+      function CopySelf(const ItemCopier :
+                           IUnaryFunctor) : TContainerAdt; override;
+      { swaps self with <cont>; @see TContainerAdt.Swap }
+      procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Capacity, LoadFactor, Nodes and Resizes; Resizes counts
+        the changes of the capacity of the segments }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
+      { returns the element at the given index; @complexity O(1) }
+      function GetItem(index : IndexType) : ItemType; override;
+      { sets the element at the given index; @complexity O(1) }
+      procedure SetItem(index : IndexType; elem : ItemType); override;
+      { inserts item at index, i.e. the new element will be at
+        position index; @complexity amortized O(sqrt(n)) }
+      procedure Insert(index : IndexType;
+                       aitem : ItemType); overload; override;
+      { deletes element at index; @complexity amortized O(sqrt(n)) }
+      procedure Delete(index : IndexType); overload; override;
+      { deletes n items beginning with start; @complexity
+        O(min(n*sqrt(n), Size - start)) }
+      function Delete(astart : IndexType;
+                      n : SizeType) : SizeType; overload; override;
+      { Removes the item at <index> from the container, but does not
+        dispose it. Returns the removed item. @complexity amortized
+        O(sqrt(n)) }
+      function Extract(index : IndexType) : ItemType; overload; override; 
+      { pushes elem at the back; @complexity amortized O(1) }
+      procedure PushBack(aitem : ItemType); override;
+      { pushes aitem at the front; @complexity amortized O(sqrt(n)) }
+      procedure PushFront(aitem : ItemType); override;
+      { deletes the element at the back of the container }
+      procedure PopBack; override;
+      { deletes the element at the front of the container; @complexity
+        amortized O(sqrt(n)) }
+      procedure PopFront; override;
+      { returns the element at the back }
+      function Back : ItemType; override;
+      { returns the element at the front }
+      function Front : ItemType; override;
+      { clears the container - removes all items; @complexity O(n). }
+      procedure Clear; override;
+      { returns true if container is empty; @complexity worst-case O(1). }
+      function Empty : Boolean; override;
+      { returns the number of items; @complexity worst-case O(1). }
+      function Size : SizeType; override;
+      { loop directly over the segments }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { moves the items which are kept towards the front in a single
+        pass and drops the rest at the end;
+        @complexity O(n) }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { the capacity of a single segment }
+      function SegmentCapacity : SizeType;
+      { a slice ends at the end of a segment or where the circular
+        buffer of the segment wraps around }
+      function GetSlice(index : IndexType; n : SizeType) : TSlice; override;
+   end;
+
+   TTieredVectorIterator = class (TRandomAccessContainerIterator)
+   public
+      { returns an exact copy of self; i.e. copies all the data }
+      function CopySelf : TIterator; override;
+      { exchanges items at positions i and j relative to self }
+      procedure ExchangeItemsAt(i, j : IndexType); override;
+   end;
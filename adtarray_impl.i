@@ -28,6 +28,8 @@
 &include adtarray.defs
 &include adtarray_impl.mcp
 
+&define Identity &_mcp_prefix&Identity
+
 { --------------------------- TArray ----------------------------- }
 
 constructor TArray.Create(afirstIndex : IndexType);
@@ -121,6 +123,20 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TArray.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Capacity := FItems^.Capacity;
+   stats.UsedSlots := FItems^.Size;
+   if stats.Capacity <> 0 then
+      stats.LoadFactor := stats.Items / stats.Capacity;
+   Inc(stats.Bytes, SizeOf(TDynamicArrayRec) +
+                       FItems^.Capacity * SizeOf(ItemType));
+   Inc(stats.Resizes, FItems^.Resizes);
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TArray.GetItem(index : IndexType) : ItemType;
 begin
    Result := FItems^.Items[index - firstIndex];
@@ -257,6 +273,156 @@ begin
    firstIndex := ind;
 end;
 
+procedure TArray.ForEach(const funct : IUnaryFunctor);
+var
+   i : IndexType;
+begin
+   for i := 0 to FItems^.Size - 1 do
+      funct.Perform(FItems^.Items[i]);
+end;
+
+function TArray.Fold(const funct : IBinaryFunctor;
+                     init : ItemType) : ItemType;
+var
+   i : IndexType;
+begin
+   Result := init;
+   for i := 0 to FItems^.Size - 1 do
+      Result := funct.Perform(Result, FItems^.Items[i]);
+end;
+
+function TArray.FindIf(const pred : IUnaryPredicate;
+                       var aitem : ItemType) : Boolean;
+var
+   i : IndexType;
+begin
+   for i := 0 to FItems^.Size - 1 do
+   begin
+      if pred.Test(FItems^.Items[i]) then
+      begin
+         aitem := FItems^.Items[i];
+         Result := true;
+         Exit;
+      end;
+   end;
+   Result := false;
+end;
+
+function TArray.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   i : IndexType;
+begin
+   Result := 0;
+   for i := 0 to FItems^.Size - 1 do
+   begin
+      if pred.Test(FItems^.Items[i]) then
+         Inc(Result);
+   end;
+end;
+
+function TArray.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   r, w : IndexType;
+   aitem : ItemType;
+begin
+   r := 0;
+   w := 0;
+   try
+      while r < FItems^.Size do
+      begin
+         aitem := FItems^.Items[r];
+         if pred.Test(aitem) then { may raise }
+         begin
+            Inc(r);
+            DisposeItem(aitem);
+         end else
+         begin
+            FItems^.Items[w] := aitem;
+            Inc(w);
+            Inc(r);
+         end;
+      end;
+   finally
+      { [w, r) holds the deleted items; if an exception was raised
+        the items from r onwards have not been tested yet and are
+        moved to w }
+      Result := r - w;
+      ArrayRemoveItems(FItems, w, r - w);
+   end;
+end;
+
+procedure TArray.CopyItems(src : TArray; srcIndex, destIndex : IndexType;
+                           n : SizeType; const itemCopier : IUnaryFunctor);
+var
+   i, s, d, inside : IndexType;
+   aitem, old : ItemType;
+begin
+   Assert((srcIndex >= src.LowIndex) and
+             (srcIndex + n <= src.HighIndex + 1), msgInvalidIndex);
+   Assert((destIndex >= LowIndex) and (destIndex <= HighIndex + 1),
+          msgInvalidIndex);
+
+   s := srcIndex - src.firstIndex;
+   d := destIndex - firstIndex;
+   { the number of items overwritten; the rest are pushed at the back }
+   inside := FItems^.Size - d;
+   if inside > n then
+      inside := n;
+
+&if (&_mcp_is_plain_data(&ItemType&))
+   { a block move gives the same result as copying the items one by
+     one unless the destination starts inside the source or the
+     overwritten items have to be disposed }
+&if (&_mcp_type_needs_destruction(&ItemType))
+   if (itemCopier = Identity) and (not OwnsItems) and
+&else
+   if (itemCopier = Identity) and
+&endif
+         ((src <> self) or (d <= s) or (d >= s + n)) then
+   begin
+      if inside > 0 then
+      begin
+         system.Move(src.FItems^.Items[s], FItems^.Items[d],
+                     inside * SizeOf(ItemType));
+      end;
+   end else
+&endif
+   begin
+      for i := 0 to inside - 1 do
+      begin
+         aitem := itemCopier.Perform(src.FItems^.Items[s + i]);
+         old := FItems^.Items[d + i];
+         DisposeItem(old);
+         FItems^.Items[d + i] := aitem;
+      end;
+   end;
+
+   { src.FItems may be reallocated here if src = self }
+   for i := inside to n - 1 do
+      ArrayPushBack(FItems, itemCopier.Perform(src.FItems^.Items[s + i]));
+end;
+
+function TArray.GetSlice(index : IndexType; n : SizeType) : TSlice;
+begin
+   Assert((index >= LowIndex) and (index + n <= HighIndex + 1),
+          msgInvalidIndex);
+   Result.Items := @FItems^.Items[index - firstIndex];
+   Result.Count := n;
+end;
+
+procedure TArray.InsertBlock(index : IndexType; const buffer : array of ItemType;
+                             n : SizeType);
+begin
+   Assert((n >= 0) and (n <= Length(buffer)), msgInvalidArgument);
+   Assert((index >= LowIndex) and (index <= HighIndex + 1), msgInvalidIndex);
+
+   if n <> 0 then
+   begin
+      ArrayReserveItems(FItems, index - firstIndex, n);
+      StoreBlock(index, buffer, n);
+   end;
+end;
+
 { -------------------------- TArrayIterator ----------------------------- }
 
 function TArrayIterator.CopySelf : TIterator;
@@ -381,8 +547,8 @@ procedure TPascalArray.Insert(index : IndexType; aitem : ItemType);
 begin
    Assert((index >= 0) and (index <= Length(FPascalArray)), msgInvalidIndex);
    SetLength(FPascalArray, Length(FPascalArray) + 1);
-   SafeMove(FPascalArray[index], FPascalArray[index + 1],
-            (Length(FPascalArray) - 1 - index));
+   RelocateItems(FPascalArray[index], FPascalArray[index + 1],
+                 (Length(FPascalArray) - 1 - index));
    FPascalArray[index] := aitem;
 end;
 
@@ -411,8 +577,8 @@ begin
    &endif
    if astart + n <> Length(FPascalArray) then
    begin
-      SafeMove(FPascalArray[astart + n], FPascalArray[astart],
-               (Length(FPascalArray) - astart - n));
+      RelocateItems(FPascalArray[astart + n], FPascalArray[astart],
+                    (Length(FPascalArray) - astart - n));
    end;
    SetLength(FPascalArray, Length(FPascalArray) - n);
    Result := n;
@@ -422,8 +588,8 @@ function TPascalArray.Extract(index : IndexType) : ItemType;
 begin
    Assert((index >= 0) and (index < Length(FPascalArray)), msgInvalidIndex);
    Result := FPascalArray[index];
-   SafeMove(FPascalArray[index + 1], FPascalArray[index],
-            (Length(FPascalArray) - index - 1));
+   RelocateItems(FPascalArray[index + 1], FPascalArray[index],
+                 (Length(FPascalArray) - index - 1));
    SetLength(FPascalArray, Length(FPascalArray) - 1);
 end;
 
@@ -436,8 +602,8 @@ end;
 procedure TPascalArray.PushFront(aitem : ItemType); 
 begin
    SetLength(FPascalArray, Length(FPascalArray) + 1);
-   SafeMove(FPascalArray[0], FPascalArray[1],
-            (Length(FPascalArray) - 1));
+   RelocateItems(FPascalArray[0], FPascalArray[1],
+                 (Length(FPascalArray) - 1));
    FPascalArray[0] := aitem;
 end;
 
@@ -452,8 +618,8 @@ procedure TPascalArray.PopFront;
 begin
    Assert(Length(FPascalArray) <> 0, msgReadEmpty);
    DisposeItem(FPascalArray[0]);
-   SafeMove(FPascalArray[1], FPascalArray[0],
-            (Length(FPascalArray) - 1));
+   RelocateItems(FPascalArray[1], FPascalArray[0],
+                 (Length(FPascalArray) - 1));
    SetLength(FPascalArray, Length(FPascalArray) - 1);
 end;
 
@@ -494,6 +660,102 @@ begin
    Result := Length(FPascalArray);
 end;
 
+procedure TPascalArray.ForEach(const funct : IUnaryFunctor);
+var
+   i : IndexType;
+begin
+   for i := 0 to Length(FPascalArray) - 1 do
+      funct.Perform(FPascalArray[i]);
+end;
+
+function TPascalArray.FindIf(const pred : IUnaryPredicate;
+                             var aitem : ItemType) : Boolean;
+var
+   i : IndexType;
+begin
+   for i := 0 to Length(FPascalArray) - 1 do
+   begin
+      if pred.Test(FPascalArray[i]) then
+      begin
+         aitem := FPascalArray[i];
+         Result := true;
+         Exit;
+      end;
+   end;
+   Result := false;
+end;
+
+function TPascalArray.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   i : IndexType;
+begin
+   Result := 0;
+   for i := 0 to Length(FPascalArray) - 1 do
+   begin
+      if pred.Test(FPascalArray[i]) then
+         Inc(Result);
+   end;
+end;
+
+function TPascalArray.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   r, w, i : IndexType;
+   aitem : ItemType;
+begin
+   r := 0;
+   w := 0;
+   try
+      while r < Length(FPascalArray) do
+      begin
+         aitem := FPascalArray[r];
+         if pred.Test(aitem) then { may raise }
+         begin
+            Inc(r);
+            DisposeItem(aitem);
+         end else
+         begin
+            FPascalArray[w] := aitem;
+            Inc(w);
+            Inc(r);
+         end;
+      end;
+   finally
+      { [w, r) holds the deleted items; if an exception was raised
+        the items from r onwards have not been tested yet and are
+        moved to w }
+      Result := r - w;
+      if Result <> 0 then
+      begin
+         for i := r to Length(FPascalArray) - 1 do
+            FPascalArray[i - Result] := FPascalArray[i];
+         SetLength(FPascalArray, Length(FPascalArray) - Result);
+      end;
+   end;
+end;
+
+function TPascalArray.GetSlice(index : IndexType; n : SizeType) : TSlice;
+begin
+   Assert((index >= 0) and (index + n <= Length(FPascalArray)), msgInvalidIndex);
+   Result.Items := @FPascalArray[index];
+   Result.Count := n;
+end;
+
+procedure TPascalArray.InsertBlock(index : IndexType;
+                                   const buffer : array of ItemType;
+                                   n : SizeType);
+begin
+   Assert((n >= 0) and (n <= Length(buffer)), msgInvalidArgument);
+   Assert((index >= 0) and (index <= Length(FPascalArray)), msgInvalidIndex);
+
+   if n <> 0 then
+   begin
+      SetLength(FPascalArray, Length(FPascalArray) + n);
+      RelocateItems(FPascalArray[index], FPascalArray[index + n],
+                    Length(FPascalArray) - n - index);
+      StoreBlock(index, buffer, n);
+   end;
+end;
+
 { -------------------------- TPascalArrayIterator --------------------------- }
 
 function TPascalArrayIterator.CopySelf : TIterator;
@@ -511,3 +773,631 @@ begin
                          TPascalArray(FCont).FPascalArray[j]);
 end;
 
+
+
+{ ====================================================================== }
+
+{ --------------------------- TTieredVector ----------------------------- }
+
+constructor TTieredVector.Create;
+begin
+   inherited Create;
+   FShift := tvMinSegmentShift;
+   FMask := (1 shl FShift) - 1;
+end;
+
+constructor TTieredVector.CreateCopy(const cont : TTieredVector;
+                                     const itemCopier : IUnaryFunctor);
+var
+   i : IndexType;
+begin
+   inherited CreateCopy(cont);
+   FShift := cont.FShift;
+   FMask := cont.FMask;
+   
+   if itemCopier <> nil then
+   begin
+      SetCapacity(cont.FSize);
+      for i := 0 to cont.FSize - 1 do
+         PushBack(itemCopier.Perform(cont.GetItem(i))); { may raise }
+   end;
+end;
+
+destructor TTieredVector.Destroy;
+begin
+   Clear;
+   inherited;
+end;
+
+procedure TTieredVector.SegmentShiftRight(seg, first : IndexType; n : SizeType);
+var
+   src, dest, chunk : IndexType;
+begin
+   with FSegments[seg] do
+   begin
+      { the items are moved from the back in at most three chunks,
+        none of which wraps around the end of the buffer }
+      while n > 0 do
+      begin
+         src := (StartIndex + first + n - 1) and FMask;
+         dest := (src + 1) and FMask;
+         chunk := n;
+         if src + 1 < chunk then
+            chunk := src + 1;
+         if dest + 1 < chunk then
+            chunk := dest + 1;
+         RelocateItems(Buffer^.Items[src - chunk + 1],
+                       Buffer^.Items[dest - chunk + 1], chunk);
+         Dec(n, chunk);
+      end;
+   end;
+end;
+
+procedure TTieredVector.SegmentShiftLeft(seg, first : IndexType; n : SizeType);
+var
+   src, dest, chunk : IndexType;
+begin
+   with FSegments[seg] do
+   begin
+      while n > 0 do
+      begin
+         src := (StartIndex + first) and FMask;
+         dest := (src + FMask) and FMask;
+         chunk := n;
+         if FMask + 1 - src < chunk then
+            chunk := FMask + 1 - src;
+         if FMask + 1 - dest < chunk then
+            chunk := FMask + 1 - dest;
+         RelocateItems(Buffer^.Items[src], Buffer^.Items[dest], chunk);
+         Inc(first, chunk);
+         Dec(n, chunk);
+      end;
+   end;
+end;
+
+procedure TTieredVector.Restructure(newShift : IndexType);
+var
+   newSegs : TTieredVectorSegmentArray;
+   newMask, i : IndexType;
+begin
+   newMask := (1 shl newShift) - 1;
+   SetLength(newSegs, (FSize + newMask) shr newShift);
+   try
+      for i := 0 to Length(newSegs) - 1 do
+      begin
+         BufferAllocate(newSegs[i].Buffer, newMask + 1);
+         newSegs[i].StartIndex := 0;
+      end;
+   except
+      for i := 0 to Length(newSegs) - 1 do
+         BufferDeallocate(newSegs[i].Buffer);
+      raise;
+   end;
+   
+   for i := 0 to FSize - 1 do
+   begin
+      with FSegments[i shr FShift] do
+      begin
+         RelocateItems(Buffer^.Items[(StartIndex + i) and FMask],
+                       newSegs[i shr newShift].Buffer^.Items[i and newMask], 1);
+      end;
+   end;
+   
+   { the old buffers hold no items now, so deallocating them does not
+     release any references }
+   for i := 0 to Length(FSegments) - 1 do
+      BufferDeallocate(FSegments[i].Buffer);
+   
+   FSegments := newSegs;
+   FSegCount := Length(newSegs);
+   FShift := newShift;
+   FMask := newMask;
+{$ifdef PASCAL_ADT_STATS }
+   Inc(FResizes);
+{$endif PASCAL_ADT_STATS }
+end;
+
+procedure TTieredVector.MakeRoom;
+begin
+   if FSize = SizeType(FSegCount) shl FShift then
+   begin
+      { keep the number of segments at most twice the capacity of a
+        segment }
+      if FSegCount > SizeType(2) shl FShift then
+         Restructure(FShift + 1);
+      
+      if FSize = SizeType(FSegCount) shl FShift then
+      begin
+         if FSegCount = Length(FSegments) then
+            SetLength(FSegments, 2*FSegCount + 1);
+         with FSegments[FSegCount] do
+         begin
+            if Buffer = nil then
+               BufferAllocate(Buffer, FMask + 1);
+            StartIndex := 0;
+         end;
+         Inc(FSegCount);
+      end;
+   end;
+end;
+
+function TTieredVector.GetCapacity : SizeType;
+var
+   i : IndexType;
+begin
+   Result := 0;
+   for i := 0 to Length(FSegments) - 1 do
+   begin
+      if FSegments[i].Buffer <> nil then
+         Inc(Result, FMask + 1);
+   end;
+end;
+
+procedure TTieredVector.SetCapacity(cap : SizeType);
+var
+   needed, i : IndexType;
+begin
+   needed := (cap + FMask) shr FShift;
+   if needed > Length(FSegments) then
+      SetLength(FSegments, needed);
+   for i := 0 to needed - 1 do
+   begin
+      if FSegments[i].Buffer = nil then
+         BufferAllocate(FSegments[i].Buffer, FMask + 1);
+   end;
+end;
+
+function TTieredVector.RandomAccessStart : TRandomAccessIterator;
+begin
+   Result := Start;
+end;
+
+function TTieredVector.RandomAccessFinish : TRandomAccessIterator;
+begin
+   Result := Finish;
+end;
+
+function TTieredVector.Start : TTieredVectorIterator;
+begin
+   Result := TTieredVectorIterator.Create(0, self);
+end;
+
+function TTieredVector.Finish : TTieredVectorIterator;
+begin
+   Result := TTieredVectorIterator.Create(FSize, self);
+end;
+
+function TTieredVector.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TTieredVector.CreateCopy(self, itemCopier);
+end;
+
+procedure TTieredVector.Swap(cont : TContainerAdt);
+begin
+   if cont is TTieredVector then
+   begin
+      BasicSwap(cont);
+      ExchangePtr(FSegments, TTieredVector(cont).FSegments);
+      ExchangeData(FSegCount, TTieredVector(cont).FSegCount, SizeOf(SizeType));
+      ExchangeData(FSize, TTieredVector(cont).FSize, SizeOf(SizeType));
+      ExchangeData(FShift, TTieredVector(cont).FShift, SizeOf(IndexType));
+      ExchangeData(FMask, TTieredVector(cont).FMask, SizeOf(IndexType));
+{$ifdef PASCAL_ADT_STATS }
+      ExchangeData(FResizes, TTieredVector(cont).FResizes, SizeOf(SizeType));
+{$endif PASCAL_ADT_STATS }
+   end else
+      inherited;
+end;
+
+{$ifdef PASCAL_ADT_STATS }
+procedure TTieredVector.GetStats(var stats : TContainerStats);
+var
+   segs : SizeType;
+begin
+   inherited;
+   stats.Capacity := GetCapacity;
+   stats.UsedSlots := FSize;
+   if stats.Capacity <> 0 then
+      stats.LoadFactor := stats.Items / stats.Capacity;
+   segs := stats.Capacity shr FShift;
+   Inc(stats.Nodes, segs);
+   Inc(stats.Bytes, Length(FSegments) * SizeOf(TTieredVectorSegment) +
+                       segs * SizeOf(TDynamicBufferRec) +
+                       stats.Capacity * SizeOf(ItemType));
+   Inc(stats.Resizes, FResizes);
+end;
+{$endif PASCAL_ADT_STATS }
+
+function TTieredVector.GetItem(index : IndexType) : ItemType;
+begin
+   Assert(IsValidIndex(index, FSize), msgInvalidIndex);
+   with FSegments[index shr FShift] do
+      Result := Buffer^.Items[(StartIndex + index) and FMask];
+end;
+
+procedure TTieredVector.SetItem(index : IndexType; elem : ItemType);
+begin
+   Assert(IsValidIndex(index, FSize), msgInvalidIndex);
+   with FSegments[index shr FShift] do
+   begin
+      DisposeItem(Buffer^.Items[(StartIndex + index) and FMask]);
+      Buffer^.Items[(StartIndex + index) and FMask] := elem;
+   end;
+end;
+
+procedure TTieredVector.Insert(index : IndexType; aitem : ItemType);
+var
+   seg, off, j : IndexType;
+   n : SizeType;
+begin
+   Assert((index >= 0) and (index <= FSize), msgInvalidIndex);
+   MakeRoom; { may raise }
+   
+   seg := index shr FShift;
+   off := index and FMask;
+   if seg = FSegCount - 1 then
+      n := FSize - (SizeType(seg) shl FShift) - off
+   else
+      n := FMask - off;
+   
+   { pass the last item of each segment after <seg> to the front of
+     the next segment }
+   for j := FSegCount - 1 downto seg + 1 do
+   begin
+      FSegments[j].StartIndex := (FSegments[j].StartIndex + FMask) and FMask;
+      with FSegments[j - 1] do
+      begin
+         RelocateItems(Buffer^.Items[(StartIndex + FMask) and FMask],
+                       FSegments[j].Buffer^.Items[FSegments[j].StartIndex], 1);
+      end;
+   end;
+   
+   SegmentShiftRight(seg, off, n);
+   with FSegments[seg] do
+      Buffer^.Items[(StartIndex + off) and FMask] := aitem;
+   Inc(FSize);
+end;
+
+procedure TTieredVector.Delete(index : IndexType);
+var
+   aitem : ItemType;
+begin
+   aitem := Extract(index);
+   DisposeItem(aitem);
+end;
+
+function TTieredVector.Delete(astart : IndexType; n : SizeType) : SizeType;
+var
+   i : IndexType;
+   aitem : ItemType;
+begin
+   Assert(IsValidIndex(astart, FSize), msgInvalidIndex);
+   
+   if n > FSize - astart then
+      n := FSize - astart;
+   Result := n;
+   
+   if n <= (FSize - astart) shr FShift then
+   begin
+      { few items - it is cheaper to delete them one by one }
+      for i := 1 to n do
+      begin
+         aitem := Extract(astart);
+         DisposeItem(aitem);
+      end;
+   end else
+   begin
+      &if (&_mcp_type_needs_destruction(&ItemType))
+      if OwnsItems then
+      begin
+         for i := astart to astart + n - 1 do
+            DisposeItem(GetItem(i));
+      end;
+      &endif
+      
+      for i := astart + n to FSize - 1 do
+      begin
+         RelocateItems(FSegments[i shr FShift].Buffer^.Items[
+                          (FSegments[i shr FShift].StartIndex + i) and FMask],
+                       FSegments[(i - n) shr FShift].Buffer^.Items[
+                          (FSegments[(i - n) shr FShift].StartIndex + i - n) and FMask],
+                       1);
+      end;
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+      { release the deleted items which have not been overwritten }
+      for i := FSize - n to FSize - 1 do
+      begin
+         with FSegments[i shr FShift] do
+            Finalize(Buffer^.Items[(StartIndex + i) and FMask]);
+      end;
+&endif
+      
+      Dec(FSize, n);
+      FSegCount := (FSize + FMask) shr FShift;
+   end;
+end;
+
+function TTieredVector.Extract(index : IndexType) : ItemType;
+var
+   seg, off, j : IndexType;
+   n : SizeType;
+begin
+   Assert(IsValidIndex(index, FSize), msgInvalidIndex);
+   
+   { keep the number of segments at least 1/8 of the capacity of a
+     segment; this is done first so that nothing is lost if it
+     raises }
+   if (FShift > tvMinSegmentShift) and (FSegCount shl 3 < FMask + 1) then
+      Restructure(FShift - 1);
+   
+   seg := index shr FShift;
+   off := index and FMask;
+   if seg = FSegCount - 1 then
+      n := FSize - (SizeType(seg) shl FShift) - off - 1
+   else
+      n := FMask - off;
+   
+   with FSegments[seg] do
+   begin
+      Result := Buffer^.Items[(StartIndex + off) and FMask];
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+      Finalize(Buffer^.Items[(StartIndex + off) and FMask]);
+&endif
+   end;
+   SegmentShiftLeft(seg, off + 1, n);
+   
+   { pass the first item of each segment after <seg> to the back of
+     the previous segment }
+   for j := seg + 1 to FSegCount - 1 do
+   begin
+      with FSegments[j] do
+      begin
+         RelocateItems(Buffer^.Items[StartIndex],
+                       FSegments[j - 1].Buffer^.Items[
+                          (FSegments[j - 1].StartIndex + FMask) and FMask], 1);
+         StartIndex := (StartIndex + 1) and FMask;
+      end;
+   end;
+   
+   Dec(FSize);
+   if FSize = SizeType(FSegCount - 1) shl FShift then
+      Dec(FSegCount);
+end;
+
+procedure TTieredVector.PushBack(aitem : ItemType);
+begin
+   Insert(FSize, aitem);
+end;
+
+procedure TTieredVector.PushFront(aitem : ItemType);
+begin
+   Insert(0, aitem);
+end;
+
+procedure TTieredVector.PopBack;
+var
+   aitem : ItemType;
+begin
+   Assert(FSize <> 0, msgReadEmpty);
+   aitem := Extract(FSize - 1);
+   DisposeItem(aitem);
+end;
+
+procedure TTieredVector.PopFront;
+var
+   aitem : ItemType;
+begin
+   Assert(FSize <> 0, msgReadEmpty);
+   aitem := Extract(0);
+   DisposeItem(aitem);
+end;
+
+function TTieredVector.Back : ItemType;
+begin
+   Assert(FSize <> 0, msgReadEmpty);
+   Result := GetItem(FSize - 1);
+end;
+
+function TTieredVector.Front : ItemType;
+begin
+   Assert(FSize <> 0, msgReadEmpty);
+   Result := GetItem(0);
+end;
+
+procedure TTieredVector.Clear;
+var
+   i : IndexType;
+begin
+   &if (&_mcp_type_needs_destruction(&ItemType))
+   if OwnsItems then
+   begin
+      for i := 0 to FSize - 1 do
+         DisposeItem(GetItem(i));
+   end;
+   &endif
+   for i := 0 to Length(FSegments) - 1 do
+      BufferDeallocate(FSegments[i].Buffer);
+   FSegments := nil;
+   FSegCount := 0;
+   FSize := 0;
+   FShift := tvMinSegmentShift;
+   FMask := (1 shl FShift) - 1;
+   GrabageCollector.FreeObjects;
+end;
+
+function TTieredVector.Empty : Boolean;
+begin
+   Result := FSize = 0;
+end;
+
+function TTieredVector.Size : SizeType;
+begin
+   Result := FSize;
+end;
+
+procedure TTieredVector.ForEach(const funct : IUnaryFunctor);
+var
+   seg, j, n : IndexType;
+begin
+   for seg := 0 to FSegCount - 1 do
+   begin
+      n := FSize - (SizeType(seg) shl FShift);
+      if n > FMask + 1 then
+         n := FMask + 1;
+      with FSegments[seg] do
+      begin
+         for j := 0 to n - 1 do
+            funct.Perform(Buffer^.Items[(StartIndex + j) and FMask]);
+      end;
+   end;
+end;
+
+function TTieredVector.FindIf(const pred : IUnaryPredicate;
+                              var aitem : ItemType) : Boolean;
+var
+   seg, j, n : IndexType;
+begin
+   for seg := 0 to FSegCount - 1 do
+   begin
+      n := FSize - (SizeType(seg) shl FShift);
+      if n > FMask + 1 then
+         n := FMask + 1;
+      with FSegments[seg] do
+      begin
+         for j := 0 to n - 1 do
+         begin
+            if pred.Test(Buffer^.Items[(StartIndex + j) and FMask]) then
+            begin
+               aitem := Buffer^.Items[(StartIndex + j) and FMask];
+               Result := true;
+               Exit;
+            end;
+         end;
+      end;
+   end;
+   Result := false;
+end;
+
+function TTieredVector.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   seg, j, n : IndexType;
+begin
+   Result := 0;
+   for seg := 0 to FSegCount - 1 do
+   begin
+      n := FSize - (SizeType(seg) shl FShift);
+      if n > FMask + 1 then
+         n := FMask + 1;
+      with FSegments[seg] do
+      begin
+         for j := 0 to n - 1 do
+         begin
+            if pred.Test(Buffer^.Items[(StartIndex + j) and FMask]) then
+               Inc(Result);
+         end;
+      end;
+   end;
+end;
+
+function TTieredVector.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   r, w, i : IndexType;
+   aitem : ItemType;
+begin
+   r := 0;
+   w := 0;
+   try
+      while r < FSize do
+      begin
+         with FSegments[r shr FShift] do
+            aitem := Buffer^.Items[(StartIndex + r) and FMask];
+         if pred.Test(aitem) then { may raise }
+         begin
+            Inc(r);
+            DisposeItem(aitem);
+         end else
+         begin
+            with FSegments[w shr FShift] do
+               Buffer^.Items[(StartIndex + w) and FMask] := aitem;
+            Inc(w);
+            Inc(r);
+         end;
+      end;
+   finally
+      { [w, r) holds the deleted items; if an exception was raised
+        the items from r onwards have not been tested yet and are
+        moved to w }
+      Result := r - w;
+      if Result <> 0 then
+      begin
+         for i := r to FSize - 1 do
+         begin
+            aitem := GetItem(i);
+            with FSegments[(i - Result) shr FShift] do
+               Buffer^.Items[(StartIndex + i - Result) and FMask] := aitem;
+         end;
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+         { release the items left beyond the new end }
+         for i := FSize - Result to FSize - 1 do
+         begin
+            with FSegments[i shr FShift] do
+               Finalize(Buffer^.Items[(StartIndex + i) and FMask]);
+         end;
+&endif
+         Dec(FSize, Result);
+         FSegCount := (FSize + FMask) shr FShift;
+      end;
+   end;
+end;
+
+function TTieredVector.SegmentCapacity : SizeType;
+begin
+   Result := FMask + 1;
+end;
+
+function TTieredVector.GetSlice(index : IndexType; n : SizeType) : TSlice;
+var
+   off : IndexType;
+begin
+   Assert((index >= 0) and (index + n <= FSize), msgInvalidIndex);
+   with FSegments[index shr FShift] do
+   begin
+      off := (StartIndex + index) and FMask;
+      Result.Items := @Buffer^.Items[off];
+   end;
+   { stop at the physical end of the buffer or at the logical end of
+     the segment, whichever comes first }
+   Result.Count := FMask + 1 - off;
+   if FMask + 1 - (index and FMask) < Result.Count then
+      Result.Count := FMask + 1 - (index and FMask);
+   if n < Result.Count then
+      Result.Count := n;
+end;
+
+{ ------------------------ TTieredVectorIterator ------------------------- }
+
+function TTieredVectorIterator.CopySelf : TIterator;
+begin
+   Result := TTieredVectorIterator.Create(FIndex, FCont);
+end;
+
+procedure TTieredVectorIterator.ExchangeItemsAt(i, j : IndexType);
+var
+   i1, i2 : IndexType;
+begin
+   with TTieredVector(FCont) do
+   begin
+      i1 := FIndex + i;
+      i2 := FIndex + j;
+      Assert(IsValidIndex(i1, FSize), msgInvalidIndex);
+      Assert(IsValidIndex(i2, FSize), msgInvalidIndex);
+      adtutils.ExchangeItem(
+         FSegments[i1 shr FShift].Buffer^.Items[
+            (FSegments[i1 shr FShift].StartIndex + i1) and FMask],
+         FSegments[i2 shr FShift].Buffer^.Items[
+            (FSegments[i2 shr FShift].StartIndex + i2) and FMask]);
+   end;
+end;
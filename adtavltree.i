@@ -59,6 +59,9 @@ type
         not be inserted }
       function InsertNode(aitem : ItemType;
                           node : PBinaryTreeNode) : PBinaryTreeNode; override;
+      { sets the balance factor of <node> }
+      procedure InitBuiltNode(node : PBinaryTreeNode;
+                              leftHeight, rightHeight : SizeType); override;
       
    public      
       { creates an AVL tree }
@@ -295,6 +295,13 @@ begin
    end;
 end;
 
+procedure TAvlTree.InitBuiltNode(node : PBinaryTreeNode;
+                                 leftHeight, rightHeight : SizeType);
+begin
+   Assert(Abs(leftHeight - rightHeight) <= 1, msgInternalError);
+   PAvlTreeNode(node)^.bf := leftHeight - rightHeight;
+end;
+
 function TAvlTree.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
 begin
    Result := TAvlTree.CreateCopy(self, itemCopier);
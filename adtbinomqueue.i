@@ -95,6 +95,11 @@ type
                            IUnaryFunctor) : TContainerAdt; override;
       { @see TContainerAdt.Swap }
       procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Nodes and Height; Height is the number of levels of
+        the highest tree }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       { @fetch-related }
       { @complexity O(log(n)); }
       procedure Insert(aitem : ItemType); override;
@@ -110,6 +115,13 @@ type
       { <aqueue> must be a TBinomialQueue; @complexity O(log(n)); @see
         TPriorityQueueAdt.Merge; }
       procedure Merge(aqueue : TPriorityQueueAdt); override;
+      { walk the nodes of the trees in pre-order without creating
+        iterators; DeleteIf tests all the items first and then
+        rebuilds the queue from the kept ones, so the queue is not
+        changed if pred raises an exception; @complexity O(n) }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
       procedure Clear; override;
       function Empty : Boolean; override;
       function Size : SizeType; override;
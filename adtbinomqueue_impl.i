@@ -384,6 +384,27 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TBinomialQueue.GetStats(var stats : TContainerStats);
+var
+   i : IndexType;
+begin
+   inherited;
+   stats.Nodes := FSize;
+   Inc(stats.Bytes, Length(FTrees) * SizeOf(PBinomialTreeNode) +
+                       FSize * SizeOf(TBinomialTreeNode));
+   { the tree at FTrees[i] has 2^i nodes on i + 1 levels }
+   for i := High(FTrees) downto 0 do
+   begin
+      if FTrees[i] <> nil then
+      begin
+         stats.Height := i + 1;
+         break;
+      end;
+   end;
+end;
+{$endif PASCAL_ADT_STATS }
+
 procedure TBinomialQueue.Insert(aitem : ItemType);
 var
    node : PBinomialTreeNode;
@@ -422,6 +443,76 @@ begin
    bqueue.Destroy;
 end;
 
+function TBinomialQueue.FindIf(const pred : IUnaryPredicate;
+                               var aitem : ItemType) : Boolean;
+var
+   node : PBinomialTreeNode;
+   i : IndexType;
+begin
+   for i := 0 to Length(FTrees) - 1 do
+   begin
+      { the roots have neither parents nor siblings, so the pre-order
+        traversal ends with the tree }
+      node := FTrees[i];
+      while node <> nil do
+      begin
+         if pred.Test(node^.Item) then
+         begin
+            aitem := node^.Item;
+            Result := true;
+            Exit;
+         end;
+         node := NextPreOrderNode(node);
+      end;
+   end;
+   Result := false;
+end;
+
+function TBinomialQueue.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   kept, removed : array of ItemType;
+   node : PBinomialTreeNode;
+   aitem : ItemType;
+   i, numKept : IndexType;
+begin
+   Result := 0;
+   numKept := 0;
+   SetLength(kept, FSize);
+   SetLength(removed, FSize);
+   for i := 0 to Length(FTrees) - 1 do
+   begin
+      node := FTrees[i];
+      while node <> nil do
+      begin
+         if pred.Test(node^.Item) then
+         begin
+            removed[Result] := node^.Item;
+            Inc(Result);
+         end else
+         begin
+            kept[numKept] := node^.Item;
+            Inc(numKept);
+         end;
+         node := NextPreOrderNode(node);
+      end;
+   end;
+
+   if Result <> 0 then
+   begin
+      for i := 0 to Length(FTrees) - 1 do
+         DestroyTree(FTrees[i], false);
+      FTrees := nil;
+      Assert(FSize = 0);
+      for i := 0 to Result - 1 do
+      begin
+         aitem := removed[i];
+         DisposeItem(aitem);
+      end;
+      for i := 0 to numKept - 1 do
+         Insert(kept[i]);
+   end;
+end;
+
 procedure TBinomialQueue.Clear;
 var
    i : IndexType;
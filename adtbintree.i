@@ -72,6 +72,10 @@ type
                            IUnaryFunctor) : TContainerAdt; override;
       { @see TContainerAdt.Swap }
       procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Nodes, Height and Rotations }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       { returns the iterator pointing at the root of the tree }
       function Root : TBinaryTreeIterator;
       { returns the iterator pointing at the root of the tree }
@@ -130,6 +134,13 @@ type
       function Size : SizeType; override;
       { returns false }
       function IsDefinedOrder : Boolean; override;
+      { walk the nodes in pre-order without creating iterators;
+        DeleteIf removes the nodes with ExtractNodePreOrder, so the
+        remaining items keep their pre-order; @complexity O(n*h) for
+        DeleteIf in the worst case, O(n) for FindIf }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
 
       { returns a pointer to the root node (PBinaryTreeNode); this may
         be sometimes useful in performance-critical parts of
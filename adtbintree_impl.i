@@ -505,6 +505,17 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TBinaryTree.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Nodes := stats.Items;
+   Inc(stats.Bytes, stats.Nodes * SizeOf(TBinaryTreeNode));
+   if FRoot <> nil then
+      stats.Height := NodeHeight(FRoot) + 1;
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TBinaryTree.Root : TBinaryTreeIterator;
 begin
    Result := TBinaryTreeIterator.Create(FRoot, self);
@@ -747,6 +758,45 @@ begin
    Result := false;
 end;
 
+function TBinaryTree.FindIf(const pred : IUnaryPredicate;
+                            var aitem : ItemType) : Boolean;
+var
+   node : PBinaryTreeNode;
+begin
+   node := FRoot;
+   while node <> nil do
+   begin
+      if pred.Test(node^.Item) then
+      begin
+         aitem := node^.Item;
+         Result := true;
+         Exit;
+      end;
+      node := NextPreOrderNode(node);
+   end;
+   Result := false;
+end;
+
+function TBinaryTree.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   node : PBinaryTreeNode;
+   aitem : ItemType;
+begin
+   Result := 0;
+   node := FRoot;
+   while node <> nil do
+   begin
+      aitem := node^.Item;
+      if pred.Test(aitem) then
+      begin
+         ExtractNodePreOrder(node, true); { updates FSize }
+         Inc(Result);
+         DisposeItem(aitem);
+      end else
+         node := NextPreOrderNode(node);
+   end;
+end;
+
 procedure TBinaryTree.InsertNode(var node : PBinaryTreeNode;
                                  parent : PBinaryTreeNode; aitem : ItemType);
 begin
@@ -970,6 +1020,10 @@ begin
    Assert((node <> nil) and (node^.RightChild <> nil),
           msgInvalidNodeForSingleLeftRotation);
 
+{$ifdef PASCAL_ADT_STATS }
+   Inc(FStats.Rotations);
+{$endif PASCAL_ADT_STATS }
+
    parent := node^.Parent;
    rchild := node^.RightChild;
 
@@ -1001,6 +1055,10 @@ begin
              (node^.RightChild^.LeftChild <> nil),
           msgInvalidNodeForDoubleLeftRotation);
 
+{$ifdef PASCAL_ADT_STATS }
+   Inc(FStats.Rotations, 2);
+{$endif PASCAL_ADT_STATS }
+
    parent := node^.Parent;
    rchild := node^.RightChild;
    t := rchild^.LeftChild;
@@ -1036,6 +1094,10 @@ begin
    Assert((node <> nil) and (node^.LeftChild <> nil),
           msgInvalidNodeForSingleRightRotation);
 
+{$ifdef PASCAL_ADT_STATS }
+   Inc(FStats.Rotations);
+{$endif PASCAL_ADT_STATS }
+
    parent := node^.Parent;
    lchild := node^.LeftChild;
 
@@ -1065,6 +1127,10 @@ begin
              (node^.LeftChild^.RightChild <> nil),
           msgInvalidNodeForDoubleRightRotation);
 
+{$ifdef PASCAL_ADT_STATS }
+   Inc(FStats.Rotations, 2);
+{$endif PASCAL_ADT_STATS }
+
    parent := node^.Parent;
    lchild := node^.LeftChild;
    t := lchild^.RightChild;
@@ -69,9 +69,20 @@ type
       { exchanges the binary tree of self (FBinaryTree) with that of
         <tree> }
       procedure ExchangeBinaryTrees(tree : TBinarySearchTreeBase);
+      { called by LoadFromStream for every node of the perfectly
+        balanced tree it builds, after both sub-trees of <node> have
+        been built; <leftHeight> and <rightHeight> are the heights of
+        these sub-trees; descendants may override this to initialize
+        their own balancing information; does nothing by default }
+      procedure InitBuiltNode(node : PBinaryTreeNode;
+                              leftHeight, rightHeight : SizeType); virtual;
    public
       { deletes all items and deallocates any allocated memory }
       destructor Destroy; override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Nodes, Height and Rotations of the underlying binary tree }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       function Start : TSetIterator; override;
       function Finish : TSetIterator; override;
 &if (&_mcp_accepts_nil)
@@ -94,6 +105,24 @@ type
       { returns a range <LowerBound, UpperBound), works faster than
         calling these two functions separately }
       function EqualRange(aitem : ItemType) : TSetIteratorRange; override;
+      { writes the items in sorted order }
+      procedure SaveToStream(stream : TStream;
+                             const streamer : IStreamer); overload; override;
+      { builds a perfectly balanced tree from the sorted sequence of
+        items written by SaveToStream, without comparing the items
+        except to check that they are in order; @complexity O(n) }
+      procedure LoadFromStream(stream : TStream;
+                               const streamer : IStreamer); overload; override;
+      { visit the items in sorted order by following the parent
+        pointers from one node to its in-order successor, so neither a
+        stack nor any iterators are needed; DeleteIf is inherited from
+        TSetAdt, as every deletion may restructure the tree }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
       procedure Clear; override;
       function Empty : Boolean; override;
       function Size : SizeType; override;
@@ -55,6 +55,20 @@ begin
    inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TBinarySearchTreeBase.GetStats(var stats : TContainerStats);
+var
+   treeStats : TContainerStats;
+begin
+   inherited;
+   FBinaryTree.GetStats(treeStats);
+   stats.Nodes := treeStats.Nodes;
+   stats.Height := treeStats.Height;
+   Inc(stats.Bytes, treeStats.Bytes);
+   Inc(stats.Rotations, treeStats.Rotations);
+end;
+{$endif PASCAL_ADT_STATS }
+
 procedure TBinarySearchTreeBase.SetOwnsItems(b : Boolean);
 begin
    inherited;
@@ -234,6 +248,11 @@ begin
    ExchangePtr(FBinaryTree, tree.FBinaryTree);
 end;
 
+procedure TBinarySearchTreeBase.InitBuiltNode(node : PBinaryTreeNode;
+                                              leftHeight, rightHeight : SizeType);
+begin
+end;
+
 function TBinarySearchTreeBase.Start : TSetIterator;
 begin
    Result := TBinarySearchTreeBaseIterator.Create(nil, self);
@@ -374,6 +393,180 @@ begin
    Result := TSetIteratorRange.Create(iter1, iter2);
 end;
 
+procedure TBinarySearchTreeBase.SaveToStream(stream : TStream;
+                                             const streamer : IStreamer);
+var
+   items : TDynamicBuffer;
+   node : PBinaryTreeNode;
+   num : SizeType;
+begin
+   StreamWriteHeader(stream, sfBinarySearchTree, SizeOf(ItemType));
+   StreamWriteSize(stream, FBinaryTree.Size);
+
+   BufferAllocate(items, FBinaryTree.Size);
+   try
+      num := 0;
+      node := FirstInOrderNode(FBinaryTree.RootNode);
+      while node <> nil do
+      begin
+         items^.Items[num] := node^.Item;
+         Inc(num);
+         node := NextInOrderNode(node);
+      end;
+      Assert(num = FBinaryTree.Size, msgInternalError);
+
+      if num <> 0 then
+         StreamWriteItems(stream, items^.Items[0], num, streamer);
+   finally
+      BufferDeallocate(items);
+   end;
+end;
+
+procedure TBinarySearchTreeBase.LoadFromStream(stream : TStream;
+                                               const streamer : IStreamer);
+var
+   items : TDynamicBuffer;
+   root : PBinaryTreeNode;
+   num, lh, rh : SizeType;
+   i : IndexType;
+   owns : Boolean;
+
+   { builds a balanced sub-tree from items[lo..hi] at <node>; returns
+     its height }
+   function BuildSubTree(var node : PBinaryTreeNode; parent : PBinaryTreeNode;
+                         lo, hi : IndexType) : SizeType;
+   var
+      mid : IndexType;
+      lh, rh : SizeType;
+   begin
+      if lo > hi then
+      begin
+         Result := 0;
+         Exit;
+      end;
+      mid := lo + (hi - lo + 1) div 2;
+      FBinaryTree.InsertNode(node, parent, items^.Items[mid]); { may raise }
+      lh := BuildSubTree(node^.LeftChild, node, lo, mid - 1);
+      rh := BuildSubTree(node^.RightChild, node, mid + 1, hi);
+      InitBuiltNode(node, lh, rh);
+      if lh > rh then
+         Result := lh + 1
+      else
+         Result := rh + 1;
+   end;
+
+begin
+   StreamReadHeader(stream, sfBinarySearchTree, SizeOf(ItemType));
+   num := StreamReadSize(stream);
+
+   BufferAllocate(items, num);
+   try
+      if num <> 0 then
+         StreamReadItems(stream, items^.Items[0], num, streamer);
+
+      for i := 1 to num - 1 do
+      begin
+         if (ItemComparer.Compare(items^.Items[i - 1], items^.Items[i]) > 0) or
+               (not RepeatedItems and
+                   (ItemComparer.Compare(items^.Items[i - 1], items^.Items[i]) = 0)) then
+         begin
+            raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+         end;
+      end;
+   except
+      for i := 0 to num - 1 do
+         DisposeItem(items^.Items[i]);
+      BufferDeallocate(items);
+      raise;
+   end;
+
+   Clear;
+   if num <> 0 then
+   begin
+      try
+         FBinaryTree.InsertAsRoot(items^.Items[num div 2]);
+         root := FBinaryTree.RootNode;
+         lh := BuildSubTree(root^.LeftChild, root, 0, num div 2 - 1);
+         rh := BuildSubTree(root^.RightChild, root, num div 2 + 1, num - 1);
+         InitBuiltNode(root, lh, rh);
+      except
+         { remove the nodes without disposing any item and then
+           dispose all the items read }
+         owns := OwnsItems;
+         OwnsItems := false;
+         try
+            FBinaryTree.Clear;
+         finally
+            OwnsItems := owns;
+         end;
+         for i := 0 to num - 1 do
+            DisposeItem(items^.Items[i]);
+         BufferDeallocate(items);
+         raise;
+      end;
+   end;
+   BufferDeallocate(items);
+end;
+
+procedure TBinarySearchTreeBase.ForEach(const funct : IUnaryFunctor);
+var
+   node : PBinaryTreeNode;
+begin
+   node := FirstInOrderNode(FBinaryTree.RootNode);
+   while node <> nil do
+   begin
+      funct.Perform(node^.Item);
+      node := NextInOrderNode(node);
+   end;
+end;
+
+function TBinarySearchTreeBase.Fold(const funct : IBinaryFunctor;
+                                    init : ItemType) : ItemType;
+var
+   node : PBinaryTreeNode;
+begin
+   Result := init;
+   node := FirstInOrderNode(FBinaryTree.RootNode);
+   while node <> nil do
+   begin
+      Result := funct.Perform(Result, node^.Item);
+      node := NextInOrderNode(node);
+   end;
+end;
+
+function TBinarySearchTreeBase.FindIf(const pred : IUnaryPredicate;
+                                      var aitem : ItemType) : Boolean;
+var
+   node : PBinaryTreeNode;
+begin
+   node := FirstInOrderNode(FBinaryTree.RootNode);
+   while node <> nil do
+   begin
+      if pred.Test(node^.Item) then
+      begin
+         aitem := node^.Item;
+         Result := true;
+         Exit;
+      end;
+      node := NextInOrderNode(node);
+   end;
+   Result := false;
+end;
+
+function TBinarySearchTreeBase.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   node : PBinaryTreeNode;
+begin
+   Result := 0;
+   node := FirstInOrderNode(FBinaryTree.RootNode);
+   while node <> nil do
+   begin
+      if pred.Test(node^.Item) then
+         Inc(Result);
+      node := NextInOrderNode(node);
+   end;
+end;
+
 procedure TBinarySearchTreeBase.Clear;
 begin
    FBinaryTree.Clear;
@@ -0,0 +1,201 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtconcqueue.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtconcqueue.defs
+
+type
+   { a slot of @<TMpmcQueue>; see the notes in TMpmcQueue }
+   TMpmcQueueSlot = record
+      Sequence : SizeType;
+      Item : ItemType;
+   end;
+   PMpmcQueueSlot = ^TMpmcQueueSlot;
+   TMpmcQueueSlotArray = array of TMpmcQueueSlot;
+   TSpscQueueItemArray = array of ItemType;
+
+{ ========================= Single-producer queue ============================ }
+
+   { A bounded lock-free queue for one producer thread and one consumer
+     thread. Only the producer may call @<TryPushBack>, @<PushMany>,
+     @<PushBack> and @<InsertItem>. Only the consumer may call
+     @<TryPopFront>, @<PopMany>, @<Front>, @<PopFront>,
+     @<ExtractItem> and @<Clear>. @<Size> and @<Empty> may be called
+     by any thread, but they return only a snapshot. The other methods
+     may be called only when no other thread uses the queue. An item
+     popped with TryPopFront, PopMany or ExtractItem is no longer
+     owned by the queue. }
+   TSpscQueue = class (TQueueAdt)
+   private
+      FItems : TSpscQueueItemArray;
+      FMask : SizeType;
+      FPad0 : TCacheLinePadding;
+      { the position of the front item; written only by the consumer }
+      FHead : SizeType;
+      { the value of FTail last read by the consumer }
+      FTailCache : SizeType;
+      FPad1 : TCacheLinePadding;
+      { the position one beyond the back item; written only by the
+        producer }
+      FTail : SizeType;
+      { the value of FHead last read by the producer }
+      FHeadCache : SizeType;
+      FPad2 : TCacheLinePadding;
+
+      function GetCapacity : SizeType;
+
+   public
+      { creates a queue with the capacity of cqDefaultCapacity }
+      constructor Create; overload;
+      { creates a queue with the capacity of <acapacity> rounded up to
+        a power of two }
+      constructor Create(acapacity : SizeType); overload;
+      constructor CreateCopy(const cont : TSpscQueue;
+                             const itemCopier : IUnaryFunctor); overload;
+      destructor Destroy; override;
+      function CopySelf(const ItemCopier :
+                           IUnaryFunctor) : TContainerAdt; override;
+      { pushes <aitem> at the back; returns false if the queue is full;
+        @complexity worst-case O(1). }
+      function TryPushBack(aitem : ItemType) : Boolean;
+      { removes the item at the front and stores it in <aitem>;
+        returns false if the queue is empty; @complexity worst-case
+        O(1). }
+      function TryPopFront(var aitem : ItemType) : Boolean;
+      { pushes as many items from the beginning of <aitems> as there is
+        room for and makes them visible to the consumer at once;
+        returns the number of items pushed }
+      function PushMany(const aitems : array of ItemType) : SizeType;
+      { pops at most Length(<aitems>) items and stores them in <aitems>
+        in the order in which they were pushed; returns the number of
+        items popped }
+      function PopMany(var aitems : array of ItemType) : SizeType;
+      { pushes <aitem> at the back; if the queue is full then waits
+        until the consumer makes room }
+      procedure PushBack(aitem : ItemType); override;
+      procedure PopFront; override;
+      function Front : ItemType; override;
+      { implemented with @<TryPushBack> - returns false if the queue is
+        full }
+      function InsertItem(aitem : ItemType) : Boolean; override;
+      function ExtractItem : ItemType; override;
+      { scan the items from the front to the back in place instead of
+        popping and pushing them again; DeleteIf moves the kept items
+        towards the front; like the other methods not listed above,
+        they may be called only when no other thread uses the queue }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      procedure Clear; override;
+      function Empty : Boolean; override;
+      function Size : SizeType; override;
+      { the maximal number of items in the queue }
+      property Capacity : SizeType read GetCapacity;
+   end;
+
+{ ========================== Multi-producer queue ============================ }
+
+   { A bounded lock-free queue for any number of producer and consumer
+     threads. Any thread may call @<TryPushBack>, @<TryPopFront>,
+     @<PushMany>, @<PopMany>, @<PushBack>, @<PopFront>,
+     @<InsertItem>, @<ExtractItem>, @<Clear>, @<Size> and
+     @<Empty>; the last two return only a snapshot. @<Front> may be
+     called only if there is just one consumer thread. The other
+     methods may be called only when no other thread uses the
+     queue. An item popped with TryPopFront, PopMany or ExtractItem is
+     no longer owned by the queue. }
+   TMpmcQueue = class (TQueueAdt)
+   private
+      { the slot for the position p is FSlots[p and FMask]; its
+        Sequence is p when it may be written to by the producer which
+        has advanced FTail from p, and p + 1 when it may be read by
+        the consumer which has advanced FHead from p; after reading,
+        the consumer sets it to p + Capacity, the next position stored
+        in the slot }
+      FSlots : TMpmcQueueSlotArray;
+      FMask : SizeType;
+      FPad0 : TCacheLinePadding;
+      { the position of the next item to pop; advanced by the
+        consumers }
+      FHead : SizeType;
+      FPad1 : TCacheLinePadding;
+      { the position of the next item to push; advanced by the
+        producers }
+      FTail : SizeType;
+      FPad2 : TCacheLinePadding;
+
+      procedure InitSlots(acapacity : SizeType);
+      function GetCapacity : SizeType;
+
+   public
+      { creates a queue with the capacity of cqDefaultCapacity }
+      constructor Create; overload;
+      { creates a queue with the capacity of <acapacity> rounded up to
+        a power of two }
+      constructor Create(acapacity : SizeType); overload;
+      constructor CreateCopy(const cont : TMpmcQueue;
+                             const itemCopier : IUnaryFunctor); overload;
+      destructor Destroy; override;
+      function CopySelf(const ItemCopier :
+                           IUnaryFunctor) : TContainerAdt; override;
+      { pushes <aitem> at the back; returns false if the queue is full;
+        @complexity O(1) if there is no contention. }
+      function TryPushBack(aitem : ItemType) : Boolean;
+      { removes the item at the front and stores it in <aitem>;
+        returns false if the queue is empty; @complexity O(1) if there
+        is no contention. }
+      function TryPopFront(var aitem : ItemType) : Boolean;
+      { pushes as many items from the beginning of <aitems> as there is
+        room for; the items occupy consecutive positions in the queue,
+        i.e. no other producer can interleave its items with them;
+        returns the number of items pushed }
+      function PushMany(const aitems : array of ItemType) : SizeType;
+      { pops at most Length(<aitems>) items from consecutive positions
+        and stores them in <aitems>; returns the number of items
+        popped }
+      function PopMany(var aitems : array of ItemType) : SizeType;
+      { pushes <aitem> at the back; if the queue is full then waits
+        until some consumer makes room }
+      procedure PushBack(aitem : ItemType); override;
+      procedure PopFront; override;
+      function Front : ItemType; override;
+      { implemented with @<TryPushBack> - returns false if the queue is
+        full }
+      function InsertItem(aitem : ItemType) : Boolean; override;
+      function ExtractItem : ItemType; override;
+      { scan the items from the front to the back in place instead of
+        popping and pushing them again; DeleteIf moves the kept items
+        towards the front; like the other methods not listed above,
+        they may be called only when no other thread uses the queue }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      procedure Clear; override;
+      function Empty : Boolean; override;
+      function Size : SizeType; override;
+      { the maximal number of items in the queue }
+      property Capacity : SizeType read GetCapacity;
+   end;
@@ -0,0 +1,666 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtconcqueue_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtconcqueue.defs
+&include adtconcqueue_impl.mcp
+
+{ **************************************************************************** }
+{                          Lock-free bounded queues                            }
+{ **************************************************************************** }
+
+{ All positions only grow; the index of the position p in the array of
+  items is p and Mask. The producer writes an item before it publishes
+  the new position with a memory barrier in between, and the consumer
+  reads the item before it releases the slot, likewise. }
+
+{ ---------------------------- TSpscQueue members ---------------------------- }
+
+constructor TSpscQueue.Create;
+begin
+   Create(cqDefaultCapacity);
+end;
+
+constructor TSpscQueue.Create(acapacity : SizeType);
+var
+   cap : SizeType;
+begin
+   inherited Create;
+   cap := 2;
+   while cap < acapacity do
+      cap := cap shl 1;
+   SetLength(FItems, cap);
+   FMask := cap - 1;
+end;
+
+constructor TSpscQueue.CreateCopy(const cont : TSpscQueue;
+                                  const itemCopier : IUnaryFunctor);
+var
+   pos : SizeType;
+begin
+   inherited CreateCopy(cont);
+   SetLength(FItems, cont.FMask + 1);
+   FMask := cont.FMask;
+   if itemCopier <> nil then
+   begin
+      { if the copier raises an exception the destructor disposes the
+        items already copied }
+      pos := cont.FHead;
+      while pos <> cont.FTail do
+      begin
+         FItems[FTail] := itemCopier.Perform(cont.FItems[pos and FMask]);
+         Inc(FTail);
+         Inc(pos);
+      end;
+   end;
+end;
+
+destructor TSpscQueue.Destroy;
+begin
+   if FItems <> nil then
+      Clear;
+   inherited;
+end;
+
+function TSpscQueue.GetCapacity : SizeType;
+begin
+   Result := FMask + 1;
+end;
+
+function TSpscQueue.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TSpscQueue.CreateCopy(self, itemCopier);
+end;
+
+function TSpscQueue.TryPushBack(aitem : ItemType) : Boolean;
+var
+   tail : SizeType;
+begin
+   tail := FTail;
+   if tail - FHeadCache > FMask then
+   begin
+      FHeadCache := FHead;
+      MemoryBarrier;
+      if tail - FHeadCache > FMask then
+      begin
+         Result := false;
+         Exit;
+      end;
+   end;
+   FItems[tail and FMask] := aitem;
+   MemoryBarrier;
+   FTail := tail + 1;
+   Result := true;
+end;
+
+function TSpscQueue.TryPopFront(var aitem : ItemType) : Boolean;
+var
+   head : SizeType;
+begin
+   head := FHead;
+   if head = FTailCache then
+   begin
+      FTailCache := FTail;
+      MemoryBarrier;
+      if head = FTailCache then
+      begin
+         Result := false;
+         Exit;
+      end;
+   end;
+   aitem := FItems[head and FMask];
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+   FItems[head and FMask] := DefaultItem;
+&endif
+   MemoryBarrier;
+   FHead := head + 1;
+   Result := true;
+end;
+
+function TSpscQueue.PushMany(const aitems : array of ItemType) : SizeType;
+var
+   tail, i : SizeType;
+begin
+   tail := FTail;
+   Result := FMask + 1 - (tail - FHeadCache);
+   if Result < Length(aitems) then
+   begin
+      FHeadCache := FHead;
+      MemoryBarrier;
+      Result := FMask + 1 - (tail - FHeadCache);
+      if Result > Length(aitems) then
+         Result := Length(aitems);
+   end else
+      Result := Length(aitems);
+
+   for i := 0 to Result - 1 do
+      FItems[(tail + i) and FMask] := aitems[Low(aitems) + i];
+   MemoryBarrier;
+   FTail := tail + Result;
+end;
+
+function TSpscQueue.PopMany(var aitems : array of ItemType) : SizeType;
+var
+   head, i : SizeType;
+begin
+   head := FHead;
+   Result := FTailCache - head;
+   if Result < Length(aitems) then
+   begin
+      FTailCache := FTail;
+      MemoryBarrier;
+      Result := FTailCache - head;
+      if Result > Length(aitems) then
+         Result := Length(aitems);
+   end else
+      Result := Length(aitems);
+
+   for i := 0 to Result - 1 do
+   begin
+      aitems[Low(aitems) + i] := FItems[(head + i) and FMask];
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+      FItems[(head + i) and FMask] := DefaultItem;
+&endif
+   end;
+   MemoryBarrier;
+   FHead := head + Result;
+end;
+
+procedure TSpscQueue.PushBack(aitem : ItemType);
+begin
+   while not TryPushBack(aitem) do
+      Backoff;
+end;
+
+procedure TSpscQueue.PopFront;
+var
+   aitem : ItemType;
+   popped : Boolean;
+begin
+   popped := TryPopFront(aitem);
+   Assert(popped, msgPopEmpty);
+   if popped then
+      DisposeItem(aitem);
+end;
+
+function TSpscQueue.Front : ItemType;
+begin
+   Assert(not Empty, msgReadEmpty);
+   Result := FItems[FHead and FMask];
+end;
+
+function TSpscQueue.InsertItem(aitem : ItemType) : Boolean;
+begin
+   Result := TryPushBack(aitem);
+end;
+
+function TSpscQueue.ExtractItem : ItemType;
+var
+   popped : Boolean;
+begin
+   Result := DefaultItem;
+   popped := TryPopFront(Result);
+   Assert(popped, msgPopEmpty);
+end;
+
+function TSpscQueue.FindIf(const pred : IUnaryPredicate;
+                           var aitem : ItemType) : Boolean;
+var
+   pos : SizeType;
+begin
+   pos := FHead;
+   while pos <> FTail do
+   begin
+      if pred.Test(FItems[pos and FMask]) then
+      begin
+         aitem := FItems[pos and FMask];
+         Result := true;
+         Exit;
+      end;
+      Inc(pos);
+   end;
+   Result := false;
+end;
+
+function TSpscQueue.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   aitem : ItemType;
+   pos, kept : SizeType;
+begin
+   Result := 0;
+   pos := FHead;
+   kept := FHead;
+   try
+      { the items which are kept are moved towards the front; the
+        positions [kept, pos) are free }
+      while pos <> FTail do
+      begin
+         aitem := FItems[pos and FMask];
+         Inc(pos);
+         if pred.Test(aitem) then { may raise }
+         begin
+            Inc(Result);
+            DisposeItem(aitem);
+         end else
+         begin
+            FItems[kept and FMask] := aitem;
+            Inc(kept);
+         end;
+      end;
+   finally
+      { keep the items not yet tested if pred raised an exception }
+      while pos <> FTail do
+      begin
+         FItems[kept and FMask] := FItems[pos and FMask];
+         Inc(kept);
+         Inc(pos);
+      end;
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+      pos := kept;
+      while pos <> FTail do
+      begin
+         FItems[pos and FMask] := DefaultItem;
+         Inc(pos);
+      end;
+&endif
+      FTail := kept;
+      FTailCache := FTail;
+      FHeadCache := FHead;
+   end;
+end;
+
+procedure TSpscQueue.Clear;
+var
+   aitem : ItemType;
+begin
+   while TryPopFront(aitem) do
+      DisposeItem(aitem);
+end;
+
+function TSpscQueue.Empty : Boolean;
+begin
+   Result := Size = 0;
+end;
+
+function TSpscQueue.Size : SizeType;
+var
+   head : SizeType;
+begin
+   head := FHead;
+   MemoryBarrier;
+   { FTail is read after FHead, so it cannot be smaller, but it may
+     have been advanced by more than the capacity in the meantime }
+   Result := FTail - head;
+   if Result > FMask + 1 then
+      Result := FMask + 1;
+end;
+
+{ ---------------------------- TMpmcQueue members ---------------------------- }
+
+constructor TMpmcQueue.Create;
+begin
+   Create(cqDefaultCapacity);
+end;
+
+constructor TMpmcQueue.Create(acapacity : SizeType);
+begin
+   inherited Create;
+   InitSlots(acapacity);
+end;
+
+constructor TMpmcQueue.CreateCopy(const cont : TMpmcQueue;
+                                  const itemCopier : IUnaryFunctor);
+var
+   pos : SizeType;
+begin
+   inherited CreateCopy(cont);
+   InitSlots(cont.FMask + 1);
+   if itemCopier <> nil then
+   begin
+      { if the copier raises an exception the destructor disposes the
+        items already copied }
+      pos := cont.FHead;
+      while pos <> cont.FTail do
+      begin
+         FSlots[FTail].Item :=
+            itemCopier.Perform(cont.FSlots[pos and FMask].Item);
+         FSlots[FTail].Sequence := FTail + 1;
+         Inc(FTail);
+         Inc(pos);
+      end;
+   end;
+end;
+
+destructor TMpmcQueue.Destroy;
+begin
+   if FSlots <> nil then
+      Clear;
+   inherited;
+end;
+
+procedure TMpmcQueue.InitSlots(acapacity : SizeType);
+var
+   cap, i : SizeType;
+begin
+   cap := 2;
+   while cap < acapacity do
+      cap := cap shl 1;
+   SetLength(FSlots, cap);
+   FMask := cap - 1;
+   for i := 0 to cap - 1 do
+      FSlots[i].Sequence := i;
+end;
+
+function TMpmcQueue.GetCapacity : SizeType;
+begin
+   Result := FMask + 1;
+end;
+
+function TMpmcQueue.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TMpmcQueue.CreateCopy(self, itemCopier);
+end;
+
+function TMpmcQueue.TryPushBack(aitem : ItemType) : Boolean;
+var
+   pos, old, diff : SizeType;
+   slot : PMpmcQueueSlot;
+begin
+   pos := FTail;
+   repeat
+      slot := @FSlots[pos and FMask];
+      diff := slot^.Sequence - pos;
+      MemoryBarrier;
+      if diff = 0 then
+      begin
+         old := CompareExchange(FTail, pos + 1, pos);
+         if old = pos then
+            break;
+         pos := old;
+      end else if diff < 0 then
+      begin
+         { the slot still holds the item pushed Capacity positions
+           earlier - the queue is full }
+         Result := false;
+         Exit;
+      end else
+         pos := FTail; { another producer has taken the position }
+   until false;
+
+   slot^.Item := aitem;
+   MemoryBarrier;
+   slot^.Sequence := pos + 1;
+   Result := true;
+end;
+
+function TMpmcQueue.TryPopFront(var aitem : ItemType) : Boolean;
+var
+   pos, old, diff : SizeType;
+   slot : PMpmcQueueSlot;
+begin
+   pos := FHead;
+   repeat
+      slot := @FSlots[pos and FMask];
+      diff := slot^.Sequence - (pos + 1);
+      MemoryBarrier;
+      if diff = 0 then
+      begin
+         old := CompareExchange(FHead, pos + 1, pos);
+         if old = pos then
+            break;
+         pos := old;
+      end else if diff < 0 then
+      begin
+         { nothing has been written to the slot yet - the queue is
+           empty }
+         Result := false;
+         Exit;
+      end else
+         pos := FHead; { another consumer has taken the position }
+   until false;
+
+   aitem := slot^.Item;
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+   slot^.Item := DefaultItem;
+&endif
+   MemoryBarrier;
+   slot^.Sequence := pos + FMask + 1;
+   Result := true;
+end;
+
+function TMpmcQueue.PushMany(const aitems : array of ItemType) : SizeType;
+var
+   pos, i : SizeType;
+begin
+   Result := 0;
+   if Length(aitems) = 0 then
+      Exit;
+
+   repeat
+      pos := FTail;
+      { count the free slots following pos; if FTail is still pos
+        afterwards then no other producer could have taken them }
+      Result := 0;
+      while (Result < Length(aitems)) and
+               (FSlots[(pos + Result) and FMask].Sequence = pos + Result) do
+      begin
+         Inc(Result);
+      end;
+      MemoryBarrier;
+      if Result = 0 then
+      begin
+         if FSlots[pos and FMask].Sequence - pos < 0 then
+            Exit; { full }
+      end else if CompareExchange(FTail, pos + Result, pos) = pos then
+         break;
+   until false;
+
+   for i := 0 to Result - 1 do
+      FSlots[(pos + i) and FMask].Item := aitems[Low(aitems) + i];
+   MemoryBarrier;
+   for i := 0 to Result - 1 do
+      FSlots[(pos + i) and FMask].Sequence := pos + i + 1;
+end;
+
+function TMpmcQueue.PopMany(var aitems : array of ItemType) : SizeType;
+var
+   pos, i : SizeType;
+   slot : PMpmcQueueSlot;
+begin
+   Result := 0;
+   if Length(aitems) = 0 then
+      Exit;
+
+   repeat
+      pos := FHead;
+      Result := 0;
+      while (Result < Length(aitems)) and
+               (FSlots[(pos + Result) and FMask].Sequence = pos + Result + 1) do
+      begin
+         Inc(Result);
+      end;
+      MemoryBarrier;
+      if Result = 0 then
+      begin
+         if FSlots[pos and FMask].Sequence - (pos + 1) < 0 then
+            Exit; { empty }
+      end else if CompareExchange(FHead, pos + Result, pos) = pos then
+         break;
+   until false;
+
+   for i := 0 to Result - 1 do
+   begin
+      slot := @FSlots[(pos + i) and FMask];
+      aitems[Low(aitems) + i] := slot^.Item;
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+      slot^.Item := DefaultItem;
+&endif
+   end;
+   MemoryBarrier;
+   for i := 0 to Result - 1 do
+      FSlots[(pos + i) and FMask].Sequence := pos + i + FMask + 1;
+end;
+
+procedure TMpmcQueue.PushBack(aitem : ItemType);
+begin
+   while not TryPushBack(aitem) do
+      Backoff;
+end;
+
+procedure TMpmcQueue.PopFront;
+var
+   aitem : ItemType;
+   popped : Boolean;
+begin
+   popped := TryPopFront(aitem);
+   Assert(popped, msgPopEmpty);
+   if popped then
+      DisposeItem(aitem);
+end;
+
+function TMpmcQueue.Front : ItemType;
+var
+   slot : PMpmcQueueSlot;
+begin
+   slot := @FSlots[FHead and FMask];
+   Assert(slot^.Sequence = FHead + 1, msgReadEmpty);
+   Result := slot^.Item;
+end;
+
+function TMpmcQueue.InsertItem(aitem : ItemType) : Boolean;
+begin
+   Result := TryPushBack(aitem);
+end;
+
+function TMpmcQueue.ExtractItem : ItemType;
+var
+   popped : Boolean;
+begin
+   Result := DefaultItem;
+   popped := TryPopFront(Result);
+   Assert(popped, msgPopEmpty);
+end;
+
+function TMpmcQueue.FindIf(const pred : IUnaryPredicate;
+                           var aitem : ItemType) : Boolean;
+var
+   pos : SizeType;
+begin
+   pos := FHead;
+   while pos <> FTail do
+   begin
+      if pred.Test(FSlots[pos and FMask].Item) then
+      begin
+         aitem := FSlots[pos and FMask].Item;
+         Result := true;
+         Exit;
+      end;
+      Inc(pos);
+   end;
+   Result := false;
+end;
+
+function TMpmcQueue.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   aitem : ItemType;
+   pos, kept : SizeType;
+begin
+   Result := 0;
+   pos := FHead;
+   kept := FHead;
+   try
+      { the items which are kept are moved towards the front; the
+        positions [kept, pos) are free }
+      while pos <> FTail do
+      begin
+         aitem := FSlots[pos and FMask].Item;
+         Inc(pos);
+         if pred.Test(aitem) then { may raise }
+         begin
+            Inc(Result);
+            DisposeItem(aitem);
+         end else
+         begin
+            FSlots[kept and FMask].Item := aitem;
+            Inc(kept);
+         end;
+      end;
+   finally
+      { keep the items not yet tested if pred raised an exception }
+      while pos <> FTail do
+      begin
+         FSlots[kept and FMask].Item := FSlots[pos and FMask].Item;
+         Inc(kept);
+         Inc(pos);
+      end;
+      { the freed slots may be written to by the producers which
+        take their positions again }
+      pos := kept;
+      while pos <> FTail do
+      begin
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+         FSlots[pos and FMask].Item := DefaultItem;
+&endif
+         FSlots[pos and FMask].Sequence := pos;
+         Inc(pos);
+      end;
+      FTail := kept;
+   end;
+end;
+
+procedure TMpmcQueue.Clear;
+var
+   aitem : ItemType;
+begin
+   while TryPopFront(aitem) do
+      DisposeItem(aitem);
+end;
+
+function TMpmcQueue.Empty : Boolean;
+begin
+   Result := Size = 0;
+end;
+
+function TMpmcQueue.Size : SizeType;
+var
+   head : SizeType;
+begin
+   head := FHead;
+   MemoryBarrier;
+   { the items at the positions taken by the producers, but not
+     written yet, are counted as well }
+   Result := FTail - head;
+   if Result < 0 then
+      Result := 0
+   else if Result > FMask + 1 then
+      Result := FMask + 1;
+end;
@@ -0,0 +1,272 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtconcskiplist.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtconcskiplist.defs
+
+type
+   PConcurrentSkipListNode = ^TConcurrentSkipListNode;
+   TConcurrentSkipListLinks = array[0..cslMaxLevel - 1] of PConcurrentSkipListNode;
+   TConcurrentSkipListNode = record
+      Item : ItemType;
+      { links the removed nodes waiting to be freed }
+      NextRetired : PConcurrentSkipListNode;
+      { held while the links from the node are changed }
+      Lock : LongInt;
+      { the number of levels the node is linked at }
+      Level : Integer;
+      { set when the node starts being removed; never reset }
+      Marked : Boolean;
+      { set when the node has been linked at all its levels }
+      FullyLinked : Boolean;
+      { false if the item has been extracted and must not be disposed
+        together with the node }
+      OwnsItem : Boolean;
+      { only the first Level links are allocated; this must be the
+        last field }
+      Next : TConcurrentSkipListLinks;
+   end;
+
+   { a sorted set implemented with a skip list which may be accessed
+     by many threads at once without any external locking; @<Has>,
+     @<Find>, @<Count>, @<LowerBound>, @<UpperBound> and
+     @<EqualRange> never take locks; @<Insert> and @<Delete> lock
+     only the nodes whose links they change (the lazy skip list of
+     Herlihy, Lev, Luchangco and Shavit); removed nodes are freed (and
+     their items disposed) only when no operation that could have
+     reached them is running any more (epoch-based reclamation);
+     therefore, an item removed by one thread may be disposed a bit
+     later by another thread; @<Clear>, @<Swap>, @<CopySelf> with a
+     nil copier, the destructor and changing the properties of the set
+     must not be run concurrently with any other operation on the
+     set. }
+   { Iterators do not protect the nodes they point to. To iterate
+     while other threads may delete items, enclose the whole use of
+     the iterators between @<BeginScan> and @<EndScan>; the iteration
+     then sees every item present during the whole scan and may or may
+     not see the items inserted or removed meanwhile. An iterator
+     object itself must not be shared between threads. Items returned
+     by @<Find> or by an iterator may be disposed as soon as another
+     thread deletes them, unless the caller is inside a scan. }
+   TConcurrentSkipList = class (TSortedSetAdt)
+   private
+      FHead : PConcurrentSkipListNode;
+      FSize : SizeType;
+      FPadding1 : TCacheLinePadding;
+      { the current epoch; changed only under FRetireLock }
+      FEpoch : SizeType;
+      { the numbers of operations which entered the epochs; the
+        counter of the epoch e is FActive[e mod 3] }
+      FActive : array[0..2] of TEpochCounter;
+      { the lists of nodes removed by the operations that entered the
+        epoch e are kept in FRetired[e mod 3] }
+      FRetired : array[0..2] of PConcurrentSkipListNode;
+      FRetiredCount : SizeType;
+      FRetireLock : LongInt;
+
+      procedure InitFields;
+      { allocates a node with <level> links; the links are nil }
+      function NewNode(aitem : ItemType; level : Integer) : PConcurrentSkipListNode;
+      { frees the memory of node; does not dispose its item }
+      procedure FreeNode(node : PConcurrentSkipListNode);
+      { disposes the item of node if the node owns it and frees the
+        node }
+      procedure DestroyNode(node : PConcurrentSkipListNode);
+      { registers the calling thread as running an operation and
+        returns the epoch it entered; no node reachable from FHead
+        after this call is freed before the matching LeaveEpoch }
+      function EnterEpoch : SizeType;
+      procedure LeaveEpoch(epoch : SizeType);
+      { hands over a node removed from the list by an operation running
+        in <epoch> to be freed later }
+      procedure Retire(node : PConcurrentSkipListNode; epoch : SizeType);
+      { advances the epoch as far as possible and frees the nodes that
+        cannot be reached by any running operation }
+      procedure Reclaim;
+      { frees all the retired nodes; no operation may be running }
+      procedure FreeRetired;
+      { returns true if node is in the set, i.e. fully inserted and not
+        being removed }
+      function IsLive(node : PConcurrentSkipListNode) : Boolean;
+      { returns the first live node starting from <node> at the lowest
+        level, or nil }
+      function FirstLive(node : PConcurrentSkipListNode) : PConcurrentSkipListNode;
+      { returns the first live node >= aitem (> aitem if upper is
+        true) or nil }
+      function LowerBoundNode(aitem : ItemType;
+                              upper : Boolean) : PConcurrentSkipListNode;
+      { assigns to preds[l] the last node < aitem (<= aitem if upper is
+        true) at level l, and to succs[l] the node after it, for every
+        level }
+      procedure FindNodes(aitem : ItemType; upper : Boolean;
+                          var preds, succs : TConcurrentSkipListLinks);
+      { assigns to preds[l] the node before <node> at level l, for
+        every level }
+      procedure FindPredecessors(node : PConcurrentSkipListNode;
+                                 var preds : TConcurrentSkipListLinks);
+      { returns the last node at the lowest level, or FHead }
+      function LastNode : PConcurrentSkipListNode;
+      { unlocks the distinct nodes among preds[0..count-1] }
+      procedure UnlockNodes(const preds : TConcurrentSkipListLinks; count : Integer);
+      { inserts aitem; returns true and assigns the new node to node if
+        inserted; returns false and assigns the equal node already in
+        the set to node if aitem cannot be inserted; must be called
+        between EnterEpoch and LeaveEpoch }
+      function InsertNode(aitem : ItemType;
+                          var node : PConcurrentSkipListNode) : Boolean;
+      { removes node; returns false if it has already been removed by
+        another thread; if disposeItem is false then the item will not
+        be disposed when the node is freed; must be called between
+        EnterEpoch and LeaveEpoch; epoch must be the one returned by
+        EnterEpoch }
+      function RemoveNode(node : PConcurrentSkipListNode; epoch : SizeType;
+                          disposeItem : Boolean) : Boolean;
+      { removes all items equal to aitem; returns their number }
+      function RemoveItems(aitem : ItemType; disposeItems : Boolean) : SizeType;
+
+   public
+      constructor Create;
+      { creates a copy of cont; itemCopier may be nil, in which case
+        an empty set with the same properties is created; may be run
+        concurrently with other operations on cont; @complexity O(n) }
+      constructor CreateCopy(const cont : TConcurrentSkipList;
+                             const itemCopier : IUnaryFunctor); overload;
+      destructor Destroy; override;
+      { returns a copy of self; @complexity O(n) }
+      function CopySelf(const ItemCopier :
+                           IUnaryFunctor) : TContainerAdt; override;
+      { @see TContainerAdt.Swap; not thread-safe }
+      procedure Swap(cont : TContainerAdt); override;
+      { starts a scan by the calling thread; until the matching
+        @<EndScan> no node is freed that is reachable from the set
+        or from an iterator into it when BeginScan is called or later;
+        the returned value must be passed to EndScan; scans should be
+        short, as they delay freeing removed nodes for all threads }
+      function BeginScan : SizeType;
+      { ends a scan started with @<BeginScan> }
+      procedure EndScan(scan : SizeType);
+      { returns the start iterator }
+      function Start : TSetIterator; override;
+      { returns the finish iterator }
+      function Finish : TSetIterator; override;
+&if (&_mcp_accepts_nil)
+      { if RepeatedItems is false and there is an item equal to aitem in
+        the set, then returns this item; in all other cases inserts
+        aitem into the set and returns nil; @complexity average
+        O(log(n)) }
+      function FindOrInsert(aitem : ItemType) : ItemType; override;
+      { returns the first item equal to aitem, or nil if not found;
+        lock-free; @complexity average O(log(n)) }
+      function Find(aitem : ItemType) : ItemType; override;
+&endif &# end &_mcp_accepts_nil
+      { returns true if the given item is present in the set;
+        lock-free; @complexity average O(log(n)) }
+      function Has(aitem : ItemType) : Boolean; override;
+      { returns the number of items in the set equal to aitem;
+        lock-free; @complexity average O(log(n) + m), where m is the
+        result }
+      function Count(aitem : ItemType) : SizeType; override;
+      { the same as below; the hint is ignored }
+      function Insert(pos : TSetIterator;
+                      aitem : ItemType) : Boolean; overload; override;
+      { inserts aitem into the set; returns true if it was inserted,
+        or false if it cannot be inserted (this happens for non-multi
+        (without repeated items) set when item equal to aitem is already
+        in the set); if the item is not inserted it is not owned by
+        the container and not disposed! @complexity average
+        O(log(n)) }
+      function Insert(aitem : ItemType) : Boolean; overload; override;
+      { removes the item at pos from the set; does nothing if it has
+        already been removed by another thread; @complexity average
+        O(log(n)) }
+      procedure Delete(pos : TSetIterator); overload; override;
+      { removes all items equal to aitem from the set; returns the
+        number of deleted items; @complexity average O(m*log(n)),
+        where m is the number of deleted items }
+      function Delete(aitem : ItemType) : SizeType; overload; override;
+      { removes all items equal to aitem from the set without disposing
+        them; returns their number; @complexity average O(m*log(n)),
+        where m is the number of extracted items }
+      function Extract(aitem : ItemType) : SizeType; override;
+      { returns the first item >= aitem; lock-free; @complexity average
+        O(log(n)) }
+      function LowerBound(aitem : ItemType) : TSetIterator; override;
+      { returns the first item > aitem; lock-free; @complexity average
+        O(log(n)) }
+      function UpperBound(aitem : ItemType) : TSetIterator; override;
+      { returns a range <LowerBound, UpperBound); lock-free;
+        @complexity average O(log(n)) }
+      function EqualRange(aitem : ItemType) : TSetIteratorRange; override;
+      { walk the lowest level inside a single scan, without iterators;
+        the item found may be disposed as soon as another thread
+        deletes it, like the one returned by @<Find>; @complexity O(n) }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      { the items inserted or deleted by other threads meanwhile may or
+        may not be tested; returns the number of items deleted by this
+        call }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { returns the first item according to ItemComparer; @complexity
+        O(1) }
+      function First : ItemType; override;
+      { removes the first item and returns it; if several threads call
+        this at once each of them gets a different item; @complexity
+        average O(log(n)) }
+      function ExtractFirst : ItemType; override;
+      { clears the container - removes all items; not thread-safe;
+        @complexity O(n) }
+      procedure Clear; override;
+      { returns true if container is empty }
+      function Empty : Boolean; override;
+      { returns the number of items; while other threads are changing
+        the set the result is only an approximation; @complexity O(1) }
+      function Size : SizeType; override;
+   end;
+
+   TConcurrentSkipListIterator = class (TSetIterator)
+   private
+      FList : TConcurrentSkipList;
+      { nil for the finish iterator }
+      FNode : PConcurrentSkipListNode;
+
+   public
+      constructor Create(node : PConcurrentSkipListNode; list : TConcurrentSkipList);
+      function CopySelf : TIterator; override;
+      function Equal(const Pos : TIterator) : Boolean; override;
+      function GetItem : ItemType; override;
+      procedure SetItem(aitem : ItemType); override;
+      procedure ResetItem; override;
+      { skips the items being removed by other threads }
+      procedure Advance; overload; override;
+      { @complexity average O(log(n)) }
+      procedure Retreat; override;
+      { @complexity average O(log(n)) }
+      procedure Insert(aitem : ItemType); override;
+      function Extract : ItemType; override;
+      function Owner : TContainerAdt; override;
+      function IsStart : Boolean; override;
+      function IsFinish : Boolean; override;
+   end;
@@ -0,0 +1,974 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtconcskiplist_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtconcskiplist.defs
+&include adtconcskiplist_impl.mcp
+
+{ ========================================================================== }
+{             Notes on the implementation of TConcurrentSkipList            }
+{ -------------------------------------------------------------------------- }
+{ A node is in the set if it is FullyLinked and not Marked. Readers
+  just follow the links and skip the nodes which are not in the
+  set. A writer locks the predecessors of the place it changes, from
+  the lowest level upwards, and checks that they are still linked to
+  the nodes it has found; if not, it unlocks them and searches again.
+  A node to be removed is locked and Marked first, so no node is ever
+  linked after it. All locks are taken in the order opposite to the
+  order of the nodes in the list, which prevents deadlocks. }
+{ Every operation enters the current epoch e and leaves it when done.
+  The epoch may be advanced from e to e + 1 only when no operation is
+  running in e - 1. Thus, an operation which entered e finishes
+  before the epoch reaches e + 2, and the nodes removed during it
+  cannot be reached by anyone after the epoch reaches e + 3. The nodes
+  removed in e are kept in FRetired[e mod 3] and freed when the epoch
+  is advanced to e + 3. When only one thread uses the set the epoch
+  is advanced three times after every removal, so the removed items
+  are disposed immediately. }
+{ ========================================================================== }
+
+{ ------------------------- TConcurrentSkipList ---------------------------- }
+
+constructor TConcurrentSkipList.Create;
+begin
+   inherited;
+   InitFields;
+end;
+
+constructor TConcurrentSkipList.CreateCopy(const cont : TConcurrentSkipList;
+                                           const itemCopier : IUnaryFunctor);
+var
+   last : TConcurrentSkipListLinks;
+   src, node : PConcurrentSkipListNode;
+   epoch : SizeType;
+   l : Integer;
+begin
+   inherited CreateCopy(TSetAdt(cont));
+   InitFields;
+   if itemCopier <> nil then
+   begin
+      for l := 0 to cslMaxLevel - 1 do
+         last[l] := FHead;
+
+      epoch := cont.EnterEpoch;
+      try
+         src := cont.FirstLive(cont.FHead^.Next[0]);
+         while src <> nil do
+         begin
+            node := NewNode(itemCopier.Perform(src^.Item), RandomLevel);
+            node^.FullyLinked := true;
+            for l := 0 to node^.Level - 1 do
+            begin
+               last[l]^.Next[l] := node;
+               last[l] := node;
+            end;
+            Inc(FSize);
+            src := cont.FirstLive(src^.Next[0]);
+         end;
+      finally
+         cont.LeaveEpoch(epoch);
+      end;
+   end;
+end;
+
+destructor TConcurrentSkipList.Destroy;
+begin
+   if FHead <> nil then
+   begin
+      Clear;
+      FreeNode(FHead);
+   end;
+   inherited;
+end;
+
+procedure TConcurrentSkipList.InitFields;
+var
+   i : Integer;
+begin
+   FHead := NewNode(DefaultItem, cslMaxLevel);
+   FHead^.FullyLinked := true;
+   FHead^.OwnsItem := false;
+   FSize := 0;
+   FEpoch := 0;
+   for i := 0 to 2 do
+   begin
+      FActive[i].Count := 0;
+      FRetired[i] := nil;
+   end;
+   FRetiredCount := 0;
+   FRetireLock := 0;
+end;
+
+function TConcurrentSkipList.NewNode(aitem : ItemType;
+                                     level : Integer) : PConcurrentSkipListNode;
+var
+   nodeSize : SizeType;
+begin
+   nodeSize := SizeOf(TConcurrentSkipListNode) -
+      (cslMaxLevel - level) * SizeOf(PConcurrentSkipListNode);
+   GetMem(Result, nodeSize);
+   { the Item field must be zeroed if ItemType is a managed type }
+   FillChar(Result^, nodeSize, 0);
+   Result^.Item := aitem;
+   Result^.Level := level;
+   Result^.OwnsItem := true;
+end;
+
+procedure TConcurrentSkipList.FreeNode(node : PConcurrentSkipListNode);
+begin
+   { releases the item if ItemType is a managed type }
+   node^.Item := DefaultItem;
+   FreeMem(node);
+end;
+
+procedure TConcurrentSkipList.DestroyNode(node : PConcurrentSkipListNode);
+var
+   aitem : ItemType;
+begin
+   if node^.OwnsItem then
+   begin
+      aitem := node^.Item;
+      DisposeItem(aitem);
+   end;
+   FreeNode(node);
+end;
+
+function TConcurrentSkipList.EnterEpoch : SizeType;
+begin
+   repeat
+      Result := FEpoch;
+      InterlockedIncrement(FActive[Result mod 3].Count);
+      if FEpoch = Result then
+         Exit;
+      { the epoch has been advanced in the meantime; the counter of
+        the old epoch must not be kept increased }
+      InterlockedDecrement(FActive[Result mod 3].Count);
+   until false;
+end;
+
+procedure TConcurrentSkipList.LeaveEpoch(epoch : SizeType);
+begin
+   InterlockedDecrement(FActive[epoch mod 3].Count);
+end;
+
+procedure TConcurrentSkipList.Retire(node : PConcurrentSkipListNode;
+                                     epoch : SizeType);
+begin
+   SpinLock(FRetireLock);
+   node^.NextRetired := FRetired[epoch mod 3];
+   FRetired[epoch mod 3] := node;
+   Inc(FRetiredCount);
+   SpinUnlock(FRetireLock);
+end;
+
+procedure TConcurrentSkipList.Reclaim;
+var
+   freed, node, nextNode : PConcurrentSkipListNode;
+   e : SizeType;
+   i : Integer;
+begin
+   if FRetiredCount = 0 then
+      Exit;
+
+   freed := nil;
+   SpinLock(FRetireLock);
+   for i := 1 to 3 do
+   begin
+      e := FEpoch;
+      if FActive[(e + 2) mod 3].Count <> 0 then
+         break;
+      { nobody runs in e - 1, so the epoch may be advanced, and
+        the nodes removed in e - 2 may be freed }
+      node := FRetired[(e + 1) mod 3];
+      FRetired[(e + 1) mod 3] := nil;
+      while node <> nil do
+      begin
+         nextNode := node^.NextRetired;
+         node^.NextRetired := freed;
+         freed := node;
+         Dec(FRetiredCount);
+         node := nextNode;
+      end;
+      FEpoch := e + 1;
+      MemoryBarrier;
+   end;
+   SpinUnlock(FRetireLock);
+
+   while freed <> nil do
+   begin
+      nextNode := freed^.NextRetired;
+      DestroyNode(freed);
+      freed := nextNode;
+   end;
+end;
+
+procedure TConcurrentSkipList.FreeRetired;
+var
+   node, nextNode : PConcurrentSkipListNode;
+   i : Integer;
+begin
+   for i := 0 to 2 do
+   begin
+      node := FRetired[i];
+      FRetired[i] := nil;
+      while node <> nil do
+      begin
+         nextNode := node^.NextRetired;
+         DestroyNode(node);
+         node := nextNode;
+      end;
+   end;
+   FRetiredCount := 0;
+end;
+
+function TConcurrentSkipList.IsLive(node : PConcurrentSkipListNode) : Boolean;
+begin
+   Result := node^.FullyLinked and not node^.Marked;
+end;
+
+function TConcurrentSkipList.FirstLive(node : PConcurrentSkipListNode) : PConcurrentSkipListNode;
+begin
+   while (node <> nil) and not IsLive(node) do
+      node := node^.Next[0];
+   Result := node;
+end;
+
+function TConcurrentSkipList.LowerBoundNode(aitem : ItemType;
+                                            upper : Boolean) : PConcurrentSkipListNode;
+var
+   pred, curr : PConcurrentSkipListNode;
+   l : Integer;
+   c : IndexType;
+begin
+   pred := FHead;
+   for l := cslMaxLevel - 1 downto 0 do
+   begin
+      curr := pred^.Next[l];
+      while curr <> nil do
+      begin
+         _mcp_compare_assign(curr^.Item, aitem, c);
+         if (c > 0) or ((c = 0) and not upper) then
+            break;
+         pred := curr;
+         curr := pred^.Next[l];
+      end;
+   end;
+   Result := FirstLive(pred^.Next[0]);
+end;
+
+procedure TConcurrentSkipList.FindNodes(aitem : ItemType; upper : Boolean;
+                                        var preds, succs : TConcurrentSkipListLinks);
+var
+   pred, curr : PConcurrentSkipListNode;
+   l : Integer;
+   c : IndexType;
+begin
+   pred := FHead;
+   for l := cslMaxLevel - 1 downto 0 do
+   begin
+      curr := pred^.Next[l];
+      while curr <> nil do
+      begin
+         _mcp_compare_assign(curr^.Item, aitem, c);
+         if (c > 0) or ((c = 0) and not upper) then
+            break;
+         pred := curr;
+         curr := pred^.Next[l];
+      end;
+      preds[l] := pred;
+      succs[l] := curr;
+   end;
+end;
+
+procedure TConcurrentSkipList.FindPredecessors(node : PConcurrentSkipListNode;
+                                               var preds : TConcurrentSkipListLinks);
+var
+   pred, curr : PConcurrentSkipListNode;
+   l : Integer;
+   c : IndexType;
+begin
+   pred := FHead;
+   for l := cslMaxLevel - 1 downto 0 do
+   begin
+      curr := pred^.Next[l];
+      while (curr <> nil) and (curr <> node) do
+      begin
+         _mcp_compare_assign(curr^.Item, node^.Item, c);
+         { the items equal to node^.Item may be passed only at the
+           levels where node is present - otherwise it is not known
+           whether they precede node }
+         if (c > 0) or ((c = 0) and (l >= node^.Level)) then
+            break;
+         pred := curr;
+         curr := pred^.Next[l];
+      end;
+      preds[l] := pred;
+   end;
+end;
+
+function TConcurrentSkipList.LastNode : PConcurrentSkipListNode;
+var
+   l : Integer;
+begin
+   Result := FHead;
+   for l := cslMaxLevel - 1 downto 0 do
+   begin
+      while Result^.Next[l] <> nil do
+         Result := Result^.Next[l];
+   end;
+end;
+
+procedure TConcurrentSkipList.UnlockNodes(const preds : TConcurrentSkipListLinks;
+                                          count : Integer);
+var
+   l : Integer;
+begin
+   for l := 0 to count - 1 do
+   begin
+      if (l = 0) or (preds[l] <> preds[l - 1]) then
+         SpinUnlock(preds[l]^.Lock);
+   end;
+end;
+
+function TConcurrentSkipList.InsertNode(aitem : ItemType;
+                                        var node : PConcurrentSkipListNode) : Boolean;
+var
+   preds, succs : TConcurrentSkipListLinks;
+   pred, newNode : PConcurrentSkipListNode;
+   level, l, locked : Integer;
+   valid : Boolean;
+begin
+   newNode := NewNode(aitem, RandomLevel);
+   level := newNode^.Level;
+   repeat
+      FindNodes(aitem, true, preds, succs);
+
+      if not RepeatedItems then
+      begin
+         pred := preds[0];
+         if (pred <> FHead) and _mcp_equal(pred^.Item, aitem) then
+         begin
+            if not pred^.Marked then
+            begin
+               while not pred^.FullyLinked do
+                  Backoff;
+               FreeNode(newNode);
+               node := pred;
+               Result := false;
+               Exit;
+            end;
+            { an equal item is being removed - wait until it is unlinked }
+            Backoff;
+            continue;
+         end;
+      end;
+
+      valid := true;
+      locked := 0;
+      while valid and (locked < level) do
+      begin
+         l := locked;
+         if (l = 0) or (preds[l] <> preds[l - 1]) then
+            SpinLock(preds[l]^.Lock);
+         Inc(locked);
+         valid := (not preds[l]^.Marked) and (preds[l]^.Next[l] = succs[l]) and
+            ((succs[l] = nil) or not succs[l]^.Marked);
+      end;
+
+      if valid then
+      begin
+         for l := 0 to level - 1 do
+            newNode^.Next[l] := succs[l];
+         { the node must be complete before anyone can reach it }
+         MemoryBarrier;
+         for l := 0 to level - 1 do
+            preds[l]^.Next[l] := newNode;
+         newNode^.FullyLinked := true;
+      end;
+      UnlockNodes(preds, locked);
+   until valid;
+
+   AtomicAdd(FSize, 1);
+   node := newNode;
+   Result := true;
+end;
+
+function TConcurrentSkipList.RemoveNode(node : PConcurrentSkipListNode;
+                                        epoch : SizeType;
+                                        disposeItem : Boolean) : Boolean;
+var
+   preds : TConcurrentSkipListLinks;
+   l, locked : Integer;
+   valid : Boolean;
+begin
+   Result := false;
+   if not IsLive(node) then
+      Exit;
+
+   SpinLock(node^.Lock);
+   if node^.Marked then
+   begin
+      SpinUnlock(node^.Lock);
+      Exit;
+   end;
+   node^.Marked := true;
+   node^.OwnsItem := disposeItem;
+
+   repeat
+      FindPredecessors(node, preds);
+      valid := true;
+      locked := 0;
+      while valid and (locked < node^.Level) do
+      begin
+         l := locked;
+         if (l = 0) or (preds[l] <> preds[l - 1]) then
+            SpinLock(preds[l]^.Lock);
+         Inc(locked);
+         valid := (not preds[l]^.Marked) and (preds[l]^.Next[l] = node);
+      end;
+
+      if valid then
+      begin
+         for l := node^.Level - 1 downto 0 do
+            preds[l]^.Next[l] := node^.Next[l];
+      end;
+      UnlockNodes(preds, locked);
+   until valid;
+   SpinUnlock(node^.Lock);
+
+   AtomicAdd(FSize, -1);
+   Retire(node, epoch);
+   Result := true;
+end;
+
+function TConcurrentSkipList.RemoveItems(aitem : ItemType;
+                                         disposeItems : Boolean) : SizeType;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+   found : Boolean;
+begin
+   Result := 0;
+   repeat
+      epoch := EnterEpoch;
+      try
+         node := LowerBoundNode(aitem, false);
+         found := (node <> nil) and _mcp_equal(node^.Item, aitem);
+         if found and RemoveNode(node, epoch, disposeItems) then
+            Inc(Result);
+      finally
+         LeaveEpoch(epoch);
+      end;
+      Reclaim;
+   until not found;
+end;
+
+function TConcurrentSkipList.CopySelf(const ItemCopier :
+                                         IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TConcurrentSkipList.CreateCopy(self, itemCopier);
+end;
+
+procedure TConcurrentSkipList.Swap(cont : TContainerAdt);
+var
+   list : TConcurrentSkipList;
+begin
+   if cont is TConcurrentSkipList then
+   begin
+      BasicSwap(cont);
+      list := TConcurrentSkipList(cont);
+      FreeRetired;
+      list.FreeRetired;
+      ExchangePtr(FHead, list.FHead);
+      ExchangeData(FSize, list.FSize, SizeOf(SizeType));
+   end else
+      inherited;
+end;
+
+function TConcurrentSkipList.BeginScan : SizeType;
+begin
+   Result := EnterEpoch;
+end;
+
+procedure TConcurrentSkipList.EndScan(scan : SizeType);
+begin
+   LeaveEpoch(scan);
+   Reclaim;
+end;
+
+function TConcurrentSkipList.Start : TSetIterator;
+var
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      Result := TConcurrentSkipListIterator.Create(FirstLive(FHead^.Next[0]), self);
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.Finish : TSetIterator;
+begin
+   Result := TConcurrentSkipListIterator.Create(nil, self);
+end;
+
+&if (&_mcp_accepts_nil)
+function TConcurrentSkipList.FindOrInsert(aitem : ItemType) : ItemType;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      if InsertNode(aitem, node) then
+         Result := nil
+      else
+         Result := node^.Item;
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.Find(aitem : ItemType) : ItemType;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      node := LowerBoundNode(aitem, false);
+      if (node <> nil) and _mcp_equal(node^.Item, aitem) then
+         Result := node^.Item
+      else
+         Result := nil;
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+&endif &# end &_mcp_accepts_nil
+
+function TConcurrentSkipList.Has(aitem : ItemType) : Boolean;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      node := LowerBoundNode(aitem, false);
+      Result := (node <> nil) and _mcp_equal(node^.Item, aitem);
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.Count(aitem : ItemType) : SizeType;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   Result := 0;
+   epoch := EnterEpoch;
+   try
+      node := LowerBoundNode(aitem, false);
+      while (node <> nil) and _mcp_equal(node^.Item, aitem) do
+      begin
+         Inc(Result);
+         node := FirstLive(node^.Next[0]);
+      end;
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.Insert(pos : TSetIterator; aitem : ItemType) : Boolean;
+begin
+   Assert(pos is TConcurrentSkipListIterator, msgInvalidIterator);
+   Result := Insert(aitem);
+end;
+
+function TConcurrentSkipList.Insert(aitem : ItemType) : Boolean;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      Result := InsertNode(aitem, node);
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+procedure TConcurrentSkipList.Delete(pos : TSetIterator);
+var
+   epoch : SizeType;
+begin
+   Assert(pos is TConcurrentSkipListIterator, msgInvalidIterator);
+   Assert(not pos.IsFinish, msgDeletingInvalidIterator);
+
+   epoch := EnterEpoch;
+   try
+      RemoveNode(TConcurrentSkipListIterator(pos).FNode, epoch, true);
+   finally
+      LeaveEpoch(epoch);
+   end;
+   Reclaim;
+end;
+
+function TConcurrentSkipList.Delete(aitem : ItemType) : SizeType;
+begin
+   Result := RemoveItems(aitem, true);
+end;
+
+function TConcurrentSkipList.Extract(aitem : ItemType) : SizeType;
+begin
+   Result := RemoveItems(aitem, false);
+end;
+
+function TConcurrentSkipList.LowerBound(aitem : ItemType) : TSetIterator;
+var
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      Result := TConcurrentSkipListIterator.Create(LowerBoundNode(aitem, false), self);
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.UpperBound(aitem : ItemType) : TSetIterator;
+var
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      Result := TConcurrentSkipListIterator.Create(LowerBoundNode(aitem, true), self);
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.EqualRange(aitem : ItemType) : TSetIteratorRange;
+var
+   iter1, iter2 : TConcurrentSkipListIterator;
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      iter1 := TConcurrentSkipListIterator.Create(LowerBoundNode(aitem, false), self);
+      iter2 := TConcurrentSkipListIterator.Create(LowerBoundNode(aitem, true), self);
+   finally
+      LeaveEpoch(epoch);
+   end;
+   Result := TSetIteratorRange.Create(iter1, iter2);
+end;
+
+function TConcurrentSkipList.FindIf(const pred : IUnaryPredicate;
+                                    var aitem : ItemType) : Boolean;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   Result := false;
+   epoch := EnterEpoch;
+   try
+      node := FirstLive(FHead^.Next[0]);
+      while node <> nil do
+      begin
+         if pred.Test(node^.Item) then
+         begin
+            aitem := node^.Item;
+            Result := true;
+            break;
+         end;
+         node := FirstLive(node^.Next[0]);
+      end;
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   Result := 0;
+   epoch := EnterEpoch;
+   try
+      node := FirstLive(FHead^.Next[0]);
+      while node <> nil do
+      begin
+         if pred.Test(node^.Item) and RemoveNode(node, epoch, true) then
+            Inc(Result);
+         { the node is not freed before LeaveEpoch }
+         node := FirstLive(node^.Next[0]);
+      end;
+   finally
+      LeaveEpoch(epoch);
+   end;
+   Reclaim;
+end;
+
+function TConcurrentSkipList.First : ItemType;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      node := FirstLive(FHead^.Next[0]);
+      Assert(node <> nil, msgReadEmpty);
+      Result := node^.Item;
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.ExtractFirst : ItemType;
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+   removed : Boolean;
+begin
+   repeat
+      epoch := EnterEpoch;
+      try
+         node := FirstLive(FHead^.Next[0]);
+         Assert(node <> nil, msgReadEmpty);
+         Result := node^.Item;
+         removed := RemoveNode(node, epoch, false);
+      finally
+         LeaveEpoch(epoch);
+      end;
+   until removed;
+   Reclaim;
+end;
+
+procedure TConcurrentSkipList.Clear;
+var
+   node, nextNode : PConcurrentSkipListNode;
+   l : Integer;
+begin
+   node := FHead^.Next[0];
+   for l := 0 to cslMaxLevel - 1 do
+      FHead^.Next[l] := nil;
+   while node <> nil do
+   begin
+      nextNode := node^.Next[0];
+      DestroyNode(node);
+      node := nextNode;
+   end;
+   FreeRetired;
+   FSize := 0;
+   GrabageCollector.FreeObjects;
+end;
+
+function TConcurrentSkipList.Empty : Boolean;
+var
+   epoch : SizeType;
+begin
+   epoch := EnterEpoch;
+   try
+      Result := FirstLive(FHead^.Next[0]) = nil;
+   finally
+      LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipList.Size : SizeType;
+begin
+   Result := FSize;
+end;
+
+{ --------------------- TConcurrentSkipListIterator ------------------------ }
+
+constructor TConcurrentSkipListIterator.Create(node : PConcurrentSkipListNode;
+                                               list : TConcurrentSkipList);
+begin
+   inherited Create(list);
+   FList := list;
+   FNode := node;
+end;
+
+function TConcurrentSkipListIterator.CopySelf : TIterator;
+begin
+   Result := TConcurrentSkipListIterator.Create(FNode, FList);
+end;
+
+function TConcurrentSkipListIterator.Equal(const Pos : TIterator) : Boolean;
+begin
+   Assert(pos is TConcurrentSkipListIterator, msgInvalidIterator);
+
+   Result := FNode = TConcurrentSkipListIterator(pos).FNode;
+end;
+
+function TConcurrentSkipListIterator.GetItem : ItemType;
+begin
+   Assert(FNode <> nil, msgInvalidIterator);
+
+   Result := FNode^.Item;
+end;
+
+procedure TConcurrentSkipListIterator.SetItem(aitem : ItemType);
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   Assert(FNode <> nil, msgInvalidIterator);
+
+   epoch := FList.EnterEpoch;
+   try
+      FList.RemoveNode(FNode, epoch, true);
+      if FList.InsertNode(aitem, node) then
+      begin
+         FNode := node;
+      end else
+      begin
+         FNode := nil;
+         with FList do
+            DisposeItem(aitem);
+      end;
+   finally
+      FList.LeaveEpoch(epoch);
+   end;
+   FList.Reclaim;
+end;
+
+procedure TConcurrentSkipListIterator.ResetItem;
+var
+   aitem : ItemType;
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   Assert(FNode <> nil, msgInvalidIterator);
+
+   epoch := FList.EnterEpoch;
+   try
+      aitem := FNode^.Item;
+      if FList.RemoveNode(FNode, epoch, false) then
+      begin
+         if FList.InsertNode(aitem, node) then
+         begin
+            FNode := node;
+         end else
+         begin
+            FNode := nil;
+            with FList do
+               DisposeItem(aitem);
+         end;
+      end;
+   finally
+      FList.LeaveEpoch(epoch);
+   end;
+   FList.Reclaim;
+end;
+
+procedure TConcurrentSkipListIterator.Advance;
+begin
+   Assert(FNode <> nil, msgAdvancingFinishIterator);
+
+   FNode := FList.FirstLive(FNode^.Next[0]);
+end;
+
+procedure TConcurrentSkipListIterator.Retreat;
+var
+   preds : TConcurrentSkipListLinks;
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   epoch := FList.EnterEpoch;
+   try
+      node := FNode;
+      repeat
+         if node = nil then
+         begin
+            node := FList.LastNode;
+         end else
+         begin
+            FList.FindPredecessors(node, preds);
+            node := preds[0];
+         end;
+         Assert(node <> FList.FHead, msgRetreatingStartIterator);
+      until FList.IsLive(node);
+      FNode := node;
+   finally
+      FList.LeaveEpoch(epoch);
+   end;
+end;
+
+procedure TConcurrentSkipListIterator.Insert(aitem : ItemType);
+var
+   node : PConcurrentSkipListNode;
+   epoch : SizeType;
+begin
+   epoch := FList.EnterEpoch;
+   try
+      if FList.InsertNode(aitem, node) then
+         FNode := node
+      else
+         FNode := nil;
+   finally
+      FList.LeaveEpoch(epoch);
+   end;
+end;
+
+function TConcurrentSkipListIterator.Extract : ItemType;
+var
+   epoch : SizeType;
+   removed : Boolean;
+begin
+   Assert(FNode <> nil, msgDeletingInvalidIterator);
+
+   epoch := FList.EnterEpoch;
+   try
+      Result := FNode^.Item;
+      removed := FList.RemoveNode(FNode, epoch, false);
+      { the node is not freed before LeaveEpoch }
+      FNode := FList.FirstLive(FNode^.Next[0]);
+   finally
+      FList.LeaveEpoch(epoch);
+   end;
+   FList.Reclaim;
+   Assert(removed, msgInvalidIterator);
+end;
+
+function TConcurrentSkipListIterator.Owner : TContainerAdt;
+begin
+   Result := FList;
+end;
+
+function TConcurrentSkipListIterator.IsStart : Boolean;
+begin
+   Result := FNode = FList.FirstLive(FList.FHead^.Next[0]);
+end;
+
+function TConcurrentSkipListIterator.IsFinish : Boolean;
+begin
+   Result := FNode = nil;
+end;
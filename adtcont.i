@@ -107,9 +107,9 @@ type
       FRepeatedItems : Boolean;
       FComparer : IBinaryComparer;
 
-      procedure SetRepeatedItems(b : Boolean);
-      procedure SetComparer(comp : IBinaryComparer);
    protected
+      procedure SetRepeatedItems(b : Boolean); virtual;
+      procedure SetComparer(comp : IBinaryComparer); virtual;
       {$warnings off }
       constructor Create; overload;
       constructor CreateCopy(const cont : TSetAdt); overload;
@@ -219,6 +219,17 @@ type
       { @fetch-related }
       { implemented with not Empty }
       function CanExtract : Boolean; override;
+      { writes the items from Start to Finish; does not modify the
+        set }
+      procedure SaveToStream(stream : TStream;
+                             const streamer : IStreamer); overload; override;
+      { searches the items from Start to Finish; does not modify the
+        set }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      { deletes the items from Start to Finish with the Delete method
+        of a single iterator }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
 
 
       { @invariant not RepeatedItems implies foreach x in self holds
@@ -308,6 +319,10 @@ type
 {$ifdef TEST_PASCAL_ADT }
       procedure LogStatus(mname : String); override;
 {$endif }
+{$ifdef PASCAL_ADT_STATS }
+      { adds Capacity and LoadFactor }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       { returns true }
       class function NeedsHasher : Boolean; override;
 
@@ -388,6 +403,10 @@ type
       { @fetch-related }
       { implemented with not Empty }
       function CanExtract : Boolean; override;
+      { searches the items in the preorder traversal order; does not
+        modify the tree }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
    end;
 
    { -------------------- sequential containers ------------------------ }
@@ -483,6 +502,17 @@ type
                      Dest : TForwardIterator); overload; virtual;
       { moves <Source> to before <Dest>. }
       procedure Move(Source, Dest : TForwardIterator); overload; virtual;
+      { writes the items from ForwardStart to ForwardFinish; does not
+        modify the list }
+      procedure SaveToStream(stream : TStream;
+                             const streamer : IStreamer); overload; override;
+      { searches the items from ForwardStart to ForwardFinish; does
+        not modify the list }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      { deletes the items from ForwardStart to ForwardFinish with the
+        Delete method of a single iterator }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
 
 {$ifdef DEBUG_PASCAL_ADT }
       { This field is present only when compiling in the debug mode.
@@ -507,6 +537,16 @@ type
       function BidirectionalFinish : TBidirectionalIterator;
    end;
 
+   { A non-owning view of a part of the storage of a random access
+     container - <Count> items stored one after another in memory,
+     the first of them at <Items>. A slice does not copy anything and
+     is valid only until the container is modified.
+     @see TRandomAccessContainerAdt.GetSlice }
+   TSlice = record
+      Items : PItemType;
+      Count : SizeType;
+   end;
+
    { Represents a container with random access to items.  }
    TRandomAccessContainerAdt = class (TDoubleListAdt)
    protected
@@ -515,6 +555,11 @@ type
       { sets the capacity to <cap>; sets only if <cap> is bigger than
         the current capacity }
       procedure SetCapacity(cap : SizeType); virtual; abstract;
+      { copies buffer[0..n-1] to the positions [index,index+n) one
+        slice at a time, without disposing what was stored there;
+        used to fill the place made for new items }
+      procedure StoreBlock(index : IndexType; const buffer : array of ItemType;
+                           n : SizeType);
 
    public
       { returns an iterator to the first element in the container }
@@ -559,6 +604,43 @@ type
       { returns the highest index in the collection; for containers
         with fixed, zero-based indices always returns Size - 1 (default) }
       function HighIndex : IndexType; virtual;
+      { returns a slice of the storage beginning with the item at
+        <index> and consisting of at most <n> items which are stored
+        contiguously; the slice holds at least one item if <n> > 0;
+        the items of an array form a single slice, those of a circular
+        deque at most two and those of a segmented deque one slice per
+        segment; @complexity O(1) }
+      function GetSlice(index : IndexType; n : SizeType) : TSlice; virtual; abstract;
+      { copies the <n> items at [index,index+n) to buffer[0..n-1]; the
+        items are not copied with any copier, so for objects the
+        buffer only gets references to the items still owned by the
+        container; the default implementation moves whole slices
+        (see @<GetSlice>) in one go; @complexity O(n) }
+      procedure ReadBlock(index : IndexType; var buffer : array of ItemType;
+                          n : SizeType); virtual;
+      { replaces the <n> items at [index,index+n) with buffer[0..n-1];
+        the replaced items are disposed, like with SetItem, and the
+        container takes over the new ones; the default implementation
+        works one slice at a time; @complexity O(n) }
+      procedure WriteBlock(index : IndexType; const buffer : array of ItemType;
+                           n : SizeType); virtual;
+      { pushes buffer[0..n-1] at the back; the default implementation
+        calls @<InsertBlock>; @complexity amortized O(n) for the
+        containers which override InsertBlock }
+      procedure AppendBlock(const buffer : array of ItemType;
+                            n : SizeType); virtual;
+      { inserts buffer[0..n-1] before the item at <index>, so that
+        buffer[0] ends up at <index>; the default implementation calls
+        Insert for every item; the containers which can make room for
+        all the items at once override it; @complexity O(n + m) for
+        them, where m is the number of items moved to make room, and n
+        times the cost of Insert otherwise }
+      procedure InsertBlock(index : IndexType; const buffer : array of ItemType;
+                            n : SizeType); virtual;
+      { reserves the capacity for all the items before pushing them at
+        the back }
+      procedure LoadFromStream(stream : TStream;
+                               const streamer : IStreamer); overload; override;
 
       property Capacity : SizeType read GetCapacity write SetCapacity;
    end;
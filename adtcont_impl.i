@@ -54,6 +54,70 @@ type
    end;
 
 
+{ writes a generic snapshot containing <num> items starting at <iter>;
+  destroys <iter> }
+procedure WriteIteratorToStream(stream : TStream; iter : TForwardIterator;
+                                num : SizeType; const streamer : IStreamer);
+begin
+   try
+      StreamWriteHeader(stream, sfGeneric, SizeOf(ItemType));
+      StreamWriteSize(stream, num);
+      while num <> 0 do
+      begin
+         Assert(not iter.IsFinish, msgInternalError);
+         StreamWriteItem(stream, iter.Item, streamer);
+         iter.Advance;
+         Dec(num);
+      end;
+   finally
+      iter.Destroy;
+   end;
+end;
+
+{ returns in <aitem> the first item satisfying <pred> from <iter> to
+  the end of the container; destroys <iter> }
+function FindIteratorIf(iter : TForwardIterator; const pred : IUnaryPredicate;
+                        var aitem : ItemType) : Boolean;
+begin
+   Result := false;
+   try
+      while not iter.IsFinish do
+      begin
+         if pred.Test(iter.Item) then
+         begin
+            aitem := iter.Item;
+            Result := true;
+            break;
+         end;
+         iter.Advance;
+      end;
+   finally
+      iter.Destroy;
+   end;
+end;
+
+{ deletes the items satisfying <pred> from <iter> to the end of the
+  container; iter.Delete must advance <iter> to the next item;
+  destroys <iter> }
+function DeleteIteratorIf(iter : TForwardIterator;
+                          const pred : IUnaryPredicate) : SizeType;
+begin
+   Result := 0;
+   try
+      while not iter.IsFinish do
+      begin
+         if pred.Test(iter.Item) then
+         begin
+            iter.Delete;
+            Inc(Result);
+         end else
+            iter.Advance;
+      end;
+   finally
+      iter.Destroy;
+   end;
+end;
+
 { ----------------------- TDefinedOrderContainerAdt --------------------------- }
 
 function TDefinedOrderContainerAdt.IsDefinedOrder : Boolean;
@@ -129,6 +193,12 @@ begin
    Result := not Empty;
 end;
 
+function TBasicTreeAdt.FindIf(const pred : IUnaryPredicate;
+                              var aitem : ItemType) : Boolean;
+begin
+   Result := FindIteratorIf(PreOrderIterator, pred, aitem);
+end;
+
 { -------------------------- TQueueAdt -------------------------------- }
 
 function TQueueAdt.InsertItem(aitem : ItemType) : Boolean;
@@ -233,6 +303,22 @@ begin
    Result := not Empty;
 end;
 
+procedure TSetAdt.SaveToStream(stream : TStream; const streamer : IStreamer);
+begin
+   WriteIteratorToStream(stream, Start, Size, streamer);
+end;
+
+function TSetAdt.FindIf(const pred : IUnaryPredicate;
+                        var aitem : ItemType) : Boolean;
+begin
+   Result := FindIteratorIf(Start, pred, aitem);
+end;
+
+function TSetAdt.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+begin
+   Result := DeleteIteratorIf(Start, pred);
+end;
+
 { ------------------------- TSortedSetAdt ------------------------------ }
 
 function TSortedSetAdt.First : ItemType;
@@ -317,6 +403,16 @@ begin
 end;
 {$endif TEST_PASCAL_ADT }
 
+{$ifdef PASCAL_ADT_STATS }
+procedure THashSetAdt.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Capacity := Capacity;
+   if stats.Capacity <> 0 then
+      stats.LoadFactor := stats.Items / stats.Capacity;
+end;
+{$endif PASCAL_ADT_STATS }
+
 { ---------------------------- TListAdt ---------------------------------- }
 
 {$ifdef DEBUG_PASCAL_ADT }
@@ -337,6 +433,22 @@ begin
    adtalgs.Move(Source, Next(Source), Dest);
 end;
 
+procedure TListAdt.SaveToStream(stream : TStream; const streamer : IStreamer);
+begin
+   WriteIteratorToStream(stream, ForwardStart, Size, streamer);
+end;
+
+function TListAdt.FindIf(const pred : IUnaryPredicate;
+                         var aitem : ItemType) : Boolean;
+begin
+   Result := FindIteratorIf(ForwardStart, pred, aitem);
+end;
+
+function TListAdt.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+begin
+   Result := DeleteIteratorIf(ForwardStart, pred);
+end;
+
 { ---------------------------- TDoubleListAdt ---------------------------------- }
 
 function TDoubleListAdt.BidirectionalStart : TBidirectionalIterator;
@@ -401,6 +513,120 @@ begin
    Result := Size - 1;
 end;
 
+procedure TRandomAccessContainerAdt.StoreBlock(index : IndexType;
+                                               const buffer : array of ItemType;
+                                               n : SizeType);
+var
+   slice : TSlice;
+   pitem : PItemType;
+   i : IndexType;
+begin
+   i := 0;
+   while i < n do
+   begin
+      slice := GetSlice(index + i, n - i);
+      { buffer is a const parameter and SafeMove takes var ones }
+      pitem := @buffer[i];
+      SafeMove(pitem^, slice.Items^, slice.Count);
+      Inc(i, slice.Count);
+   end;
+end;
+
+procedure TRandomAccessContainerAdt.ReadBlock(index : IndexType;
+                                              var buffer : array of ItemType;
+                                              n : SizeType);
+var
+   slice : TSlice;
+   i : IndexType;
+begin
+   Assert((n >= 0) and (n <= Length(buffer)), msgInvalidArgument);
+   Assert((index >= LowIndex) and (index + n <= HighIndex + 1),
+          msgInvalidIndex);
+
+   i := 0;
+   while i < n do
+   begin
+      slice := GetSlice(index + i, n - i);
+      SafeMove(slice.Items^, buffer[i], slice.Count);
+      Inc(i, slice.Count);
+   end;
+end;
+
+procedure TRandomAccessContainerAdt.WriteBlock(index : IndexType;
+                                               const buffer : array of ItemType;
+                                               n : SizeType);
+var
+   slice : TSlice;
+   pitem : PItemType;
+   aitem : ItemType;
+   i, j : IndexType;
+begin
+   Assert((n >= 0) and (n <= Length(buffer)), msgInvalidArgument);
+   Assert((index >= LowIndex) and (index + n <= HighIndex + 1),
+          msgInvalidIndex);
+
+   if OwnsItems then
+   begin
+      i := 0;
+      while i < n do
+      begin
+         slice := GetSlice(index + i, n - i);
+         pitem := slice.Items;
+         for j := 1 to slice.Count do
+         begin
+            aitem := pitem^;
+            DisposeItem(aitem);
+            Inc(pitem);
+         end;
+         Inc(i, slice.Count);
+      end;
+   end;
+   StoreBlock(index, buffer, n);
+end;
+
+procedure TRandomAccessContainerAdt.AppendBlock(const buffer : array of ItemType;
+                                                n : SizeType);
+begin
+   InsertBlock(HighIndex + 1, buffer, n);
+end;
+
+procedure TRandomAccessContainerAdt.InsertBlock(index : IndexType;
+                                                const buffer : array of ItemType;
+                                                n : SizeType);
+var
+   i : IndexType;
+begin
+   Assert((n >= 0) and (n <= Length(buffer)), msgInvalidArgument);
+   Assert((index >= LowIndex) and (index <= HighIndex + 1), msgInvalidIndex);
+
+   for i := 0 to n - 1 do
+      Insert(index + i, buffer[i]);
+end;
+
+procedure TRandomAccessContainerAdt.LoadFromStream(stream : TStream;
+                                                   const streamer : IStreamer);
+var
+   num : SizeType;
+   aitem : ItemType;
+begin
+   StreamReadHeader(stream, sfGeneric, SizeOf(ItemType));
+   num := StreamReadSize(stream);
+   Clear;
+   Capacity := num;
+   while num <> 0 do
+   begin
+      aitem := DefaultItem;
+      StreamReadItem(stream, aitem, streamer);
+      try
+         PushBack(aitem);
+      except
+         DisposeItem(aitem);
+         raise;
+      end;
+      Dec(num);
+   end;
+end;
+
 
 { ---------------------- TRandomAccessContainerIterator ------------------------ }
 
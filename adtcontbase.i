@@ -43,6 +43,12 @@ type
       FOwnsItems : Boolean;
 
    protected
+{$ifdef PASCAL_ADT_STATS }
+      { the counters of Resizes, Rehashes and Rotations; the other
+        fields are not used }
+      FStats : TContainerStats;
+{$endif PASCAL_ADT_STATS }
+
       {$warnings off }
       constructor Create; overload;
       { creates self as a copy of cont; this should be called by every
@@ -72,6 +78,15 @@ type
       function FormatItem(aitem : ItemType) : String;
 {$endif TEST_PASCAL_ADT }
 
+{$ifdef PASCAL_ADT_STATS }
+      { fills <stats> with the statistics of the container; the
+        default implementation fills only Items, Bytes, Iterators and
+        the counters; descendants add the information specific to
+        their structure; @complexity O(n) for hash tables and trees,
+        O(1) otherwise }
+      procedure GetStats(var stats : TContainerStats); virtual;
+{$endif PASCAL_ADT_STATS }
+
       { returns a copy of self. copies all the data into the new
         object of then same type. Uses ItemCopier to copy items. This
         functor should return exact copy of item, i.e. the new object
@@ -100,6 +115,62 @@ type
         exceptions; it does not leak anything but may destroy some
         user data in case of an exception; }
       procedure Swap(cont : TContainerAdt); virtual;
+      { writes a snapshot of the container to <stream>; <streamer> is
+        used to write the items; if it is nil then the default binary
+        representation of each item is written (not allowed for
+        object items, EInvalidArgument is raised); the default
+        implementation writes the items in the order in which FindIf
+        visits them; descendants override it to preserve their
+        internal layout; @complexity O(n). }
+      procedure SaveToStream(stream : TStream;
+                             const streamer : IStreamer); overload; virtual;
+      { replaces the items in the container with the ones read from a
+        snapshot written by SaveToStream with an equivalent
+        <streamer>; raises EInvalidStreamFormat if the stream does not
+        contain a valid snapshot of a container of this kind; the
+        default implementation inserts the items with InsertItem;
+        @complexity O(n) for containers which keep their internal
+        layout in the snapshot, otherwise n times the cost of
+        InsertItem. }
+      procedure LoadFromStream(stream : TStream;
+                               const streamer : IStreamer); overload; virtual;
+      { applies <funct> to every item in the container; the results
+        returned by <funct> are ignored, so it may only inspect the
+        items or modify the objects they point to, but it must not
+        change anything the container depends on (e.g. the keys of
+        sets); unlike the ForEach algorithm from @<adtalgs> this does
+        not create any iterators; the default implementation uses
+        @<FindIf>; @complexity O(n). }
+      procedure ForEach(const funct : IUnaryFunctor); virtual;
+      { returns funct(...funct(funct(init, x1), x2)..., xn), where
+        x1..xn are the items of the container in the order in which
+        ForEach visits them; the default implementation uses
+        @<FindIf>; @complexity O(n). }
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; virtual;
+      { finds the first item (in the order in which ForEach visits
+        them) satisfying <pred>; returns true and assigns the item to
+        <aitem> if it is found, otherwise returns false and leaves
+        <aitem> untouched; the default implementation extracts all
+        the items with ExtractItem and inserts them back afterwards;
+        descendants override it to avoid modifying the container;
+        @complexity O(n). }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; virtual;
+      { returns the number of items satisfying <pred>; the default
+        implementation uses @<FindIf>; @complexity O(n). }
+      function CountIf(const pred : IUnaryPredicate) : SizeType; virtual;
+      { deletes (and disposes) all the items satisfying <pred>;
+        returns the number of deleted items; the relative order of
+        the remaining items is preserved in containers without a
+        defined order, except for the default implementation, which
+        extracts all the items with ExtractItem and inserts back those
+        not deleted, so it may rearrange the container (e.g. a tree);
+        invalidates all iterators; @complexity O(n) for most
+        containers, n times the cost of InsertItem with the default
+        implementation. }
+      { @postcondition Size = old Size - Result }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; virtual;
       { inserts aitem somewhere into the container; returns true if
         successful, false if aitem could not be inserted }
       { @postcondition Result implies Size = old Size + 1 }
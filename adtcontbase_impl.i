@@ -30,6 +30,97 @@
 
 &define Identity &_mcp_prefix&Identity
 
+type
+   { the predicates used to implement ForEach, Fold, CountIf and
+     SaveToStream in terms of FindIf; they never accept an item, so
+     FindIf visits all of them }
+   TForEachVisitor = class (TFunctor, IUnaryPredicate)
+   private
+      FFunctor : IUnaryFunctor;
+   public
+      constructor Create(const funct : IUnaryFunctor);
+      function Test(aitem : ItemType) : Boolean;
+   end;
+
+   TFoldVisitor = class (TFunctor, IUnaryPredicate)
+   private
+      FFunctor : IBinaryFunctor;
+      FAccumulator : ItemType;
+   public
+      constructor Create(const funct : IBinaryFunctor; init : ItemType);
+      function Test(aitem : ItemType) : Boolean;
+   end;
+
+   TCountVisitor = class (TFunctor, IUnaryPredicate)
+   private
+      FPredicate : IUnaryPredicate;
+      FCount : SizeType;
+   public
+      constructor Create(const pred : IUnaryPredicate);
+      function Test(aitem : ItemType) : Boolean;
+   end;
+
+   TStreamVisitor = class (TFunctor, IUnaryPredicate)
+   private
+      FStream : TStream;
+      FStreamer : IStreamer;
+   public
+      constructor Create(stream : TStream; const streamer : IStreamer);
+      function Test(aitem : ItemType) : Boolean;
+   end;
+
+constructor TForEachVisitor.Create(const funct : IUnaryFunctor);
+begin
+   inherited Create;
+   FFunctor := funct;
+end;
+
+function TForEachVisitor.Test(aitem : ItemType) : Boolean;
+begin
+   FFunctor.Perform(aitem);
+   Result := false;
+end;
+
+constructor TFoldVisitor.Create(const funct : IBinaryFunctor; init : ItemType);
+begin
+   inherited Create;
+   FFunctor := funct;
+   FAccumulator := init;
+end;
+
+function TFoldVisitor.Test(aitem : ItemType) : Boolean;
+begin
+   FAccumulator := FFunctor.Perform(FAccumulator, aitem);
+   Result := false;
+end;
+
+constructor TCountVisitor.Create(const pred : IUnaryPredicate);
+begin
+   inherited Create;
+   FPredicate := pred;
+   FCount := 0;
+end;
+
+function TCountVisitor.Test(aitem : ItemType) : Boolean;
+begin
+   if FPredicate.Test(aitem) then
+      Inc(FCount);
+   Result := false;
+end;
+
+constructor TStreamVisitor.Create(stream : TStream; const streamer : IStreamer);
+begin
+   inherited Create;
+   FStream := stream;
+   FStreamer := streamer;
+end;
+
+function TStreamVisitor.Test(aitem : ItemType) : Boolean;
+begin
+   StreamWriteItem(FStream, aitem, FStreamer);
+   Result := false;
+end;
+
 { TContainerAdt members }
 
 constructor TContainerAdt.Create;
@@ -111,9 +202,9 @@ begin
       Result := IntToStr(TTestObject(aitem).Value)
    else
       Result := Format('<object address: %X>', [PointerValueType(aitem)]);
-&elseif (&ItemType == Real)
+&elseif (&ItemType == Real || &ItemType == Double)
    Result := FloatToStr(aitem);
-&elseif (&ItemType == Integer || &ItemType == Cardinal)
+&elseif (&_mcp_is_number(&ItemType&))
    Result := IntToStr(aitem);
 &elseif (&ItemType == Pointer)
    Result := Format('<pointer: %X>', [PointerValueType(aitem)]);
@@ -124,6 +215,16 @@ end;
 
 {$endif TEST_PASCAL_ADT }
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TContainerAdt.GetStats(var stats : TContainerStats);
+begin
+   stats := FStats;
+   stats.Items := Size;
+   stats.Bytes := InstanceSize;
+   stats.Iterators := FGrabageCollector.RegisteredObjects;
+end;
+{$endif PASCAL_ADT_STATS }
+
 procedure TContainerAdt.Swap(cont : TContainerAdt);
 var
    temp : TDynamicBuffer;
@@ -190,6 +291,166 @@ begin
 //   end;
 end;
 
+procedure TContainerAdt.SaveToStream(stream : TStream;
+                                     const streamer : IStreamer);
+var
+   pred : IUnaryPredicate;
+   aitem : ItemType;
+begin
+&if (&ItemType == TObject)
+   if streamer = nil then
+      raise EInvalidArgument.Create(msgNilFunctor);
+&endif
+   StreamWriteHeader(stream, sfGeneric, SizeOf(ItemType));
+   StreamWriteSize(stream, Size);
+   pred := TStreamVisitor.Create(stream, streamer);
+   aitem := DefaultItem;
+   FindIf(pred, aitem);
+end;
+
+procedure TContainerAdt.LoadFromStream(stream : TStream;
+                                       const streamer : IStreamer);
+var
+   num : SizeType;
+   aitem : ItemType;
+begin
+   StreamReadHeader(stream, sfGeneric, SizeOf(ItemType));
+   num := StreamReadSize(stream);
+   Clear;
+   while num <> 0 do
+   begin
+      aitem := DefaultItem;
+      StreamReadItem(stream, aitem, streamer);
+      try
+         if not InsertItem(aitem) then
+            DisposeItem(aitem);
+      except
+         DisposeItem(aitem);
+         raise;
+      end;
+      Dec(num);
+   end;
+end;
+
+procedure TContainerAdt.ForEach(const funct : IUnaryFunctor);
+var
+   pred : IUnaryPredicate;
+   aitem : ItemType;
+begin
+   pred := TForEachVisitor.Create(funct);
+   aitem := DefaultItem;
+   FindIf(pred, aitem);
+end;
+
+function TContainerAdt.Fold(const funct : IBinaryFunctor;
+                            init : ItemType) : ItemType;
+var
+   visitor : TFoldVisitor;
+   pred : IUnaryPredicate;
+   aitem : ItemType;
+begin
+   visitor := TFoldVisitor.Create(funct, init);
+   pred := visitor; { keeps the visitor alive }
+   aitem := DefaultItem;
+   FindIf(pred, aitem);
+   Result := visitor.FAccumulator;
+end;
+
+function TContainerAdt.FindIf(const pred : IUnaryPredicate;
+                              var aitem : ItemType) : Boolean;
+var
+   temp : TDynamicBuffer;
+   i, num : SizeType;
+begin
+   Result := false;
+   BufferAllocate(temp, Size);
+   num := 0;
+   try
+      while (num < temp^.Capacity) and CanExtract do
+      begin
+         temp^.Items[num] := ExtractItem; { may raise }
+         Inc(num);
+      end;
+
+      i := 0;
+      while (i < num) and not Result do
+      begin
+         if pred.Test(temp^.Items[i]) then
+         begin
+            aitem := temp^.Items[i];
+            Result := true;
+         end;
+         Inc(i);
+      end;
+
+   finally
+      { put the items back in the order they were extracted }
+      for i := 0 to num - 1 do
+         InsertItem(temp^.Items[i]);
+      BufferDeallocate(temp);
+   end;
+end;
+
+function TContainerAdt.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   visitor : TCountVisitor;
+   vpred : IUnaryPredicate;
+   aitem : ItemType;
+begin
+   visitor := TCountVisitor.Create(pred);
+   vpred := visitor; { keeps the visitor alive }
+   aitem := DefaultItem;
+   FindIf(vpred, aitem);
+   Result := visitor.FCount;
+end;
+
+function TContainerAdt.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   temp : TDynamicBuffer;
+   i, j, num, kept : SizeType;
+   aitem : ItemType;
+begin
+   Result := 0;
+   BufferAllocate(temp, Size);
+   num := 0;
+   kept := 0;
+   i := 0;
+   try
+      while (num < temp^.Capacity) and CanExtract do
+      begin
+         temp^.Items[num] := ExtractItem; { may raise }
+         Inc(num);
+      end;
+
+      { the items which are kept are moved to the beginning of temp;
+        [kept, i) is free }
+      while i < num do
+      begin
+         aitem := temp^.Items[i];
+         if pred.Test(aitem) then { may raise }
+         begin
+            Inc(i);
+            Inc(Result);
+            DisposeItem(aitem);
+         end else
+         begin
+            temp^.Items[kept] := aitem;
+            Inc(kept);
+            Inc(i);
+         end;
+      end;
+
+   finally
+      { put back the items which are kept and the ones not yet tested
+        if an exception was raised }
+      for j := 0 to kept - 1 do
+         InsertItem(temp^.Items[j]);
+      for j := i to num - 1 do
+         InsertItem(temp^.Items[j]);
+      BufferDeallocate(temp);
+   end;
+end;
+
 procedure TContainerAdt.&<DisposeItem>(aitem : ItemType);
 begin
    &_mcp_dispose_item(aitem, FDisposer.Perform, OwnsItems, FDisposer);
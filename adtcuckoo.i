@@ -0,0 +1,305 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtcuckoo.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtcuckoo.defs
+
+type
+   PCuckooDupNode = ^TCuckooDupNode;
+   { holds an item equal to the item in a slot of TCuckooHashTable;
+     such items are kept in a list hanging off the slot and do not
+     take any slots themselves }
+   TCuckooDupNode = record
+      Item : ItemType;
+      Next : PCuckooDupNode;
+   end;
+
+   { a bucket of TCuckooHashTable; the tags are kept together in
+     front of the items, so that the items are read only when a tag
+     matches; a tag of 0 means that the slot is free }
+   TCuckooBucket = record
+      Tags : array[0..ccBucketSize - 1] of Word;
+      Items : array[0..ccBucketSize - 1] of ItemType;
+   end;
+
+   { an item for which no slot has been found }
+   TCuckooStashEntry = record
+      Item : ItemType;
+      Dups : PCuckooDupNode;
+   end;
+
+   TCuckooHashTableIterator = class;
+
+   { TCuckooHashTable is a bucketized cuckoo hash table. Every item
+     has two buckets of ccBucketSize slots chosen by its hash, and is
+     always stored in one of them, so Has, Find, Count and Delete
+     read at most two buckets (plus the stash, which is almost always
+     empty) no matter how the items collide; the second bucket is
+     prefetched before the first one is searched, so that the cache
+     misses of both buckets overlap. The buckets are not aligned to
+     cache lines (a bucket of pointer-sized items takes 40 bytes on
+     64-bit targets), so a bucket may span two of them and a lookup
+     may touch up to four cache lines, though usually two or three.
+     When both buckets of an inserted item are full some item is
+     moved to its other bucket, possibly moving another one, and so
+     on; an item left without a slot after ccMaxKicks moves goes to
+     the stash, and when the stash overflows the table is rehashed
+     with a new seed or grown. Items equal to an item already in the
+     set (if RepeatedItems is true) are kept in a list attached to its
+     slot. Any insertion may move items between slots and thus
+     invalidates all iterators. Warning: the hashing function must not
+     raise exceptions. }
+   TCuckooHashTable = class (THashSetAdt)
+   private
+      FBuckets : array of TCuckooBucket;
+      { the lists of items equal to the items in the slots, indexed by
+        slot; valid only for slots with ccDupsFlag set in their tags;
+        empty until the first such item is inserted }
+      FDups : array of PCuckooDupNode;
+      { items for which no slot has been found }
+      FStash : array of TCuckooStashEntry;
+      FStashSize : SizeType;
+      { if FStashSize exceeds this then the table is rehashed }
+      FStashLimit : SizeType;
+      FCapacity : SizeType; { the number of slots }
+      FBucketMask : IndexType; { the number of buckets - 1 }
+      FTableSize : SizeType; { log2(FCapacity) }
+      FSize : SizeType; { the number of items }
+      { the number of items in the slots and in the stash, i.e. FSize
+        without the items in the lists of equal items }
+      FSlotItems : SizeType;
+      { maximal value of (FSlotItems/FCapacity) shl ccRatioFactor }
+      FMaxFillRatio : SizeType;
+      { the same as above, but minimal value }
+      FMinFillRatio : SizeType;
+      { true if the table has been grown automatically since the last
+        user call to Clear, Rehash or since creation of the object }
+      FCanShrink : Boolean;
+      { mixed into the hashes of the items; changed on every rehash }
+      FSeed : Cardinal;
+      { the state of the generator of random numbers }
+      FRandom : Cardinal;
+
+      function NextRandom : Cardinal;
+      { computes the first bucket and the tag of aitem }
+      procedure HashItem(aitem : ItemType; var bucket : IndexType;
+                         var tag : Word);
+{$ifdef INLINE_DIRECTIVE }
+      inline;
+{$endif }
+      { returns the other bucket of an item with the given tag stored
+        in bucket; it is computed from the tag only, so that items can
+        be moved without being hashed again }
+      function AltBucket(bucket : IndexType; tag : Word) : IndexType;
+{$ifdef INLINE_DIRECTIVE }
+      inline;
+{$endif }
+      { returns the slot of bucket containing an item equal to aitem
+        with the given tag, or -1 }
+      function FindInBucket(aitem : ItemType; bucket : IndexType;
+                            tag : Word) : IndexType;
+{$ifdef INLINE_DIRECTIVE }
+      inline;
+{$endif }
+      { returns the position of the item equal to aitem which is stored
+        in a slot or in the stash, or -1 if there is no such item;
+        positions 0..FCapacity-1 are the slots and positions
+        FCapacity..FCapacity+FStashSize-1 the entries of the stash }
+      function FindPos(aitem : ItemType) : IndexType;
+      { returns the item at position pos }
+      function ItemAt(pos : IndexType) : ItemType;
+      { returns the list of items equal to the one at pos }
+      function DupsAt(pos : IndexType) : PCuckooDupNode;
+      { sets the list of items equal to the one at pos }
+      procedure SetDupsAt(pos : IndexType; dups : PCuckooDupNode);
+      { returns the first position >= pos holding an item, or -1 }
+      function NextUsedPos(pos : IndexType) : IndexType;
+      { returns the last position <= pos holding an item, or -1 }
+      function PrevUsedPos(pos : IndexType) : IndexType;
+      { puts aitem into a free slot of bucket; returns false if there
+        is no free slot }
+      function PutIntoBucket(aitem : ItemType; bucket : IndexType;
+                             tag : Word; dups : PCuckooDupNode) : Boolean;
+      { stores aitem (together with the list of items equal to it)
+        into one of its buckets, moving other items if necessary; if
+        this fails the item left without a slot is put into the stash;
+        does not change FSize nor FSlotItems }
+      procedure PlaceItem(aitem : ItemType; bucket : IndexType;
+                          tag : Word; dups : PCuckooDupNode);
+      procedure AddToStash(aitem : ItemType; dups : PCuckooDupNode);
+      { inserts aitem; returns false if it has not been inserted
+        because RepeatedItems is false and there is an equal item }
+      function DoInsert(aitem : ItemType) : Boolean;
+      { removes the item at pos and returns it; if there are items
+        equal to it then the first of them takes its place; if pos is
+        in the stash, then the entries after it are moved back by one }
+      function RemoveAt(pos : IndexType) : ItemType;
+      { disposes all items equal to the one at pos, but not this item
+        itself; returns their number }
+      function DisposeDupsAt(pos : IndexType) : SizeType;
+      { rehashes the table if the stash has grown too large }
+      procedure CheckStash;
+      procedure CheckMinFillRatio;
+      procedure CheckMaxFillRatio;
+      { allocates an empty table of 2^tableSize slots; does not touch
+        the items }
+      procedure AllocateTable(tableSize : SizeType);
+      { initializes all fields to their default values }
+      procedure InitFields;
+      { disposes all items without freeing the table }
+      procedure DisposeAllItems;
+
+   protected
+      function GetCapacity : SizeType; override;
+      function CalculateCapacity(ex : SizeType) : SizeType; override;
+      function GetMaxFillRatio : SizeType; override;
+      procedure SetMaxFillRatio(fr : SizeType); override;
+      function GetMinFillRatio : SizeType; override;
+      procedure SetMinFillRatio(fr : SizeType); override;
+
+   public
+      constructor Create; overload;
+      { creates a copy of ct; items are copied using itemCopier; if
+        itemCopier is nil then an empty table with the same
+        parameters is created; the copy has exactly the same layout as
+        ct, so no item is hashed }
+      constructor CreateCopy(const ct : TCuckooHashTable;
+                             const itemCopier : IUnaryFunctor); overload;
+      { frees all items and releases any allocated memory }
+      destructor Destroy; override;
+
+{$ifdef PASCAL_ADT_STATS }
+      { counts a probe of 1 for the items in their first buckets, 2 for
+        those in their second buckets and 3 plus the index for the
+        items in the stash; an item in a list of equal items counts
+        one more than the item before it }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
+
+      { returns an exact copy of self; @complexity O(m) }
+      function CopySelf(const ItemCopier : IUnaryFunctor) :
+         TContainerAdt; override;
+      { @see TContainerAdt.Swap }
+      procedure Swap(cont : TContainerAdt); override;
+      { returns the start iterator; @complexity worst-case O(m) }
+      function Start : TSetIterator; override;
+      { returns the finish iterator }
+      function Finish : TSetIterator; override;
+&if (&_mcp_accepts_nil)
+      { if RepeatedItems is false and there is an item equal to aitem in
+        the set, then returns this item; in all other cases inserts
+        aitem into the set and returns nil }
+      function FindOrInsert(aitem : ItemType) : ItemType; override;
+      { returns the first item equal to aitem, or nil if not found;
+        @complexity worst-case O(1) (unless the stash overflows, which
+        happens only with a very bad hasher) }
+      function Find(aitem : ItemType) : ItemType; override;
+&endif &# end &_mcp_accepts_nil
+      { returns true if the given item is present in the set;
+        @complexity worst-case O(1) }
+      function Has(aitem : ItemType) : Boolean; override;
+      { returns the number of items in the set equal to aitem;
+        @complexity O(k), where k is the returned value }
+      function Count(aitem : ItemType) : SizeType; override;
+      { exactly the same as below; pos is discarded }
+      function Insert(pos : TSetIterator;
+                      aitem : ItemType) : Boolean; overload; override;
+      { inserts aitem into the set; returns true if self was inserted,
+        or false if it cannot be inserted (this happens for non-multi
+        (without repeated items) set when item equal to aitem is already
+        in the set); if the item is not inserted it is not owned by
+        the container and not disposed; invalidates all iterators;
+        @complexity amortized O(1), but a single insertion may move
+        up to ccMaxKicks items or rehash the table }
+      function Insert(aitem : ItemType) : Boolean; overload; override;
+      { removes the item at pos from the set }
+      procedure Delete(pos : TSetIterator); overload; override;
+      { removes all items equal to aitem from the set; returns the
+        number of deleted items; @complexity O(k), where k is the
+        number of deleted items, amortized if the table is shrunk }
+      function Delete(aitem : ItemType) : SizeType; overload; override;
+      { returns the iterator starting the range of items equal to aitem }
+      function LowerBound(aitem : ItemType) : TSetIterator; override;
+      { returns the iterator that ends a range of items equal to aitem;
+        @complexity O(k + m/n), where k is the number of items equal to
+        aitem }
+      function UpperBound(aitem : ItemType) : TSetIterator; override;
+      { returns a range <LowerBound, UpperBound) }
+      function EqualRange(aitem : ItemType) : TSetIteratorRange; override;
+      { rehashes the table making it 2^EX times larger with a new seed;
+        ex may be negative, but the resulting capacity of the table
+        cannot be less than its minimal allowed value. }
+      procedure Rehash(ex : SizeType); override;
+      { clears the container - removes all items; @complexity O(m). }
+      procedure Clear; override;
+      { returns true if container is empty; equivalent to Size = 0,
+        but may be faster; }
+      function Empty : Boolean; override;
+      { returns number of items;  }
+      function Size : SizeType; override;
+      { returns the minimal allowed capacity for the set }
+      function MinCapacity : SizeType; override;
+   end;
+
+   { the items are visited in the order of their slots, and then in
+     the order of the stash; the items equal to an item follow it
+     immediately }
+   TCuckooHashTableIterator = class (TSetIterator)
+   private
+      { the position of the item in the table, or -1 for the finish
+        iterator }
+      FPos : IndexType;
+      { the node of an item equal to the item at FPos, or nil if the
+        iterator points at the item at FPos itself }
+      FDup : PCuckooDupNode;
+      FTable : TCuckooHashTable;
+
+      {$warnings off }
+      constructor Create(apos : IndexType; adup : PCuckooDupNode;
+                         tab : TCuckooHashTable);
+      {$warnings on }
+
+   public
+      { returns an exact copy of self; i.e. copies all the data }
+      function CopySelf : TIterator; override;
+      function Equal(const Pos : TIterator) : Boolean; override;
+      function GetItem : ItemType; override;
+      { @fetch-related }
+      { invalidates all other iterators if aitem is not equal to the
+        old item }
+      procedure SetItem(aitem : ItemType); override;
+      { @fetch-related }
+      procedure ResetItem; override;
+      procedure Advance; overload; override;
+      procedure Retreat; override;
+      { invalidates all other iterators }
+      procedure Insert(aitem : ItemType); override;
+      function Extract : ItemType; override;
+      function Owner : TContainerAdt; override;
+      { @complexity worst-case O(m) }
+      function IsStart : Boolean; override;
+      function IsFinish : Boolean; override;
+   end;
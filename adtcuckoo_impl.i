@@ -0,0 +1,1101 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtcuckoo_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtcuckoo.defs
+&include adtcuckoo_impl.mcp
+
+{ turn range checking off }
+{$R-}
+
+{ **************************************************************************** }
+{   Notes on the implementation of TCuckooHashTable: }
+{ FBuckets is an array of FCapacity/ccBucketSize buckets, each holding
+  ccBucketSize slots. The hash of an item, mixed with FSeed, gives the
+  index of its first bucket and a 15-bit tag (never 0, since the tag
+  of a free slot is 0). The index of the second bucket is the index of
+  the first one xor'ed with a function of the tag, so that for an item
+  stored in one of its buckets the other one can be computed from the
+  tag alone and items may be moved between buckets without calling the
+  hasher. A lookup compares the tags of both buckets and calls the
+  comparer only for the slots whose tags match. An insertion of an
+  item both of whose buckets are full takes the slot of a random item
+  in one of them and moves that item to its other bucket, perhaps
+  displacing yet another item, and so on (a random walk); after
+  ccMaxKicks moves the item left without a slot is put into FStash,
+  which is searched linearly by every unsuccessful lookup. When there
+  are more than FStashLimit items in the stash the table is rehashed
+  with a new seed, or grown if it is at least half full or reseeding
+  did not help; if even that does not empty the stash, which may
+  happen only with a hasher returning equal hashes for many different
+  items, the limit is raised so that insertions do not keep rehashing
+  the table. Items equal to an item in a slot (when RepeatedItems is
+  true) are not stored in slots; they are kept in a list attached to
+  the slot, in FDups[slot] for the slots whose tags have ccDupsFlag
+  set, or in TCuckooStashEntry.Dups for the stash. The lists move
+  together with their slot items. A position is an index into the
+  slots (0..FCapacity-1) or into the stash
+  (FCapacity..FCapacity+FStashSize-1); an iterator holds a position
+  and a node of the list of equal items (nil for the item in the slot
+  itself); -1 is the position of the finish iterator. The fill ratio
+  is computed from FSlotItems, the number of items in the slots and
+  in the stash, because only these items take slots. }
+{ **************************************************************************** }
+
+
+{ ---------------------------- TCuckooHashTable ------------------------------ }
+
+constructor TCuckooHashTable.Create;
+begin
+   inherited;
+   InitFields;
+end;
+
+constructor TCuckooHashTable.CreateCopy(const ct : TCuckooHashTable;
+                                        const itemCopier : IUnaryFunctor);
+var
+   b, j : IndexType;
+
+   { appends copies of the items in the list src to the list at pos }
+   procedure CopyDups(pos : IndexType; src : PCuckooDupNode);
+   var
+      node, last : PCuckooDupNode;
+      aitem : ItemType;
+   begin
+      last := nil;
+      while src <> nil do
+      begin
+         aitem := itemCopier.Perform(src^.Item); { may raise }
+         New(node);
+         node^.Item := aitem;
+         node^.Next := nil;
+         if last = nil then
+            SetDupsAt(pos, node)
+         else
+            last^.Next := node;
+         last := node;
+         Inc(FSize);
+         src := src^.Next;
+      end;
+   end;
+
+begin
+   inherited CreateCopy(ct);
+
+   FSize := 0;
+   FSlotItems := 0;
+   FRandom := ct.FRandom;
+   FMaxFillRatio := ct.FMaxFillRatio;
+   FMinFillRatio := ct.FMinFillRatio;
+
+   if itemCopier <> nil then
+   begin
+      FCanShrink := ct.FCanShrink;
+      AllocateTable(ct.FTableSize);
+      { the copy has the same layout as ct, so that no item has to be
+        hashed }
+      FSeed := ct.FSeed;
+      for b := 0 to FBucketMask do
+      begin
+         for j := 0 to ccBucketSize - 1 do
+         begin
+            if ct.FBuckets[b].Tags[j] <> 0 then
+            begin
+               FBuckets[b].Items[j] :=
+                  itemCopier.Perform(ct.FBuckets[b].Items[j]); { may raise }
+               FBuckets[b].Tags[j] := ct.FBuckets[b].Tags[j] and ccTagMask;
+               Inc(FSize);
+               Inc(FSlotItems);
+               CopyDups((b shl ccBucketShift) + j,
+                        ct.DupsAt((b shl ccBucketShift) + j));
+            end;
+         end;
+      end;
+      for j := 0 to ct.FStashSize - 1 do
+      begin
+         AddToStash(itemCopier.Perform(ct.FStash[j].Item), nil); { may raise }
+         Inc(FSize);
+         Inc(FSlotItems);
+         CopyDups(FCapacity + j, ct.FStash[j].Dups);
+      end;
+      FStashLimit := ct.FStashLimit;
+   end else
+   begin
+      FCanShrink := false;
+      AllocateTable(ccInitialTableSize);
+   end;
+end;
+
+destructor TCuckooHashTable.Destroy;
+begin
+   if FBuckets <> nil then
+      DisposeAllItems;
+   inherited;
+end;
+
+function TCuckooHashTable.NextRandom : Cardinal;
+begin
+   { xorshift }
+   FRandom := FRandom xor (FRandom shl 13);
+   FRandom := FRandom xor (FRandom shr 17);
+   FRandom := FRandom xor (FRandom shl 5);
+   Result := FRandom;
+end;
+
+procedure TCuckooHashTable.HashItem(aitem : ItemType; var bucket : IndexType;
+                                    var tag : Word);
+{$ifdef INLINE_DIRECTIVE_REPEAT }
+inline;
+{$endif }
+var
+   x, t : Cardinal;
+begin
+   x := MixHash(Hasher.Hash(aitem) xor FSeed);
+   bucket := x and FBucketMask;
+   { the tag is taken from the high bits of a product, which depend on
+     all the bits of x, so that it is independent of the bucket }
+   t := x * ccTagMultiplier;
+   tag := (t shr 17) and ccTagMask;
+   if tag = 0 then
+      tag := 1;
+end;
+
+function TCuckooHashTable.AltBucket(bucket : IndexType; tag : Word) : IndexType;
+{$ifdef INLINE_DIRECTIVE_REPEAT }
+inline;
+{$endif }
+begin
+   { or'ing with 1 makes the two buckets different whenever there are
+     at least two of them; xor makes AltBucket its own inverse }
+   Result := (bucket xor IndexType(MixHash(tag) or 1)) and FBucketMask;
+end;
+
+function TCuckooHashTable.FindInBucket(aitem : ItemType; bucket : IndexType;
+                                       tag : Word) : IndexType;
+{$ifdef INLINE_DIRECTIVE_REPEAT }
+inline;
+{$endif }
+var
+   j : IndexType;
+begin
+   for j := 0 to ccBucketSize - 1 do
+   begin
+      if ((FBuckets[bucket].Tags[j] and ccTagMask) = tag) and
+            (_mcp_equal(FBuckets[bucket].Items[j], aitem)) then
+      begin
+         Result := (bucket shl ccBucketShift) + j;
+         Exit;
+      end;
+   end;
+   Result := -1;
+end;
+
+function TCuckooHashTable.FindPos(aitem : ItemType) : IndexType;
+var
+   bucket, bucket2, i : IndexType;
+   tag : Word;
+begin
+   HashItem(aitem, bucket, tag);
+   bucket2 := AltBucket(bucket, tag);
+   { start loading the second bucket while the first one is searched }
+   &_mcp_prefetch(FBuckets[bucket2]);
+
+   Result := FindInBucket(aitem, bucket, tag);
+   if Result = -1 then
+   begin
+      Result := FindInBucket(aitem, bucket2, tag);
+      if (Result = -1) and (FStashSize <> 0) then
+      begin
+         for i := 0 to FStashSize - 1 do
+         begin
+            if _mcp_equal(FStash[i].Item, aitem) then
+            begin
+               Result := FCapacity + i;
+               Exit;
+            end;
+         end;
+      end;
+   end;
+end;
+
+function TCuckooHashTable.ItemAt(pos : IndexType) : ItemType;
+begin
+   if pos < FCapacity then
+      Result := FBuckets[pos shr ccBucketShift].Items[pos and (ccBucketSize - 1)]
+   else
+      Result := FStash[pos - FCapacity].Item;
+end;
+
+function TCuckooHashTable.DupsAt(pos : IndexType) : PCuckooDupNode;
+begin
+   if pos < FCapacity then
+   begin
+      if (FBuckets[pos shr ccBucketShift].Tags[pos and (ccBucketSize - 1)] and
+             ccDupsFlag) <> 0 then
+      begin
+         Result := FDups[pos];
+      end else
+         Result := nil;
+   end else
+      Result := FStash[pos - FCapacity].Dups;
+end;
+
+procedure TCuckooHashTable.SetDupsAt(pos : IndexType; dups : PCuckooDupNode);
+var
+   bucket, j : IndexType;
+begin
+   if pos < FCapacity then
+   begin
+      bucket := pos shr ccBucketShift;
+      j := pos and (ccBucketSize - 1);
+      if dups <> nil then
+      begin
+         if Length(FDups) = 0 then
+            SetLength(FDups, FCapacity); { may raise }
+         FDups[pos] := dups;
+         FBuckets[bucket].Tags[j] := FBuckets[bucket].Tags[j] or ccDupsFlag;
+      end else
+         FBuckets[bucket].Tags[j] := FBuckets[bucket].Tags[j] and ccTagMask;
+   end else
+      FStash[pos - FCapacity].Dups := dups;
+end;
+
+function TCuckooHashTable.NextUsedPos(pos : IndexType) : IndexType;
+begin
+   while pos < FCapacity do
+   begin
+      if FBuckets[pos shr ccBucketShift].Tags[pos and (ccBucketSize - 1)] <> 0 then
+      begin
+         Result := pos;
+         Exit;
+      end;
+      Inc(pos);
+   end;
+   if pos < FCapacity + FStashSize then
+      Result := pos
+   else
+      Result := -1;
+end;
+
+function TCuckooHashTable.PrevUsedPos(pos : IndexType) : IndexType;
+begin
+   if pos >= FCapacity then
+   begin
+      Result := pos;
+      Exit;
+   end;
+   while pos >= 0 do
+   begin
+      if FBuckets[pos shr ccBucketShift].Tags[pos and (ccBucketSize - 1)] <> 0 then
+         break;
+      Dec(pos);
+   end;
+   Result := pos;
+end;
+
+function TCuckooHashTable.PutIntoBucket(aitem : ItemType; bucket : IndexType;
+                                        tag : Word; dups : PCuckooDupNode) : Boolean;
+var
+   j : IndexType;
+begin
+   for j := 0 to ccBucketSize - 1 do
+   begin
+      if FBuckets[bucket].Tags[j] = 0 then
+      begin
+         FBuckets[bucket].Items[j] := aitem;
+         FBuckets[bucket].Tags[j] := tag;
+         if dups <> nil then
+            SetDupsAt((bucket shl ccBucketShift) + j, dups);
+         Result := true;
+         Exit;
+      end;
+   end;
+   Result := false;
+end;
+
+procedure TCuckooHashTable.PlaceItem(aitem : ItemType; bucket : IndexType;
+                                     tag : Word; dups : PCuckooDupNode);
+var
+   kicks : SizeType;
+   j, slot : IndexType;
+   victim : ItemType;
+   victimTag : Word;
+   victimDups : PCuckooDupNode;
+begin
+   if PutIntoBucket(aitem, bucket, tag, dups) then
+      Exit;
+   bucket := AltBucket(bucket, tag);
+
+   kicks := 0;
+   while not PutIntoBucket(aitem, bucket, tag, dups) do
+   begin
+      if kicks = ccMaxKicks then
+      begin
+         AddToStash(aitem, dups);
+         Exit;
+      end;
+      Inc(kicks);
+
+      { both buckets are full - take the slot of a random item of the
+        current bucket and move that item to its other bucket }
+      j := NextRandom and (ccBucketSize - 1);
+      slot := (bucket shl ccBucketShift) + j;
+      victim := FBuckets[bucket].Items[j];
+      victimTag := FBuckets[bucket].Tags[j] and ccTagMask;
+      victimDups := DupsAt(slot);
+
+      FBuckets[bucket].Items[j] := aitem;
+      FBuckets[bucket].Tags[j] := tag;
+      SetDupsAt(slot, dups);
+
+      aitem := victim;
+      tag := victimTag;
+      dups := victimDups;
+      bucket := AltBucket(bucket, tag);
+   end;
+end;
+
+procedure TCuckooHashTable.AddToStash(aitem : ItemType; dups : PCuckooDupNode);
+begin
+   if FStashSize = Length(FStash) then
+   begin
+      if FStashSize = 0 then
+         SetLength(FStash, ccMaxStashSize + 1) { may raise }
+      else
+         SetLength(FStash, FStashSize * 2); { may raise }
+   end;
+   FStash[FStashSize].Item := aitem;
+   FStash[FStashSize].Dups := dups;
+   Inc(FStashSize);
+end;
+
+function TCuckooHashTable.DoInsert(aitem : ItemType) : Boolean;
+var
+   pos, bucket : IndexType;
+   tag : Word;
+   node : PCuckooDupNode;
+begin
+   pos := FindPos(aitem);
+   if pos <> -1 then
+   begin
+      if not RepeatedItems then
+      begin
+         Result := false;
+         Exit;
+      end;
+      { equal items do not take slots - add it to the list of the
+        item found }
+      New(node);
+      node^.Item := aitem;
+      node^.Next := DupsAt(pos);
+      SetDupsAt(pos, node);
+   end else
+   begin
+      { this must be called before hashing the item, since it may
+        change the seed }
+      CheckMaxFillRatio;
+      HashItem(aitem, bucket, tag);
+      PlaceItem(aitem, bucket, tag, nil);
+      Inc(FSlotItems);
+      CheckStash;
+   end;
+   Inc(FSize);
+   Result := true;
+end;
+
+function TCuckooHashTable.RemoveAt(pos : IndexType) : ItemType;
+var
+   node : PCuckooDupNode;
+   bucket, j, i : IndexType;
+begin
+   Result := ItemAt(pos);
+   node := DupsAt(pos);
+   if node <> nil then
+   begin
+      { the first equal item takes the place of the removed one }
+      if pos < FCapacity then
+         FBuckets[pos shr ccBucketShift].Items[pos and (ccBucketSize - 1)] := node^.Item
+      else
+         FStash[pos - FCapacity].Item := node^.Item;
+      SetDupsAt(pos, node^.Next);
+      Dispose(node);
+   end else if pos < FCapacity then
+   begin
+      bucket := pos shr ccBucketShift;
+      j := pos and (ccBucketSize - 1);
+      FBuckets[bucket].Tags[j] := 0;
+      FBuckets[bucket].Items[j] := DefaultItem;
+      Dec(FSlotItems);
+   end else
+   begin
+      for i := pos - FCapacity to FStashSize - 2 do
+         FStash[i] := FStash[i + 1];
+      Dec(FStashSize);
+      FStash[FStashSize].Item := DefaultItem;
+      FStash[FStashSize].Dups := nil;
+      Dec(FSlotItems);
+   end;
+   Dec(FSize);
+end;
+
+function TCuckooHashTable.DisposeDupsAt(pos : IndexType) : SizeType;
+var
+   node, nnode : PCuckooDupNode;
+begin
+   Result := 0;
+   node := DupsAt(pos);
+   while node <> nil do
+   begin
+      nnode := node^.Next;
+      DisposeItem(node^.Item);
+      Dispose(node);
+      node := nnode;
+      Inc(Result);
+   end;
+   SetDupsAt(pos, nil);
+   Dec(FSize, Result);
+end;
+
+procedure TCuckooHashTable.CheckStash;
+var
+   attempts : SizeType;
+   grown, canShrinkSave : Boolean;
+begin
+   if FStashSize > FStashLimit then
+   begin
+      canShrinkSave := FCanShrink;
+      grown := false;
+      attempts := 0;
+      repeat
+         if not grown and ((attempts = ccMaxReseeds) or
+                              ((FSlotItems shl ccRatioFactor) shr FTableSize >=
+                                  ccGrowFillRatio)) then
+         begin
+            Rehash(1);
+            grown := true;
+         end else
+            Rehash(0);
+         Inc(attempts);
+      until (FStashSize <= ccMaxStashSize) or (attempts > ccMaxReseeds);
+
+      if grown then
+         FCanShrink := true
+      else
+         FCanShrink := canShrinkSave;
+      { the hasher returns equal hashes for too many items - do not
+        rehash again until the stash is twice as large }
+      if FStashSize > ccMaxStashSize then
+         FStashLimit := FStashSize * 2;
+   end;
+end;
+
+procedure TCuckooHashTable.CheckMinFillRatio;
+begin
+   if AutoShrink and FCanShrink and
+         ((FSlotItems shl ccRatioFactor) shr FTableSize < FMinFillRatio) and
+         (FTableSize - 1 >= ccMinTableSize) then
+   begin
+      Rehash(-1);
+      FCanShrink := true;
+   end;
+end;
+
+procedure TCuckooHashTable.CheckMaxFillRatio;
+begin
+   if (FSlotItems shl ccRatioFactor) shr FTableSize > FMaxFillRatio then
+   begin
+      Rehash(1);
+      FCanShrink := true;
+   end;
+end;
+
+procedure TCuckooHashTable.AllocateTable(tableSize : SizeType);
+var
+   buckets : array of TCuckooBucket;
+   b, j : IndexType;
+begin
+   SetLength(buckets, CalculateCapacity(tableSize) shr ccBucketShift); { may raise }
+   for b := 0 to Length(buckets) - 1 do
+   begin
+      for j := 0 to ccBucketSize - 1 do
+      begin
+         buckets[b].Tags[j] := 0;
+         _mcp_set_zero(buckets[b].Items[j]);
+      end;
+   end;
+
+   ExchangePtr(buckets, FBuckets);
+   FTableSize := tableSize;
+   FCapacity := CalculateCapacity(tableSize);
+   FBucketMask := (FCapacity shr ccBucketShift) - 1;
+   FDups := nil;
+   FStash := nil;
+   FStashSize := 0;
+   FStashLimit := ccMaxStashSize;
+   FSeed := NextRandom;
+end;
+
+procedure TCuckooHashTable.InitFields;
+begin
+   FSize := 0;
+   FSlotItems := 0;
+   FCanShrink := false;
+   FRandom := ccRandomSeed;
+   SetMinFillRatio(ccDefaultMinFillRatio);
+   SetMaxFillRatio(ccDefaultMaxFillRatio);
+   AllocateTable(ccInitialTableSize);
+end;
+
+procedure TCuckooHashTable.DisposeAllItems;
+var
+   pos : IndexType;
+begin
+   pos := NextUsedPos(0);
+   while pos <> -1 do
+   begin
+      DisposeDupsAt(pos);
+      DisposeItem(ItemAt(pos));
+      pos := NextUsedPos(pos + 1);
+   end;
+end;
+
+function TCuckooHashTable.GetCapacity : SizeType;
+begin
+   Result := FCapacity;
+end;
+
+function TCuckooHashTable.CalculateCapacity(ex : SizeType) : SizeType;
+begin
+   Result := SizeType(1) shl ex;
+end;
+
+function TCuckooHashTable.GetMaxFillRatio : SizeType;
+begin
+   Result := (FMaxFillRatio * 100) shr ccRatioFactor;
+end;
+
+procedure TCuckooHashTable.SetMaxFillRatio(fr : SizeType);
+begin
+   FMaxFillRatio := (fr shl ccRatioFactor) div 100;
+end;
+
+function TCuckooHashTable.GetMinFillRatio : SizeType;
+begin
+   Result := (FMinFillRatio * 100) shr ccRatioFactor;
+end;
+
+procedure TCuckooHashTable.SetMinFillRatio(fr : SizeType);
+begin
+   FMinFillRatio := (fr shl ccRatioFactor) div 100;
+end;
+
+{$ifdef PASCAL_ADT_STATS }
+procedure TCuckooHashTable.GetStats(var stats : TContainerStats);
+var
+   pos, bucket : IndexType;
+   len, nodes : SizeType;
+   tag : Word;
+   node : PCuckooDupNode;
+begin
+   inherited;
+   Inc(stats.UsedSlots, FSlotItems);
+   nodes := 0;
+   pos := NextUsedPos(0);
+   while pos <> -1 do
+   begin
+      if pos < FCapacity then
+      begin
+         HashItem(ItemAt(pos), bucket, tag);
+         if pos shr ccBucketShift = bucket then
+            len := 1
+         else
+            len := 2;
+      end else
+         len := 3 + pos - FCapacity;
+      AddProbeLength(stats, len);
+
+      { the equal items are reached through the list }
+      node := DupsAt(pos);
+      while node <> nil do
+      begin
+         Inc(len);
+         AddProbeLength(stats, len);
+         Inc(nodes);
+         node := node^.Next;
+      end;
+      pos := NextUsedPos(pos + 1);
+   end;
+   Inc(stats.Nodes, nodes);
+   Inc(stats.Bytes, Length(FBuckets) * SizeOf(TCuckooBucket) +
+                    Length(FDups) * SizeOf(PCuckooDupNode) +
+                    Length(FStash) * SizeOf(TCuckooStashEntry) +
+                    nodes * SizeOf(TCuckooDupNode));
+end;
+{$endif PASCAL_ADT_STATS }
+
+function TCuckooHashTable.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TCuckooHashTable.CreateCopy(self, itemCopier);
+end;
+
+procedure TCuckooHashTable.Swap(cont : TContainerAdt);
+var
+   table : TCuckooHashTable;
+begin
+   if cont is TCuckooHashTable then
+   begin
+      BasicSwap(cont);
+      table := TCuckooHashTable(cont);
+      ExchangePtr(FBuckets, table.FBuckets);
+      ExchangePtr(FDups, table.FDups);
+      ExchangePtr(FStash, table.FStash);
+      ExchangeData(FStashSize, table.FStashSize, SizeOf(SizeType));
+      ExchangeData(FStashLimit, table.FStashLimit, SizeOf(SizeType));
+      ExchangeData(FCapacity, table.FCapacity, SizeOf(SizeType));
+      ExchangeData(FBucketMask, table.FBucketMask, SizeOf(IndexType));
+      ExchangeData(FTableSize, table.FTableSize, SizeOf(SizeType));
+      ExchangeData(FSize, table.FSize, SizeOf(SizeType));
+      ExchangeData(FSlotItems, table.FSlotItems, SizeOf(SizeType));
+      ExchangeData(FMinFillRatio, table.FMinFillRatio, SizeOf(SizeType));
+      ExchangeData(FMaxFillRatio, table.FMaxFillRatio, SizeOf(SizeType));
+      ExchangeData(FCanShrink, table.FCanShrink, SizeOf(Boolean));
+      ExchangeData(FSeed, table.FSeed, SizeOf(Cardinal));
+      ExchangeData(FRandom, table.FRandom, SizeOf(Cardinal));
+   end else
+      inherited;
+end;
+
+function TCuckooHashTable.Start : TSetIterator;
+begin
+   Result := TCuckooHashTableIterator.Create(NextUsedPos(0), nil, self);
+end;
+
+function TCuckooHashTable.Finish : TSetIterator;
+begin
+   Result := TCuckooHashTableIterator.Create(-1, nil, self);
+end;
+
+&if (&_mcp_accepts_nil)
+function TCuckooHashTable.FindOrInsert(aitem : ItemType) : ItemType;
+var
+   pos : IndexType;
+begin
+   if RepeatedItems then
+   begin
+      DoInsert(aitem);
+      Result := nil;
+   end else
+   begin
+      pos := FindPos(aitem);
+      if pos <> -1 then
+      begin
+         Result := ItemAt(pos);
+      end else
+      begin
+         DoInsert(aitem);
+         Result := nil;
+      end;
+   end;
+end;
+
+function TCuckooHashTable.Find(aitem : ItemType) : ItemType;
+var
+   pos : IndexType;
+begin
+   pos := FindPos(aitem);
+   if pos <> -1 then
+      Result := ItemAt(pos)
+   else
+      Result := nil;
+end;
+&endif &# end &_mcp_accepts_nil
+
+function TCuckooHashTable.Has(aitem : ItemType) : Boolean;
+begin
+   Result := FindPos(aitem) <> -1;
+end;
+
+function TCuckooHashTable.Count(aitem : ItemType) : SizeType;
+var
+   pos : IndexType;
+   node : PCuckooDupNode;
+begin
+   pos := FindPos(aitem);
+   if pos <> -1 then
+   begin
+      Result := 1;
+      node := DupsAt(pos);
+      while node <> nil do
+      begin
+         Inc(Result);
+         node := node^.Next;
+      end;
+   end else
+      Result := 0;
+end;
+
+function TCuckooHashTable.Insert(pos : TSetIterator; aitem : ItemType) : Boolean;
+begin
+   Result := DoInsert(aitem);
+end;
+
+function TCuckooHashTable.Insert(aitem : ItemType) : Boolean;
+begin
+   Result := DoInsert(aitem);
+end;
+
+procedure TCuckooHashTable.Delete(pos : TSetIterator);
+var
+   aitem : ItemType;
+begin
+   Assert(pos is TCuckooHashTableIterator, msgInvalidIterator);
+
+   aitem := TCuckooHashTableIterator(pos).Extract;
+   DisposeItem(aitem);
+end;
+
+function TCuckooHashTable.Delete(aitem : ItemType) : SizeType;
+var
+   pos : IndexType;
+   olditem : ItemType;
+begin
+   pos := FindPos(aitem);
+   if pos <> -1 then
+   begin
+      Result := DisposeDupsAt(pos) + 1;
+      olditem := RemoveAt(pos);
+      DisposeItem(olditem);
+      CheckMinFillRatio;
+   end else
+      Result := 0;
+end;
+
+function TCuckooHashTable.LowerBound(aitem : ItemType) : TSetIterator;
+begin
+   Result := TCuckooHashTableIterator.Create(FindPos(aitem), nil, self);
+end;
+
+function TCuckooHashTable.UpperBound(aitem : ItemType) : TSetIterator;
+var
+   pos : IndexType;
+begin
+   pos := FindPos(aitem);
+   if pos <> -1 then
+      pos := NextUsedPos(pos + 1);
+   Result := TCuckooHashTableIterator.Create(pos, nil, self);
+end;
+
+function TCuckooHashTable.EqualRange(aitem : ItemType) : TSetIteratorRange;
+var
+   pos1, pos2 : IndexType;
+begin
+   pos1 := FindPos(aitem);
+   if pos1 <> -1 then
+      pos2 := NextUsedPos(pos1 + 1)
+   else
+      pos2 := -1;
+   Result := TSetIteratorRange.Create(
+      TCuckooHashTableIterator.Create(pos1, nil, self),
+      TCuckooHashTableIterator.Create(pos2, nil, self)
+                                     );
+end;
+
+procedure TCuckooHashTable.Rehash(ex : SizeType);
+var
+   buckets : array of TCuckooBucket;
+   dups, newDups : array of PCuckooDupNode;
+   stash : array of TCuckooStashEntry;
+   stashSize : SizeType;
+   b, j, bucket : IndexType;
+   tag : Word;
+   node : PCuckooDupNode;
+begin
+   Assert(FTableSize + ex >= ccMinTableSize, msgContainerTooSmall);
+
+   if Length(FDups) <> 0 then
+      SetLength(newDups, CalculateCapacity(FTableSize + ex)); { may raise }
+
+   { take the old arrays over; AllocateTable may raise only before
+     changing anything }
+   ExchangePtr(buckets, FBuckets);
+   ExchangePtr(dups, FDups);
+   ExchangePtr(stash, FStash);
+   stashSize := FStashSize;
+   try
+      AllocateTable(FTableSize + ex); { may raise }
+   except
+      ExchangePtr(buckets, FBuckets);
+      ExchangePtr(dups, FDups);
+      ExchangePtr(stash, FStash);
+      raise;
+   end;
+   ExchangePtr(newDups, FDups);
+
+   { the items are moved rather than copied, so only the stash may need
+     more memory }
+   for b := 0 to Length(buckets) - 1 do
+   begin
+      for j := 0 to ccBucketSize - 1 do
+      begin
+         if buckets[b].Tags[j] <> 0 then
+         begin
+            if (buckets[b].Tags[j] and ccDupsFlag) <> 0 then
+               node := dups[(b shl ccBucketShift) + j]
+            else
+               node := nil;
+            HashItem(buckets[b].Items[j], bucket, tag);
+            PlaceItem(buckets[b].Items[j], bucket, tag, node);
+         end;
+      end;
+   end;
+   for j := 0 to stashSize - 1 do
+   begin
+      HashItem(stash[j].Item, bucket, tag);
+      PlaceItem(stash[j].Item, bucket, tag, stash[j].Dups);
+   end;
+
+   FCanShrink := false;
+{$ifdef PASCAL_ADT_STATS }
+   Inc(FStats.Rehashes);
+{$endif PASCAL_ADT_STATS }
+end;
+
+procedure TCuckooHashTable.Clear;
+begin
+   DisposeAllItems;
+   FSize := 0;
+   FSlotItems := 0;
+   FCanShrink := false;
+   AllocateTable(ccInitialTableSize);
+
+   GrabageCollector.FreeObjects;
+end;
+
+function TCuckooHashTable.Empty : Boolean;
+begin
+   Result := FSize = 0;
+end;
+
+function TCuckooHashTable.Size : SizeType;
+begin
+   Result := FSize;
+end;
+
+function TCuckooHashTable.MinCapacity : SizeType;
+begin
+   Result := CalculateCapacity(ccMinTableSize);
+end;
+
+
+{ ------------------------ TCuckooHashTableIterator -------------------------- }
+
+constructor TCuckooHashTableIterator.Create(apos : IndexType; adup : PCuckooDupNode;
+                                            tab : TCuckooHashTable);
+begin
+   inherited Create(tab);
+   FPos := apos;
+   FDup := adup;
+   FTable := tab;
+end;
+
+function TCuckooHashTableIterator.CopySelf : TIterator;
+begin
+   Result := TCuckooHashTableIterator.Create(FPos, FDup, FTable);
+end;
+
+function TCuckooHashTableIterator.Equal(const Pos : TIterator) : Boolean;
+begin
+   Assert(pos is TCuckooHashTableIterator, msgInvalidIterator);
+   Result := (TCuckooHashTableIterator(pos).FPos = FPos) and
+      (TCuckooHashTableIterator(pos).FDup = FDup);
+end;
+
+function TCuckooHashTableIterator.GetItem : ItemType;
+begin
+   Assert(FPos <> -1, msgReadingInvalidIterator);
+
+   if FDup <> nil then
+      Result := FDup^.Item
+   else
+      Result := FTable.ItemAt(FPos);
+end;
+
+procedure TCuckooHashTableIterator.SetItem(aitem : ItemType);
+var
+   olditem : ItemType;
+begin
+   Assert(FPos <> -1, msgReadingInvalidIterator);
+
+   with FTable do
+   begin
+      olditem := self.GetItem;
+      if _mcp_equal(olditem, aitem) then
+      begin
+         DisposeItem(olditem);
+         if self.FDup <> nil then
+            self.FDup^.Item := aitem
+         else if self.FPos < FCapacity then
+         begin
+            FBuckets[self.FPos shr ccBucketShift].
+               Items[self.FPos and (ccBucketSize - 1)] := aitem;
+         end else
+            FStash[self.FPos - FCapacity].Item := aitem;
+      end else
+      begin
+         olditem := self.Extract;
+         DisposeItem(olditem);
+         self.Insert(aitem);
+      end;
+   end;
+end;
+
+procedure TCuckooHashTableIterator.ResetItem;
+begin
+   Insert(Extract);
+end;
+
+procedure TCuckooHashTableIterator.Advance;
+begin
+   Assert(FPos <> -1, msgAdvancingInvalidIterator);
+
+   if FDup <> nil then
+      FDup := FDup^.Next
+   else
+      FDup := FTable.DupsAt(FPos);
+   if FDup = nil then
+      FPos := FTable.NextUsedPos(FPos + 1);
+end;
+
+procedure TCuckooHashTableIterator.Retreat;
+var
+   node : PCuckooDupNode;
+begin
+   if FDup <> nil then
+   begin
+      node := FTable.DupsAt(FPos);
+      if node = FDup then
+      begin
+         FDup := nil;
+      end else
+      begin
+         while node^.Next <> FDup do
+            node := node^.Next;
+         FDup := node;
+      end;
+   end else
+   begin
+      if FPos = -1 then
+         FPos := FTable.PrevUsedPos(FTable.FCapacity + FTable.FStashSize - 1)
+      else
+         FPos := FTable.PrevUsedPos(FPos - 1);
+      Assert(FPos <> -1, msgRetreatingStartIterator);
+
+      { move to the last of the items equal to the one at FPos }
+      FDup := FTable.DupsAt(FPos);
+      if FDup <> nil then
+      begin
+         while FDup^.Next <> nil do
+            FDup := FDup^.Next;
+      end;
+   end;
+end;
+
+procedure TCuckooHashTableIterator.Insert(aitem : ItemType);
+begin
+   if FTable.DoInsert(aitem) then
+   begin
+      { an item equal to an item already in the table is put at the
+        front of its list }
+      FPos := FTable.FindPos(aitem);
+      FDup := FTable.DupsAt(FPos);
+   end else
+   begin
+      FPos := -1;
+      FDup := nil;
+   end;
+end;
+
+function TCuckooHashTableIterator.Extract : ItemType;
+var
+   node, nnode : PCuckooDupNode;
+   hadDups : Boolean;
+begin
+   Assert(FPos <> -1, msgDeletingInvalidIterator);
+
+   with FTable do
+   begin
+      if self.FDup <> nil then
+      begin
+         node := DupsAt(self.FPos);
+         nnode := self.FDup^.Next;
+         if node = self.FDup then
+         begin
+            SetDupsAt(self.FPos, nnode);
+         end else
+         begin
+            while node^.Next <> self.FDup do
+               node := node^.Next;
+            node^.Next := nnode;
+         end;
+         Result := self.FDup^.Item;
+         Dispose(self.FDup);
+         Dec(FSize);
+
+         self.FDup := nnode;
+         if nnode = nil then
+            self.FPos := NextUsedPos(self.FPos + 1);
+      end else
+      begin
+         hadDups := DupsAt(self.FPos) <> nil;
+         Result := RemoveAt(self.FPos);
+         { if there were equal items then the first of them is now at
+           FPos; if an entry of the stash has been removed then the
+           next entry has been moved to FPos }
+         if not hadDups then
+         begin
+            if self.FPos < FCapacity then
+               self.FPos := NextUsedPos(self.FPos + 1)
+            else
+               self.FPos := NextUsedPos(self.FPos);
+         end;
+      end;
+   end;
+end;
+
+function TCuckooHashTableIterator.Owner : TContainerAdt;
+begin
+   Result := FTable;
+end;
+
+function TCuckooHashTableIterator.IsStart : Boolean;
+begin
+   Result := (FDup = nil) and (FPos = FTable.NextUsedPos(0));
+end;
+
+function TCuckooHashTableIterator.IsFinish : Boolean;
+begin
+   Result := FPos = -1;
+end;
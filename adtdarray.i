@@ -50,6 +50,10 @@ type
    TDynamicArrayRec = record
       StartIndex : IndexType;
       Size, Capacity : SizeType;
+{$ifdef PASCAL_ADT_STATS }
+      { the number of times the array has been reallocated }
+      Resizes : SizeType;
+{$endif PASCAL_ADT_STATS }
       Items : array of ItemType
    end;
    { @See TDynamicArrayRec }
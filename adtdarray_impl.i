@@ -103,6 +103,9 @@ begin
    a^.Size := 0;
    a^.Capacity := capacity;
    a^.StartIndex := StartIndex;
+{$ifdef PASCAL_ADT_STATS }
+   a^.Resizes := 0;
+{$endif PASCAL_ADT_STATS }
    Assert(ConsistentArray(a));
 end;
 
@@ -115,6 +118,9 @@ begin
    begin
       SetLength(a^.Items, newcap);
       a^.Capacity := newcap;
+{$ifdef PASCAL_ADT_STATS }
+      Inc(a^.Resizes);
+{$endif PASCAL_ADT_STATS }
    end;
 end;
 
@@ -171,8 +177,6 @@ end;
 
 procedure ArrayReserveItems(var a : TDynamicArray; index : IndexType;
                             n : SizeType);
-var
-   i : IndexType;
 begin
    Assert(a <> nil, msgNilArray);
    Assert(ConsistentArray(a));
@@ -186,16 +190,14 @@ begin
       end;
       with a^ do
       begin
-         for i := StartIndex + Size + n - 1 downto StartIndex + index + n do
-            Items[i] := Items[i - n];
+         RelocateItems(Items[StartIndex + index], Items[StartIndex + index + n],
+                       Size - index);
          Inc(Size, n);
       end;
    end;
 end;
 
 procedure ArrayRemoveItems(a : TDynamicArray; index : IndexType; n : SizeType);
-var
-   i : IndexType;
 begin
    Assert(a <> nil, msgNilArray);
    Assert(ConsistentArray(a));
@@ -204,8 +206,8 @@ begin
    begin
       with a^ do
       begin
-         for i := StartIndex + index to StartIndex + Size - n do
-            Items[i] := Items[i + n];
+         RelocateItems(Items[StartIndex + index + n], Items[StartIndex + index],
+                       Size - index - n);
          Dec(Size, n);
       end;
    end;
@@ -233,7 +235,7 @@ begin
             begin
                StartIndex := (Capacity - Size) div 2;
             end;
-            SafeMove(Items[0], Items[StartIndex + 1], Size);
+            RelocateItems(Items[0], Items[StartIndex + 1], Size);
          end else
          begin
             Dec(StartIndex);
@@ -274,7 +276,7 @@ begin
       begin
 	 if iftomove then
 	 begin
-	    SafeMove(Items[StartIndex + 1], Items[StartIndex], Size);
+	    RelocateItems(Items[StartIndex + 1], Items[StartIndex], Size);
 	 end else 
 	    Inc(StartIndex);
       end;
@@ -444,7 +446,13 @@ procedure ArrayCircularMove(a : TDynamicArray;
 var
    source, dest, finish, destptr : PItemType;
    decr : SizeType;
+&if (&_mcp_is_plain_data(&ItemType&))
    temp : ItemType;
+&else
+   { the items are exchanged bit by bit, without adjusting reference
+     counts }
+   temp : array[0..SizeOf(ItemType) - 1] of Byte;
+&endif
 begin
    Assert(a <> nil, msgNilArray);
    Assert(ConsistentArray(a));
@@ -465,9 +473,15 @@ begin
    
    while n <> 0 do
    begin
+&if (&_mcp_is_plain_data(&ItemType&))
       temp := dest^;
       dest^ := source^;
       source^ := temp;
+&else
+      system.Move(dest^, temp, SizeOf(ItemType));
+      system.Move(source^, dest^, SizeOf(ItemType));
+      system.Move(temp, source^, SizeOf(ItemType));
+&endif
       
       Inc(dest);
       if dest = finish then
@@ -505,15 +519,18 @@ begin
 	 tomove := capacity - StartIndex
       else
 	 tomove := Size;
-      { is this ok? does it work with Strings? are the references
-        automatically adjusted or not? }
-      SafeMove(Items[StartIndex], buf^.Items[0], tomove);
+      { the items are relocated, so the old array holds only nils
+        afterwards and freeing it does not release any references }
+      RelocateItems(Items[StartIndex], buf^.Items[0], tomove);
       if StartIndex + Size > capacity then
       begin
-	 SafeMove(Items[0], buf^.Items[tomove], (StartIndex + Size - capacity));
+	 RelocateItems(Items[0], buf^.Items[tomove], (StartIndex + Size - capacity));
       end;
       buf^.Size := Size;
       buf^.Capacity := newcap;
+{$ifdef PASCAL_ADT_STATS }
+      buf^.Resizes := Resizes + 1;
+{$endif PASCAL_ADT_STATS }
       a^.Items := nil;
       Dispose(a);
    end;
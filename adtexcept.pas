@@ -63,6 +63,13 @@ type
    public
       constructor Create;
    end;
+
+   { raised by LoadFromStream when the data read from the stream is not
+     a valid snapshot of the container }
+   EInvalidStreamFormat = class (EPascalAdt)
+   public
+      constructor Create(s : String);
+   end;
    
 
 implementation
@@ -102,5 +109,10 @@ begin
    inherited Create(msgInternalError);
 end;
 
+constructor EInvalidStreamFormat.Create(s : String);
+begin
+   inherited Create(s);
+end;
+
 
 end.
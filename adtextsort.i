@@ -0,0 +1,149 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtextsort.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtextsort.defs
+
+type
+   TExternalSortRunWriter = class;
+
+   { sorts sequences of items which do not fit in memory; the items are
+     read with @<Streamer> from a stream until its end, in runs of at
+     most @<RunSize> items; each run is sorted in memory with
+     StableSort and written to a temporary file in
+     @<TempDirectory>; then the runs are merged, at most @<MaxFanIn>
+     at a time, until the last merge writes the sorted sequence to the
+     destination; if @<OverlapIo> is true the runs are sorted and
+     written by a separate thread while the next run is being read,
+     so two runs are kept in memory at once; all the files are read
+     and written sequentially through buffers of @<BufferSize> bytes;
+     the sort is stable; the temporary files are deleted even if an
+     exception is raised; @complexity O(n*log(n)) comparisons and
+     O(n*log(n/RunSize)/log(MaxFanIn)) item reads and writes;
+     @memory-usage O(RunSize + MaxFanIn*BufferSize) }
+   TExternalSorter = class
+   private
+      FComparer : IBinaryComparer;
+      FStreamer : IStreamer;
+      FRun, FSpareRun : TArray;
+      FRunSize : SizeType;
+      FBufferSize : SizeType;
+      FMaxFanIn : SizeType;
+      FTempDirectory : String;
+      FOverlapIo : Boolean;
+      { the names and the numbers of items of the runs still to be
+        merged are at the indices [FFirstRun,FRunCount) }
+      FRunFiles : array of String;
+      FRunSizes : array of SizeType;
+      FFirstRun, FRunCount : SizeType;
+      FFileCounter : SizeType;
+
+      function GetItemDisposer : IUnaryFunctor;
+      procedure SetItemDisposer(const disposer : IUnaryFunctor);
+      procedure SetRunSize(asize : SizeType);
+      procedure SetBufferSize(asize : SizeType);
+      procedure SetMaxFanIn(afanIn : SizeType);
+      { returns the name of the file for the next run and records it
+        as the last run, with <num> items }
+      function AddRunFile(num : SizeType) : String;
+      { reads at most RunSize items from <source> into <run>; returns
+        false if there are no more items }
+      function ReadRun(source : TStream; run : TArray) : Boolean;
+      { sorts <run>, writes it to the file <fileName> and clears it }
+      procedure WriteRun(run : TArray; const fileName : String);
+      { reads <source> and writes the sorted runs }
+      procedure CreateRuns(source : TStream);
+      { merges <num> runs starting with FFirstRun and removes them;
+        writes the result to <destStream> if it is not nil and to
+        <destIter> otherwise }
+      procedure MergeRuns(num : SizeType; destStream : TStream;
+                          destIter : TOutputIterator);
+      { merges the runs until at most MaxFanIn are left and then merges
+        the remaining ones into the destination }
+      procedure MergeAll(destStream : TStream; destIter : TOutputIterator);
+      { deletes the files of all the runs not merged yet }
+      procedure DeleteRunFiles;
+
+   public
+      { creates a sorter ordering the items according to <comparer>
+        and reading and writing them with <streamer>; <streamer> may
+        be nil for the types which have a default binary
+        representation (see StreamWriteItem) }
+      constructor Create(const comparer : IBinaryComparer;
+                         const streamer : IStreamer);
+      destructor Destroy; override;
+      { reads all the items from the current position of <source> to
+        its end and writes them to <dest> in sorted order; the items
+        are read and written with Streamer }
+      procedure Sort(source, dest : TStream); overload;
+      { reads all the items from the current position of <source> to
+        its end and writes them in sorted order to <dest>, which takes
+        over their ownership }
+      procedure Sort(source : TStream; dest : TOutputIterator); overload;
+
+      property ItemComparer : IBinaryComparer read FComparer;
+      property Streamer : IStreamer read FStreamer;
+      { the maximal number of items sorted in memory at once; must be
+        at least 1 }
+      property RunSize : SizeType read FRunSize write SetRunSize;
+      { the size in bytes of the buffer used for every stream read or
+        written; must be at least 1 }
+      property BufferSize : SizeType read FBufferSize write SetBufferSize;
+      { the maximal number of runs merged at once; must be at least 2 }
+      property MaxFanIn : SizeType read FMaxFanIn write SetMaxFanIn;
+      { the directory for the temporary files; the default one of the
+        system if empty }
+      property TempDirectory : String read FTempDirectory write FTempDirectory;
+      { if true the runs are sorted and written by a separate thread
+        while the next one is being read; the comparer and the
+        streamer must then be safe to use from two threads at once }
+      property OverlapIo : Boolean read FOverlapIo write FOverlapIo;
+      { the functor used to dispose the items written to a stream; nil
+        by default, which means the default disposal for the type }
+      property ItemDisposer : IUnaryFunctor read GetItemDisposer
+                                            write SetItemDisposer;
+   end;
+
+   { sorts and writes one run in a separate thread; used by
+     TExternalSorter }
+   TExternalSortRunWriter = class (TThread)
+   private
+      FSorter : TExternalSorter;
+      FRun : TArray;
+      FFileName : String;
+      FError : TObject;
+   protected
+      procedure Execute; override;
+   public
+      constructor Create(sorter : TExternalSorter; run : TArray;
+                         const fileName : String);
+      { waits for the thread to finish and destroys it; the exception
+        raised in the thread, if any, is freed }
+      destructor Destroy; override;
+      { waits for the thread to finish, destroys it and re-raises the
+        exception raised in it, if any }
+      procedure Finish;
+   end;
@@ -0,0 +1,458 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtextsort_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtextsort.defs
+&include adtextsort_impl.mcp
+
+{ -------------------------- TExternalSorter ------------------------------- }
+
+constructor TExternalSorter.Create(const comparer : IBinaryComparer;
+                                   const streamer : IStreamer);
+begin
+   inherited Create;
+   FComparer := comparer;
+   FStreamer := streamer;
+   FRunSize := esDefaultRunSize;
+   FBufferSize := esDefaultBufferSize;
+   FMaxFanIn := esDefaultMaxFanIn;
+   FTempDirectory := '';
+   FOverlapIo := false;
+   FFirstRun := 0;
+   FRunCount := 0;
+   FFileCounter := 0;
+   FRun := TArray.Create;
+   FSpareRun := TArray.Create;
+end;
+
+destructor TExternalSorter.Destroy;
+begin
+   DeleteRunFiles;
+   FRun.Free;
+   FSpareRun.Free;
+   inherited;
+end;
+
+function TExternalSorter.GetItemDisposer : IUnaryFunctor;
+begin
+   Result := FRun.ItemDisposer;
+end;
+
+procedure TExternalSorter.SetItemDisposer(const disposer : IUnaryFunctor);
+begin
+   FRun.ItemDisposer := disposer;
+   FSpareRun.ItemDisposer := disposer;
+end;
+
+procedure TExternalSorter.SetRunSize(asize : SizeType);
+begin
+   if asize < 1 then
+      raise EInvalidArgument.Create('TExternalSorter.SetRunSize');
+   FRunSize := asize;
+end;
+
+procedure TExternalSorter.SetBufferSize(asize : SizeType);
+begin
+   if asize < 1 then
+      raise EInvalidArgument.Create('TExternalSorter.SetBufferSize');
+   FBufferSize := asize;
+end;
+
+procedure TExternalSorter.SetMaxFanIn(afanIn : SizeType);
+begin
+   if afanIn < 2 then
+      raise EInvalidArgument.Create('TExternalSorter.SetMaxFanIn');
+   FMaxFanIn := afanIn;
+end;
+
+function TExternalSorter.AddRunFile(num : SizeType) : String;
+var
+   dir : String;
+   pid : Cardinal;
+begin
+   dir := FTempDirectory;
+   if dir = '' then
+   begin
+{$ifdef FPC }
+      dir := GetTempDir;
+{$else }
+      dir := GetEnvironmentVariable('TEMP');
+{$endif }
+   end;
+   { the address of self is unique only within the process, so two
+     programs sorting at once in the same directory could otherwise
+     overwrite each other's runs }
+{$ifdef FPC }
+   pid := Cardinal(GetProcessID);
+{$else }
+   pid := GetCurrentProcessId;
+{$endif }
+   Result := IncludeTrailingPathDelimiter(dir) + 'adtsort' +
+                IntToHex(pid, 8) + '_' +
+                IntToHex(PointerValueType(self), 2*SizeOf(Pointer)) + '_' +
+                IntToStr(FFileCounter) + '.tmp';
+   Inc(FFileCounter);
+
+   if FRunCount = SizeType(Length(FRunFiles)) then
+   begin
+      SetLength(FRunFiles, 2*FRunCount + 8);
+      SetLength(FRunSizes, 2*FRunCount + 8);
+   end;
+   FRunFiles[FRunCount] := Result;
+   FRunSizes[FRunCount] := num;
+   Inc(FRunCount);
+end;
+
+function TExternalSorter.ReadRun(source : TStream; run : TArray) : Boolean;
+var
+   aitem : ItemType;
+begin
+   Assert(run.Empty);
+
+   while (run.Size < FRunSize) and not TBlockStream(source).AtEnd do
+   begin
+      aitem := DefaultItem;
+      StreamReadItem(source, aitem, FStreamer);
+      try
+         run.PushBack(aitem);
+      except
+         with run do
+            DisposeItem(aitem);
+         raise;
+      end;
+   end;
+   Result := not run.Empty;
+end;
+
+procedure TExternalSorter.WriteRun(run : TArray; const fileName : String);
+var
+   fileStream : TFileStream;
+   output : TBlockStream;
+   i : IndexType;
+begin
+   try
+      StableSort(run.RandomAccessStart, run.RandomAccessFinish, FComparer);
+
+      output := nil;
+      fileStream := TFileStream.Create(fileName, fmCreate);
+      try
+         output := TBlockStream.Create(fileStream, FBufferSize, true);
+         for i := 0 to run.Size - 1 do
+            StreamWriteItem(output, run.GetItem(i), FStreamer);
+         output.Flush;
+      finally
+         output.Free;
+         fileStream.Free;
+      end;
+   finally
+      run.Clear;
+   end;
+end;
+
+procedure TExternalSorter.CreateRuns(source : TStream);
+var
+   input : TBlockStream;
+   writer, finished : TExternalSortRunWriter;
+   fileName : String;
+   temp : TArray;
+begin
+   writer := nil;
+   input := TBlockStream.Create(source, FBufferSize, false);
+   try
+      while ReadRun(input, FRun) do
+      begin
+         fileName := AddRunFile(FRun.Size);
+         if FOverlapIo then
+         begin
+            { FSpareRun is free only when the previous run is written }
+            if writer <> nil then
+            begin
+               finished := writer;
+               writer := nil;
+               finished.Finish; { may raise }
+            end;
+            temp := FRun;
+            FRun := FSpareRun;
+            FSpareRun := temp;
+            writer := TExternalSortRunWriter.Create(self, FSpareRun, fileName);
+         end else
+            WriteRun(FRun, fileName);
+      end;
+
+      if writer <> nil then
+      begin
+         finished := writer;
+         writer := nil;
+         finished.Finish; { may raise }
+      end;
+   finally
+      input.Free;
+      { only if an exception is being propagated; waits for the thread
+        and drops its exception, so that it does not hide this one }
+      writer.Free;
+   end;
+end;
+
+procedure TExternalSorter.MergeRuns(num : SizeType; destStream : TStream;
+                                    destIter : TOutputIterator);
+var
+   files : array of TFileStream;
+   inputs : array of TBlockStream;
+   items : array of ItemType;
+   left : array of SizeType;
+   { the indices of the runs which have a current item, ordered into
+     a binary min-heap by their current items and, for equal items,
+     by their indices, which makes the merge stable }
+   heap : array of SizeType;
+   total : SizeType;
+   heapSize, i, r : IndexType;
+   outFile : TFileStream;
+   output : TBlockStream;
+   aitem : ItemType;
+
+   function Less(a, b : SizeType) : Boolean;
+   var
+      c : IndexType;
+   begin
+      _mcp_compare_assign(items[a], items[b], c, FComparer);
+      Result := (c < 0) or ((c = 0) and (a < b));
+   end;
+
+   procedure SiftDown(i : IndexType);
+   var
+      c : IndexType;
+      top : SizeType;
+   begin
+      top := heap[i];
+      c := 2*i + 1;
+      while c < heapSize do
+      begin
+         if (c + 1 < heapSize) and Less(heap[c + 1], heap[c]) then
+            Inc(c);
+         if not Less(heap[c], top) then
+            break;
+         heap[i] := heap[c];
+         i := c;
+         c := 2*i + 1;
+      end;
+      heap[i] := top;
+   end;
+
+   { reads the next item of the k-th run into items[k]; returns false
+     if the run is exhausted }
+   function ReadNext(k : SizeType) : Boolean;
+   begin
+      Result := left[k] <> 0;
+      if Result then
+      begin
+         StreamReadItem(inputs[k], items[k], FStreamer);
+         Dec(left[k]);
+      end;
+   end;
+
+begin
+   Assert((num > 0) and (FFirstRun + num <= FRunCount));
+
+   SetLength(files, num);
+   SetLength(inputs, num);
+   SetLength(items, num);
+   SetLength(left, num);
+   SetLength(heap, num);
+   heapSize := 0;
+   outFile := nil;
+   output := nil;
+   total := 0;
+   try
+      for r := 0 to num - 1 do
+      begin
+         files[r] := nil;
+         inputs[r] := nil;
+         items[r] := DefaultItem;
+         left[r] := FRunSizes[FFirstRun + r];
+         Inc(total, left[r]);
+      end;
+      for r := 0 to num - 1 do
+      begin
+         files[r] := TFileStream.Create(FRunFiles[FFirstRun + r],
+                                        fmOpenRead or fmShareDenyWrite);
+         inputs[r] := TBlockStream.Create(files[r], FBufferSize, false);
+      end;
+
+      if destStream <> nil then
+         output := TBlockStream.Create(destStream, FBufferSize, true)
+      else if destIter = nil then
+      begin
+         { an intermediate merge - write a new run }
+         outFile := TFileStream.Create(AddRunFile(total), fmCreate);
+         output := TBlockStream.Create(outFile, FBufferSize, true);
+      end;
+
+      for r := 0 to num - 1 do
+      begin
+         if ReadNext(r) then
+         begin
+            heap[heapSize] := r;
+            Inc(heapSize);
+         end;
+      end;
+      for i := heapSize div 2 - 1 downto 0 do
+         SiftDown(i);
+
+      while heapSize <> 0 do
+      begin
+         r := heap[0];
+         aitem := items[r];
+         items[r] := DefaultItem;
+         if output <> nil then
+         begin
+            try
+               StreamWriteItem(output, aitem, FStreamer);
+            finally
+               with FRun do
+                  DisposeItem(aitem);
+            end;
+         end else
+            destIter.Write(aitem);
+
+         if not ReadNext(r) then
+         begin
+            Dec(heapSize);
+            heap[0] := heap[heapSize];
+         end;
+         if heapSize <> 0 then
+            SiftDown(0);
+      end;
+
+      if output <> nil then
+         output.Flush;
+
+   finally
+      for r := 0 to num - 1 do
+      begin
+         aitem := items[r];
+         with FRun do
+            DisposeItem(aitem);
+         inputs[r].Free;
+         files[r].Free;
+      end;
+      output.Free;
+      outFile.Free;
+   end;
+
+   for r := FFirstRun to FFirstRun + num - 1 do
+   begin
+      DeleteFile(FRunFiles[r]);
+      FRunFiles[r] := '';
+   end;
+   Inc(FFirstRun, num);
+end;
+
+procedure TExternalSorter.MergeAll(destStream : TStream;
+                                   destIter : TOutputIterator);
+begin
+   while FRunCount - FFirstRun > FMaxFanIn do
+      MergeRuns(FMaxFanIn, nil, nil);
+   if FRunCount > FFirstRun then
+      MergeRuns(FRunCount - FFirstRun, destStream, destIter);
+end;
+
+procedure TExternalSorter.DeleteRunFiles;
+var
+   r : IndexType;
+begin
+   for r := FFirstRun to FRunCount - 1 do
+      DeleteFile(FRunFiles[r]);
+   FRunFiles := nil;
+   FRunSizes := nil;
+   FFirstRun := 0;
+   FRunCount := 0;
+end;
+
+procedure TExternalSorter.Sort(source, dest : TStream);
+begin
+   Assert(dest <> nil, msgInvalidArgument);
+   try
+      CreateRuns(source);
+      MergeAll(dest, nil);
+   finally
+      FRun.Clear;
+      FSpareRun.Clear;
+      DeleteRunFiles;
+   end;
+end;
+
+procedure TExternalSorter.Sort(source : TStream; dest : TOutputIterator);
+begin
+   Assert(dest <> nil, msgInvalidArgument);
+   try
+      CreateRuns(source);
+      MergeAll(nil, dest);
+   finally
+      FRun.Clear;
+      FSpareRun.Clear;
+      DeleteRunFiles;
+   end;
+end;
+
+{ ----------------------- TExternalSortRunWriter --------------------------- }
+
+constructor TExternalSortRunWriter.Create(sorter : TExternalSorter;
+                                          run : TArray;
+                                          const fileName : String);
+begin
+   FSorter := sorter;
+   FRun := run;
+   FFileName := fileName;
+   FError := nil;
+   inherited Create(false);
+end;
+
+procedure TExternalSortRunWriter.Execute;
+begin
+   try
+      FSorter.WriteRun(FRun, FFileName);
+   except
+      FError := TObject(AcquireExceptionObject);
+   end;
+end;
+
+destructor TExternalSortRunWriter.Destroy;
+begin
+   inherited; { waits for the thread }
+   FError.Free;
+end;
+
+procedure TExternalSortRunWriter.Finish;
+var
+   error : TObject;
+begin
+   WaitFor;
+   error := FError;
+   FError := nil;
+   Free;
+   if error <> nil then
+      raise error;
+end;
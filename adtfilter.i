@@ -0,0 +1,321 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtfilter.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtfilter.defs
+
+type
+   { the base class of approximate membership filters; a filter
+     remembers the hashes of the items added to it and answers
+     whether an item may have been added; it never answers 'no' for
+     an item that has been added (and not removed), but it may answer
+     'yes' for an item that has not been added; the probability of
+     that is the false positive rate of the filter; the items
+     themselves are not stored, so a filter never owns or disposes
+     items }
+   TSetFilter = class
+   private
+      FHasher : IHasher;
+
+   protected
+      { the number of hashes added and not removed }
+      FCount : SizeType;
+
+      { <hasher> may be nil, in which case the default hasher for the
+        type of items is used }
+      constructor Create(const hasher : IHasher);
+
+   public
+      { returns a copy of self, containing the same hashes }
+      function CopySelf : TSetFilter; virtual; abstract;
+      { returns the hash of <aitem> used by the filter }
+      function HashOf(aitem : ItemType) : UnsignedType;
+      { adds <aitem> to the filter; returns false if the filter is full
+        and the item could not be added }
+      function Add(aitem : ItemType) : Boolean;
+      { returns false if <aitem> has certainly not been added to the
+        filter, or true if it may have been }
+      function MayContain(aitem : ItemType) : Boolean;
+      { removes <aitem> from the filter; returns false if it is not
+        there or the filter does not support removing items; @<aitem>
+        must have been added to the filter before, otherwise another
+        item may be removed instead }
+      function Remove(aitem : ItemType) : Boolean;
+      { the same as @<Add>, but takes the result of @<HashOf> }
+      function AddHash(hash : UnsignedType) : Boolean; virtual; abstract;
+      { the same as @<MayContain>, but takes the result of @<HashOf> }
+      function MayContainHash(hash : UnsignedType) : Boolean; virtual; abstract;
+      { the same as @<Remove>, but takes the result of @<HashOf> }
+      function RemoveHash(hash : UnsignedType) : Boolean; virtual; abstract;
+      { returns true if items may be removed from the filter }
+      function CanRemove : Boolean; virtual; abstract;
+      { removes all the items from the filter }
+      procedure Clear; virtual; abstract;
+      { returns the number of bytes used by the filter }
+      function MemoryUsage : SizeType; virtual; abstract;
+      { the number of items added and not removed }
+      property Count : SizeType read FCount;
+      { the hasher used to hash the items }
+      property Hasher : IHasher read FHasher;
+   end;
+
+   { a blocked Bloom filter; each item sets 8 bits in one 32-byte
+     block chosen by its hash, so that adding or querying an item
+     accesses only one cache line; items cannot be removed; the
+     filter never becomes full, but its false positive rate grows as
+     more items are added than it has been created for }
+   TBloomFilter = class (TSetFilter)
+   private
+      FBlocks : array of TBloomFilterBlock;
+      { the number of blocks - 1; the number of blocks is a power of
+        2 }
+      FMask : Cardinal;
+
+   public
+      { creates a filter for <capacity> items using about <bitsPerItem>
+        bits per item (rounded up so that the number of blocks is a
+        power of 2); with 8 bits per item the false positive rate is
+        about 2%, with 10 bits about 1%, with 16 bits about 0.1%;
+        <hasher> may be nil, in which case the default hasher for the
+        type of items is used }
+      constructor Create(capacity : SizeType; bitsPerItem : Integer;
+                         const hasher : IHasher); overload;
+      { creates a filter for <capacity> items using
+        bfDefaultBitsPerItem bits per item and the default hasher }
+      constructor Create(capacity : SizeType); overload;
+      constructor CreateCopy(const filter : TBloomFilter);
+      function CopySelf : TSetFilter; override;
+      { @complexity O(1) }
+      function AddHash(hash : UnsignedType) : Boolean; override;
+      { @complexity O(1) }
+      function MayContainHash(hash : UnsignedType) : Boolean; override;
+      { does nothing and returns false }
+      function RemoveHash(hash : UnsignedType) : Boolean; override;
+      { returns false }
+      function CanRemove : Boolean; override;
+      procedure Clear; override;
+      function MemoryUsage : SizeType; override;
+   end;
+
+   { a cuckoo filter with 16-bit fingerprints and buckets of 4
+     fingerprints; an item is represented by its fingerprint, stored
+     in one of two buckets determined by the hash of the item and by
+     the fingerprint; the false positive rate is about 0.01% and does
+     not depend on the number of items, but the filter may become
+     full, after which @<Add> fails; this happens only if it has been
+     filled above about 95% of its capacity, or if the same item is
+     added more than about 8 times; items may be removed }
+   TCuckooFilter = class (TSetFilter)
+   private
+      FBuckets : array of TCuckooFilterBucket;
+      { the number of buckets - 1; the number of buckets is a power of
+        2 }
+      FMask : Cardinal;
+      { the state of the random number generator choosing the
+        fingerprints to move }
+      FRandom : Cardinal;
+      { a fingerprint for which there was no place in the buckets; as
+        long as it is set the filter is full }
+      FVictimUsed : Boolean;
+      FVictimFingerprint : Word;
+      FVictimIndex : Cardinal;
+
+      { computes the index of the first bucket and the fingerprint of
+        an item with the given hash }
+      procedure IndexAndFingerprint(hash : UnsignedType; var index : Cardinal;
+                                    var fingerprint : Word);
+      { returns the other bucket the fingerprint may be in }
+      function AltIndex(index : Cardinal; fingerprint : Word) : Cardinal;
+      { puts the fingerprint into an empty slot of the bucket; returns
+        false if there is none }
+      function PlaceInBucket(index : Cardinal; fingerprint : Word) : Boolean;
+      { removes one copy of the fingerprint from the bucket; returns
+        false if it is not there }
+      function RemoveFromBucket(index : Cardinal; fingerprint : Word) : Boolean;
+      { puts the fingerprint into the bucket or its alternative,
+        moving other fingerprints to their alternative buckets if
+        necessary; if this fails the fingerprint left without place is
+        stored as the victim }
+      procedure InsertFingerprint(index : Cardinal; fingerprint : Word);
+
+   public
+      { creates a filter for <capacity> items; the number of buckets is
+        rounded up to a power of 2; <hasher> may be nil, in which case
+        the default hasher for the type of items is used }
+      constructor Create(capacity : SizeType; const hasher : IHasher); overload;
+      { creates a filter for <capacity> items using the default hasher }
+      constructor Create(capacity : SizeType); overload;
+      constructor CreateCopy(const filter : TCuckooFilter);
+      function CopySelf : TSetFilter; override;
+      { @complexity amortized O(1) }
+      function AddHash(hash : UnsignedType) : Boolean; override;
+      { @complexity O(1) }
+      function MayContainHash(hash : UnsignedType) : Boolean; override;
+      { @complexity O(1) }
+      function RemoveHash(hash : UnsignedType) : Boolean; override;
+      { returns true }
+      function CanRemove : Boolean; override;
+      procedure Clear; override;
+      function MemoryUsage : SizeType; override;
+   end;
+
+   { a set which keeps a filter of its items in front of another set;
+     @<Has>, @<Count> and @<Find> first ask the filter and return at
+     once if the item is certainly not in the set, so that lookups of
+     absent items usually cost one hash and one cache miss instead of
+     a search in the set; the other operations are passed to the
+     underlying set and keep the filter up to date; the iterators wrap
+     those of the underlying set and also keep the filter up to date;
+     the items must not be inserted into the underlying set by other
+     means than through this object (but they may be removed from it
+     directly, which only makes the filter less precise); if the
+     filter becomes full
+     it stops being used until @<RebuildFilter> is called; the hasher
+     of the filter must return equal values for items equal
+     according to @<ItemComparer> }
+   TFilteredSet = class (TSetAdt)
+   private
+      FSet : TSetAdt;
+      FFilter : TSetFilter;
+      { false if the filter does not contain all the items in the set }
+      FFilterValid : Boolean;
+
+      procedure FilterAdd(aitem : ItemType);
+      procedure FilterAddHash(hash : UnsignedType);
+      procedure FilterRemove(hash : UnsignedType; count : SizeType);
+      { returns an iterator of self wrapping <iter>, an iterator of the
+        underlying set }
+      function Wrap(iter : TSetIterator) : TSetIterator;
+      { returns the iterator of the underlying set wrapped by <pos> }
+      function Unwrap(pos : TSetIterator) : TSetIterator;
+
+   protected
+      procedure SetOwnsItems(b : Boolean); override;
+      procedure SetDisposer(const proc : IUnaryFunctor); override;
+      procedure SetRepeatedItems(b : Boolean); override;
+      procedure SetComparer(comp : IBinaryComparer); override;
+
+   public
+      { creates a set passing its operations to <aset> and keeping a
+        filter of its items in <afilter>; the items already in <aset>
+        are added to the filter; <aset> and <afilter> become owned by
+        the created object; the set has the same properties
+        (RepeatedItems, OwnsItems, etc.) as <aset>, and changing them
+        changes them in <aset>; @complexity O(n) }
+      constructor Create(aset : TSetAdt; afilter : TSetFilter);
+      { creates a copy of cont; if itemCopier is nil then an empty set
+        with an empty filter is created }
+      constructor CreateCopy(const cont : TFilteredSet;
+                             const itemCopier : IUnaryFunctor); overload;
+      { destroys the underlying set and the filter }
+      destructor Destroy; override;
+      { @see TContainerAdt.CopySelf }
+      function CopySelf(const ItemCopier :
+                           IUnaryFunctor) : TContainerAdt; override;
+      { @see TContainerAdt.Swap }
+      procedure Swap(cont : TContainerAdt); override;
+      { clears the filter and adds all the items in the underlying set
+        to it; the filter is used again if all of them fit in it;
+        @complexity O(n) }
+      procedure RebuildFilter;
+      function Start : TSetIterator; override;
+      function Finish : TSetIterator; override;
+&if (&_mcp_accepts_nil)
+      { @see TSetAdt.FindOrInsert }
+      function FindOrInsert(aitem : ItemType) : ItemType; override;
+      { returns nil without searching the underlying set if the filter
+        says aitem is not there; @see TSetAdt.Find }
+      function Find(aitem : ItemType) : ItemType; override;
+&endif &# end &_mcp_accepts_nil
+      { returns false without searching the underlying set if the
+        filter says aitem is not there; @see TSetAdt.Has }
+      function Has(aitem : ItemType) : Boolean; override;
+      { returns 0 without searching the underlying set if the filter
+        says aitem is not there; @see TSetAdt.Count }
+      function Count(aitem : ItemType) : SizeType; override;
+      { @see TSetAdt.Insert }
+      function Insert(pos : TSetIterator;
+                      aitem : ItemType) : Boolean; overload; override;
+      { @see TSetAdt.Insert }
+      function Insert(aitem : ItemType) : Boolean; overload; override;
+      { @see TSetAdt.Delete }
+      procedure Delete(pos : TSetIterator); overload; override;
+      { @see TSetAdt.Delete }
+      function Delete(aitem : ItemType) : SizeType; overload; override;
+      { @see TSetAdt.Extract }
+      function Extract(aitem : ItemType) : SizeType; override;
+      { the same as for the underlying set; does not use the filter }
+      function LowerBound(aitem : ItemType) : TSetIterator; override;
+      { the same as for the underlying set; does not use the filter }
+      function UpperBound(aitem : ItemType) : TSetIterator; override;
+      { the same as for the underlying set; does not use the filter }
+      function EqualRange(aitem : ItemType) : TSetIteratorRange; override;
+      { @see TContainerAdt.ExtractItem }
+      function ExtractItem : ItemType; override;
+      { clears the underlying set and the filter }
+      procedure Clear; override;
+      function Empty : Boolean; override;
+      function Size : SizeType; override;
+      { the filter; must not be modified directly }
+      property Filter : TSetFilter read FFilter;
+      { the underlying set; must not be modified directly, other than
+        by removing items }
+      property InnerSet : TSetAdt read FSet;
+      { true if the filter is used, i.e. it has not become full }
+      property FilterActive : Boolean read FFilterValid;
+   end;
+
+   { an iterator into a TFilteredSet; passes everything to an iterator
+     of the underlying set, and adds the items inserted through it to
+     the filter and removes the items extracted through it from the
+     filter }
+   TFilteredSetIterator = class (TSetIterator)
+   private
+      FSet : TFilteredSet;
+      FIter : TSetIterator;
+
+   public
+      constructor Create(aset : TFilteredSet; iter : TSetIterator);
+      { destroys the iterator of the underlying set as well, unless
+        called from the grabage collector of the filtered set, which
+        is freed after the underlying set }
+      destructor Destroy; override;
+      function CopySelf : TIterator; override;
+      function Equal(const Pos : TIterator) : Boolean; override;
+      function GetItem : ItemType; override;
+      procedure SetItem(aitem : ItemType); override;
+      { the hash of the item before the change cannot be removed from
+        the filter, so it is left there, which only makes the filter
+        less precise }
+      procedure ResetItem; override;
+      procedure Advance; overload; override;
+      procedure Retreat; override;
+      procedure Insert(aitem : ItemType); override;
+      function Extract : ItemType; override;
+      function Owner : TContainerAdt; override;
+      function IsStart : Boolean; override;
+      function IsFinish : Boolean; override;
+   end;
@@ -0,0 +1,727 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtfilter_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtfilter.defs
+&include adtfilter_impl.mcp
+
+{ ---------------------------- TSetFilter --------------------------------- }
+
+constructor TSetFilter.Create(const hasher : IHasher);
+begin
+   inherited Create;
+   if hasher <> nil then
+      FHasher := hasher
+   else
+      FHasher := &_mcp_hasher(&ItemType);
+   Assert(FHasher <> nil, msgNilFunctor);
+   FCount := 0;
+end;
+
+function TSetFilter.HashOf(aitem : ItemType) : UnsignedType;
+begin
+   Result := FHasher.Hash(aitem);
+end;
+
+function TSetFilter.Add(aitem : ItemType) : Boolean;
+begin
+   Result := AddHash(FHasher.Hash(aitem));
+end;
+
+function TSetFilter.MayContain(aitem : ItemType) : Boolean;
+begin
+   Result := MayContainHash(FHasher.Hash(aitem));
+end;
+
+function TSetFilter.Remove(aitem : ItemType) : Boolean;
+begin
+   Result := RemoveHash(FHasher.Hash(aitem));
+end;
+
+{ ---------------------------- TBloomFilter --------------------------------- }
+
+constructor TBloomFilter.Create(capacity : SizeType; bitsPerItem : Integer;
+                                const hasher : IHasher);
+var
+   blocks : SizeType;
+begin
+   inherited Create(hasher);
+   Assert(bitsPerItem > 0, msgInvalidArgument);
+
+   blocks := (capacity * bitsPerItem + SizeOf(TBloomFilterBlock) * adtBitsInByte - 1)
+      div (SizeOf(TBloomFilterBlock) * adtBitsInByte);
+   if blocks < 1 then
+      blocks := 1;
+   blocks := SizeType(1) shl CeilLog2(blocks);
+   SetLength(FBlocks, blocks);
+   FMask := blocks - 1;
+   Clear;
+end;
+
+constructor TBloomFilter.Create(capacity : SizeType);
+begin
+   Create(capacity, bfDefaultBitsPerItem, nil);
+end;
+
+constructor TBloomFilter.CreateCopy(const filter : TBloomFilter);
+begin
+   inherited Create(filter.Hasher);
+   FBlocks := Copy(filter.FBlocks);
+   FMask := filter.FMask;
+   FCount := filter.FCount;
+end;
+
+function TBloomFilter.CopySelf : TSetFilter;
+begin
+   Result := TBloomFilter.CreateCopy(self);
+end;
+
+function TBloomFilter.AddHash(hash : UnsignedType) : Boolean;
+var
+   key : Cardinal;
+   block : ^TBloomFilterBlock;
+   i : Integer;
+begin
+   key := MixHash(hash);
+   block := @FBlocks[key and FMask];
+   { the top 5 bits of key * salt select a bit in a 32-bit word }
+   for i := Low(BloomSalts) to High(BloomSalts) do
+      block^[i] := block^[i] or (Cardinal(1) shl (Cardinal(key * BloomSalts[i]) shr 27));
+   Inc(FCount);
+   Result := true;
+end;
+
+function TBloomFilter.MayContainHash(hash : UnsignedType) : Boolean;
+var
+   key : Cardinal;
+   block : ^TBloomFilterBlock;
+   i : Integer;
+begin
+   key := MixHash(hash);
+   block := @FBlocks[key and FMask];
+   for i := Low(BloomSalts) to High(BloomSalts) do
+   begin
+      if block^[i] and (Cardinal(1) shl (Cardinal(key * BloomSalts[i]) shr 27)) = 0 then
+      begin
+         Result := false;
+         Exit;
+      end;
+   end;
+   Result := true;
+end;
+
+function TBloomFilter.RemoveHash(hash : UnsignedType) : Boolean;
+begin
+   Result := false;
+end;
+
+function TBloomFilter.CanRemove : Boolean;
+begin
+   Result := false;
+end;
+
+procedure TBloomFilter.Clear;
+begin
+   if Length(FBlocks) <> 0 then
+      FillChar(FBlocks[0], Length(FBlocks) * SizeOf(TBloomFilterBlock), 0);
+   FCount := 0;
+end;
+
+function TBloomFilter.MemoryUsage : SizeType;
+begin
+   Result := Length(FBlocks) * SizeOf(TBloomFilterBlock);
+end;
+
+{ ---------------------------- TCuckooFilter --------------------------------- }
+
+constructor TCuckooFilter.Create(capacity : SizeType; const hasher : IHasher);
+var
+   buckets : SizeType;
+begin
+   inherited Create(hasher);
+   { the filter gets full at about 95% }
+   buckets := (capacity * 100 div 95 + cfBucketSize - 1) div cfBucketSize;
+   if buckets < 1 then
+      buckets := 1;
+   buckets := SizeType(1) shl CeilLog2(buckets);
+   SetLength(FBuckets, buckets);
+   FMask := buckets - 1;
+   FRandom := $2545F491;
+   Clear;
+end;
+
+constructor TCuckooFilter.Create(capacity : SizeType);
+begin
+   Create(capacity, nil);
+end;
+
+constructor TCuckooFilter.CreateCopy(const filter : TCuckooFilter);
+begin
+   inherited Create(filter.Hasher);
+   FBuckets := Copy(filter.FBuckets);
+   FMask := filter.FMask;
+   FRandom := filter.FRandom;
+   FVictimUsed := filter.FVictimUsed;
+   FVictimFingerprint := filter.FVictimFingerprint;
+   FVictimIndex := filter.FVictimIndex;
+   FCount := filter.FCount;
+end;
+
+function TCuckooFilter.CopySelf : TSetFilter;
+begin
+   Result := TCuckooFilter.CreateCopy(self);
+end;
+
+procedure TCuckooFilter.IndexAndFingerprint(hash : UnsignedType;
+                                            var index : Cardinal;
+                                            var fingerprint : Word);
+var
+   x : Cardinal;
+begin
+   x := MixHash(hash);
+   index := x and FMask;
+   { the fingerprint must not be correlated with the index, so it is
+     taken from another mix of the hash }
+   fingerprint := Word(MixHash(x) shr 16);
+   if fingerprint = 0 then
+      fingerprint := 1;
+end;
+
+function TCuckooFilter.AltIndex(index : Cardinal; fingerprint : Word) : Cardinal;
+begin
+   { AltIndex(AltIndex(i, f), f) = i, so the other bucket of a
+     fingerprint may be computed without knowing the item }
+   Result := (index xor MixHash(fingerprint)) and FMask;
+end;
+
+function TCuckooFilter.PlaceInBucket(index : Cardinal; fingerprint : Word) : Boolean;
+var
+   i : Integer;
+begin
+   for i := 0 to cfBucketSize - 1 do
+   begin
+      if FBuckets[index][i] = 0 then
+      begin
+         FBuckets[index][i] := fingerprint;
+         Result := true;
+         Exit;
+      end;
+   end;
+   Result := false;
+end;
+
+function TCuckooFilter.RemoveFromBucket(index : Cardinal; fingerprint : Word) : Boolean;
+var
+   i : Integer;
+begin
+   for i := 0 to cfBucketSize - 1 do
+   begin
+      if FBuckets[index][i] = fingerprint then
+      begin
+         FBuckets[index][i] := 0;
+         Result := true;
+         Exit;
+      end;
+   end;
+   Result := false;
+end;
+
+procedure TCuckooFilter.InsertFingerprint(index : Cardinal; fingerprint : Word);
+var
+   kick : Integer;
+   slot : Integer;
+   evicted : Word;
+begin
+   if PlaceInBucket(index, fingerprint) then
+      Exit;
+   index := AltIndex(index, fingerprint);
+   if PlaceInBucket(index, fingerprint) then
+      Exit;
+
+   for kick := 1 to cfMaxKicks do
+   begin
+      { xorshift }
+      FRandom := FRandom xor (FRandom shl 13);
+      FRandom := FRandom xor (FRandom shr 17);
+      FRandom := FRandom xor (FRandom shl 5);
+      slot := FRandom mod cfBucketSize;
+
+      evicted := FBuckets[index][slot];
+      FBuckets[index][slot] := fingerprint;
+      fingerprint := evicted;
+      index := AltIndex(index, fingerprint);
+      if PlaceInBucket(index, fingerprint) then
+         Exit;
+   end;
+
+   FVictimUsed := true;
+   FVictimIndex := index;
+   FVictimFingerprint := fingerprint;
+end;
+
+function TCuckooFilter.AddHash(hash : UnsignedType) : Boolean;
+var
+   index : Cardinal;
+   fingerprint : Word;
+begin
+   if FVictimUsed then
+   begin
+      Result := false;
+      Exit;
+   end;
+   IndexAndFingerprint(hash, index, fingerprint);
+   InsertFingerprint(index, fingerprint);
+   Inc(FCount);
+   Result := true;
+end;
+
+function TCuckooFilter.MayContainHash(hash : UnsignedType) : Boolean;
+var
+   index, index2 : Cardinal;
+   fingerprint : Word;
+   i : Integer;
+begin
+   IndexAndFingerprint(hash, index, fingerprint);
+   index2 := AltIndex(index, fingerprint);
+   Result := true;
+   for i := 0 to cfBucketSize - 1 do
+   begin
+      if (FBuckets[index][i] = fingerprint) or
+            (FBuckets[index2][i] = fingerprint) then
+         Exit;
+   end;
+   Result := FVictimUsed and (FVictimFingerprint = fingerprint) and
+      ((FVictimIndex = index) or (FVictimIndex = index2));
+end;
+
+function TCuckooFilter.RemoveHash(hash : UnsignedType) : Boolean;
+var
+   index, index2 : Cardinal;
+   fingerprint : Word;
+begin
+   IndexAndFingerprint(hash, index, fingerprint);
+   index2 := AltIndex(index, fingerprint);
+   if RemoveFromBucket(index, fingerprint) or
+         RemoveFromBucket(index2, fingerprint) then
+   begin
+      Dec(FCount);
+      if FVictimUsed then
+      begin
+         { there is a free slot now - try to place the victim again }
+         FVictimUsed := false;
+         InsertFingerprint(FVictimIndex, FVictimFingerprint);
+      end;
+      Result := true;
+   end else if FVictimUsed and (FVictimFingerprint = fingerprint) and
+                  ((FVictimIndex = index) or (FVictimIndex = index2)) then
+   begin
+      Dec(FCount);
+      FVictimUsed := false;
+      Result := true;
+   end else
+      Result := false;
+end;
+
+function TCuckooFilter.CanRemove : Boolean;
+begin
+   Result := true;
+end;
+
+procedure TCuckooFilter.Clear;
+begin
+   if Length(FBuckets) <> 0 then
+      FillChar(FBuckets[0], Length(FBuckets) * SizeOf(TCuckooFilterBucket), 0);
+   FVictimUsed := false;
+   FCount := 0;
+end;
+
+function TCuckooFilter.MemoryUsage : SizeType;
+begin
+   Result := Length(FBuckets) * SizeOf(TCuckooFilterBucket);
+end;
+
+{ ---------------------------- TFilteredSet --------------------------------- }
+
+constructor TFilteredSet.Create(aset : TSetAdt; afilter : TSetFilter);
+begin
+   Assert((aset <> nil) and (afilter <> nil), msgNilObject);
+
+   inherited CreateCopy(aset);
+   FSet := aset;
+   FFilter := afilter;
+   RebuildFilter;
+end;
+
+constructor TFilteredSet.CreateCopy(const cont : TFilteredSet;
+                                    const itemCopier : IUnaryFunctor);
+begin
+   inherited CreateCopy(TSetAdt(cont));
+   FSet := TSetAdt(cont.FSet.CopySelf(itemCopier));
+   FFilter := cont.FFilter.CopySelf;
+   FFilterValid := cont.FFilterValid;
+   if itemCopier = nil then
+   begin
+      FFilter.Clear;
+      FFilterValid := true;
+   end;
+end;
+
+destructor TFilteredSet.Destroy;
+begin
+   FSet.Free;
+   FFilter.Free;
+   inherited;
+end;
+
+procedure TFilteredSet.FilterAdd(aitem : ItemType);
+begin
+   if FFilterValid and not FFilter.Add(aitem) then
+      FFilterValid := false;
+end;
+
+procedure TFilteredSet.FilterAddHash(hash : UnsignedType);
+begin
+   if FFilterValid and not FFilter.AddHash(hash) then
+      FFilterValid := false;
+end;
+
+procedure TFilteredSet.FilterRemove(hash : UnsignedType; count : SizeType);
+begin
+   if FFilterValid and FFilter.CanRemove then
+   begin
+      while count > 0 do
+      begin
+         FFilter.RemoveHash(hash);
+         Dec(count);
+      end;
+   end;
+end;
+
+function TFilteredSet.Wrap(iter : TSetIterator) : TSetIterator;
+begin
+   Result := TFilteredSetIterator.Create(self, iter);
+end;
+
+function TFilteredSet.Unwrap(pos : TSetIterator) : TSetIterator;
+begin
+   Assert((pos is TFilteredSetIterator) and (pos.Owner = self),
+          msgInvalidIterator);
+
+   Result := TFilteredSetIterator(pos).FIter;
+end;
+
+procedure TFilteredSet.SetOwnsItems(b : Boolean);
+begin
+   inherited;
+   FSet.OwnsItems := b;
+end;
+
+procedure TFilteredSet.SetDisposer(const proc : IUnaryFunctor);
+begin
+   inherited;
+   FSet.ItemDisposer := proc;
+end;
+
+procedure TFilteredSet.SetRepeatedItems(b : Boolean);
+begin
+   inherited;
+   FSet.RepeatedItems := b;
+end;
+
+procedure TFilteredSet.SetComparer(comp : IBinaryComparer);
+begin
+   inherited;
+   FSet.ItemComparer := comp;
+end;
+
+function TFilteredSet.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TFilteredSet.CreateCopy(self, ItemCopier);
+end;
+
+procedure TFilteredSet.Swap(cont : TContainerAdt);
+begin
+   if cont is TFilteredSet then
+   begin
+      BasicSwap(cont);
+      ExchangePtr(FSet, TFilteredSet(cont).FSet);
+      ExchangePtr(FFilter, TFilteredSet(cont).FFilter);
+      ExchangeData(FFilterValid, TFilteredSet(cont).FFilterValid, SizeOf(Boolean));
+   end else
+      inherited;
+end;
+
+procedure TFilteredSet.RebuildFilter;
+var
+   iter : TSetIterator;
+begin
+   FFilter.Clear;
+   FFilterValid := true;
+   iter := FSet.Start;
+   while FFilterValid and not iter.IsFinish do
+   begin
+      FilterAdd(iter.Item);
+      iter.Advance;
+   end;
+   iter.Destroy;
+end;
+
+function TFilteredSet.Start : TSetIterator;
+begin
+   Result := Wrap(FSet.Start);
+end;
+
+function TFilteredSet.Finish : TSetIterator;
+begin
+   Result := Wrap(FSet.Finish);
+end;
+
+&if (&_mcp_accepts_nil)
+function TFilteredSet.FindOrInsert(aitem : ItemType) : ItemType;
+begin
+   Result := FSet.FindOrInsert(aitem);
+   if Result = nil then
+      FilterAdd(aitem);
+end;
+
+function TFilteredSet.Find(aitem : ItemType) : ItemType;
+begin
+   if FFilterValid and not FFilter.MayContain(aitem) then
+      Result := nil
+   else
+      Result := FSet.Find(aitem);
+end;
+&endif &# end &_mcp_accepts_nil
+
+function TFilteredSet.Has(aitem : ItemType) : Boolean;
+begin
+   if FFilterValid and not FFilter.MayContain(aitem) then
+      Result := false
+   else
+      Result := FSet.Has(aitem);
+end;
+
+function TFilteredSet.Count(aitem : ItemType) : SizeType;
+begin
+   if FFilterValid and not FFilter.MayContain(aitem) then
+      Result := 0
+   else
+      Result := FSet.Count(aitem);
+end;
+
+function TFilteredSet.Insert(pos : TSetIterator; aitem : ItemType) : Boolean;
+begin
+   Result := FSet.Insert(Unwrap(pos), aitem);
+   if Result then
+      FilterAdd(aitem);
+end;
+
+function TFilteredSet.Insert(aitem : ItemType) : Boolean;
+begin
+   Result := FSet.Insert(aitem);
+   if Result then
+      FilterAdd(aitem);
+end;
+
+procedure TFilteredSet.Delete(pos : TSetIterator);
+var
+   hash : UnsignedType;
+begin
+   { the item may be disposed by Delete, so it must be hashed before }
+   hash := FFilter.HashOf(pos.Item);
+   FSet.Delete(Unwrap(pos));
+   FilterRemove(hash, 1);
+end;
+
+function TFilteredSet.Delete(aitem : ItemType) : SizeType;
+var
+   hash : UnsignedType;
+begin
+   hash := FFilter.HashOf(aitem);
+   if FFilterValid and not FFilter.MayContainHash(hash) then
+   begin
+      Result := 0;
+      Exit;
+   end;
+   Result := FSet.Delete(aitem);
+   FilterRemove(hash, Result);
+end;
+
+function TFilteredSet.Extract(aitem : ItemType) : SizeType;
+var
+   hash : UnsignedType;
+begin
+   hash := FFilter.HashOf(aitem);
+   if FFilterValid and not FFilter.MayContainHash(hash) then
+   begin
+      Result := 0;
+      Exit;
+   end;
+   Result := FSet.Extract(aitem);
+   FilterRemove(hash, Result);
+end;
+
+function TFilteredSet.LowerBound(aitem : ItemType) : TSetIterator;
+begin
+   Result := Wrap(FSet.LowerBound(aitem));
+end;
+
+function TFilteredSet.UpperBound(aitem : ItemType) : TSetIterator;
+begin
+   Result := Wrap(FSet.UpperBound(aitem));
+end;
+
+function TFilteredSet.EqualRange(aitem : ItemType) : TSetIteratorRange;
+var
+   range : TSetIteratorRange;
+begin
+   range := FSet.EqualRange(aitem);
+   Result := TSetIteratorRange.Create(Wrap(range.Start), Wrap(range.Finish));
+   range.Destroy;
+end;
+
+function TFilteredSet.ExtractItem : ItemType;
+var
+   iter : TSetIterator;
+begin
+   Assert(CanExtract);
+   iter := FSet.Start;
+   Result := iter.Extract;
+   iter.Destroy;
+   FilterRemove(FFilter.HashOf(Result), 1);
+end;
+
+procedure TFilteredSet.Clear;
+begin
+   FSet.Clear;
+   FFilter.Clear;
+   FFilterValid := true;
+   GrabageCollector.FreeObjects;
+end;
+
+function TFilteredSet.Empty : Boolean;
+begin
+   Result := FSet.Empty;
+end;
+
+function TFilteredSet.Size : SizeType;
+begin
+   Result := FSet.Size;
+end;
+
+{ ------------------------ TFilteredSetIterator ----------------------------- }
+
+constructor TFilteredSetIterator.Create(aset : TFilteredSet; iter : TSetIterator);
+begin
+   inherited Create(aset);
+   FSet := aset;
+   FIter := iter;
+end;
+
+destructor TFilteredSetIterator.Destroy;
+begin
+   if not FSet.GrabageCollector.IsInGrabageCollector then
+      FIter.Destroy;
+   inherited;
+end;
+
+function TFilteredSetIterator.CopySelf : TIterator;
+begin
+   Result := TFilteredSetIterator.Create(FSet, TSetIterator(FIter.CopySelf));
+end;
+
+function TFilteredSetIterator.Equal(const Pos : TIterator) : Boolean;
+begin
+   Assert(pos is TFilteredSetIterator, msgInvalidIterator);
+
+   Result := FIter.Equal(TFilteredSetIterator(pos).FIter);
+end;
+
+function TFilteredSetIterator.GetItem : ItemType;
+begin
+   Result := FIter.Item;
+end;
+
+procedure TFilteredSetIterator.SetItem(aitem : ItemType);
+var
+   oldHash, newHash : UnsignedType;
+begin
+   { aitem is disposed if it cannot be inserted, and the old item may
+     be disposed as well, so both must be hashed before }
+   oldHash := FSet.FFilter.HashOf(FIter.Item);
+   newHash := FSet.FFilter.HashOf(aitem);
+   FIter.SetItem(aitem);
+   FSet.FilterRemove(oldHash, 1);
+   if not FIter.IsFinish then
+      FSet.FilterAddHash(newHash);
+end;
+
+procedure TFilteredSetIterator.ResetItem;
+begin
+   FIter.ResetItem;
+   FSet.FilterAdd(FIter.Item);
+end;
+
+procedure TFilteredSetIterator.Advance;
+begin
+   FIter.Advance;
+end;
+
+procedure TFilteredSetIterator.Retreat;
+begin
+   FIter.Retreat;
+end;
+
+procedure TFilteredSetIterator.Insert(aitem : ItemType);
+var
+   hash : UnsignedType;
+begin
+   hash := FSet.FFilter.HashOf(aitem);
+   FIter.Insert(aitem);
+   if not FIter.IsFinish then
+      FSet.FilterAddHash(hash);
+end;
+
+function TFilteredSetIterator.Extract : ItemType;
+begin
+   Result := FIter.Extract;
+   FSet.FilterRemove(FSet.FFilter.HashOf(Result), 1);
+end;
+
+function TFilteredSetIterator.Owner : TContainerAdt;
+begin
+   Result := FSet;
+end;
+
+function TFilteredSetIterator.IsStart : Boolean;
+begin
+   Result := FIter.IsStart;
+end;
+
+function TFilteredSetIterator.IsFinish : Boolean;
+begin
+   Result := FIter.IsFinish;
+end;
@@ -92,6 +92,17 @@ type
       function Hash(aitem : ItemType) : UnsignedType;
    end;
 
+   { a functor used to write items to a stream and to read them back;
+     used by the SaveToStream and LoadFromStream methods of
+     containers; ReadItem should return a new item equal to the one
+     written by WriteItem }
+   IStreamer = interface (IFunctor)
+      { writes <aitem> to <stream> }
+      procedure WriteItem(stream : TStream; aitem : ItemType);
+      { reads an item written by WriteItem from <stream> }
+      function ReadItem(stream : TStream) : ItemType;
+   end;
+
    { ------------------- Procedure/Function types ----------------------- }
 
    TUnaryProcedure = procedure(aitem : ItemType);
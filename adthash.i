@@ -107,6 +107,20 @@ type
         should be inserted }
       function FindNode(aitem : ItemType; var bucket : IndexType;
                         var node : PHashNode) : Boolean;
+{$ifdef INLINE_DIRECTIVE }
+      inline;
+{$endif }
+      { the same as FindNode, but uses <hashValue> as the hash of
+        aitem instead of computing it }
+      function FindNodeHashed(aitem : ItemType; hashValue : UnsignedType;
+                              var bucket : IndexType;
+                              var node : PHashNode) : Boolean;
+      { computes the hashes of items[start..finish-1], stores them in
+        hashes[0..finish-start-1] and prefetches the buckets the items
+        hash to }
+      procedure HashBatch(const items : array of ItemType;
+                          start, finish : IndexType;
+                          var hashes : array of UnsignedType);
       { inserts aitem before or after position (bucket,node); this has
         to be the correct position returned by FindNode; sets
         (bucket,node) to point to the newly inserted node; does not
@@ -154,12 +168,41 @@ type
         buckets empty, filled, etc. }
       procedure LogStatus(mname : String); override;
 {$endif TEST_PASCAL_ADT }
+{$ifdef PASCAL_ADT_STATS }
+      { adds the lengths of the collision chains }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
 
       { returns an exact copy of self; @complexity O(n) }
       function CopySelf(const ItemCopier : IUnaryFunctor) :
          TContainerAdt; override;
       { @see TContainerAdt.Swap }
       procedure Swap(cont : TContainerAdt); override;
+      { writes the layout of the buckets (the lengths of all collision
+        chains) followed by the items in bucket order; @complexity
+        O(n+m), where m is the capacity of the table }
+      procedure SaveToStream(stream : TStream;
+                             const streamer : IStreamer); overload; override;
+      { restores the table from a snapshot written by SaveToStream
+        without hashing any item - the items are put back into the
+        same buckets; the table must use a hasher returning the same
+        values as the one used by the table that wrote the snapshot,
+        so the default binary representation should not be used for
+        items hashed by their addresses; @complexity O(n+m) }
+      procedure LoadFromStream(stream : TStream;
+                               const streamer : IStreamer); overload; override;
+      { walk the collision chains bucket by bucket; @complexity
+        O(n+m), where m is the capacity of the table }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { unlinks the deleted items from the collision chains in a
+        single pass over the buckets and then shrinks the table if
+        AutoShrink is on; @complexity O(n+m) }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
       { returns the start iterator; @complexity worst-case O(n) }
       function Start : TSetIterator; override;
       { returns the finish iterator }
@@ -191,6 +234,28 @@ type
         the container and not disposed !  @complexity average O(1),
         worst-case O(n) }
       function Insert(aitem : ItemType) : Boolean; overload; override;
+      { the batched versions of Has, Find and Insert; they store the
+        result for items[i] in res[i] and return the number of items
+        found (inserted); res must be at least as long as items; the
+        items are processed in batches of several dozen - all items of
+        a batch are hashed and the buckets they hash to are prefetched
+        before the first of them is resolved, so that the cache misses
+        of different items overlap; this is much faster than calling
+        Has, Find or Insert in a loop when the table does not fit in
+        the cache; @complexity average O(k), worst-case O(k*n), where
+        k is the number of items }
+      function HasMany(const items : array of ItemType;
+                       var res : array of Boolean) : SizeType;
+&if (&_mcp_accepts_nil)
+      { stores nil in res[i] if items[i] is not found }
+      function FindMany(const items : array of ItemType;
+                        var res : array of ItemType) : SizeType;
+&endif &# end &_mcp_accepts_nil
+      { res[i] is true if items[i] has been inserted; the items not
+        inserted are not owned by the set; if an exception is raised
+        then only the items for which res[i] is true are owned }
+      function InsertMany(const items : array of ItemType;
+                          var res : array of Boolean) : SizeType;
       { removes the item at pos from the set; }
       procedure Delete(pos : TSetIterator); overload; override;
       { removes all items equal to aitem from the set; returns the
@@ -329,6 +394,21 @@ type
         you should check for such a case by comparing the size of the
         container before and after calling this method.  }
       function DoInsert(aitem : ItemType; var h : IndexType) : SizeType; overload;
+      { the same as above, but uses <hashValue> as the hash of aitem
+        instead of computing it }
+      function DoInsertHashed(aitem : ItemType; hashValue : UnsignedType;
+                              var h : IndexType) : SizeType;
+      { returns the index of the first field containing an item equal
+        to aitem, or the index of a free field if there is no such
+        item; hashValue is the hash of aitem }
+      function LocateHashed(aitem : ItemType;
+                            hashValue : UnsignedType) : IndexType;
+      { computes the hashes of items[start..finish-1], stores them in
+        hashes[0..finish-start-1] and prefetches the fields the items
+        hash to }
+      procedure HashBatch(const items : array of ItemType;
+                          start, finish : IndexType;
+                          var hashes : array of UnsignedType);
       { the same as above but returns true if aitem was inserted, false
         if not; }
       function DoInsert(aitem : ItemType) : Boolean; overload;
@@ -358,12 +438,39 @@ type
       { writes some information about the hash table to the log file }
       procedure LogStatus(mname : String); override;
 {$endif TEST_PASCAL_ADT }
+{$ifdef PASCAL_ADT_STATS }
+      { adds the lengths of the probe sequences }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
 
       { returns an exact copy of self; @complexity O(n) }
       function CopySelf(const ItemCopier : IUnaryFunctor) :
          TContainerAdt; override;
       { @see TContainerAdt.Swap }
       procedure Swap(cont : TContainerAdt); override;
+      { writes the state of every field of the table followed by the
+        items in the order of the fields; @complexity O(m), where m is
+        the capacity of the table }
+      procedure SaveToStream(stream : TStream;
+                             const streamer : IStreamer); overload; override;
+      { restores the table from a snapshot written by SaveToStream
+        without hashing any item - every item is put back into the same
+        field; the same restrictions on the hasher apply as for
+        THashTable.LoadFromStream; @complexity O(m) }
+      procedure LoadFromStream(stream : TStream;
+                               const streamer : IStreamer); overload; override;
+      { scan the fields of the table in order, skipping the free and
+        deleted ones; @complexity O(m) }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { marks the fields of the deleted items as deleted in a single
+        scan and then shrinks or rehashes the table if needed;
+        @complexity O(m) }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
       { returns the start iterator; @complexity worst-case O(m) }
       function Start : TSetIterator; override;
       { returns the finish iterator }
@@ -395,6 +502,28 @@ type
         the container and not disposed !  @complexity average O(1),
         worst-case O(n) }
       function Insert(aitem : ItemType) : Boolean; overload; override;
+      { the batched versions of Has, Find and Insert; they store the
+        result for items[i] in res[i] and return the number of items
+        found (inserted); res must be at least as long as items; the
+        items are processed in batches of several dozen - all items of
+        a batch are hashed and the fields they hash to are prefetched
+        before the first of them is resolved, so that the cache misses
+        of different items overlap; this is much faster than calling
+        Has, Find or Insert in a loop when the table does not fit in
+        the cache; @complexity average O(k), worst-case O(k*n), where
+        k is the number of items }
+      function HasMany(const items : array of ItemType;
+                       var res : array of Boolean) : SizeType;
+&if (&_mcp_accepts_nil)
+      { stores nil in res[i] if items[i] is not found }
+      function FindMany(const items : array of ItemType;
+                        var res : array of ItemType) : SizeType;
+&endif &# end &_mcp_accepts_nil
+      { res[i] is true if items[i] has been inserted; the items not
+        inserted are not owned by the set; if an exception is raised
+        then only the items for which res[i] is true are owned }
+      function InsertMany(const items : array of ItemType;
+                          var res : array of Boolean) : SizeType;
       { removes the item at pos from the set; }
       procedure Delete(pos : TSetIterator); overload; override;
       { removes all items equal to aitem from the set; returns the
@@ -326,8 +326,18 @@ end;
 
 function THashTable.FindNode(aitem : ItemType; var bucket : IndexType;
                              var node : PHashNode) : Boolean;
+{$ifdef INLINE_DIRECTIVE_REPEAT }
+inline;
+{$endif }
 begin
-   bucket := GetBucketIndex(Hasher.Hash(aitem));
+   Result := FindNodeHashed(aitem, Hasher.Hash(aitem), bucket, node);
+end;
+
+function THashTable.FindNodeHashed(aitem : ItemType; hashValue : UnsignedType;
+                                   var bucket : IndexType;
+                                   var node : PHashNode) : Boolean;
+begin
+   bucket := GetBucketIndex(hashValue);
    if FBuckets[bucket].Next <> @FBuckets[bucket] then
    begin
       if _mcp_equal(FBuckets[bucket].Item, aitem) then
@@ -356,6 +366,19 @@ begin
    end;
 end;
 
+procedure THashTable.HashBatch(const items : array of ItemType;
+                               start, finish : IndexType;
+                               var hashes : array of UnsignedType);
+var
+   i : IndexType;
+begin
+   for i := start to finish - 1 do
+   begin
+      hashes[i - start] := Hasher.Hash(items[i]);
+      &_mcp_prefetch(FBuckets[GetBucketIndex(hashes[i - start])]);
+   end;
+end;
+
 procedure THashTable.InsertNode(var bucket : IndexType; var node : PHashNode;
                                 aitem : ItemType);
 var
@@ -562,6 +585,35 @@ begin
 end;
 {$endif TEST_PASCAL_ADT }
 
+{$ifdef PASCAL_ADT_STATS }
+procedure THashTable.GetStats(var stats : TContainerStats);
+var
+   i : IndexType;
+   len : SizeType;
+   node : PHashNode;
+begin
+   inherited;
+   for i := 0 to FCapacity - 1 do
+   begin
+      node := @FBuckets[i];
+      if node^.Next <> node then
+      begin
+         Inc(stats.UsedSlots);
+         len := 0;
+         while node <> nil do
+         begin
+            Inc(len);
+            AddProbeLength(stats, len);
+            node := node^.Next;
+         end;
+         { the first node of every chain is stored in FBuckets }
+         Inc(stats.Nodes, len - 1);
+      end;
+   end;
+   Inc(stats.Bytes, (FCapacity + stats.Nodes) * SizeOf(THashNode));
+end;
+{$endif PASCAL_ADT_STATS }
+
 function THashTable.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
 begin
    Result := THashTable.CreateCopy(self, itemCopier);
@@ -587,6 +639,260 @@ begin
       inherited;
 end;
 
+procedure THashTable.SaveToStream(stream : TStream; const streamer : IStreamer);
+var
+   lengths : array of LongInt;
+   items : TDynamicBuffer;
+   i, num : SizeType;
+   node : PHashNode;
+begin
+   StreamWriteHeader(stream, sfHashTable, SizeOf(ItemType));
+   StreamWriteSize(stream, FTableSize);
+   StreamWriteSize(stream, FSize);
+
+   SetLength(lengths, FCapacity);
+   BufferAllocate(items, FSize);
+   try
+      num := 0;
+      for i := 0 to FCapacity - 1 do
+      begin
+         lengths[i] := 0;
+         if FBuckets[i].Next <> @FBuckets[i] then
+         begin
+            node := @FBuckets[i];
+            while node <> nil do
+            begin
+               items^.Items[num] := node^.Item;
+               Inc(num);
+               Inc(lengths[i]);
+               node := node^.Next;
+            end;
+         end;
+      end;
+      Assert(num = FSize, msgInternalError);
+
+      stream.WriteBuffer(lengths[0], FCapacity*SizeOf(LongInt));
+      if num <> 0 then
+         StreamWriteItems(stream, items^.Items[0], num, streamer);
+   finally
+      BufferDeallocate(items);
+   end;
+end;
+
+procedure THashTable.LoadFromStream(stream : TStream; const streamer : IStreamer);
+var
+   lengths : array of LongInt;
+   items : TDynamicBuffer;
+   tableSize, cap, num, total, i, j, k : SizeType;
+   node : PHashNode;
+begin
+   StreamReadHeader(stream, sfHashTable, SizeOf(ItemType));
+   tableSize := StreamReadSize(stream);
+   num := StreamReadSize(stream);
+   if (tableSize < htMinTableSize) or
+         (tableSize >= SizeOf(SizeType)*adtBitsInByte - 1) then
+   begin
+      raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+   end;
+   cap := CalculateCapacity(tableSize);
+   if cap > (stream.Size - stream.Position) div SizeOf(LongInt) then
+      raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+
+   SetLength(lengths, cap);
+   stream.ReadBuffer(lengths[0], cap*SizeOf(LongInt));
+   total := 0;
+   for i := 0 to cap - 1 do
+   begin
+      if lengths[i] < 0 then
+         raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+      Inc(total, lengths[i]);
+   end;
+   if total <> num then
+      raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+
+   BufferAllocate(items, num);
+   k := 0; { the number of items already placed in the table }
+   try
+      if num <> 0 then
+         StreamReadItems(stream, items^.Items[0], num, streamer);
+
+      Clear;
+      SetLength(FBuckets, 0);
+      FTableSize := tableSize;
+      FCapacity := cap;
+      SetLength(FBuckets, FCapacity);
+      for i := 0 to FCapacity - 1 do
+      begin
+         _mcp_set_zero(FBuckets[i].Item);
+         FBuckets[i].Next := @FBuckets[i];
+      end;
+
+      { the items are placed into the buckets they were in when
+        written, so there is no need to hash them again }
+      for i := 0 to FCapacity - 1 do
+      begin
+         if lengths[i] <> 0 then
+         begin
+            node := @FBuckets[i];
+            node^.Next := nil;
+            node^.Item := items^.Items[k];
+            Inc(k);
+            Inc(FSize);
+            for j := 2 to lengths[i] do
+            begin
+               NewNode(node^.Next); { may raise }
+               node := node^.Next;
+               node^.Next := nil;
+               node^.Item := items^.Items[k];
+               Inc(k);
+               Inc(FSize);
+            end;
+         end;
+      end;
+   except
+      { the items not yet placed in the table are not owned by anyone }
+      while k < num do
+      begin
+         DisposeItem(items^.Items[k]);
+         Inc(k);
+      end;
+      BufferDeallocate(items);
+      raise;
+   end;
+   BufferDeallocate(items);
+
+   FFirstUsedBucket := -1;
+   FCanShrink := false;
+end;
+
+procedure THashTable.ForEach(const funct : IUnaryFunctor);
+var
+   i : IndexType;
+   node : PHashNode;
+begin
+   for i := 0 to FCapacity - 1 do
+   begin
+      if FBuckets[i].Next <> @FBuckets[i] then
+      begin
+         node := @FBuckets[i];
+         while node <> nil do
+         begin
+            funct.Perform(node^.Item);
+            node := node^.Next;
+         end;
+      end;
+   end;
+end;
+
+function THashTable.Fold(const funct : IBinaryFunctor;
+                         init : ItemType) : ItemType;
+var
+   i : IndexType;
+   node : PHashNode;
+begin
+   Result := init;
+   for i := 0 to FCapacity - 1 do
+   begin
+      if FBuckets[i].Next <> @FBuckets[i] then
+      begin
+         node := @FBuckets[i];
+         while node <> nil do
+         begin
+            Result := funct.Perform(Result, node^.Item);
+            node := node^.Next;
+         end;
+      end;
+   end;
+end;
+
+function THashTable.FindIf(const pred : IUnaryPredicate;
+                           var aitem : ItemType) : Boolean;
+var
+   i : IndexType;
+   node : PHashNode;
+begin
+   for i := 0 to FCapacity - 1 do
+   begin
+      if FBuckets[i].Next <> @FBuckets[i] then
+      begin
+         node := @FBuckets[i];
+         while node <> nil do
+         begin
+            if pred.Test(node^.Item) then
+            begin
+               aitem := node^.Item;
+               Result := true;
+               Exit;
+            end;
+            node := node^.Next;
+         end;
+      end;
+   end;
+   Result := false;
+end;
+
+function THashTable.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   i : IndexType;
+   node : PHashNode;
+begin
+   Result := 0;
+   for i := 0 to FCapacity - 1 do
+   begin
+      if FBuckets[i].Next <> @FBuckets[i] then
+      begin
+         node := @FBuckets[i];
+         while node <> nil do
+         begin
+            if pred.Test(node^.Item) then
+               Inc(Result);
+            node := node^.Next;
+         end;
+      end;
+   end;
+end;
+
+function THashTable.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   i : IndexType;
+   node, prev : PHashNode;
+   aitem : ItemType;
+begin
+   Result := 0;
+   for i := 0 to FCapacity - 1 do
+   begin
+      if FBuckets[i].Next = @FBuckets[i] then
+         continue;
+
+      { as in ExtractNode, prev = nil denotes the first item, which is
+        stored in the bucket itself }
+      prev := nil;
+      node := @FBuckets[i];
+      while node <> nil do
+      begin
+         if pred.Test(node^.Item) then
+         begin
+            aitem := ExtractNode(i, prev);
+            Inc(Result);
+            DisposeItem(aitem);
+            { the next item is now at the position of the deleted one }
+            if prev <> nil then
+               node := prev^.Next
+            else if FBuckets[i].Next <> @FBuckets[i] then
+               node := @FBuckets[i]
+            else
+               node := nil;
+         end else
+         begin
+            prev := node;
+            node := node^.Next;
+         end;
+      end;
+   end;
+   if Result <> 0 then
+      CheckMinFillRatio;
+end;
+
 function THashTable.Start : TSetIterator;
 begin
    Result := THashTableIterator.Create(0, nil, self);
@@ -685,6 +991,111 @@ begin
    CheckMaxFillRatio;
 end;
 
+function THashTable.HasMany(const items : array of ItemType;
+                            var res : array of Boolean) : SizeType;
+var
+   hashes : array[0..htBatchSize - 1] of UnsignedType;
+   i, start, finish : IndexType;
+   bucket : IndexType;
+   node : PHashNode;
+begin
+   Assert(Length(res) >= Length(items), msgInvalidArgument);
+
+   Result := 0;
+   start := 0;
+   while start < Length(items) do
+   begin
+      finish := start + htBatchSize;
+      if finish > Length(items) then
+         finish := Length(items);
+      HashBatch(items, start, finish, hashes);
+
+      for i := start to finish - 1 do
+      begin
+         res[i] := FindNodeHashed(items[i], hashes[i - start], bucket, node);
+         if res[i] then
+            Inc(Result);
+      end;
+      start := finish;
+   end;
+end;
+
+&if (&_mcp_accepts_nil)
+function THashTable.FindMany(const items : array of ItemType;
+                             var res : array of ItemType) : SizeType;
+var
+   hashes : array[0..htBatchSize - 1] of UnsignedType;
+   i, start, finish : IndexType;
+   bucket : IndexType;
+   node : PHashNode;
+begin
+   Assert(Length(res) >= Length(items), msgInvalidArgument);
+
+   Result := 0;
+   start := 0;
+   while start < Length(items) do
+   begin
+      finish := start + htBatchSize;
+      if finish > Length(items) then
+         finish := Length(items);
+      HashBatch(items, start, finish, hashes);
+
+      for i := start to finish - 1 do
+      begin
+         if FindNodeHashed(items[i], hashes[i - start], bucket, node) then
+         begin
+            if node = nil then
+               res[i] := FBuckets[bucket].Item
+            else
+               res[i] := node^.Next^.Item;
+            Inc(Result);
+         end else
+            res[i] := nil;
+      end;
+      start := finish;
+   end;
+end;
+&endif &# end &_mcp_accepts_nil
+
+function THashTable.InsertMany(const items : array of ItemType;
+                               var res : array of Boolean) : SizeType;
+var
+   hashes : array[0..htBatchSize - 1] of UnsignedType;
+   i, start, finish : IndexType;
+   bucket : IndexType;
+   node : PHashNode;
+begin
+   Assert(Length(res) >= Length(items), msgInvalidArgument);
+
+   for i := 0 to Length(items) - 1 do
+      res[i] := false;
+
+   Result := 0;
+   start := 0;
+   while start < Length(items) do
+   begin
+      finish := start + htBatchSize;
+      if finish > Length(items) then
+         finish := Length(items);
+      HashBatch(items, start, finish, hashes);
+
+      for i := start to finish - 1 do
+      begin
+         { the hashes stay valid even if the table is rehashed in the
+           middle of the batch; only the prefetches are wasted then }
+         if not FindNodeHashed(items[i], hashes[i - start], bucket, node)
+               or RepeatedItems then
+         begin
+            InsertNode(bucket, node, items[i]);
+            res[i] := true;
+            Inc(Result);
+            CheckMaxFillRatio;
+         end;
+      end;
+      start := finish;
+   end;
+end;
+
 procedure THashTable.Delete(pos : TSetIterator);
 var
    aitem : ItemType;
@@ -930,6 +1341,9 @@ begin
    FCapacity := NewCapacity;
    FTableSize := NewTableSize;
    FFirstUsedBucket := -1;
+{$ifdef PASCAL_ADT_STATS }
+   Inc(FStats.Rehashes);
+{$endif PASCAL_ADT_STATS }
 
    for i := 0 to FCapacity - 1 do
    begin
@@ -1475,6 +1889,12 @@ begin
 end;
 
 function TScatterTable.DoInsert(aitem : ItemType; var h : IndexType) : SizeType;
+begin
+   Result := DoInsertHashed(aitem, Hasher.Hash(aitem), h);
+end;
+
+function TScatterTable.DoInsertHashed(aitem : ItemType; hashValue : UnsignedType;
+                                      var h : IndexType) : SizeType;
 var
    i, ii, ii2 : IndexType;
    p : SizeType;
@@ -1486,7 +1906,7 @@ begin
      table could possibly invalidate them. }
    CheckMaxFillRatio;
 
-   h := GetIndex(Hasher.Hash(aitem));
+   h := GetIndex(hashValue);
    { find the first item equal to aitem, if not found insert at the back
      of the collision chain; if found find the nearest item not equal
      to aitem, exchange aitem with it and continue with inserting this
@@ -1669,6 +2089,43 @@ begin
    FFirstUsedIndex := -1;
 end; { end DoInsert }
 
+function TScatterTable.LocateHashed(aitem : ItemType;
+                                    hashValue : UnsignedType) : IndexType;
+var
+   h : IndexType;
+   p : SizeType;
+begin
+   h := GetIndex(hashValue);
+   Result := h;
+   if (FArray^.Items[h] <> stFree) and
+         ((FArray^.Items[h] = stDeleted) or
+             (not _mcp_equal(FArray^.Items[h], aitem))) then
+   begin
+      p := FirstProbe;
+      Result := GetIndex(h + p);
+      while (FArray^.Items[Result] <> stFree) and
+               ((FArray^.Items[Result] = stDeleted) or
+                   (not _mcp_equal(FArray^.Items[Result], aitem))) do
+      begin
+         p := NextProbe(p);
+         Result := GetIndex(h + p);
+      end;
+   end;
+end;
+
+procedure TScatterTable.HashBatch(const items : array of ItemType;
+                                  start, finish : IndexType;
+                                  var hashes : array of UnsignedType);
+var
+   i : IndexType;
+begin
+   for i := start to finish - 1 do
+   begin
+      hashes[i - start] := Hasher.Hash(items[i]);
+      &_mcp_prefetch(FArray^.Items[GetIndex(hashes[i - start])]);
+   end;
+end;
+
 function TScatterTable.DoInsert(aitem : ItemType) : Boolean;
 var
    dummy : IndexType;
@@ -1808,6 +2265,37 @@ begin
 end;
 {$endif TEST_PASCAL_ADT }
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TScatterTable.GetStats(var stats : TContainerStats);
+var
+   i, h : IndexType;
+   p, len : SizeType;
+begin
+   inherited;
+   stats.UsedSlots := FArray^.Size;
+   Inc(stats.Bytes, FArray^.Capacity * SizeOf(ItemType));
+   for i := 0 to FArray^.Capacity - 1 do
+   begin
+      if (FArray^.Items[i] <> stFree) and (FArray^.Items[i] <> stDeleted) then
+      begin
+         { follow the probe sequence of the item until it is reached }
+         h := GetIndex(Hasher.Hash(FArray^.Items[i]));
+         p := 0;
+         len := 1;
+         while GetIndex(h + p) <> i do
+         begin
+            if p = 0 then
+               p := FirstProbe
+            else
+               p := NextProbe(p);
+            Inc(len);
+         end;
+         AddProbeLength(stats, len);
+      end;
+   end;
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TScatterTable.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
 begin
    Result := TScatterTable.CreateCopy(self, itemcopier);
@@ -1833,6 +2321,187 @@ begin
       inherited;
 end;
 
+procedure TScatterTable.SaveToStream(stream : TStream; const streamer : IStreamer);
+var
+   states : array of Byte;
+   i : IndexType;
+begin
+   StreamWriteHeader(stream, sfScatterTable, SizeOf(ItemType));
+   StreamWriteSize(stream, FTableSize);
+   StreamWriteSize(stream, FArray^.Size);
+   StreamWriteSize(stream, FDeletedFields);
+
+   SetLength(states, FArray^.Capacity);
+   for i := 0 to FArray^.Capacity - 1 do
+   begin
+      if FArray^.Items[i] = stFree then
+         states[i] := stStreamFree
+      else if FArray^.Items[i] = stDeleted then
+         states[i] := stStreamDeleted
+      else
+         states[i] := stStreamUsed;
+   end;
+   stream.WriteBuffer(states[0], FArray^.Capacity);
+
+   for i := 0 to FArray^.Capacity - 1 do
+   begin
+      if states[i] = stStreamUsed then
+         StreamWriteItem(stream, FArray^.Items[i], streamer);
+   end;
+end;
+
+procedure TScatterTable.LoadFromStream(stream : TStream; const streamer : IStreamer);
+var
+   states : array of Byte;
+   newarr : TDynamicArray;
+   tableSize, cap, num, delFields, used, deleted : SizeType;
+   i, j : IndexType;
+begin
+   StreamReadHeader(stream, sfScatterTable, SizeOf(ItemType));
+   tableSize := StreamReadSize(stream);
+   num := StreamReadSize(stream);
+   delFields := StreamReadSize(stream);
+   if (tableSize < stMinTableSize) or
+         (tableSize >= SizeOf(SizeType)*adtBitsInByte - 1) then
+   begin
+      raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+   end;
+   cap := CalculateCapacity(tableSize);
+   if cap > stream.Size - stream.Position then
+      raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+
+   SetLength(states, cap);
+   stream.ReadBuffer(states[0], cap);
+   used := 0;
+   deleted := 0;
+   for i := 0 to cap - 1 do
+   begin
+      case states[i] of
+         stStreamFree: ;
+         stStreamDeleted: Inc(deleted);
+         stStreamUsed: Inc(used);
+      else
+         raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+      end;
+   end;
+   { there must be at least one free field, otherwise probing would
+     never stop }
+   if (used <> num) or (deleted <> delFields) or (used + deleted >= cap) then
+      raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+
+   ArrayAllocate(newarr, cap, 0);
+   i := 0;
+   try
+      while i < cap do
+      begin
+         case states[i] of
+            stStreamFree: newarr^.Items[i] := stFree;
+            stStreamDeleted: newarr^.Items[i] := stDeleted;
+            stStreamUsed: StreamReadItem(stream, newarr^.Items[i], streamer);
+         end;
+         Inc(i);
+      end;
+   except
+      for j := 0 to i - 1 do
+      begin
+         if states[j] = stStreamUsed then
+            DisposeItem(newarr^.Items[j]);
+      end;
+      ArrayDeallocate(newarr);
+      raise;
+   end;
+
+   Clear;
+   ArrayDeallocate(FArray);
+   FArray := newarr;
+   FArray^.Size := num;
+   FTableSize := tableSize;
+   FDeletedFields := delFields;
+   FCanShrink := false;
+   FFirstUsedIndex := -1;
+end;
+
+procedure TScatterTable.ForEach(const funct : IUnaryFunctor);
+var
+   i : IndexType;
+begin
+   for i := 0 to FArray^.Capacity - 1 do
+   begin
+      if (FArray^.Items[i] <> stFree) and (FArray^.Items[i] <> stDeleted) then
+         funct.Perform(FArray^.Items[i]);
+   end;
+end;
+
+function TScatterTable.Fold(const funct : IBinaryFunctor;
+                            init : ItemType) : ItemType;
+var
+   i : IndexType;
+begin
+   Result := init;
+   for i := 0 to FArray^.Capacity - 1 do
+   begin
+      if (FArray^.Items[i] <> stFree) and (FArray^.Items[i] <> stDeleted) then
+         Result := funct.Perform(Result, FArray^.Items[i]);
+   end;
+end;
+
+function TScatterTable.FindIf(const pred : IUnaryPredicate;
+                              var aitem : ItemType) : Boolean;
+var
+   i : IndexType;
+begin
+   for i := 0 to FArray^.Capacity - 1 do
+   begin
+      if (FArray^.Items[i] <> stFree) and (FArray^.Items[i] <> stDeleted) and
+            pred.Test(FArray^.Items[i]) then
+      begin
+         aitem := FArray^.Items[i];
+         Result := true;
+         Exit;
+      end;
+   end;
+   Result := false;
+end;
+
+function TScatterTable.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   i : IndexType;
+begin
+   Result := 0;
+   for i := 0 to FArray^.Capacity - 1 do
+   begin
+      if (FArray^.Items[i] <> stFree) and (FArray^.Items[i] <> stDeleted) and
+            pred.Test(FArray^.Items[i]) then
+      begin
+         Inc(Result);
+      end;
+   end;
+end;
+
+function TScatterTable.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   i : IndexType;
+   aitem : ItemType;
+begin
+   Result := 0;
+   for i := 0 to FArray^.Capacity - 1 do
+   begin
+      if (FArray^.Items[i] <> stFree) and (FArray^.Items[i] <> stDeleted) and
+            pred.Test(FArray^.Items[i]) then
+      begin
+         aitem := FArray^.Items[i];
+         FArray^.Items[i] := stDeleted;
+         Inc(FDeletedFields);
+         Dec(FArray^.Size);
+         Inc(Result);
+         FFirstUsedIndex := -1;
+         DisposeItem(aitem);
+      end;
+   end;
+   if Result <> 0 then
+      CheckMinFillRatio;
+end;
+
 function TScatterTable.Start : TSetIterator;
 begin
    Result := TScatterTableIterator.Create(0, 0, self);
@@ -2020,6 +2689,104 @@ begin
    Result := DoInsert(aitem);
 end;
 
+function TScatterTable.HasMany(const items : array of ItemType;
+                               var res : array of Boolean) : SizeType;
+var
+   hashes : array[0..stBatchSize - 1] of UnsignedType;
+   i, start, finish : IndexType;
+begin
+   Assert(Length(res) >= Length(items), msgInvalidArgument);
+
+   CheckDeletedFields;
+
+   Result := 0;
+   start := 0;
+   while start < Length(items) do
+   begin
+      finish := start + stBatchSize;
+      if finish > Length(items) then
+         finish := Length(items);
+      HashBatch(items, start, finish, hashes);
+
+      for i := start to finish - 1 do
+      begin
+         res[i] := FArray^.Items[LocateHashed(items[i], hashes[i - start])] <>
+                      stFree;
+         if res[i] then
+            Inc(Result);
+      end;
+      start := finish;
+   end;
+end;
+
+&if (&_mcp_accepts_nil)
+function TScatterTable.FindMany(const items : array of ItemType;
+                                var res : array of ItemType) : SizeType;
+var
+   hashes : array[0..stBatchSize - 1] of UnsignedType;
+   i, start, finish : IndexType;
+begin
+   Assert(Length(res) >= Length(items), msgInvalidArgument);
+
+   CheckDeletedFields;
+
+   Result := 0;
+   start := 0;
+   while start < Length(items) do
+   begin
+      finish := start + stBatchSize;
+      if finish > Length(items) then
+         finish := Length(items);
+      HashBatch(items, start, finish, hashes);
+
+      for i := start to finish - 1 do
+      begin
+         { stFree is nil }
+         res[i] := FArray^.Items[LocateHashed(items[i], hashes[i - start])];
+         if res[i] <> nil then
+            Inc(Result);
+      end;
+      start := finish;
+   end;
+end;
+&endif &# end &_mcp_accepts_nil
+
+function TScatterTable.InsertMany(const items : array of ItemType;
+                                  var res : array of Boolean) : SizeType;
+var
+   hashes : array[0..stBatchSize - 1] of UnsignedType;
+   i, start, finish : IndexType;
+   h : IndexType;
+   prevSize : SizeType;
+begin
+   Assert(Length(res) >= Length(items), msgInvalidArgument);
+
+   for i := 0 to Length(items) - 1 do
+      res[i] := false;
+
+   Result := 0;
+   start := 0;
+   while start < Length(items) do
+   begin
+      finish := start + stBatchSize;
+      if finish > Length(items) then
+         finish := Length(items);
+      HashBatch(items, start, finish, hashes);
+
+      for i := start to finish - 1 do
+      begin
+         prevSize := FArray^.Size;
+         DoInsertHashed(items[i], hashes[i - start], h);
+         if FArray^.Size <> prevSize then
+         begin
+            res[i] := true;
+            Inc(Result);
+         end;
+      end;
+      start := finish;
+   end;
+end;
+
 procedure TScatterTable.Delete(pos : TSetIterator);
 var
    i : IndexType;
@@ -2258,6 +3025,9 @@ begin
    ArrayDeallocate(oldtab);
 
    FCanShrink := false;
+{$ifdef PASCAL_ADT_STATS }
+   Inc(FStats.Rehashes);
+{$endif PASCAL_ADT_STATS }
 end;
 
 procedure TScatterTable.Clear;
@@ -59,6 +59,12 @@ type
         item Sizeer, so the callee needs to update it itself }
       procedure DoMove(dest, source1, source2 : PSingleListNode;
                        list2 : TSingleList);
+      { merges two adjacent sorted runs; the first run consists of
+        lenA nodes following <pa>, <pb> is its last node, the second
+        run consists of lenB nodes following <pb>; returns the last
+        node of the merged run }
+      function MergeRuns(pa, pb : PSingleListNode; lenA, lenB : SizeType;
+                         const comparer : IBinaryComparer) : PSingleListNode;
    public
       constructor Create; overload;
       { a copy-constructor; creates self as a copy of <cont>; uses
@@ -72,6 +78,10 @@ type
                            IUnaryFunctor) : TContainerAdt; override;
       { @see TContainerAdt.Swap; }
       procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Nodes (including the header node) }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       { returns the start iterator; @see Tutorial }
       function ForwardStart : TForwardIterator; override;
       { returns the finish iterator; @see Tutorial }
@@ -125,6 +135,31 @@ type
       function Size : SizeType; override;
       { returns false }
       function IsDefinedOrder : Boolean; override;
+      { sorts the list with a natural merge sort, which repeatedly
+        merges adjacent non-descending runs and only relinks the nodes
+        with DoMove; no items are copied and no iterators are created;
+        <comparer> may be nil only for the types for which a default
+        comparison is defined (see adtalgs); as the positions in a
+        singly linked list are represented by the preceding nodes, all
+        iterators into the list are invalidated; @stable yes;
+        @complexity O(n*log(r)), where r is the number of
+        non-descending runs in the list, i.e. O(n) for sorted input;
+        @memory-usage O(1) }
+      procedure StableSort(const comparer : IBinaryComparer);
+      { the same as @<StableSort>; there is no faster unstable sort for
+        linked lists }
+      procedure Sort(const comparer : IBinaryComparer);
+      { walks the nodes from StartNode^.Next, prefetching the next node
+        while the current item is processed; no iterators are created }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { unlinks the nodes of the deleted items in one pass, keeping a
+        pointer to the preceding node }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
       
       { returns a pointer to the start node in the list; this property
         should be used only in performance-critical code as it does
@@ -229,6 +264,12 @@ type
         item Sizeer, so the callee needs to update it itself }
       procedure DoMove(dest, source1, source2 : PDoubleListNode;
                        list2 : TDoubleList);
+      { merges two adjacent sorted runs; the first run consists of
+        lenA nodes starting with <pa>, the second one of lenB nodes
+        starting with <pb>; returns the node following the merged
+        run }
+      function MergeRuns(pa, pb : PDoubleListNode; lenA, lenB : SizeType;
+                         const comparer : IBinaryComparer) : PDoubleListNode;
    public
       constructor Create; overload;
       { a copy-constructor; creates self as a copy of cont; uses
@@ -242,6 +283,10 @@ type
                            IUnaryFunctor) : TContainerAdt; override;
       { @see TContainerAdt.Swap; }
       procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Nodes (including the header node) }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       function ForwardStart : TForwardIterator; override;
       function ForwardFinish : TForwardIterator; override;
       { returns the start iterator }
@@ -283,6 +328,37 @@ type
       function Size : SizeType; override;
       { returns false }
       function IsDefinedOrder : Boolean; override;
+      { sorts the list with a natural merge sort, which repeatedly
+        merges adjacent non-descending runs and only relinks the nodes
+        with DoMove; no items are copied and no iterators are created;
+        <comparer> may be nil only for the types for which a default
+        comparison is defined (see adtalgs); the iterators into the list
+        remain valid and point to the same items as before; @stable
+        yes; @complexity O(n*log(r)), where r is the number of
+        non-descending runs in the list, i.e. O(n) for sorted input;
+        @memory-usage O(1) }
+      procedure StableSort(const comparer : IBinaryComparer);
+      { the same as @<StableSort>; there is no faster unstable sort for
+        linked lists }
+      procedure Sort(const comparer : IBinaryComparer);
+      { walk the ring of nodes from StartNode to FinishNode,
+        prefetching the next node while the current item is processed;
+        no iterators are created }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { unlinks the nodes of the deleted items in one pass }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { reverses the order of the items in the range [astart,afinish)
+        by walking the nodes inwards from both ends and exchanging
+        their items; the nodes are not relinked, so all iterators keep
+        pointing at the same positions, exactly as with the Reverse
+        algorithm from @<adtalgs>, which calls this for doubly linked
+        lists; @complexity O(n) }
+      procedure Reverse(astart, afinish : TForwardIterator);
       
       { returns a pointer to the start node in the list; this property
         should be used only in performance-critical code as it does
@@ -378,6 +454,14 @@ type
       procedure DoMove(dest, prevdest,
                        source1, prevs1,
                        source2, prevs2 : PXListNode; list2 : TXorList);
+      { merges two adjacent sorted runs; the first run consists of
+        lenA nodes starting with <pa>, the second one of lenB nodes
+        starting with <pb>; prevA and prevB are the nodes before <pa>
+        and <pb>; on exit <pa> is the node following the merged run
+        and <prevA> the node before it }
+      procedure MergeRuns(var pa, prevA : PXListNode; pb, prevB : PXListNode;
+                          lenA, lenB : SizeType;
+                          const comparer : IBinaryComparer);
       procedure DoClear;
    public
       constructor Create; overload;
@@ -392,6 +476,10 @@ type
                            IUnaryFunctor) : TContainerAdt; override;
       { @see TContainerAdt.Swap; }
       procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Nodes }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       function ForwardStart : TForwardIterator; override;
       function ForwardFinish : TForwardIterator; override;
       { returns an iterator to the first item in the list (the start
@@ -423,6 +511,30 @@ type
       function Size : SizeType; override;
       { returns false }
       function IsDefinedOrder : Boolean; override;
+      { sorts the list with a natural merge sort, which repeatedly
+        merges adjacent non-descending runs and only relinks the nodes
+        with DoMove; no items are copied and no iterators are created;
+        <comparer> may be nil only for the types for which a default
+        comparison is defined (see adtalgs); the iterators into the list
+        are invalidated, because they store the preceding nodes; @stable
+        yes; @complexity O(n*log(r)), where r is the number of
+        non-descending runs in the list, i.e. O(n) for sorted input;
+        @memory-usage O(1) }
+      procedure StableSort(const comparer : IBinaryComparer);
+      { the same as @<StableSort>; there is no faster unstable sort for
+        linked lists }
+      procedure Sort(const comparer : IBinaryComparer);
+      { walk the nodes from the front, decoding the next node from the
+        previous one and prefetching it while the current item is
+        processed; no iterators are created }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { unlinks the nodes of the deleted items in one pass }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
    end;
 
    { an iterator into a XOR list }
@@ -170,6 +170,44 @@ begin
       FFinishNode := source2;
 end;
 
+{ pa^.Next is the current node of the first run and pb^.Next the
+  current node of the second one; pb remains the last node of the
+  first run until it is exhausted }
+function TSingleList.MergeRuns(pa, pb : PSingleListNode; lenA, lenB : SizeType;
+                               const comparer : IBinaryComparer) : PSingleListNode;
+var
+   q : PSingleListNode;
+begin
+   while (lenA > 0) and (lenB > 0) do
+   begin
+      if &_mcp_lt(pb^.Next^.Item, pa^.Next^.Item, comparer) then
+      begin
+         { move the longest prefix of the second run smaller than the
+           current item of the first run at once }
+         q := pb^.Next;
+         Dec(lenB);
+         while (lenB > 0) and &_mcp_lt(q^.Next^.Item, pa^.Next^.Item, comparer) do
+         begin
+            q := q^.Next;
+            Dec(lenB);
+         end;
+         DoMove(pa, pb, q, self);
+         pa := q;
+      end else
+      begin
+         pa := pa^.Next;
+         Dec(lenA);
+      end;
+   end;
+
+   Result := pb;
+   while lenB > 0 do
+   begin
+      Result := Result^.Next;
+      Dec(lenB);
+   end;
+end;
+
 
 function TSingleList.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
 begin
@@ -192,6 +230,15 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TSingleList.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Nodes := stats.Items + 1;
+   Inc(stats.Bytes, stats.Nodes * SizeOf(TSingleListNode));
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TSingleList.ForwardStart : TForwardIterator;
 begin
    Result := TSingleListIterator.Create(FStartNode, self);
@@ -426,6 +473,135 @@ begin
    Result := false;
 end;
 
+procedure TSingleList.StableSort(const comparer : IBinaryComparer);
+var
+   pos, lastA, node : PSingleListNode;
+   lenA, lenB, merges : SizeType;
+begin
+   { each pass merges pairs of adjacent maximal non-descending runs,
+     so an already sorted list is only scanned once }
+   repeat
+      merges := 0;
+      pos := FStartNode;
+      while pos^.Next <> nil do
+      begin
+         lastA := pos;
+         lenA := 0;
+         repeat
+            lastA := lastA^.Next;
+            Inc(lenA);
+         until (lastA^.Next = nil) or
+                  &_mcp_lt(lastA^.Next^.Item, lastA^.Item, comparer);
+         node := lastA;
+         lenB := 0;
+         if node^.Next <> nil then
+         begin
+            repeat
+               node := node^.Next;
+               Inc(lenB);
+            until (node^.Next = nil) or
+                     &_mcp_lt(node^.Next^.Item, node^.Item, comparer);
+         end;
+         if lenB = 0 then
+            break;
+         pos := MergeRuns(pos, lastA, lenA, lenB, comparer);
+         Inc(merges);
+      end;
+   until merges = 0;
+end;
+
+procedure TSingleList.Sort(const comparer : IBinaryComparer);
+begin
+   StableSort(comparer);
+end;
+
+procedure TSingleList.ForEach(const funct : IUnaryFunctor);
+var
+   node, next : PSingleListNode;
+begin
+   node := FStartNode^.Next;
+   while node <> nil do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      funct.Perform(node^.Item);
+      node := next;
+   end;
+end;
+
+function TSingleList.Fold(const funct : IBinaryFunctor;
+                          init : ItemType) : ItemType;
+var
+   node, next : PSingleListNode;
+begin
+   Result := init;
+   node := FStartNode^.Next;
+   while node <> nil do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      Result := funct.Perform(Result, node^.Item);
+      node := next;
+   end;
+end;
+
+function TSingleList.FindIf(const pred : IUnaryPredicate;
+                            var aitem : ItemType) : Boolean;
+var
+   node, next : PSingleListNode;
+begin
+   node := FStartNode^.Next;
+   while node <> nil do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      if pred.Test(node^.Item) then
+      begin
+         aitem := node^.Item;
+         Result := true;
+         Exit;
+      end;
+      node := next;
+   end;
+   Result := false;
+end;
+
+function TSingleList.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   node, next : PSingleListNode;
+begin
+   Result := 0;
+   node := FStartNode^.Next;
+   while node <> nil do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      if pred.Test(node^.Item) then
+         Inc(Result);
+      node := next;
+   end;
+end;
+
+function TSingleList.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   prev : PSingleListNode;
+   aitem : ItemType;
+begin
+   Result := 0;
+   prev := FStartNode;
+   while prev^.Next <> nil do
+   begin
+      &_mcp_prefetch(prev^.Next^.Next^);
+      if pred.Test(prev^.Next^.Item) then
+      begin
+         aitem := ExtractNode(prev); { updates FFinishNode and FSize }
+         Inc(Result);
+         DisposeItem(aitem);
+      end else
+         prev := prev^.Next;
+   end;
+end;
+
 function TSingleList.InsertNode(pos : PSingleListNode;
                                 aitem : ItemType) : PSingleListNode;
 begin
@@ -694,6 +870,41 @@ begin
       FStartNode := source1;
 end;
 
+function TDoubleList.MergeRuns(pa, pb : PDoubleListNode; lenA, lenB : SizeType;
+                               const comparer : IBinaryComparer) : PDoubleListNode;
+var
+   q : PDoubleListNode;
+begin
+   while (lenA > 0) and (lenB > 0) do
+   begin
+      if &_mcp_lt(pb^.Item, pa^.Item, comparer) then
+      begin
+         { move the longest prefix of the second run smaller than the
+           current item of the first run at once }
+         q := pb^.Next;
+         Dec(lenB);
+         while (lenB > 0) and &_mcp_lt(q^.Item, pa^.Item, comparer) do
+         begin
+            q := q^.Next;
+            Dec(lenB);
+         end;
+         DoMove(pa, pb, q, self);
+         pb := q;
+      end else
+      begin
+         pa := pa^.Next;
+         Dec(lenA);
+      end;
+   end;
+
+   Result := pb;
+   while lenB > 0 do
+   begin
+      Result := Result^.Next;
+      Dec(lenB);
+   end;
+end;
+
 function TDoubleList.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
 begin
    Result := TDoubleList.CreateCopy(self, ItemCopier);
@@ -714,6 +925,15 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TDoubleList.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Nodes := stats.Items + 1;
+   Inc(stats.Bytes, stats.Nodes * SizeOf(TDoubleListNode));
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TDoubleList.ForwardStart : TForwardIterator;
 begin
    Result := Start;
@@ -966,6 +1186,166 @@ begin
    Result := false;
 end;
 
+procedure TDoubleList.StableSort(const comparer : IBinaryComparer);
+var
+   node, pb, q, last, finish : PDoubleListNode;
+   lenA, lenB, merges : SizeType;
+begin
+   { the finish node is never moved }
+   finish := GetFinishNode;
+   { each pass merges pairs of adjacent maximal non-descending runs,
+     so an already sorted list is only scanned once }
+   repeat
+      merges := 0;
+      node := FStartNode;
+      while node <> finish do
+      begin
+         pb := node;
+         lenA := 0;
+         repeat
+            last := pb;
+            pb := pb^.Next;
+            Inc(lenA);
+         until (pb = finish) or &_mcp_lt(pb^.Item, last^.Item, comparer);
+         q := pb;
+         lenB := 0;
+         if q <> finish then
+         begin
+            repeat
+               last := q;
+               q := q^.Next;
+               Inc(lenB);
+            until (q = finish) or &_mcp_lt(q^.Item, last^.Item, comparer);
+         end;
+         if lenB = 0 then
+            break;
+         node := MergeRuns(node, pb, lenA, lenB, comparer);
+         Inc(merges);
+      end;
+   until merges = 0;
+end;
+
+procedure TDoubleList.Sort(const comparer : IBinaryComparer);
+begin
+   StableSort(comparer);
+end;
+
+procedure TDoubleList.ForEach(const funct : IUnaryFunctor);
+var
+   node, next, finish : PDoubleListNode;
+begin
+   node := FStartNode;
+   finish := GetFinishNode;
+   while node <> finish do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      funct.Perform(node^.Item);
+      node := next;
+   end;
+end;
+
+function TDoubleList.Fold(const funct : IBinaryFunctor;
+                          init : ItemType) : ItemType;
+var
+   node, next, finish : PDoubleListNode;
+begin
+   Result := init;
+   node := FStartNode;
+   finish := GetFinishNode;
+   while node <> finish do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      Result := funct.Perform(Result, node^.Item);
+      node := next;
+   end;
+end;
+
+function TDoubleList.FindIf(const pred : IUnaryPredicate;
+                            var aitem : ItemType) : Boolean;
+var
+   node, next, finish : PDoubleListNode;
+begin
+   node := FStartNode;
+   finish := GetFinishNode;
+   while node <> finish do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      if pred.Test(node^.Item) then
+      begin
+         aitem := node^.Item;
+         Result := true;
+         Exit;
+      end;
+      node := next;
+   end;
+   Result := false;
+end;
+
+function TDoubleList.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   node, next, finish : PDoubleListNode;
+begin
+   Result := 0;
+   node := FStartNode;
+   finish := GetFinishNode;
+   while node <> finish do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      if pred.Test(node^.Item) then
+         Inc(Result);
+      node := next;
+   end;
+end;
+
+function TDoubleList.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   node, next, finish : PDoubleListNode;
+   aitem : ItemType;
+begin
+   Result := 0;
+   node := FStartNode;
+   finish := GetFinishNode;
+   while node <> finish do
+   begin
+      next := node^.Next;
+      &_mcp_prefetch(next^);
+      if pred.Test(node^.Item) then
+      begin
+         aitem := ExtractNode(node); { updates FStartNode and FSize }
+         Inc(Result);
+         DisposeItem(aitem);
+      end;
+      node := next;
+   end;
+end;
+
+procedure TDoubleList.Reverse(astart, afinish : TForwardIterator);
+var
+   first, last : PDoubleListNode;
+   aitem : ItemType;
+begin
+   Assert(astart is TDoubleListIterator, msgInvalidIterator);
+   Assert(afinish is TDoubleListIterator, msgInvalidIterator);
+   Assert((astart.Owner = self) and (afinish.Owner = self), msgWrongOwner);
+
+   first := TDoubleListIterator(astart).Node;
+   last := TDoubleListIterator(afinish).Node;
+   while first <> last do
+   begin
+      last := last^.Prev;
+      if first = last then
+         break;
+      aitem := first^.Item;
+      first^.Item := last^.Item;
+      last^.Item := aitem;
+      first := first^.Next;
+   end;
+end;
+
 function TDoubleList.InsertNode(pos : PDoubleListNode;
                                 aitem : ItemType) : PDoubleListNode;
 begin
@@ -1318,6 +1698,52 @@ begin
       BackNode := prevs2;
 end;
 
+{ prevB remains the last node of the first run until it is exhausted }
+procedure TXorList.MergeRuns(var pa, prevA : PXListNode; pb, prevB : PXListNode;
+                             lenA, lenB : SizeType;
+                             const comparer : IBinaryComparer);
+var
+   q, prevq, temp : PXListNode;
+begin
+   while (lenA > 0) and (lenB > 0) do
+   begin
+      if &_mcp_lt(pb^.Item, pa^.Item, comparer) then
+      begin
+         { move the longest prefix of the second run smaller than the
+           current item of the first run at once }
+         q := PXListNode(pb^.PN xor PointerValueType(prevB));
+         prevq := pb;
+         Dec(lenB);
+         while (lenB > 0) and &_mcp_lt(q^.Item, pa^.Item, comparer) do
+         begin
+            temp := q;
+            q := PXListNode(q^.PN xor PointerValueType(prevq));
+            prevq := temp;
+            Dec(lenB);
+         end;
+         DoMove(pa, prevA, pb, prevB, q, prevq, self);
+         prevA := prevq;
+         pb := q;
+      end else
+      begin
+         temp := pa;
+         pa := PXListNode(pa^.PN xor PointerValueType(prevA));
+         prevA := temp;
+         Dec(lenA);
+      end;
+   end;
+
+   pa := pb;
+   prevA := prevB;
+   while lenB > 0 do
+   begin
+      temp := pa;
+      pa := PXListNode(pa^.PN xor PointerValueType(prevA));
+      prevA := temp;
+      Dec(lenB);
+   end;
+end;
+
 procedure TXorList.DoClear;
 var
    next, temp : PXListNode;
@@ -1363,6 +1789,15 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TXorList.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Nodes := stats.Items;
+   Inc(stats.Bytes, stats.Nodes * SizeOf(TXListNode));
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TXorList.ForwardStart : TForwardIterator;
 begin
    Result := Start;
@@ -1635,6 +2070,150 @@ begin
    Result := false;
 end;
 
+procedure TXorList.StableSort(const comparer : IBinaryComparer);
+var
+   node, prev, pb, prevB, q, prevq, temp : PXListNode;
+   lenA, lenB, merges : SizeType;
+begin
+   { each pass merges pairs of adjacent maximal non-descending runs,
+     so an already sorted list is only scanned once }
+   repeat
+      merges := 0;
+      node := FStartNode;
+      prev := nil;
+      while node <> nil do
+      begin
+         pb := node;
+         prevB := prev;
+         lenA := 0;
+         repeat
+            temp := pb;
+            pb := PXListNode(pb^.PN xor PointerValueType(prevB));
+            prevB := temp;
+            Inc(lenA);
+         until (pb = nil) or &_mcp_lt(pb^.Item, prevB^.Item, comparer);
+         q := pb;
+         prevq := prevB;
+         lenB := 0;
+         if q <> nil then
+         begin
+            repeat
+               temp := q;
+               q := PXListNode(q^.PN xor PointerValueType(prevq));
+               prevq := temp;
+               Inc(lenB);
+            until (q = nil) or &_mcp_lt(q^.Item, prevq^.Item, comparer);
+         end;
+         if lenB = 0 then
+            break;
+         MergeRuns(node, prev, pb, prevB, lenA, lenB, comparer);
+         Inc(merges);
+      end;
+   until merges = 0;
+end;
+
+procedure TXorList.Sort(const comparer : IBinaryComparer);
+begin
+   StableSort(comparer);
+end;
+
+procedure TXorList.ForEach(const funct : IUnaryFunctor);
+var
+   prev, node, next : PXListNode;
+begin
+   prev := nil;
+   node := FStartNode;
+   while node <> nil do
+   begin
+      next := PXListNode(node^.PN xor PointerValueType(prev));
+      &_mcp_prefetch(next^);
+      funct.Perform(node^.Item);
+      prev := node;
+      node := next;
+   end;
+end;
+
+function TXorList.Fold(const funct : IBinaryFunctor;
+                       init : ItemType) : ItemType;
+var
+   prev, node, next : PXListNode;
+begin
+   Result := init;
+   prev := nil;
+   node := FStartNode;
+   while node <> nil do
+   begin
+      next := PXListNode(node^.PN xor PointerValueType(prev));
+      &_mcp_prefetch(next^);
+      Result := funct.Perform(Result, node^.Item);
+      prev := node;
+      node := next;
+   end;
+end;
+
+function TXorList.FindIf(const pred : IUnaryPredicate;
+                         var aitem : ItemType) : Boolean;
+var
+   prev, node, next : PXListNode;
+begin
+   prev := nil;
+   node := FStartNode;
+   while node <> nil do
+   begin
+      next := PXListNode(node^.PN xor PointerValueType(prev));
+      &_mcp_prefetch(next^);
+      if pred.Test(node^.Item) then
+      begin
+         aitem := node^.Item;
+         Result := true;
+         Exit;
+      end;
+      prev := node;
+      node := next;
+   end;
+   Result := false;
+end;
+
+function TXorList.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   prev, node, next : PXListNode;
+begin
+   Result := 0;
+   prev := nil;
+   node := FStartNode;
+   while node <> nil do
+   begin
+      next := PXListNode(node^.PN xor PointerValueType(prev));
+      &_mcp_prefetch(next^);
+      if pred.Test(node^.Item) then
+         Inc(Result);
+      prev := node;
+      node := next;
+   end;
+end;
+
+function TXorList.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   prev, node, next : PXListNode;
+begin
+   Result := 0;
+   prev := nil;
+   node := FStartNode;
+   while node <> nil do
+   begin
+      next := PXListNode(node^.PN xor PointerValueType(prev));
+      &_mcp_prefetch(next^);
+      if pred.Test(node^.Item) then
+      begin
+         { prev stays the same, DoDelete relinks it with next }
+         DisposeNodeAndItem(DoDelete(node, prev));
+         Inc(Result);
+      end else
+         prev := node;
+      node := next;
+   end;
+end;
+
 { --------------------------- TXorListIterator members ------------------------- }
 
 constructor TXorListIterator.Create(thisnode, prevnode : PXListNode;
@@ -180,6 +180,32 @@ type
       function ExtractItem : ItemType; override;
       { returns false }
       function CanExtract : Boolean; override;
+      { writes a snapshot of the map to <stream>; <keyStreamer> is
+        used to write the keys and <itemStreamer> to write the items;
+        either may be nil, in which case the default binary
+        representation is written; the default implementation writes
+        all (key, item) pairs from Start to Finish; @complexity O(n) }
+      procedure SaveToStream(stream : TStream;
+                             const keyStreamer : IKeyStreamer;
+                             const itemStreamer : IItemStreamer); overload; virtual;
+      { replaces the contents of the map with a snapshot written by
+        SaveToStream with equivalent streamers; the default
+        implementation inserts the pairs with Insert }
+      procedure LoadFromStream(stream : TStream;
+                               const keyStreamer : IKeyStreamer;
+                               const itemStreamer : IItemStreamer); overload; virtual;
+      { the same as SaveToStream(stream, nil, streamer) }
+      procedure SaveToStream(stream : TStream;
+                             const streamer : IItemStreamer); overload; override;
+      { the same as LoadFromStream(stream, nil, streamer) }
+      procedure LoadFromStream(stream : TStream;
+                               const streamer : IItemStreamer); overload; override;
+      { searches the items (not the keys) from Start to Finish }
+      function FindIf(const pred : IItemUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      { deletes the (key, item) pairs whose items satisfy <pred>, from
+        Start to Finish, with the Delete method of a single iterator }
+      function DeleteIf(const pred : IItemUnaryPredicate) : SizeType; override;
    end;
 
    { ----------------- map iterator --------------------- }
@@ -323,6 +349,11 @@ type
       function CopySelf(const mapCopier : IUnaryFunctor) : TItemContainerAdt; override;
       { @see TMapAdt.Swap; }
       procedure Swap(cont : TItemContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { takes the structure of the underlying set and adds the
+        memory used by the entries }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       { returns the start iterator }
       function Start : TMapIterator; override;
       { returns the finish iterator }
@@ -347,6 +378,20 @@ type
       { Returns the range <LowerBound, UpperBound). Works faster than
         calling these two functions separately. }
       function EqualRange(key : KeyType) : TMapIteratorRange; override;
+      { delegates to the underlying set, so the snapshot preserves
+        its internal layout (e.g. the buckets of a THashTable); it may
+        be loaded only into a map using the same kind of set }
+      procedure SaveToStream(stream : TStream;
+                             const keyStreamer : IKeyStreamer;
+                             const itemStreamer : IItemStreamer); overload; override;
+      procedure LoadFromStream(stream : TStream;
+                               const keyStreamer : IKeyStreamer;
+                               const itemStreamer : IItemStreamer); overload; override;
+      { delegate to the FindIf and DeleteIf of the underlying set,
+        which walk its nodes without creating iterators }
+      function FindIf(const pred : IItemUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function DeleteIf(const pred : IItemUnaryPredicate) : SizeType; override;
       procedure Clear; override;
       function Empty : Boolean; override;
       function Size : SizeType; override;
@@ -39,6 +39,29 @@ type
       property Map : TMap read FMap;
    end;
 
+   { tests the items of the TMapEntry objects stored in the set of a
+     TMap with a predicate on items }
+   TMapEntryPredicate = class (TFunctor, IUnaryPredicate)
+   private
+      FPred : IItemUnaryPredicate;
+   public
+      constructor Create(const pred : IItemUnaryPredicate);
+      function Test(aitem : TObject) : Boolean;
+   end;
+
+   { writes and reads TMapEntry objects stored in the set of a TMap }
+   TMapStreamer = class (TFunctor, IStreamer)
+   private
+      FMap : TMap;
+      FKeyStreamer : IKeyStreamer;
+      FItemStreamer : IItemStreamer;
+   public
+      constructor Create(amap : TMap; const keyStreamer : IKeyStreamer;
+                         const itemStreamer : IItemStreamer);
+      procedure WriteItem(stream : TStream; aitem : TObject);
+      function ReadItem(stream : TStream) : TObject;
+   end;
+
    TMapCopier = class (TMapAdtCopier, IUnaryFunctor)
    private
       FMap : TMap;
@@ -229,6 +252,113 @@ begin
    Result := false;
 end;
 
+procedure TMapAdt.SaveToStream(stream : TStream;
+                               const keyStreamer : IKeyStreamer;
+                               const itemStreamer : IItemStreamer);
+var
+   iter : TMapIterator;
+begin
+   StreamWriteHeader(stream, sfGeneric, SizeOf(KeyType) + SizeOf(ItemType));
+   StreamWriteSize(stream, Size);
+   iter := Start;
+   try
+      while not iter.IsFinish do
+      begin
+         StreamWriteItem(stream, iter.Key, keyStreamer);
+         StreamWriteItem(stream, iter.Item, itemStreamer);
+         iter.Advance;
+      end;
+   finally
+      iter.Destroy;
+   end;
+end;
+
+procedure TMapAdt.LoadFromStream(stream : TStream;
+                                 const keyStreamer : IKeyStreamer;
+                                 const itemStreamer : IItemStreamer);
+var
+   num : SizeType;
+   k : KeyType;
+   aitem : ItemType;
+begin
+   StreamReadHeader(stream, sfGeneric, SizeOf(KeyType) + SizeOf(ItemType));
+   num := StreamReadSize(stream);
+   Clear;
+   while num <> 0 do
+   begin
+      k := DefaultKey;
+      aitem := DefaultItem;
+      StreamReadItem(stream, k, keyStreamer);
+      try
+         StreamReadItem(stream, aitem, itemStreamer);
+         if not Insert(k, aitem) then
+         begin
+            DisposeKey(k);
+            DisposeItem(aitem);
+         end;
+      except
+         DisposeKey(k);
+         DisposeItem(aitem);
+         raise;
+      end;
+      Dec(num);
+   end;
+end;
+
+procedure TMapAdt.SaveToStream(stream : TStream; const streamer : IItemStreamer);
+begin
+   SaveToStream(stream, nil, streamer);
+end;
+
+procedure TMapAdt.LoadFromStream(stream : TStream; const streamer : IItemStreamer);
+begin
+   LoadFromStream(stream, nil, streamer);
+end;
+
+function TMapAdt.FindIf(const pred : IItemUnaryPredicate;
+                        var aitem : ItemType) : Boolean;
+var
+   iter : TMapIterator;
+begin
+   Result := false;
+   iter := Start;
+   try
+      while not iter.IsFinish do
+      begin
+         if pred.Test(iter.Item) then
+         begin
+            aitem := iter.Item;
+            Result := true;
+            break;
+         end;
+         iter.Advance;
+      end;
+   finally
+      iter.Destroy;
+   end;
+end;
+
+function TMapAdt.DeleteIf(const pred : IItemUnaryPredicate) : SizeType;
+var
+   iter : TMapIterator;
+begin
+   Result := 0;
+   iter := Start;
+   try
+      while not iter.IsFinish do
+      begin
+         if pred.Test(iter.Item) then
+         begin
+            iter.Delete;
+            Inc(Result);
+         end else
+            iter.Advance;
+      end;
+   finally
+      iter.Destroy;
+   end;
+end;
+
 { ----------------------------- TMapIterator --------------------------------- }
 
 procedure TMapIterator.Insert(aitem : ItemType);
@@ -287,6 +417,18 @@ begin
    end;
 end;
 
+{ -------------------- TMapEntryPredicate ------------------------ }
+
+constructor TMapEntryPredicate.Create(const pred : IItemUnaryPredicate);
+begin
+   FPred := pred;
+end;
+
+function TMapEntryPredicate.Test(aitem : TObject) : Boolean;
+begin
+   Result := FPred.Test(TMapEntry(aitem).Item);
+end;
+
 { ----------------------- TMapCopier ----------------------------- }
 
 constructor TMapCopier.Create(const keycp : IKeyUnaryFunctor;
@@ -319,6 +461,44 @@ begin
       Result := nil;
 end;
 
+{ ----------------------- TMapStreamer ----------------------------- }
+
+constructor TMapStreamer.Create(amap : TMap; const keyStreamer : IKeyStreamer;
+                                const itemStreamer : IItemStreamer);
+begin
+   inherited Create;
+   FMap := amap;
+   FKeyStreamer := keyStreamer;
+   FItemStreamer := itemStreamer;
+end;
+
+procedure TMapStreamer.WriteItem(stream : TStream; aitem : TObject);
+begin
+   StreamWriteItem(stream, TMapEntry(aitem).Key, FKeyStreamer);
+   StreamWriteItem(stream, TMapEntry(aitem).Item, FItemStreamer);
+end;
+
+function TMapStreamer.ReadItem(stream : TStream) : TObject;
+var
+   k : KeyType;
+   aitem : ItemType;
+begin
+   k := DefaultKey;
+   aitem := DefaultItem;
+   StreamReadItem(stream, k, FKeyStreamer);
+   try
+      StreamReadItem(stream, aitem, FItemStreamer);
+      Result := TMapEntry.Create(k, aitem);
+   except
+      with FMap do
+      begin
+         DisposeKey(k);
+         DisposeItem(aitem);
+      end;
+      raise;
+   end;
+end;
+
 { --------------------------- TMapComparer ---------------------------------- }
 
 constructor TMapComparer.Create(const keycmp : IKeyBinaryComparer);
@@ -440,6 +620,27 @@ begin
    end;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TMap.GetStats(var stats : TContainerStats);
+var
+   setStats : TContainerStats;
+begin
+   inherited;
+   FSet.GetStats(setStats);
+   stats.Nodes := setStats.Nodes;
+   stats.Capacity := setStats.Capacity;
+   stats.UsedSlots := setStats.UsedSlots;
+   stats.LoadFactor := setStats.LoadFactor;
+   stats.ProbeLengths := setStats.ProbeLengths;
+   stats.MaxProbeLength := setStats.MaxProbeLength;
+   stats.Height := setStats.Height;
+   Inc(stats.Bytes, setStats.Bytes + stats.Items * TMapEntry.InstanceSize);
+   Inc(stats.Resizes, setStats.Resizes);
+   Inc(stats.Rehashes, setStats.Rehashes);
+   Inc(stats.Rotations, setStats.Rotations);
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TMap.Start : TMapIterator;
 begin
    Result := TMapAdaptorIterator.Create(FSet.Start, self);
@@ -602,6 +803,49 @@ begin
                      them }
 end;
 
+procedure TMap.SaveToStream(stream : TStream;
+                            const keyStreamer : IKeyStreamer;
+                            const itemStreamer : IItemStreamer);
+var
+   streamer : IStreamer;
+begin
+   streamer := TMapStreamer.Create(self, keyStreamer, itemStreamer);
+   FSet.SaveToStream(stream, streamer);
+end;
+
+procedure TMap.LoadFromStream(stream : TStream;
+                              const keyStreamer : IKeyStreamer;
+                              const itemStreamer : IItemStreamer);
+var
+   streamer : IStreamer;
+begin
+   streamer := TMapStreamer.Create(self, keyStreamer, itemStreamer);
+   CachedEntry := nil;
+   FSet.LoadFromStream(stream, streamer);
+end;
+
+function TMap.FindIf(const pred : IItemUnaryPredicate;
+                     var aitem : ItemType) : Boolean;
+var
+   entry : TObject;
+   epred : IUnaryPredicate;
+begin
+   entry := nil;
+   epred := TMapEntryPredicate.Create(pred);
+   Result := FSet.FindIf(epred, entry);
+   if Result then
+      aitem := TMapEntry(entry).Item;
+end;
+
+function TMap.DeleteIf(const pred : IItemUnaryPredicate) : SizeType;
+var
+   epred : IUnaryPredicate;
+begin
+   epred := TMapEntryPredicate.Create(pred);
+   CachedEntry := nil;
+   Result := FSet.DeleteIf(epred);
+end;
+
 procedure TMap.Clear;
 begin
    FSet.Clear;
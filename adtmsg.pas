@@ -84,6 +84,15 @@ const
    msgOutOfMemory = 'PascalAdt: Out of memory';
    msgNoArgCreate = 'Programming error: calling TContainerAdt.Create with no arguments';
 
+   { stream messages }
+   msgStreamSignature = 'LoadFromStream: The stream does not contain a container snapshot.';
+   msgStreamVersion = 'LoadFromStream: Unsupported version of the snapshot format.';
+   msgStreamFormat = 'LoadFromStream: The snapshot was written by a different kind of container or with a different item type.';
+   msgStreamCorrupted = 'LoadFromStream: The container snapshot is corrupted.';
+
+   { perfect hashing messages }
+   msgPerfectHashFailed = 'TPerfectHashFunction: Could not find a perfect hash function for the given hashes.';
+
 implementation
 
 end.
@@ -0,0 +1,116 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtparalgs.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtparalgs.defs
+
+{ All routines below take an optional <pool> argument - the pool
+  executing the work; @<DefaultTaskPool> is used if it is nil. Their
+  results are the same as those of the sequential routines with the
+  same names (without the Parallel prefix) from adtalgs. }
+
+{ ---------------------------- searching ------------------------------------- }
+
+{ returns an iterator pointing to the first item in [start,finish)
+  equal to <aitem>, or an iterator equal to finish if there is no such
+  item; chunks beyond the one where the item is found are not started;
+  @complexity O(n/p) }
+function ParallelFind(const start, finish : TRandomAccessIterator;
+                      aitem : ItemType;
+                      const comparer : IBinaryComparer = nil;
+                      pool : TTaskPool = nil) : TRandomAccessIterator; overload;
+{ the same as above, but uses pred to test which item to return }
+function ParallelFind(const start, finish : TRandomAccessIterator;
+                      const pred : IUnaryPredicate;
+                      pool : TTaskPool = nil) : TRandomAccessIterator; overload;
+{ returns the number of items satisfying the predicate pred;
+  @complexity O(n/p) }
+function ParallelCount(const start, finish : TRandomAccessIterator;
+                       const pred : IUnaryPredicate;
+                       pool : TTaskPool = nil) : SizeType; overload;
+{ returns an iterator pointing to the first minimal item in the range
+  [start,finish); @complexity O(n/p) }
+function ParallelMinimal(const start, finish : TRandomAccessIterator;
+                         const comparer : IBinaryComparer = nil;
+                         pool : TTaskPool = nil) : TRandomAccessIterator; overload;
+{ returns an iterator pointing to the first maximal item in the range
+  [start,finish); @complexity O(n/p) }
+function ParallelMaximal(const start, finish : TRandomAccessIterator;
+                         const comparer : IBinaryComparer = nil;
+                         pool : TTaskPool = nil) : TRandomAccessIterator; overload;
+{ returns true if two ranges are item-to-item equal; @complexity
+  O(n/p) }
+function ParallelEqual(const start1, finish1, start2 : TRandomAccessIterator;
+                       const pred : IBinaryPredicate;
+                       pool : TTaskPool = nil) : Boolean; overload;
+{ returns the first pair of iterators such that Result.First is an
+  iterator into the first range, Result.Second into the second, and
+  pred.Test(Result.First.Item, Result.Second.Item) is false; if there
+  is no such pair then Result.First is equal to finish1; @complexity
+  O(n/p) }
+function ParallelMismatch(const start1, finish1, start2 : TRandomAccessIterator;
+                          const pred : IBinaryPredicate;
+                          pool : TTaskPool = nil) : TForwardIteratorPair; overload;
+
+{ ---------------------------- modifying ------------------------------------- }
+
+{ replaces each item in [start,finish) with funct.Perform(item); the
+  items replaced are never disposed; @complexity O(n/p); @see ForEach }
+procedure ParallelForEach(const start, finish : TRandomAccessIterator;
+                          const funct : IUnaryFunctor;
+                          pool : TTaskPool = nil); overload;
+{ replaces each item in [start,finish) with funct.Perform(item); the
+  old items are all disposed; @complexity O(n/p); @see Generate }
+procedure ParallelGenerate(const start, finish : TRandomAccessIterator;
+                           const funct : IUnaryFunctor;
+                           pool : TTaskPool = nil); overload;
+{ copies items from [start1,finish1) to [start2,...) using itemCopier;
+  the second range must contain at least the same number of items as
+  the first one, and the items overwritten in it are disposed; the
+  ranges must not overlap; @complexity O(n/p); @see Copy }
+procedure ParallelCopy(const start1, finish1, start2 : TRandomAccessIterator;
+                       const itemCopier : IUnaryFunctor;
+                       pool : TTaskPool = nil); overload;
+{ partitions [start,finish) according to pred; returns an iterator
+  iter such that for each i in [start,iter) pred.Test(i.Item) is true,
+  for each i in [iter, finish) pred.Test(i.Item) is false; the chunks
+  are partitioned independently, after which the items on the wrong
+  side of the boundary are exchanged, also in parallel; not stable;
+  @complexity O(n/p); @see Partition }
+function ParallelPartition(const start, finish : TRandomAccessIterator;
+                           const pred : IUnaryPredicate;
+                           pool : TTaskPool = nil) : TRandomAccessIterator; overload;
+{ deletes all duplicate items from [start,finish), leaving only the
+  first item of each sequence of equal items; as with Unique, equal
+  items must come one after another; each chunk is compacted
+  separately, after which the items left are moved to their final
+  positions, found from the prefix sums of the numbers of items left
+  in the chunks, through an auxiliary buffer; @returns the number of
+  duplicates deleted; @complexity O(n/p) plus the cost of deleting
+  the duplicates from the container; @see Unique }
+function ParallelUnique(const start, finish : TRandomAccessIterator;
+                        const comparer : IBinaryComparer = nil;
+                        pool : TTaskPool = nil) : SizeType; overload;
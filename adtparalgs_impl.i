@@ -0,0 +1,763 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtparalgs_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtparalgs.defs
+&include adtparalgs_impl.mcp
+
+type
+   { finds the first index i for which Matches(i) is true; FFound is
+     FSize if there is no such index }
+   TParallelSearchJob = class (TParallelRangeJob)
+   protected
+      FFound : IndexType;
+      function Matches(i : IndexType) : Boolean; virtual; abstract;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   public
+      constructor Create(size, chunkSize : IndexType);
+   end;
+
+   TParallelFindJob = class (TParallelSearchJob)
+   protected
+      FStart : TRandomAccessIterator;
+      FItem : ItemType;
+      FComparer : IBinaryComparer;
+      function Matches(i : IndexType) : Boolean; override;
+   end;
+
+   TParallelFindIfJob = class (TParallelSearchJob)
+   protected
+      FStart : TRandomAccessIterator;
+      FPred : IUnaryPredicate;
+      function Matches(i : IndexType) : Boolean; override;
+   end;
+
+   TParallelMismatchJob = class (TParallelSearchJob)
+   protected
+      FStart1, FStart2 : TRandomAccessIterator;
+      FPred : IBinaryPredicate;
+      function Matches(i : IndexType) : Boolean; override;
+   end;
+
+   { counts the items satisfying FPred in each chunk }
+   TParallelCountJob = class (TParallelRangeJob)
+   protected
+      FStart : TRandomAccessIterator;
+      FPred : IUnaryPredicate;
+      FCounts : array of SizeType;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   end;
+
+   { finds the index of the first minimal (maximal if FMaximal is
+     true) item of each chunk }
+   TParallelExtremeJob = class (TParallelRangeJob)
+   protected
+      FStart : TRandomAccessIterator;
+      FComparer : IBinaryComparer;
+      FMaximal : Boolean;
+      FBest : array of IndexType;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   end;
+
+   { sets the item at each index i of FDest to
+     FFunctor.Perform(FSource[i]) }
+   TParallelTransformJob = class (TParallelRangeJob)
+   protected
+      FSource, FDest : TRandomAccessIterator;
+      FFunctor : IUnaryFunctor;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   end;
+
+   { partitions each chunk separately and stores the number of items
+     satisfying FPred in it }
+   TParallelPartitionJob = class (TParallelRangeJob)
+   protected
+      FStart : TRandomAccessIterator;
+      FPred : IUnaryPredicate;
+      FTrueCounts : array of IndexType;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   end;
+
+   { exchanges the k-th item of the first sequence of intervals with
+     the k-th item of the second one, for each k; interval j of a
+     sequence begins at index From[j] and contains Sums[j + 1] -
+     Sums[j] items }
+   TParallelExchangeJob = class (TParallelRangeJob)
+   protected
+      FStart : TRandomAccessIterator;
+      FFrom1, FSums1, FFrom2, FSums2 : TIndexArray;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   end;
+
+   { moves the first item of each sequence of equal items in a chunk
+     to the beginning of the chunk and stores the number of such
+     items; FPrevious[chunk] is the item preceding the chunk, read
+     before the job is started }
+   TParallelUniqueJob = class (TParallelRangeJob)
+   protected
+      FStart : TRandomAccessIterator;
+      FComparer : IBinaryComparer;
+      FPrevious : array of ItemType;
+      FKept : TIndexArray;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   end;
+
+   { copies the FKept[chunk] first items of each chunk to FItems,
+     starting at FOffsets[chunk], and disposes the remaining ones }
+   TParallelGatherJob = class (TParallelRangeJob)
+   protected
+      FStart : TRandomAccessIterator;
+      FKept, FOffsets : TIndexArray;
+      FItems : array of ItemType;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   end;
+
+   { sets the item at each index i of FDest to FItems[i] }
+   TParallelScatterJob = class (TParallelRangeJob)
+   protected
+      FDest : TRandomAccessIterator;
+      FItems : array of ItemType;
+      procedure ExecuteChunk(chunk : IndexType); override;
+   end;
+
+{ ----------------------------- search jobs --------------------------------- }
+
+constructor TParallelSearchJob.Create(size, chunkSize : IndexType);
+begin
+   inherited Create(size, chunkSize);
+   FFound := size;
+end;
+
+procedure TParallelSearchJob.ExecuteChunk(chunk : IndexType);
+var
+   i : IndexType;
+begin
+   for i := ChunkStart(chunk) to ChunkFinish(chunk) - 1 do
+   begin
+      if Matches(i) then
+      begin
+         { the chunks before this one have all been started and will
+           be finished, so FFound ends up as the first index found }
+         FetchMin(FFound, i);
+         CancelAfter(chunk);
+         Exit;
+      end;
+   end;
+end;
+
+function TParallelFindJob.Matches(i : IndexType) : Boolean;
+begin
+   Result := _mcp_equal(FStart.GetItemAt(i), FItem, FComparer);
+end;
+
+function TParallelFindIfJob.Matches(i : IndexType) : Boolean;
+begin
+   Result := FPred.Test(FStart.GetItemAt(i));
+end;
+
+function TParallelMismatchJob.Matches(i : IndexType) : Boolean;
+begin
+   Result := not FPred.Test(FStart1.GetItemAt(i), FStart2.GetItemAt(i));
+end;
+
+{ ------------------------------- other jobs --------------------------------- }
+
+procedure TParallelCountJob.ExecuteChunk(chunk : IndexType);
+var
+   i : IndexType;
+   c : SizeType;
+begin
+   c := 0;
+   for i := ChunkStart(chunk) to ChunkFinish(chunk) - 1 do
+   begin
+      if FPred.Test(FStart.GetItemAt(i)) then
+         Inc(c);
+   end;
+   FCounts[chunk] := c;
+end;
+
+procedure TParallelExtremeJob.ExecuteChunk(chunk : IndexType);
+var
+   i, best : IndexType;
+   aitem, bestItem : ItemType;
+begin
+   best := ChunkStart(chunk);
+   bestItem := FStart.GetItemAt(best);
+   for i := best + 1 to ChunkFinish(chunk) - 1 do
+   begin
+      aitem := FStart.GetItemAt(i);
+      if FMaximal then
+      begin
+         if _mcp_gt(aitem, bestItem, FComparer) then
+         begin
+            best := i;
+            bestItem := aitem;
+         end;
+      end else if _mcp_lt(aitem, bestItem, FComparer) then
+      begin
+         best := i;
+         bestItem := aitem;
+      end;
+   end;
+   FBest[chunk] := best;
+end;
+
+procedure TParallelTransformJob.ExecuteChunk(chunk : IndexType);
+var
+   i : IndexType;
+begin
+   for i := ChunkStart(chunk) to ChunkFinish(chunk) - 1 do
+      FDest.SetItemAt(i, FFunctor.Perform(FSource.GetItemAt(i)));
+end;
+
+procedure TParallelPartitionJob.ExecuteChunk(chunk : IndexType);
+var
+   i, j : IndexType;
+begin
+   i := ChunkStart(chunk);
+   j := ChunkFinish(chunk) - 1;
+   while true do
+   begin
+      while (i <= j) and FPred.Test(FStart.GetItemAt(i)) do
+         Inc(i);
+      while (i < j) and not FPred.Test(FStart.GetItemAt(j)) do
+         Dec(j);
+      if i >= j then
+         break;
+      FStart.ExchangeItemsAt(i, j);
+      Inc(i);
+      Dec(j);
+   end;
+   FTrueCounts[chunk] := i - ChunkStart(chunk);
+end;
+
+procedure TParallelExchangeJob.ExecuteChunk(chunk : IndexType);
+var
+   k, kfinish, j1, j2, i1, i2 : IndexType;
+begin
+   k := ChunkStart(chunk);
+   kfinish := ChunkFinish(chunk);
+   j1 := IntervalOf(FSums1, k);
+   j2 := IntervalOf(FSums2, k);
+   i1 := FFrom1[j1] + k - FSums1[j1];
+   i2 := FFrom2[j2] + k - FSums2[j2];
+   while k < kfinish do
+   begin
+      FStart.ExchangeItemsAt(i1, i2);
+      Inc(k);
+      Inc(i1);
+      Inc(i2);
+      if k = FSums1[j1 + 1] then
+      begin
+         Inc(j1);
+         if j1 < Length(FFrom1) then
+            i1 := FFrom1[j1];
+      end;
+      if k = FSums2[j2 + 1] then
+      begin
+         Inc(j2);
+         if j2 < Length(FFrom2) then
+            i2 := FFrom2[j2];
+      end;
+   end;
+end;
+
+procedure TParallelUniqueJob.ExecuteChunk(chunk : IndexType);
+var
+   i, kept : IndexType;
+   aitem, prev : ItemType;
+begin
+   i := ChunkStart(chunk);
+   if chunk = 0 then
+   begin
+      prev := FStart.GetItemAt(i);
+      Inc(i);
+   end else
+      prev := FPrevious[chunk];
+   kept := i;
+   { the duplicates are only moved to the end of the chunk here - the
+     next chunk may still be comparing its first item with the last
+     one of this chunk }
+   while i < ChunkFinish(chunk) do
+   begin
+      aitem := FStart.GetItemAt(i);
+      if not _mcp_equal(aitem, prev, FComparer) then
+      begin
+         prev := aitem;
+         if kept <> i then
+            FStart.ExchangeItemsAt(kept, i);
+         Inc(kept);
+      end;
+      Inc(i);
+   end;
+   FKept[chunk] := kept - ChunkStart(chunk);
+end;
+
+procedure TParallelGatherJob.ExecuteChunk(chunk : IndexType);
+var
+   i, cstart : IndexType;
+begin
+   cstart := ChunkStart(chunk);
+   for i := 0 to FKept[chunk] - 1 do
+      FItems[FOffsets[chunk] + i] := FStart.GetItemAt(cstart + i);
+   for i := cstart + FKept[chunk] to ChunkFinish(chunk) - 1 do
+      FStart.SetItemAt(i, DefaultItem);
+end;
+
+procedure TParallelScatterJob.ExecuteChunk(chunk : IndexType);
+var
+   i : IndexType;
+begin
+   for i := ChunkStart(chunk) to ChunkFinish(chunk) - 1 do
+      FDest.SetItemAt(i, FItems[i]);
+end;
+
+{ ------------------------------ searching ----------------------------------- }
+
+{ runs the search job and returns an iterator at the index found }
+function RunSearch(job : TParallelSearchJob; const start : TRandomAccessIterator;
+                   pool : TTaskPool) : TRandomAccessIterator; overload;
+begin
+   try
+      PoolOrDefault(pool).Run(job);
+      Result := CopyOf(start);
+      Result.Advance(job.FFound);
+   finally
+      job.Free;
+   end;
+end;
+
+function ParallelFind(const start, finish : TRandomAccessIterator;
+                      aitem : ItemType;
+                      const comparer : IBinaryComparer;
+                      pool : TTaskPool) : TRandomAccessIterator;
+var
+   job : TParallelFindJob;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   pool := PoolOrDefault(pool);
+   job := TParallelFindJob.Create(start.Distance(finish), pool.ChunkSize);
+   job.FStart := start;
+   job.FItem := aitem;
+   job.FComparer := comparer;
+   Result := RunSearch(job, start, pool);
+end;
+
+function ParallelFind(const start, finish : TRandomAccessIterator;
+                      const pred : IUnaryPredicate;
+                      pool : TTaskPool) : TRandomAccessIterator;
+var
+   job : TParallelFindIfJob;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   pool := PoolOrDefault(pool);
+   job := TParallelFindIfJob.Create(start.Distance(finish), pool.ChunkSize);
+   job.FStart := start;
+   job.FPred := pred;
+   Result := RunSearch(job, start, pool);
+end;
+
+function ParallelCount(const start, finish : TRandomAccessIterator;
+                       const pred : IUnaryPredicate;
+                       pool : TTaskPool) : SizeType;
+var
+   job : TParallelCountJob;
+   i : IndexType;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   pool := PoolOrDefault(pool);
+   job := TParallelCountJob.Create(start.Distance(finish), pool.ChunkSize);
+   try
+      job.FStart := start;
+      job.FPred := pred;
+      SetLength(job.FCounts, job.ChunkCount);
+      pool.Run(job);
+      Result := 0;
+      for i := 0 to job.ChunkCount - 1 do
+         Inc(Result, job.FCounts[i]);
+   finally
+      job.Free;
+   end;
+end;
+
+{ returns the first minimal or maximal item of [start,finish) }
+function ParallelExtreme(const start, finish : TRandomAccessIterator;
+                         const comparer : IBinaryComparer;
+                         maximal : Boolean;
+                         pool : TTaskPool) : TRandomAccessIterator; overload;
+var
+   job : TParallelExtremeJob;
+   i, best : IndexType;
+   aitem, bestItem : ItemType;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   pool := PoolOrDefault(pool);
+   job := TParallelExtremeJob.Create(start.Distance(finish), pool.ChunkSize);
+   try
+      job.FStart := start;
+      job.FComparer := comparer;
+      job.FMaximal := maximal;
+      SetLength(job.FBest, job.ChunkCount);
+      pool.Run(job);
+
+      { combine the results of the chunks in order, so that the first
+        extreme item is found }
+      best := job.FSize;
+      if job.ChunkCount <> 0 then
+      begin
+         best := job.FBest[0];
+         bestItem := start.GetItemAt(best);
+         for i := 1 to job.ChunkCount - 1 do
+         begin
+            aitem := start.GetItemAt(job.FBest[i]);
+            if (maximal and _mcp_gt(aitem, bestItem, comparer)) or
+                  (not maximal and _mcp_lt(aitem, bestItem, comparer)) then
+            begin
+               best := job.FBest[i];
+               bestItem := aitem;
+            end;
+         end;
+      end;
+      Result := CopyOf(start);
+      Result.Advance(best);
+   finally
+      job.Free;
+   end;
+end;
+
+function ParallelMinimal(const start, finish : TRandomAccessIterator;
+                         const comparer : IBinaryComparer;
+                         pool : TTaskPool) : TRandomAccessIterator;
+begin
+   Result := ParallelExtreme(start, finish, comparer, false, pool);
+end;
+
+function ParallelMaximal(const start, finish : TRandomAccessIterator;
+                         const comparer : IBinaryComparer;
+                         pool : TTaskPool) : TRandomAccessIterator;
+begin
+   Result := ParallelExtreme(start, finish, comparer, true, pool);
+end;
+
+{ returns the index of the first mismatch of the two ranges, or the
+  length of the first range if there is none }
+function ParallelMismatchIndex(const start1, finish1,
+                               start2 : TRandomAccessIterator;
+                               const pred : IBinaryPredicate;
+                               pool : TTaskPool) : IndexType; overload;
+var
+   job : TParallelMismatchJob;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start1, finish1);
+{$endif }
+
+   pool := PoolOrDefault(pool);
+   job := TParallelMismatchJob.Create(start1.Distance(finish1), pool.ChunkSize);
+   try
+      job.FStart1 := start1;
+      job.FStart2 := start2;
+      job.FPred := pred;
+      pool.Run(job);
+      Result := job.FFound;
+   finally
+      job.Free;
+   end;
+end;
+
+function ParallelEqual(const start1, finish1, start2 : TRandomAccessIterator;
+                       const pred : IBinaryPredicate;
+                       pool : TTaskPool) : Boolean;
+begin
+   Result := ParallelMismatchIndex(start1, finish1, start2, pred, pool) =
+      start1.Distance(finish1);
+end;
+
+function ParallelMismatch(const start1, finish1, start2 : TRandomAccessIterator;
+                          const pred : IBinaryPredicate;
+                          pool : TTaskPool) : TForwardIteratorPair;
+var
+   i : IndexType;
+   iter1, iter2 : TRandomAccessIterator;
+begin
+   i := ParallelMismatchIndex(start1, finish1, start2, pred, pool);
+   iter1 := CopyOf(start1);
+   iter1.Advance(i);
+   iter2 := CopyOf(start2);
+   iter2.Advance(i);
+   Result := TForwardIteratorPair.Create(iter1, iter2);
+end;
+
+{ ------------------------------ modifying ----------------------------------- }
+
+{ sets dest[i] to funct.Perform(source[i]) for each i in [0,n) }
+procedure ParallelTransform(const source, dest : TRandomAccessIterator;
+                            n : IndexType; const funct : IUnaryFunctor;
+                            pool : TTaskPool); overload;
+var
+   job : TParallelTransformJob;
+begin
+   pool := PoolOrDefault(pool);
+   job := TParallelTransformJob.Create(n, pool.ChunkSize);
+   try
+      job.FSource := source;
+      job.FDest := dest;
+      job.FFunctor := funct;
+      pool.Run(job);
+   finally
+      job.Free;
+   end;
+end;
+
+procedure ParallelForEach(const start, finish : TRandomAccessIterator;
+                          const funct : IUnaryFunctor;
+                          pool : TTaskPool);
+var
+   owner : TContainerAdt;
+   owns : Boolean;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   owner := start.Owner;
+   owns := owner.OwnsItems;
+   owner.OwnsItems := false;
+   try
+      ParallelTransform(start, start, start.Distance(finish), funct, pool);
+   finally
+      owner.OwnsItems := owns;
+   end;
+end;
+
+procedure ParallelGenerate(const start, finish : TRandomAccessIterator;
+                           const funct : IUnaryFunctor;
+                           pool : TTaskPool);
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   ParallelTransform(start, start, start.Distance(finish), funct, pool);
+end;
+
+procedure ParallelCopy(const start1, finish1, start2 : TRandomAccessIterator;
+                       const itemCopier : IUnaryFunctor;
+                       pool : TTaskPool);
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start1, finish1);
+{$endif }
+
+   ParallelTransform(start1, start2, start1.Distance(finish1),
+                     itemCopier, pool);
+end;
+
+function ParallelPartition(const start, finish : TRandomAccessIterator;
+                           const pred : IUnaryPredicate;
+                           pool : TTaskPool) : TRandomAccessIterator;
+var
+   job : TParallelPartitionJob;
+   xjob : TParallelExchangeJob;
+   from1, sums1, from2, sums2 : TIndexArray;
+   n1, n2, c, cstart, cfinish, boundary : IndexType;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   pool := PoolOrDefault(pool);
+   job := TParallelPartitionJob.Create(start.Distance(finish), pool.ChunkSize);
+   try
+      job.FStart := start;
+      job.FPred := pred;
+      SetLength(job.FTrueCounts, job.ChunkCount);
+      pool.Run(job);
+
+      boundary := 0;
+      for c := 0 to job.ChunkCount - 1 do
+         Inc(boundary, job.FTrueCounts[c]);
+
+      { the items not satisfying pred before the boundary form the
+        first sequence of intervals, those satisfying it after the
+        boundary the second one; both contain the same number of
+        items }
+      SetLength(from1, job.ChunkCount);
+      SetLength(sums1, job.ChunkCount + 1);
+      SetLength(from2, job.ChunkCount);
+      SetLength(sums2, job.ChunkCount + 1);
+      n1 := 0;
+      n2 := 0;
+      sums1[0] := 0;
+      sums2[0] := 0;
+      for c := 0 to job.ChunkCount - 1 do
+      begin
+         cstart := job.ChunkStart(c) + job.FTrueCounts[c];
+         cfinish := job.ChunkFinish(c);
+         if cfinish > boundary then
+            cfinish := boundary;
+         if cstart < cfinish then
+         begin
+            from1[n1] := cstart;
+            sums1[n1 + 1] := sums1[n1] + cfinish - cstart;
+            Inc(n1);
+         end;
+
+         cstart := job.ChunkStart(c);
+         if cstart < boundary then
+            cstart := boundary;
+         cfinish := job.ChunkStart(c) + job.FTrueCounts[c];
+         if cstart < cfinish then
+         begin
+            from2[n2] := cstart;
+            sums2[n2 + 1] := sums2[n2] + cfinish - cstart;
+            Inc(n2);
+         end;
+      end;
+   finally
+      job.Free;
+   end;
+   Assert(sums1[n1] = sums2[n2], msgInternalError);
+
+   if n1 <> 0 then
+   begin
+      { exchange the misplaced items pairwise }
+      xjob := TParallelExchangeJob.Create(sums1[n1], pool.ChunkSize);
+      try
+         xjob.FStart := start;
+         SetLength(from1, n1);
+         SetLength(sums1, n1 + 1);
+         SetLength(from2, n2);
+         SetLength(sums2, n2 + 1);
+         xjob.FFrom1 := from1;
+         xjob.FSums1 := sums1;
+         xjob.FFrom2 := from2;
+         xjob.FSums2 := sums2;
+         pool.Run(xjob);
+      finally
+         xjob.Free;
+      end;
+   end;
+
+   Result := CopyOf(start);
+   Result.Advance(boundary);
+end;
+
+function ParallelUnique(const start, finish : TRandomAccessIterator;
+                        const comparer : IBinaryComparer;
+                        pool : TTaskPool) : SizeType;
+var
+   job : TParallelUniqueJob;
+   gjob : TParallelGatherJob;
+   sjob : TParallelScatterJob;
+   offsets : TIndexArray;
+   items : array of ItemType;
+   n, total, c : IndexType;
+   owner : TContainerAdt;
+   owns : Boolean;
+   iter : TRandomAccessIterator;
+begin
+{$ifdef DEBUG_PASCAL_ADT }
+   CheckIteratorRange(start, finish);
+{$endif }
+
+   pool := PoolOrDefault(pool);
+   n := start.Distance(finish);
+   job := TParallelUniqueJob.Create(n, pool.ChunkSize);
+   gjob := nil;
+   try
+      job.FStart := start;
+      job.FComparer := comparer;
+      SetLength(job.FPrevious, job.ChunkCount);
+      for c := 1 to job.ChunkCount - 1 do
+         job.FPrevious[c] := start.GetItemAt(job.ChunkStart(c) - 1);
+      SetLength(job.FKept, job.ChunkCount);
+      pool.Run(job);
+
+      { chunk c's items go to [offsets[c], offsets[c] + FKept[c]) }
+      SetLength(offsets, job.ChunkCount);
+      total := 0;
+      for c := 0 to job.ChunkCount - 1 do
+      begin
+         offsets[c] := total;
+         Inc(total, job.FKept[c]);
+      end;
+      Result := n - total;
+      if Result = 0 then
+         Exit;
+
+      { the destination of a chunk may overlap the items of the
+        previous one, so the items are not moved directly }
+      SetLength(items, total);
+      gjob := TParallelGatherJob.Create(n, pool.ChunkSize);
+      gjob.FStart := start;
+      gjob.FKept := job.FKept;
+      gjob.FOffsets := offsets;
+      gjob.FItems := items;
+      pool.Run(gjob);
+   finally
+      gjob.Free;
+      job.Free;
+   end;
+
+   { the items are now either in <items> or disposed, so none of the
+     items overwritten or deleted below may be disposed }
+   owner := start.Owner;
+   owns := owner.OwnsItems;
+   owner.OwnsItems := false;
+   try
+      sjob := TParallelScatterJob.Create(total, pool.ChunkSize);
+      try
+         sjob.FDest := start;
+         sjob.FItems := items;
+         pool.Run(sjob);
+      finally
+         sjob.Free;
+      end;
+
+      iter := CopyOf(start);
+      try
+         iter.Advance(total);
+         iter.Delete(Result);
+      finally
+         iter.Destroy;
+      end;
+   finally
+      owner.OwnsItems := owns;
+   end;
+end;
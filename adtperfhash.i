@@ -0,0 +1,118 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtperfhash.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtperfhash.defs
+
+type
+   { a static set of items numbered from 0 to @<Count>-1 by a minimal
+     perfect hash function; the items are stored in an array in the
+     order of their numbers, so @<IndexOf> computes the hash of an
+     item, finds its number with @<TPerfectHashFunction.IndexOf> and
+     compares the item with the one stored under this number; the
+     values associated with the items are best kept in an array
+     indexed by these numbers; items with equal hashes (which cannot
+     be told apart by the function) are stored after the others and
+     found by a binary search of their hashes, which happens only if
+     the first comparison fails; equal items are stored only once;
+     the set does not own its items and never disposes them; the
+     hasher must return equal values for items equal according to
+     @<ItemComparer> }
+   TPerfectHashIndex = class
+   private
+      FFunction : TPerfectHashFunction;
+      FItems : array of ItemType;
+      { the hashes of the items after the first FFunction.Count ones,
+        in ascending order }
+      FExtraHashes : array of UnsignedType;
+      FCount : SizeType;
+      FHasher : IHasher;
+      FComparer : IBinaryComparer;
+
+      { builds the function for the first <num> elements of FItems and
+        puts the items in the right order, dropping duplicates }
+      procedure Build(num : SizeType);
+      { searches for <aitem> with the hash <hash> among the items after
+        the first FFunction.Count ones }
+      function IndexOfExtra(aitem : ItemType; hash : UnsignedType) : SizeType;
+      procedure InitFields(const comparer : IBinaryComparer;
+                           const hasher : IHasher);
+      function GetItem(i : SizeType) : ItemType;
+
+   public
+      { creates an index of the items of <aset>, compared with the
+        comparer of <aset>; <hasher> may be nil, in which case the
+        default hasher for the type of items is used; the hasher must
+        return equal values for equal items, otherwise @<IndexOf> may
+        not find an item equal to one in the index - this is not
+        checked; @complexity expected O(n log n) }
+      constructor Create(aset : TSetAdt; const hasher : IHasher); overload;
+      { creates an index of the items of <aset> using the default
+        hasher }
+      constructor Create(aset : TSetAdt); overload;
+      { creates an index of the items in the range [start, finish);
+        <comparer> and <hasher> may be nil, in which case the default
+        ones for the type of items are used; @complexity expected O(n
+        log n) }
+      constructor Create(start, finish : TForwardIterator;
+                         const comparer : IBinaryComparer;
+                         const hasher : IHasher); overload;
+      { reads an index written by @<SaveToStream> with the same
+        <streamer>; <comparer> and <hasher> have the same meaning as
+        for the constructor taking a range, and the hasher must return
+        the same values as the one used by the index that has been
+        written, so the default binary representation should not be
+        used for items hashed by their addresses; raises
+        EInvalidStreamFormat if the stream does not contain an index;
+        @complexity O(n) }
+      constructor CreateFromStream(stream : TStream;
+                                   const streamer : IStreamer;
+                                   const comparer : IBinaryComparer;
+                                   const hasher : IHasher);
+      destructor Destroy; override;
+      { returns the number of <aitem>, or -1 if it is not in the set;
+        @complexity O(1) expected }
+      function IndexOf(aitem : ItemType) : SizeType;
+      { returns true if <aitem> is in the set; @complexity O(1) expected }
+      function Has(aitem : ItemType) : Boolean;
+      { writes the function, the items and the hashes of the items
+        with equal hashes to <stream>; the items are written with
+        <streamer>, which may be nil if the items may be written in
+        their default binary representation }
+      procedure SaveToStream(stream : TStream; const streamer : IStreamer);
+      { returns the number of bytes used apart from the items, i.e. by
+        the function and by the hashes of the items with equal hashes }
+      function MemoryUsage : SizeType;
+      { the items, in the order of their numbers }
+      property Items[i : SizeType] : ItemType read GetItem; default;
+      { the number of items }
+      property Count : SizeType read FCount;
+      { the function giving the numbers of all the items apart from
+        those with equal hashes }
+      property HashFunction : TPerfectHashFunction read FFunction;
+      property Hasher : IHasher read FHasher;
+      property ItemComparer : IBinaryComparer read FComparer;
+   end;
@@ -0,0 +1,285 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtperfhash_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtperfhash.defs
+&include adtperfhash_impl.mcp
+
+{$R-}
+
+{ ---------------------------- TPerfectHashIndex ----------------------------- }
+
+constructor TPerfectHashIndex.Create(aset : TSetAdt; const hasher : IHasher);
+var
+   iter : TSetIterator;
+   num : SizeType;
+begin
+   inherited Create;
+   InitFields(aset.ItemComparer, hasher);
+
+   SetLength(FItems, aset.Size);
+   num := 0;
+   iter := aset.Start;
+   while not iter.IsFinish do
+   begin
+      FItems[num] := iter.Item;
+      Inc(num);
+      iter.Advance;
+   end;
+   iter.Destroy;
+   Build(num);
+end;
+
+constructor TPerfectHashIndex.Create(aset : TSetAdt);
+begin
+   Create(aset, nil);
+end;
+
+constructor TPerfectHashIndex.Create(start, finish : TForwardIterator;
+                                     const comparer : IBinaryComparer;
+                                     const hasher : IHasher);
+var
+   iter : TForwardIterator;
+   num : SizeType;
+begin
+   inherited Create;
+   InitFields(comparer, hasher);
+
+   num := 0;
+   iter := CopyOf(start);
+   while not iter.Equal(finish) do
+   begin
+      if num = Length(FItems) then
+         SetLength(FItems, 2*num + 16);
+      FItems[num] := iter.Item;
+      Inc(num);
+      iter.Advance;
+   end;
+   iter.Destroy;
+   Build(num);
+end;
+
+constructor TPerfectHashIndex.CreateFromStream(stream : TStream;
+                                               const streamer : IStreamer;
+                                               const comparer : IBinaryComparer;
+                                               const hasher : IHasher);
+var
+   numExtra, i : SizeType;
+   hash : QWord;
+begin
+   inherited Create;
+   InitFields(comparer, hasher);
+
+   StreamReadHeader(stream, sfPerfectHash, SizeOf(ItemType));
+   FCount := StreamReadSize(stream);
+   FFunction := TPerfectHashFunction.CreateFromStream(stream);
+   numExtra := StreamReadSize(stream);
+   if FFunction.Count + numExtra <> FCount then
+      raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+
+   SetLength(FExtraHashes, numExtra);
+   for i := 0 to numExtra - 1 do
+   begin
+      stream.ReadBuffer(hash, SizeOf(QWord));
+      if hash > High(UnsignedType) then
+         raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+      FExtraHashes[i] := hash;
+   end;
+
+   SetLength(FItems, FCount);
+   if FCount <> 0 then
+      StreamReadItems(stream, FItems[0], FCount, streamer);
+end;
+
+destructor TPerfectHashIndex.Destroy;
+begin
+   FFunction.Free;
+   inherited;
+end;
+
+procedure TPerfectHashIndex.InitFields(const comparer : IBinaryComparer;
+                                       const hasher : IHasher);
+begin
+   FComparer := comparer;
+&if (&ItemType == TObject)
+   Assert(FComparer <> nil, msgNilFunctor);
+&endif
+   if hasher <> nil then
+      FHasher := hasher
+   else
+      FHasher := &_mcp_hasher(&ItemType);
+   Assert(FHasher <> nil, msgNilFunctor);
+   FCount := 0;
+end;
+
+procedure TPerfectHashIndex.Build(num : SizeType);
+var
+   hashes, primaryHashes : array of UnsignedType;
+   order, primary, extra : array of SizeType;
+   items : array of ItemType;
+   i, j, first, numPrimary, numExtra : SizeType;
+   duplicate : Boolean;
+begin
+   SetLength(hashes, num);
+   SetLength(order, num);
+   for i := 0 to num - 1 do
+   begin
+      hashes[i] := FHasher.Hash(FItems[i]);
+      order[i] := i;
+   end;
+   SortByHash(hashes, order);
+
+   { the first item of every group of items with equal hashes is
+     numbered by the function, the other ones different from all the
+     items before them in the group are extra items }
+   SetLength(primary, num);
+   SetLength(extra, num);
+   numPrimary := 0;
+   numExtra := 0;
+   first := 0;
+   for i := 0 to num - 1 do
+   begin
+      if hashes[order[i]] <> hashes[order[first]] then
+         first := i;
+      if i = first then
+      begin
+         primary[numPrimary] := order[i];
+         Inc(numPrimary);
+      end else
+      begin
+         duplicate := false;
+         j := first;
+         while not duplicate and (j < i) do
+         begin
+            duplicate := &_mcp_equal(FItems[order[j]], FItems[order[i]], FComparer);
+            Inc(j);
+         end;
+         if not duplicate then
+         begin
+            extra[numExtra] := order[i];
+            Inc(numExtra);
+         end;
+      end;
+   end;
+
+   SetLength(primaryHashes, numPrimary);
+   for i := 0 to numPrimary - 1 do
+      primaryHashes[i] := hashes[primary[i]];
+   FFunction := TPerfectHashFunction.Create(primaryHashes);
+
+   FCount := numPrimary + numExtra;
+   SetLength(items, FCount);
+   for i := 0 to numPrimary - 1 do
+      items[FFunction.IndexOf(primaryHashes[i])] := FItems[primary[i]];
+   SetLength(FExtraHashes, numExtra);
+   for i := 0 to numExtra - 1 do
+   begin
+      items[numPrimary + i] := FItems[extra[i]];
+      FExtraHashes[i] := hashes[extra[i]];
+   end;
+   FItems := items;
+end;
+
+function TPerfectHashIndex.IndexOfExtra(aitem : ItemType;
+                                        hash : UnsignedType) : SizeType;
+var
+   lo, hi, mid : SizeType;
+begin
+   lo := 0;
+   hi := Length(FExtraHashes);
+   while lo < hi do
+   begin
+      mid := (lo + hi) div 2;
+      if FExtraHashes[mid] < hash then
+         lo := mid + 1
+      else
+         hi := mid;
+   end;
+
+   Result := -1;
+   while (lo < Length(FExtraHashes)) and (FExtraHashes[lo] = hash) do
+   begin
+      if &_mcp_equal(FItems[FFunction.Count + lo], aitem, FComparer) then
+      begin
+         Result := FFunction.Count + lo;
+         Exit;
+      end;
+      Inc(lo);
+   end;
+end;
+
+function TPerfectHashIndex.GetItem(i : SizeType) : ItemType;
+begin
+   Assert((i >= 0) and (i < FCount), msgInvalidIndex);
+   Result := FItems[i];
+end;
+
+function TPerfectHashIndex.IndexOf(aitem : ItemType) : SizeType;
+var
+   hash : UnsignedType;
+begin
+   Result := -1;
+   if FCount = 0 then
+      Exit;
+   hash := FHasher.Hash(aitem);
+   Result := FFunction.IndexOf(hash);
+   if not (&_mcp_equal(FItems[Result], aitem, FComparer)) then
+   begin
+      if Length(FExtraHashes) <> 0 then
+         Result := IndexOfExtra(aitem, hash)
+      else
+         Result := -1;
+   end;
+end;
+
+function TPerfectHashIndex.Has(aitem : ItemType) : Boolean;
+begin
+   Result := IndexOf(aitem) >= 0;
+end;
+
+procedure TPerfectHashIndex.SaveToStream(stream : TStream;
+                                         const streamer : IStreamer);
+var
+   i : SizeType;
+   hash : QWord;
+begin
+   StreamWriteHeader(stream, sfPerfectHash, SizeOf(ItemType));
+   StreamWriteSize(stream, FCount);
+   FFunction.SaveToStream(stream);
+   StreamWriteSize(stream, Length(FExtraHashes));
+   for i := 0 to Length(FExtraHashes) - 1 do
+   begin
+      hash := FExtraHashes[i];
+      stream.WriteBuffer(hash, SizeOf(QWord));
+   end;
+   if FCount <> 0 then
+      StreamWriteItems(stream, FItems[0], FCount, streamer);
+end;
+
+function TPerfectHashIndex.MemoryUsage : SizeType;
+begin
+   Result := FFunction.MemoryUsage + Length(FExtraHashes) * SizeOf(UnsignedType);
+end;
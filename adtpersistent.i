@@ -0,0 +1,289 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtpersistent.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtpersistent.defs
+
+type
+&if (&_mcp_type_needs_destruction(&ItemType))
+   PPersistentAvlItemRef = ^TPersistentAvlItemRef;
+   { the item of a node is shared by all the copies of the node made
+     by path copying; this record counts the copies, so that the item
+     is disposed only together with the last one; present only for
+     the item types which may need disposing }
+   TPersistentAvlItemRef = record
+      Count : LongInt;
+      { false if the item has been extracted from one of the versions
+        and must not be disposed by any of them }
+      Owned : Boolean;
+   end;
+
+&endif
+   PPersistentAvlNode = ^TPersistentAvlNode;
+   TPersistentAvlNode = record
+      Left, Right : PPersistentAvlNode;
+      Item : ItemType;
+&if (&_mcp_type_needs_destruction(&ItemType))
+      ItemRef : PPersistentAvlItemRef;
+&endif
+      { the number of nodes in the sub-tree of the node }
+      Size : SizeType;
+      Height : Integer;
+      { the number of links to the node (from parent nodes in all
+        versions and from the roots of the versions) }
+      RefCount : LongInt;
+   end;
+
+   TPersistentAvlPath = array[0..patMaxHeight - 1] of PPersistentAvlNode;
+
+   { a persistent AVL-tree; @<Snapshot> returns in O(1) time a copy
+     of the tree which is not affected by later changes to the tree
+     (and does not affect it); the versions share both their nodes and
+     their items, and every update copies only O(log(n)) nodes; every
+     node knows the size of its sub-tree, so the position of an item
+     is also available in O(log(n)) time; the reference counts of the
+     nodes are updated atomically, so different versions may be used
+     (and destroyed) in different threads, but a single version must
+     not be accessed by several threads at once if any of them
+     modifies it; the items owned by the tree are disposed when the
+     last version containing them is destroyed or changed, possibly in
+     another thread than the one which removed them from the tree. }
+   { Items are shared, not copied, so @<Extract> and all the operations
+     implemented with it (@<ExtractFirst>, TSortedSetAdt.DeleteFirst,
+     TSetIterator.Delete) hand the item over to the caller and make
+     all the versions stop owning it; an item extracted while a
+     snapshot still contains it must not be disposed before the
+     snapshot is destroyed. @<Delete> and @<Clear> never dispose an
+     item which is still contained in another version. Items must not
+     be changed in a way that alters their order while they are shared
+     with other versions. }
+   TPersistentAvlTree = class (TSortedSetAdt)
+   private
+      FRoot : PPersistentAvlNode;
+
+      { creates a copy of tree sharing all its nodes }
+      {$warnings off }
+      constructor CreateSnapshot(const tree : TPersistentAvlTree);
+      {$warnings on }
+      { returns a new node with <aitem>, not linked into the tree }
+      function NewNode(aitem : ItemType) : PPersistentAvlNode;
+      { adds a link to <node> }
+      procedure AcquireNode(node : PPersistentAvlNode);
+      { removes a link to <node>; frees the node if it was the last
+        one, releasing its children and disposing its item if it is not
+        used by any other node }
+      procedure ReleaseNode(node : PPersistentAvlNode);
+      { returns a node equal to <node> which is linked only from the
+        place where <node> was linked from; <node> is copied if it is
+        shared; the link to <node> is transferred to the result }
+      function UniqueNode(node : PPersistentAvlNode) : PPersistentAvlNode;
+      { recomputes the Size and Height of <node> from its children }
+      procedure UpdateNode(node : PPersistentAvlNode);
+      { the rotations and re-balancing of the sub-tree of <node>; node
+        must be unique; return the new root of the sub-tree }
+      function RotateLeft(node : PPersistentAvlNode) : PPersistentAvlNode;
+      function RotateRight(node : PPersistentAvlNode) : PPersistentAvlNode;
+      function Balance(node : PPersistentAvlNode) : PPersistentAvlNode;
+      { inserts newNode into the sub-tree of <node> so that rank items
+        of the sub-tree precede it; returns the new root of the
+        sub-tree }
+      function InsertNodeAt(node, newNode : PPersistentAvlNode;
+                            rank : SizeType) : PPersistentAvlNode;
+      { removes the first node from the sub-tree of <node> and assigns
+        it to minNode; returns the new root of the sub-tree }
+      function RemoveMin(node : PPersistentAvlNode;
+                         var minNode : PPersistentAvlNode) : PPersistentAvlNode;
+      { removes the rank-th node from the sub-tree of <node> and
+        assigns it to removed; the removed node is unique and has no
+        children; returns the new root of the sub-tree }
+      function RemoveNodeAt(node : PPersistentAvlNode; rank : SizeType;
+                            var removed : PPersistentAvlNode) : PPersistentAvlNode;
+      { returns a copy of the sub-tree of <node> with items copied with
+        itemCopier }
+      function CopySubTree(node : PPersistentAvlNode;
+                           const itemCopier : IUnaryFunctor) : PPersistentAvlNode;
+      { returns the rank-th node in the tree; rank < Size }
+      function NodeAt(rank : SizeType) : PPersistentAvlNode;
+      { returns the number of items < aitem }
+      function LowerRank(aitem : ItemType) : SizeType;
+      { returns the number of items <= aitem }
+      function UpperRank(aitem : ItemType) : SizeType;
+      { returns the rank at which aitem should be inserted, or -1 if
+        aitem cannot be inserted because RepeatedItems is false and an
+        equal item is already in the tree }
+      function InsertionRank(aitem : ItemType) : IndexType;
+      { removes the rank-th item from the tree and disposes it unless
+        it is still used by another version }
+      procedure DeleteAt(rank : SizeType);
+      { removes the rank-th item from the tree and returns it; the
+        item is no longer owned by any version }
+      function ExtractAt(rank : SizeType) : ItemType;
+
+   public
+      constructor Create;
+      { creates a copy of cont with all the items copied with
+        itemCopier; if itemCopier is nil then creates an empty tree
+        with the same properties as cont; @see Snapshot; @complexity
+        O(n) }
+      constructor CreateCopy(const cont : TPersistentAvlTree;
+                             const itemCopier : IUnaryFunctor); overload;
+      { destroys the tree; the nodes and items shared with other
+        versions are not freed }
+      destructor Destroy; override;
+
+{$ifdef PASCAL_ADT_STATS }
+      { adds Height }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
+
+      { returns a copy of self; @complexity O(n) }
+      function CopySelf(const ItemCopier :
+                           IUnaryFunctor) : TContainerAdt; override;
+      { @see TContainerAdt.Swap }
+      procedure Swap(cont : TContainerAdt); override;
+      { returns a copy of self which shares the nodes and the items
+        with self; changes to self do not affect the returned tree and
+        vice versa; the snapshot has the same ItemComparer,
+        RepeatedItems, OwnsItems and ItemDisposer as self; @complexity
+        O(1) }
+      function Snapshot : TPersistentAvlTree;
+      { returns the start iterator }
+      function Start : TSetIterator; override;
+      { returns the finish iterator }
+      function Finish : TSetIterator; override;
+&if (&_mcp_accepts_nil)
+      { if RepeatedItems is false and there is an item equal to aitem in
+        the set, then returns this item; in all other cases inserts
+        aitem into the set and returns nil; @complexity worst-case
+        O(log(n)) }
+      function FindOrInsert(aitem : ItemType) : ItemType; override;
+      { returns the first item equal to aitem, or nil if not found;
+        @complexity worst-case O(log(n)) }
+      function Find(aitem : ItemType) : ItemType; override;
+&endif &# end &_mcp_accepts_nil
+      { returns true if the given item is present in the set;
+        @complexity worst-case O(log(n)) }
+      function Has(aitem : ItemType) : Boolean; override;
+      { returns the number of items in the set equal to aitem;
+        @complexity worst-case O(log(n)) }
+      function Count(aitem : ItemType) : SizeType; override;
+      { the same as below; the hint is ignored }
+      function Insert(pos : TSetIterator;
+                      aitem : ItemType) : Boolean; overload; override;
+      { inserts aitem into the set; returns true if it was inserted,
+        or false if it cannot be inserted (this happens for non-multi
+        (without repeated items) set when item equal to aitem is already
+        in the set); if the item is not inserted it is not owned by
+        the container and not disposed! @complexity worst-case
+        O(log(n)) }
+      function Insert(aitem : ItemType) : Boolean; overload; override;
+      { removes the item at pos from the set; @complexity worst-case
+        O(log(n)) }
+      procedure Delete(pos : TSetIterator); overload; override;
+      { removes all items equal to aitem from the set; returns the
+        number of deleted items; @complexity worst-case O(m*log(n)),
+        where m is the number of deleted items }
+      function Delete(aitem : ItemType) : SizeType; overload; override;
+      { removes all items equal to aitem from the set without disposing
+        them; the items stop being owned by all the versions;
+        @complexity worst-case O(m*log(n)), where m is the number of
+        extracted items }
+      function Extract(aitem : ItemType) : SizeType; override;
+      { returns the first item >= aitem; @complexity worst-case
+        O(log(n)) }
+      function LowerBound(aitem : ItemType) : TSetIterator; override;
+      { returns the first item > aitem; @complexity worst-case
+        O(log(n)) }
+      function UpperBound(aitem : ItemType) : TSetIterator; override;
+      { returns a range <LowerBound, UpperBound); @complexity
+        worst-case O(log(n)) }
+      function EqualRange(aitem : ItemType) : TSetIteratorRange; override;
+      { walks the nodes in order with an explicit stack, without
+        iterators; @complexity O(n) }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      { tests all the items first and then deletes the matching ones
+        by their ranks, from the last one; if pred raises an exception
+        the tree is not changed; @complexity O(n + m*log(n)), where m
+        is the number of deleted items }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { returns the first item according to ItemComparer; @complexity
+        worst-case O(log(n)) }
+      function First : ItemType; override;
+      { removes the first item from the tree and returns it; the item
+        stops being owned by all the versions; @complexity worst-case
+        O(log(n)) }
+      function ExtractFirst : ItemType; override;
+      { clears the container - removes all items; @complexity O(n), or
+        O(1) if all the nodes are shared with another version }
+      procedure Clear; override;
+      { returns true if container is empty; equivalent to Size = 0,
+        but may be faster }
+      function Empty : Boolean; override;
+      { returns number of items; @complexity O(1) }
+      function Size : SizeType; override;
+   end;
+
+   { an iterator into a TPersistentAvlTree; remembers the path from
+     the root to its node; it is invalidated by every change to its
+     tree not made through it, but not by the changes to other
+     versions of the tree }
+   TPersistentAvlTreeIterator = class (TSetIterator)
+   private
+      FTree : TPersistentAvlTree;
+      FPath : TPersistentAvlPath;
+      { the number of nodes in FPath; 0 for the finish iterator }
+      FDepth : Integer;
+
+      { moves the iterator to the rank-th item }
+      procedure GoToRank(rank : SizeType);
+      { returns the number of items before the item at self }
+      function Rank : SizeType;
+
+   public
+      { creates a finish iterator }
+      constructor Create(tree : TPersistentAvlTree);
+      function CopySelf : TIterator; override;
+      function Equal(const Pos : TIterator) : Boolean; override;
+      function GetItem : ItemType; override;
+      { replaces the item with a newly inserted one; if aitem cannot be
+        inserted then it is disposed and the iterator is moved to the
+        finish position }
+      procedure SetItem(aitem : ItemType); override;
+      procedure ResetItem; override;
+      procedure Advance; overload; override;
+      procedure Retreat; override;
+      { @complexity worst-case O(log(n)) }
+      procedure Insert(aitem : ItemType); override;
+      function Extract : ItemType; override;
+      { deletes the items without extracting them, so the items still
+        used by other versions are not disposed; @complexity
+        worst-case O(m*log(n)) }
+      function Delete(finish : TForwardIterator) : SizeType; overload; override;
+      function Owner : TContainerAdt; override;
+      function IsStart : Boolean; override;
+      function IsFinish : Boolean; override;
+   end;
@@ -0,0 +1,923 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtpersistent_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtpersistent.defs
+&include adtpersistent_impl.mcp
+
+{ ========================================================================== }
+{             Notes on the implementation of TPersistentAvlTree             }
+{ -------------------------------------------------------------------------- }
+{ A node may be linked from several versions of the tree; RefCount
+  counts these links. A node with RefCount = 1 is reachable only
+  through a single link, so it may be changed in place by whoever
+  owns that link. Every other node is copied (UniqueNode) before it
+  is changed, and the copy takes over the link, so the other versions
+  still see the old node. All the routines changing a sub-tree take
+  over the link to its root and return the link to the new root. }
+{ All the updates are made by the position (rank) of an item, which is
+  computed first. Therefore, the item comparer is never called while
+  the tree is being rebuilt, and an exception raised by it leaves the
+  tree unchanged. }
+{ ========================================================================== }
+
+function NodeSize(node : PPersistentAvlNode) : SizeType;
+begin
+   if node <> nil then
+      Result := node^.Size
+   else
+      Result := 0;
+end;
+
+function NodeHeight(node : PPersistentAvlNode) : Integer;
+begin
+   if node <> nil then
+      Result := node^.Height
+   else
+      Result := 0;
+end;
+
+{ ------------------------ TPersistentAvlTree ------------------------------ }
+
+constructor TPersistentAvlTree.Create;
+begin
+   inherited;
+   FRoot := nil;
+end;
+
+constructor TPersistentAvlTree.CreateCopy(const cont : TPersistentAvlTree;
+                                          const itemCopier : IUnaryFunctor);
+begin
+   inherited CreateCopy(TSetAdt(cont));
+   FRoot := nil;
+   if itemCopier <> nil then
+      FRoot := CopySubTree(cont.FRoot, itemCopier);
+end;
+
+constructor TPersistentAvlTree.CreateSnapshot(const tree : TPersistentAvlTree);
+begin
+   inherited CreateCopy(TSetAdt(tree));
+   FRoot := tree.FRoot;
+   AcquireNode(FRoot);
+end;
+
+destructor TPersistentAvlTree.Destroy;
+begin
+   Clear;
+   inherited;
+end;
+
+function TPersistentAvlTree.NewNode(aitem : ItemType) : PPersistentAvlNode;
+begin
+   New(Result);
+   with Result^ do
+   begin
+      Left := nil;
+      Right := nil;
+      Item := aitem;
+      Size := 1;
+      Height := 1;
+      RefCount := 1;
+&if (&_mcp_type_needs_destruction(&ItemType))
+      ItemRef := nil;
+&endif
+   end;
+&if (&_mcp_type_needs_destruction(&ItemType))
+   try
+      New(Result^.ItemRef);
+   except
+      Dispose(Result);
+      raise;
+   end;
+   Result^.ItemRef^.Count := 1;
+   Result^.ItemRef^.Owned := true;
+&endif
+end;
+
+procedure TPersistentAvlTree.AcquireNode(node : PPersistentAvlNode);
+begin
+   if node <> nil then
+      InterlockedIncrement(node^.RefCount);
+end;
+
+procedure TPersistentAvlTree.ReleaseNode(node : PPersistentAvlNode);
+&if (&_mcp_type_needs_destruction(&ItemType))
+var
+   aitem : ItemType;
+&endif
+begin
+   if (node <> nil) and (InterlockedDecrement(node^.RefCount) = 0) then
+   begin
+      ReleaseNode(node^.Left);
+      ReleaseNode(node^.Right);
+&if (&_mcp_type_needs_destruction(&ItemType))
+      if InterlockedDecrement(node^.ItemRef^.Count) = 0 then
+      begin
+         if node^.ItemRef^.Owned then
+         begin
+            aitem := node^.Item;
+            DisposeItem(aitem);
+         end;
+         Dispose(node^.ItemRef);
+      end;
+&endif
+      Dispose(node);
+   end;
+end;
+
+function TPersistentAvlTree.UniqueNode(node : PPersistentAvlNode) : PPersistentAvlNode;
+begin
+   if node^.RefCount = 1 then
+   begin
+      Result := node;
+   end else
+   begin
+      New(Result);
+      Result^ := node^;
+      Result^.RefCount := 1;
+      AcquireNode(Result^.Left);
+      AcquireNode(Result^.Right);
+&if (&_mcp_type_needs_destruction(&ItemType))
+      InterlockedIncrement(Result^.ItemRef^.Count);
+&endif
+      { the link to node is now the link to Result }
+      ReleaseNode(node);
+   end;
+end;
+
+procedure TPersistentAvlTree.UpdateNode(node : PPersistentAvlNode);
+begin
+   node^.Size := NodeSize(node^.Left) + NodeSize(node^.Right) + 1;
+   node^.Height := Max(NodeHeight(node^.Left), NodeHeight(node^.Right)) + 1;
+end;
+
+function TPersistentAvlTree.RotateLeft(node : PPersistentAvlNode) : PPersistentAvlNode;
+begin
+   Result := UniqueNode(node^.Right);
+   node^.Right := Result^.Left;
+   Result^.Left := node;
+   UpdateNode(node);
+   UpdateNode(Result);
+end;
+
+function TPersistentAvlTree.RotateRight(node : PPersistentAvlNode) : PPersistentAvlNode;
+begin
+   Result := UniqueNode(node^.Left);
+   node^.Left := Result^.Right;
+   Result^.Right := node;
+   UpdateNode(node);
+   UpdateNode(Result);
+end;
+
+function TPersistentAvlTree.Balance(node : PPersistentAvlNode) : PPersistentAvlNode;
+var
+   bf : Integer;
+begin
+   UpdateNode(node);
+   bf := NodeHeight(node^.Left) - NodeHeight(node^.Right);
+   if bf > 1 then
+   begin
+      if NodeHeight(node^.Left^.Left) < NodeHeight(node^.Left^.Right) then
+         node^.Left := RotateLeft(UniqueNode(node^.Left));
+      Result := RotateRight(node);
+   end else if bf < -1 then
+   begin
+      if NodeHeight(node^.Right^.Right) < NodeHeight(node^.Right^.Left) then
+         node^.Right := RotateRight(UniqueNode(node^.Right));
+      Result := RotateLeft(node);
+   end else
+      Result := node;
+end;
+
+function TPersistentAvlTree.InsertNodeAt(node, newNode : PPersistentAvlNode;
+                                         rank : SizeType) : PPersistentAvlNode;
+var
+   leftSize : SizeType;
+begin
+   if node = nil then
+   begin
+      Result := newNode;
+   end else
+   begin
+      node := UniqueNode(node);
+      leftSize := NodeSize(node^.Left);
+      if rank <= leftSize then
+         node^.Left := InsertNodeAt(node^.Left, newNode, rank)
+      else
+         node^.Right := InsertNodeAt(node^.Right, newNode, rank - leftSize - 1);
+      Result := Balance(node);
+   end;
+end;
+
+function TPersistentAvlTree.RemoveMin(node : PPersistentAvlNode;
+                                      var minNode : PPersistentAvlNode) : PPersistentAvlNode;
+begin
+   node := UniqueNode(node);
+   if node^.Left = nil then
+   begin
+      minNode := node;
+      Result := node^.Right;
+      minNode^.Right := nil;
+      UpdateNode(minNode);
+   end else
+   begin
+      node^.Left := RemoveMin(node^.Left, minNode);
+      Result := Balance(node);
+   end;
+end;
+
+function TPersistentAvlTree.RemoveNodeAt(node : PPersistentAvlNode; rank : SizeType;
+                                         var removed : PPersistentAvlNode) : PPersistentAvlNode;
+var
+   leftSize : SizeType;
+   successor : PPersistentAvlNode;
+begin
+   node := UniqueNode(node);
+   leftSize := NodeSize(node^.Left);
+   if rank < leftSize then
+   begin
+      node^.Left := RemoveNodeAt(node^.Left, rank, removed);
+   end else if rank > leftSize then
+   begin
+      node^.Right := RemoveNodeAt(node^.Right, rank - leftSize - 1, removed);
+   end else
+   begin
+      removed := node;
+      successor := nil;
+      if node^.Right = nil then
+      begin
+         node := node^.Left;
+      end else if node^.Left = nil then
+      begin
+         node := node^.Right;
+      end else
+      begin
+         node^.Right := RemoveMin(node^.Right, successor);
+         successor^.Left := node^.Left;
+         successor^.Right := node^.Right;
+         node := successor;
+      end;
+      removed^.Left := nil;
+      removed^.Right := nil;
+      UpdateNode(removed);
+      if (successor = nil) or (node <> successor) then
+      begin
+         { a single child which has not been changed and may be shared,
+           or nil if a leaf has been removed }
+         Result := node;
+         Exit;
+      end;
+   end;
+   Result := Balance(node);
+end;
+
+function TPersistentAvlTree.CopySubTree(node : PPersistentAvlNode;
+                                        const itemCopier : IUnaryFunctor) : PPersistentAvlNode;
+var
+   leftCopy, rightCopy : PPersistentAvlNode;
+begin
+   if node = nil then
+   begin
+      Result := nil;
+      Exit;
+   end;
+
+   leftCopy := CopySubTree(node^.Left, itemCopier);
+   try
+      rightCopy := CopySubTree(node^.Right, itemCopier);
+      try
+         Result := NewNode(itemCopier.Perform(node^.Item));
+      except
+         ReleaseNode(rightCopy);
+         raise;
+      end;
+   except
+      ReleaseNode(leftCopy);
+      raise;
+   end;
+   Result^.Left := leftCopy;
+   Result^.Right := rightCopy;
+   UpdateNode(Result);
+end;
+
+function TPersistentAvlTree.NodeAt(rank : SizeType) : PPersistentAvlNode;
+var
+   leftSize : SizeType;
+begin
+   Assert((rank >= 0) and (rank < NodeSize(FRoot)), msgInvalidIterator);
+
+   Result := FRoot;
+   leftSize := NodeSize(Result^.Left);
+   while rank <> leftSize do
+   begin
+      if rank < leftSize then
+      begin
+         Result := Result^.Left;
+      end else
+      begin
+         rank := rank - leftSize - 1;
+         Result := Result^.Right;
+      end;
+      leftSize := NodeSize(Result^.Left);
+   end;
+end;
+
+function TPersistentAvlTree.LowerRank(aitem : ItemType) : SizeType;
+var
+   node : PPersistentAvlNode;
+   c : IndexType;
+begin
+   Result := 0;
+   node := FRoot;
+   while node <> nil do
+   begin
+      _mcp_compare_assign(node^.Item, aitem, c);
+      if c < 0 then
+      begin
+         Inc(Result, NodeSize(node^.Left) + 1);
+         node := node^.Right;
+      end else
+         node := node^.Left;
+   end;
+end;
+
+function TPersistentAvlTree.UpperRank(aitem : ItemType) : SizeType;
+var
+   node : PPersistentAvlNode;
+   c : IndexType;
+begin
+   Result := 0;
+   node := FRoot;
+   while node <> nil do
+   begin
+      _mcp_compare_assign(node^.Item, aitem, c);
+      if c <= 0 then
+      begin
+         Inc(Result, NodeSize(node^.Left) + 1);
+         node := node^.Right;
+      end else
+         node := node^.Left;
+   end;
+end;
+
+function TPersistentAvlTree.InsertionRank(aitem : ItemType) : IndexType;
+begin
+   Result := UpperRank(aitem);
+   if (not RepeatedItems) and (Result > 0) and
+         _mcp_equal(NodeAt(Result - 1)^.Item, aitem) then
+   begin
+      Result := -1;
+   end;
+end;
+
+procedure TPersistentAvlTree.DeleteAt(rank : SizeType);
+var
+   removed : PPersistentAvlNode;
+begin
+   removed := nil; { to avoid a warning }
+   FRoot := RemoveNodeAt(FRoot, rank, removed);
+   ReleaseNode(removed);
+end;
+
+function TPersistentAvlTree.ExtractAt(rank : SizeType) : ItemType;
+var
+   removed : PPersistentAvlNode;
+begin
+   removed := nil; { to avoid a warning }
+   FRoot := RemoveNodeAt(FRoot, rank, removed);
+   Result := removed^.Item;
+&if (&_mcp_type_needs_destruction(&ItemType))
+   removed^.ItemRef^.Owned := false;
+&endif
+   ReleaseNode(removed);
+end;
+
+{$ifdef PASCAL_ADT_STATS }
+procedure TPersistentAvlTree.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Height := NodeHeight(FRoot);
+end;
+{$endif PASCAL_ADT_STATS }
+
+function TPersistentAvlTree.CopySelf(const ItemCopier :
+                                        IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TPersistentAvlTree.CreateCopy(self, itemCopier);
+end;
+
+procedure TPersistentAvlTree.Swap(cont : TContainerAdt);
+begin
+   if cont is TPersistentAvlTree then
+   begin
+      BasicSwap(cont);
+      ExchangePtr(FRoot, TPersistentAvlTree(cont).FRoot);
+   end else
+      inherited;
+end;
+
+function TPersistentAvlTree.Snapshot : TPersistentAvlTree;
+begin
+   Result := TPersistentAvlTree.CreateSnapshot(self);
+end;
+
+function TPersistentAvlTree.Start : TSetIterator;
+var
+   iter : TPersistentAvlTreeIterator;
+begin
+   iter := TPersistentAvlTreeIterator.Create(self);
+   iter.GoToRank(0);
+   Result := iter;
+end;
+
+function TPersistentAvlTree.Finish : TSetIterator;
+begin
+   Result := TPersistentAvlTreeIterator.Create(self);
+end;
+
+&if (&_mcp_accepts_nil)
+function TPersistentAvlTree.FindOrInsert(aitem : ItemType) : ItemType;
+var
+   r : SizeType;
+begin
+   r := UpperRank(aitem);
+   if (not RepeatedItems) and (r > 0) and _mcp_equal(NodeAt(r - 1)^.Item, aitem) then
+   begin
+      Result := NodeAt(r - 1)^.Item;
+   end else
+   begin
+      FRoot := InsertNodeAt(FRoot, NewNode(aitem), r);
+      Result := nil;
+   end;
+end;
+
+function TPersistentAvlTree.Find(aitem : ItemType) : ItemType;
+var
+   r : SizeType;
+begin
+   r := LowerRank(aitem);
+   Result := nil;
+   if r < NodeSize(FRoot) then
+   begin
+      Result := NodeAt(r)^.Item;
+      if not _mcp_equal(Result, aitem) then
+         Result := nil;
+   end;
+end;
+&endif &# end &_mcp_accepts_nil
+
+function TPersistentAvlTree.Has(aitem : ItemType) : Boolean;
+var
+   r : SizeType;
+begin
+   r := LowerRank(aitem);
+   Result := (r < NodeSize(FRoot)) and _mcp_equal(NodeAt(r)^.Item, aitem);
+end;
+
+function TPersistentAvlTree.Count(aitem : ItemType) : SizeType;
+begin
+   Result := UpperRank(aitem) - LowerRank(aitem);
+end;
+
+function TPersistentAvlTree.Insert(pos : TSetIterator; aitem : ItemType) : Boolean;
+begin
+   Assert(pos is TPersistentAvlTreeIterator, msgInvalidIterator);
+   Result := Insert(aitem);
+end;
+
+function TPersistentAvlTree.Insert(aitem : ItemType) : Boolean;
+var
+   r : IndexType;
+begin
+   r := InsertionRank(aitem);
+   Result := r >= 0;
+   if Result then
+      FRoot := InsertNodeAt(FRoot, NewNode(aitem), r);
+end;
+
+procedure TPersistentAvlTree.Delete(pos : TSetIterator);
+begin
+   Assert(pos is TPersistentAvlTreeIterator, msgInvalidIterator);
+   Assert(not pos.IsFinish, msgDeletingInvalidIterator);
+
+   DeleteAt(TPersistentAvlTreeIterator(pos).Rank);
+end;
+
+function TPersistentAvlTree.Delete(aitem : ItemType) : SizeType;
+var
+   r : SizeType;
+   i : IndexType;
+begin
+   r := LowerRank(aitem);
+   Result := UpperRank(aitem) - r;
+   for i := 1 to Result do
+      DeleteAt(r);
+end;
+
+function TPersistentAvlTree.Extract(aitem : ItemType) : SizeType;
+var
+   r : SizeType;
+   i : IndexType;
+begin
+   r := LowerRank(aitem);
+   Result := UpperRank(aitem) - r;
+   for i := 1 to Result do
+      ExtractAt(r);
+end;
+
+function TPersistentAvlTree.LowerBound(aitem : ItemType) : TSetIterator;
+var
+   iter : TPersistentAvlTreeIterator;
+begin
+   iter := TPersistentAvlTreeIterator.Create(self);
+   iter.GoToRank(LowerRank(aitem));
+   Result := iter;
+end;
+
+function TPersistentAvlTree.UpperBound(aitem : ItemType) : TSetIterator;
+var
+   iter : TPersistentAvlTreeIterator;
+begin
+   iter := TPersistentAvlTreeIterator.Create(self);
+   iter.GoToRank(UpperRank(aitem));
+   Result := iter;
+end;
+
+function TPersistentAvlTree.EqualRange(aitem : ItemType) : TSetIteratorRange;
+var
+   iter1, iter2 : TPersistentAvlTreeIterator;
+begin
+   iter1 := TPersistentAvlTreeIterator.Create(self);
+   iter1.GoToRank(LowerRank(aitem));
+   iter2 := TPersistentAvlTreeIterator.Create(self);
+   iter2.GoToRank(UpperRank(aitem));
+   Result := TSetIteratorRange.Create(iter1, iter2);
+end;
+
+function TPersistentAvlTree.FindIf(const pred : IUnaryPredicate;
+                                   var aitem : ItemType) : Boolean;
+var
+   path : TPersistentAvlPath;
+   node : PPersistentAvlNode;
+   depth : Integer;
+begin
+   depth := 0;
+   node := FRoot;
+   while (node <> nil) or (depth > 0) do
+   begin
+      if node <> nil then
+      begin
+         path[depth] := node;
+         Inc(depth);
+         node := node^.Left;
+      end else
+      begin
+         Dec(depth);
+         node := path[depth];
+         if pred.Test(node^.Item) then
+         begin
+            aitem := node^.Item;
+            Result := true;
+            Exit;
+         end;
+         node := node^.Right;
+      end;
+   end;
+   Result := false;
+end;
+
+function TPersistentAvlTree.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   path : TPersistentAvlPath;
+   ranks : array of SizeType;
+   node : PPersistentAvlNode;
+   depth : Integer;
+   rank : SizeType;
+begin
+   Result := 0;
+   SetLength(ranks, NodeSize(FRoot));
+   rank := 0;
+   depth := 0;
+   node := FRoot;
+   while (node <> nil) or (depth > 0) do
+   begin
+      if node <> nil then
+      begin
+         path[depth] := node;
+         Inc(depth);
+         node := node^.Left;
+      end else
+      begin
+         Dec(depth);
+         node := path[depth];
+         if pred.Test(node^.Item) then
+         begin
+            ranks[Result] := rank;
+            Inc(Result);
+         end;
+         Inc(rank);
+         node := node^.Right;
+      end;
+   end;
+
+   { deleting an item does not change the ranks of the items before
+     it }
+   for rank := Result - 1 downto 0 do
+      DeleteAt(ranks[rank]);
+end;
+
+function TPersistentAvlTree.First : ItemType;
+begin
+   Assert(FRoot <> nil, msgReadEmpty);
+   Result := NodeAt(0)^.Item;
+end;
+
+function TPersistentAvlTree.ExtractFirst : ItemType;
+begin
+   Assert(FRoot <> nil, msgReadEmpty);
+   Result := ExtractAt(0);
+end;
+
+procedure TPersistentAvlTree.Clear;
+begin
+   ReleaseNode(FRoot);
+   FRoot := nil;
+   GrabageCollector.FreeObjects;
+end;
+
+function TPersistentAvlTree.Empty : Boolean;
+begin
+   Result := FRoot = nil;
+end;
+
+function TPersistentAvlTree.Size : SizeType;
+begin
+   Result := NodeSize(FRoot);
+end;
+
+{ --------------------- TPersistentAvlTreeIterator ------------------------- }
+
+constructor TPersistentAvlTreeIterator.Create(tree : TPersistentAvlTree);
+begin
+   inherited Create(tree);
+   FTree := tree;
+   FDepth := 0;
+end;
+
+procedure TPersistentAvlTreeIterator.GoToRank(rank : SizeType);
+var
+   node : PPersistentAvlNode;
+   leftSize : SizeType;
+begin
+   FDepth := 0;
+   if rank >= FTree.Size then
+      Exit;
+
+   node := FTree.FRoot;
+   repeat
+      FPath[FDepth] := node;
+      Inc(FDepth);
+      leftSize := NodeSize(node^.Left);
+      if rank < leftSize then
+      begin
+         node := node^.Left;
+      end else if rank > leftSize then
+      begin
+         rank := rank - leftSize - 1;
+         node := node^.Right;
+      end else
+         break;
+   until false;
+end;
+
+function TPersistentAvlTreeIterator.Rank : SizeType;
+var
+   i : Integer;
+begin
+   if FDepth = 0 then
+   begin
+      Result := FTree.Size;
+   end else
+   begin
+      Result := NodeSize(FPath[FDepth - 1]^.Left);
+      for i := FDepth - 1 downto 1 do
+      begin
+         if FPath[i - 1]^.Right = FPath[i] then
+            Inc(Result, NodeSize(FPath[i - 1]^.Left) + 1);
+      end;
+   end;
+end;
+
+function TPersistentAvlTreeIterator.CopySelf : TIterator;
+var
+   iter : TPersistentAvlTreeIterator;
+   i : Integer;
+begin
+   iter := TPersistentAvlTreeIterator.Create(FTree);
+   for i := 0 to FDepth - 1 do
+      iter.FPath[i] := FPath[i];
+   iter.FDepth := FDepth;
+   Result := iter;
+end;
+
+function TPersistentAvlTreeIterator.Equal(const Pos : TIterator) : Boolean;
+var
+   iter : TPersistentAvlTreeIterator;
+begin
+   Assert(pos is TPersistentAvlTreeIterator, msgInvalidIterator);
+
+   iter := TPersistentAvlTreeIterator(pos);
+   Result := (FDepth = iter.FDepth) and
+      ((FDepth = 0) or (FPath[FDepth - 1] = iter.FPath[FDepth - 1]));
+end;
+
+function TPersistentAvlTreeIterator.GetItem : ItemType;
+begin
+   Assert(FDepth <> 0, msgInvalidIterator);
+
+   Result := FPath[FDepth - 1]^.Item;
+end;
+
+procedure TPersistentAvlTreeIterator.SetItem(aitem : ItemType);
+var
+   r : IndexType;
+begin
+   Assert(FDepth <> 0, msgInvalidIterator);
+
+   { the node may be shared with other versions, so it cannot be
+     changed in place }
+   FTree.DeleteAt(Rank);
+   FDepth := 0;
+   try
+      r := FTree.InsertionRank(aitem);
+   except
+      with FTree do
+         DisposeItem(aitem);
+      raise;
+   end;
+   if r >= 0 then
+   begin
+      FTree.FRoot := FTree.InsertNodeAt(FTree.FRoot, FTree.NewNode(aitem), r);
+      GoToRank(r);
+   end else
+   begin
+      with FTree do
+         DisposeItem(aitem);
+   end;
+end;
+
+procedure TPersistentAvlTreeIterator.ResetItem;
+var
+   node : PPersistentAvlNode;
+   r : IndexType;
+begin
+   Assert(FDepth <> 0, msgInvalidIterator);
+
+   node := nil; { to avoid a warning }
+   FTree.FRoot := FTree.RemoveNodeAt(FTree.FRoot, Rank, node);
+   FDepth := 0;
+   try
+      r := FTree.InsertionRank(node^.Item);
+   except
+      FTree.ReleaseNode(node);
+      raise;
+   end;
+   if r >= 0 then
+   begin
+      FTree.FRoot := FTree.InsertNodeAt(FTree.FRoot, node, r);
+      GoToRank(r);
+   end else
+      FTree.ReleaseNode(node);
+end;
+
+procedure TPersistentAvlTreeIterator.Advance;
+var
+   node : PPersistentAvlNode;
+begin
+   Assert(FDepth <> 0, msgAdvancingFinishIterator);
+
+   node := FPath[FDepth - 1]^.Right;
+   if node <> nil then
+   begin
+      while node <> nil do
+      begin
+         FPath[FDepth] := node;
+         Inc(FDepth);
+         node := node^.Left;
+      end;
+   end else
+   begin
+      { go up until coming from a left child }
+      repeat
+         node := FPath[FDepth - 1];
+         Dec(FDepth);
+      until (FDepth = 0) or (FPath[FDepth - 1]^.Left = node);
+   end;
+end;
+
+procedure TPersistentAvlTreeIterator.Retreat;
+var
+   node : PPersistentAvlNode;
+begin
+   Assert(not IsStart, msgRetreatingStartIterator);
+
+   if FDepth = 0 then
+      node := FTree.FRoot
+   else
+      node := FPath[FDepth - 1]^.Left;
+
+   if node <> nil then
+   begin
+      while node <> nil do
+      begin
+         FPath[FDepth] := node;
+         Inc(FDepth);
+         node := node^.Right;
+      end;
+   end else
+   begin
+      { go up until coming from a right child }
+      repeat
+         node := FPath[FDepth - 1];
+         Dec(FDepth);
+      until FPath[FDepth - 1]^.Right = node;
+   end;
+end;
+
+procedure TPersistentAvlTreeIterator.Insert(aitem : ItemType);
+var
+   r : IndexType;
+begin
+   r := FTree.InsertionRank(aitem);
+   if r >= 0 then
+   begin
+      FTree.FRoot := FTree.InsertNodeAt(FTree.FRoot, FTree.NewNode(aitem), r);
+      GoToRank(r);
+   end else
+      FDepth := 0;
+end;
+
+function TPersistentAvlTreeIterator.Extract : ItemType;
+var
+   r : SizeType;
+begin
+   Assert(FDepth <> 0, msgDeletingInvalidIterator);
+
+   r := Rank;
+   Result := FTree.ExtractAt(r);
+   GoToRank(r);
+end;
+
+function TPersistentAvlTreeIterator.Delete(finish : TForwardIterator) : SizeType;
+var
+   r : SizeType;
+   i : IndexType;
+begin
+   Assert(finish is TPersistentAvlTreeIterator, msgInvalidIterator);
+   Assert(finish.Owner = FTree, msgWrongOwner);
+
+   r := Rank;
+   Result := TPersistentAvlTreeIterator(finish).Rank - r;
+   Assert(Result >= 0, msgInvalidRange);
+   for i := 1 to Result do
+      FTree.DeleteAt(r);
+   GoToRank(r);
+end;
+
+function TPersistentAvlTreeIterator.Owner : TContainerAdt;
+begin
+   Result := FTree;
+end;
+
+function TPersistentAvlTreeIterator.IsStart : Boolean;
+begin
+   Result := Rank = 0;
+end;
+
+function TPersistentAvlTreeIterator.IsFinish : Boolean;
+begin
+   Result := FDepth = 0;
+end;
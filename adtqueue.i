@@ -59,6 +59,10 @@ type
                            IUnaryFunctor) : TContainerAdt; override;
       { @see TContainerAdt.Swap }
       procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Capacity, LoadFactor and Resizes }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       function RandomAccessStart : TRandomAccessIterator; override;
       function RandomAccessFinish : TRandomAccessIterator; override;
       { returns an iterator to the first Item in the deque }
@@ -84,6 +88,33 @@ type
       function Size : SizeType; override;
       { returns false }
       function IsDefinedOrder : Boolean; override;
+      { loop over the circular buffer with a physical index which
+        wraps around at Capacity }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { moves the items which are kept towards the front in a single
+        pass; @complexity O(n) }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { moves the first <n> items to the back, preserving their order,
+        so that the item at index <n> becomes the first one; only the
+        shorter of the two parts is moved, into the free space of the
+        circular buffer, and then the start of the deque is shifted;
+        if the buffer is full nothing is moved at all; the Rotate
+        algorithm from @<adtalgs> calls this when it is applied to the
+        whole deque; @complexity O(min(n, Size - n)) }
+      procedure Rotate(n : SizeType);
+      { a slice ends where the circular buffer wraps around, so any
+        range of items consists of at most two slices }
+      function GetSlice(index : IndexType; n : SizeType) : TSlice; override;
+      { makes room for all the items with one move of the shorter part
+        of the deque and then copies them in, at most two slices at
+        a time }
+      procedure InsertBlock(index : IndexType; const buffer : array of ItemType;
+                            n : SizeType); override;
    end;
    
    TCircularDequeIterator = class(TRandomAccessContainerIterator)
@@ -116,7 +147,11 @@ type
       procedure SetCapacity(cap : SizeType); override;
 
    public
+      { uses segments of saSegmentCapacity items }
       constructor Create; overload;
+      { uses segments of <segmentCapacity> items, rounded up to a power
+        of two (at least 2) }
+      constructor Create(segmentCapacity : SizeType); overload;
       constructor CreateCopy(const cont : TSegDeque;
                              const itemCopier : IUnaryFunctor); overload;
       destructor Destroy; override;
@@ -124,6 +159,11 @@ type
                            IUnaryFunctor) : TContainerAdt; override;
       { @see TContainerAdt.Swap }
       procedure Swap(cont : TContainerAdt); override;
+{$ifdef PASCAL_ADT_STATS }
+      { adds Capacity, LoadFactor and Nodes; Nodes counts the
+        segments, including the spare ones }
+      procedure GetStats(var stats : TContainerStats); override;
+{$endif PASCAL_ADT_STATS }
       function RandomAccessStart : TRandomAccessIterator; override;
       function RandomAccessFinish : TRandomAccessIterator; override;
       { returns an iterator to the first Item in the deque }
@@ -143,11 +183,44 @@ type
       procedure PopFront; override;
       procedure PushBack(aitem : ItemType); override;
       procedure PopBack; override;
+      { pushes all of <aitems> at the back, filling one segment at a
+        time }
+      procedure PushBackMany(const aitems : array of ItemType);
+      { removes at most Length(<aitems>) items from the front and
+        stores them in <aitems>; returns the number of items removed;
+        the items are not disposed - they are owned by the caller
+        afterwards }
+      function PopFrontMany(var aitems : array of ItemType) : SizeType;
+      { returns the capacity of a single segment }
+      function SegmentCapacity : SizeType;
+      { writes the items one segment at a time }
+      procedure SaveToStream(stream : TStream;
+                             const streamer : IStreamer); overload; override;
+      { reads the items directly into the segments }
+      procedure LoadFromStream(stream : TStream;
+                               const streamer : IStreamer); overload; override;
       procedure Clear; override;
       function Empty : Boolean; override;
       function Size : SizeType; override;
       { returns false }
       function IsDefinedOrder : Boolean; override;
+      { scan the items one segment at a time, without converting
+        every index into a (segment, offset) pair }
+      procedure ForEach(const funct : IUnaryFunctor); override;
+      function Fold(const funct : IBinaryFunctor;
+                    init : ItemType) : ItemType; override;
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function CountIf(const pred : IUnaryPredicate) : SizeType; override;
+      { reads the items one segment at a time and moves the ones
+        which are kept towards the front; @complexity O(n) }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { a slice ends at the end of a segment }
+      function GetSlice(index : IndexType; n : SizeType) : TSlice; override;
+      { makes room for all the items at once and then copies them in,
+        one segment at a time }
+      procedure InsertBlock(index : IndexType; const buffer : array of ItemType;
+                            n : SizeType); override;
    end;
 
    TSegDequeIterator = class(TRandomAccessContainerIterator)
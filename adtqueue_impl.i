@@ -102,6 +102,20 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TCircularDeque.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Capacity := FItems^.Capacity;
+   stats.UsedSlots := FItems^.Size;
+   if stats.Capacity <> 0 then
+      stats.LoadFactor := stats.Items / stats.Capacity;
+   Inc(stats.Bytes, SizeOf(TDynamicArrayRec) +
+                       FItems^.Capacity * SizeOf(ItemType));
+   Inc(stats.Resizes, FItems^.Resizes);
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TCircularDeque.RandomAccessStart : TRandomAccessIterator;
 begin
    Result := Start;
@@ -244,6 +258,177 @@ begin
    Result := false;
 end;
 
+procedure TCircularDeque.ForEach(const funct : IUnaryFunctor);
+var
+   i, n : IndexType;
+begin
+   i := FItems^.StartIndex;
+   for n := 1 to FItems^.Size do
+   begin
+      funct.Perform(FItems^.Items[i]);
+      Inc(i);
+      if i = FItems^.Capacity then
+         i := 0;
+   end;
+end;
+
+function TCircularDeque.Fold(const funct : IBinaryFunctor;
+                             init : ItemType) : ItemType;
+var
+   i, n : IndexType;
+begin
+   Result := init;
+   i := FItems^.StartIndex;
+   for n := 1 to FItems^.Size do
+   begin
+      Result := funct.Perform(Result, FItems^.Items[i]);
+      Inc(i);
+      if i = FItems^.Capacity then
+         i := 0;
+   end;
+end;
+
+function TCircularDeque.FindIf(const pred : IUnaryPredicate;
+                               var aitem : ItemType) : Boolean;
+var
+   i, n : IndexType;
+begin
+   i := FItems^.StartIndex;
+   for n := 1 to FItems^.Size do
+   begin
+      if pred.Test(FItems^.Items[i]) then
+      begin
+         aitem := FItems^.Items[i];
+         Result := true;
+         Exit;
+      end;
+      Inc(i);
+      if i = FItems^.Capacity then
+         i := 0;
+   end;
+   Result := false;
+end;
+
+function TCircularDeque.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   i, n : IndexType;
+begin
+   Result := 0;
+   i := FItems^.StartIndex;
+   for n := 1 to FItems^.Size do
+   begin
+      if pred.Test(FItems^.Items[i]) then
+         Inc(Result);
+      Inc(i);
+      if i = FItems^.Capacity then
+         i := 0;
+   end;
+end;
+
+function TCircularDeque.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   r, w : IndexType; { logical indices }
+   rp, wp : IndexType; { physical indices }
+   aitem : ItemType;
+begin
+   r := 0;
+   w := 0;
+   rp := FItems^.StartIndex;
+   wp := rp;
+   try
+      while r < FItems^.Size do
+      begin
+         aitem := FItems^.Items[rp];
+         if pred.Test(aitem) then { may raise }
+         begin
+            Inc(r);
+            Inc(rp);
+            if rp = FItems^.Capacity then
+               rp := 0;
+            DisposeItem(aitem);
+         end else
+         begin
+            FItems^.Items[wp] := aitem;
+            Inc(w);
+            Inc(wp);
+            if wp = FItems^.Capacity then
+               wp := 0;
+            Inc(r);
+            Inc(rp);
+            if rp = FItems^.Capacity then
+               rp := 0;
+         end;
+      end;
+   finally
+      { [w, r) holds the deleted items; the untested ones (if an
+        exception was raised) are moved to w }
+      Result := r - w;
+      if r <> w then
+         ArrayCircularRemoveItems(FItems, w, r - w);
+   end;
+end;
+
+procedure TCircularDeque.Rotate(n : SizeType);
+var
+   k : SizeType;
+begin
+   Assert(n <= FItems^.Size, msgInvalidIndex);
+
+   with FItems^ do
+   begin
+      if (n = 0) or (n = Size) then
+         Exit;
+
+      if n <= Size - n then
+      begin
+         { move the first n items to the place just after the last one }
+         ArrayCircularMove(FItems, StartIndex,
+                           (StartIndex + Size) mod Capacity, n);
+         StartIndex := (StartIndex + n) mod Capacity;
+      end else
+      begin
+         { move the last Size - n items to the place just before the
+           first one }
+         k := Size - n;
+         ArrayCircularMove(FItems, (StartIndex + n) mod Capacity,
+                           (StartIndex + Capacity - k) mod Capacity, k);
+         StartIndex := (StartIndex + Capacity - k) mod Capacity;
+      end;
+   end;
+end;
+
+function TCircularDeque.GetSlice(index : IndexType; n : SizeType) : TSlice;
+var
+   ind : IndexType;
+begin
+   Assert((index >= 0) and (index + n <= FItems^.Size), msgInvalidIndex);
+
+   with FItems^ do
+   begin
+      ind := StartIndex + index;
+      if ind >= Capacity then
+         Dec(ind, Capacity);
+      Result.Items := @Items[ind];
+      Result.Count := Capacity - ind;
+      if n < Result.Count then
+         Result.Count := n;
+   end;
+end;
+
+procedure TCircularDeque.InsertBlock(index : IndexType;
+                                     const buffer : array of ItemType;
+                                     n : SizeType);
+begin
+   Assert((n >= 0) and (n <= Length(buffer)), msgInvalidArgument);
+   Assert((index >= 0) and (index <= FItems^.Size), msgInvalidIndex);
+
+   if n <> 0 then
+   begin
+      ArrayCircularReserveItems(FItems, index, n);
+      StoreBlock(index, buffer, n);
+   end;
+end;
+
 
 { --------------------- TCircularDequeIterator members ----------------------- }
 
@@ -257,7 +442,6 @@ procedure TCircularDequeIterator.ExchangeItemsAt(i, j : IndexType);
 var
    ind1, ind2 : IndexType;
    items1 : TDynamicArray;
-   aitem : ItemType;
 begin
    items1 := TCircularDeque(FCont).FItems;
    
@@ -271,9 +455,7 @@ begin
       if ind2 >= Capacity then
          Dec(ind2, Capacity);
 
-      aitem := Items[ind1];
-      Items[ind1] := Items[ind2];
-      Items[ind2] := aitem;
+      adtutils.ExchangeItem(Items[ind1], Items[ind2]);
    end;
 end;
 
@@ -287,9 +469,19 @@ end;
 
 constructor TSegDeque.Create;
 begin
-   inherited;
+   Create(saSegmentCapacity);
+end;
+
+constructor TSegDeque.Create(segmentCapacity : SizeType);
+var
+   shift : IndexType;
+begin
+   inherited Create;
+   shift := 1;
+   while (SizeType(1) shl shift) < segmentCapacity do
+      Inc(shift);
    SegArrayAllocate(FItems, SegDequeinitialSegments,
-                    SegDequeInitialSegments div 2, saSegmentCapacity div 2);
+                    SegDequeInitialSegments div 2, (1 shl shift) div 2, shift);
 end;
 
 constructor TSegDeque.CreateCopy(const cont : TSegDeque;
@@ -323,7 +515,8 @@ begin
    begin
       SegArrayAllocate(FItems, SegDequeinitialSegments,
                        SegDequeInitialSegments div 2,
-                       saSegmentCapacity div 2);
+                       (cont.FItems^.SegMask + 1) div 2,
+                       cont.FItems^.SegShift);
    end;
 end;
 
@@ -337,14 +530,14 @@ end;
 
 function TSegDeque.GetCapacity : SizeType;
 begin
-   Result := FItems^.Segments^.Size*saSegmentCapacity;
+   Result := FItems^.Segments^.Size*(FItems^.SegMask + 1);
 end;
 
 procedure TSegDeque.SetCapacity(cap : SizeType);
 var
    totalCap : SizeType;
 begin
-   totalCap := saSegmentCapacity*FItems^.Segments^.Size -
+   totalCap := (FItems^.SegMask + 1)*FItems^.Segments^.Size -
       FItems^.InnerStartIndex;
    if cap >  totalCap then
       SegArrayExpandRight(FItems, cap - totalCap);
@@ -365,6 +558,22 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TSegDeque.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Capacity := GetCapacity;
+   stats.UsedSlots := FItems^.Size;
+   if stats.Capacity <> 0 then
+      stats.LoadFactor := stats.Items / stats.Capacity;
+   stats.Nodes := FItems^.Segments^.Size + FItems^.SpareCount;
+   Inc(stats.Bytes, SizeOf(TSegArrayRec) + SizeOf(TPointerDynamicArrayRec) +
+                       FItems^.Segments^.Capacity * SizeOf(Pointer) +
+                       stats.Nodes * (SizeOf(TDynamicBufferRec) +
+                                         SegmentCapacity * SizeOf(ItemType)));
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TSegDeque.RandomAccessStart : TRandomAccessIterator;
 begin
    Result := Start;
@@ -494,6 +703,38 @@ begin
    DisposeItem(temp);
 end;
 
+procedure TSegDeque.PushBackMany(const aitems : array of ItemType);
+begin
+   SegArrayPushBackItems(FItems, aitems);
+end;
+
+function TSegDeque.PopFrontMany(var aitems : array of ItemType) : SizeType;
+begin
+   Result := SegArrayPopFrontItems(FItems, aitems);
+end;
+
+function TSegDeque.SegmentCapacity : SizeType;
+begin
+   Result := FItems^.SegMask + 1;
+end;
+
+procedure TSegDeque.SaveToStream(stream : TStream; const streamer : IStreamer);
+begin
+   StreamWriteHeader(stream, sfGeneric, SizeOf(ItemType));
+   StreamWriteSize(stream, FItems^.Size);
+   SegArrayWriteItems(FItems, stream, streamer);
+end;
+
+procedure TSegDeque.LoadFromStream(stream : TStream; const streamer : IStreamer);
+var
+   num : SizeType;
+begin
+   StreamReadHeader(stream, sfGeneric, SizeOf(ItemType));
+   num := StreamReadSize(stream);
+   Clear;
+   SegArrayReadItems(FItems, stream, num, streamer);
+end;
+
 procedure TSegDeque.Clear;
 begin
    &if (&_mcp_type_needs_destruction(&ItemType))
@@ -522,6 +763,147 @@ begin
    Result := false;
 end;
 
+procedure TSegDeque.ForEach(const funct : IUnaryFunctor);
+var
+   buf : TDynamicBuffer;
+   k, i, first : IndexType;
+   count : SizeType;
+begin
+   for k := 0 to SegArraySegmentCount(FItems) - 1 do
+   begin
+      SegArrayGetSegment(FItems, k, buf, first, count);
+      for i := first to first + count - 1 do
+         funct.Perform(buf^.Items[i]);
+   end;
+end;
+
+function TSegDeque.Fold(const funct : IBinaryFunctor;
+                        init : ItemType) : ItemType;
+var
+   buf : TDynamicBuffer;
+   k, i, first : IndexType;
+   count : SizeType;
+begin
+   Result := init;
+   for k := 0 to SegArraySegmentCount(FItems) - 1 do
+   begin
+      SegArrayGetSegment(FItems, k, buf, first, count);
+      for i := first to first + count - 1 do
+         Result := funct.Perform(Result, buf^.Items[i]);
+   end;
+end;
+
+function TSegDeque.FindIf(const pred : IUnaryPredicate;
+                          var aitem : ItemType) : Boolean;
+var
+   buf : TDynamicBuffer;
+   k, i, first : IndexType;
+   count : SizeType;
+begin
+   for k := 0 to SegArraySegmentCount(FItems) - 1 do
+   begin
+      SegArrayGetSegment(FItems, k, buf, first, count);
+      for i := first to first + count - 1 do
+      begin
+         if pred.Test(buf^.Items[i]) then
+         begin
+            aitem := buf^.Items[i];
+            Result := true;
+            Exit;
+         end;
+      end;
+   end;
+   Result := false;
+end;
+
+function TSegDeque.CountIf(const pred : IUnaryPredicate) : SizeType;
+var
+   buf : TDynamicBuffer;
+   k, i, first : IndexType;
+   count : SizeType;
+begin
+   Result := 0;
+   for k := 0 to SegArraySegmentCount(FItems) - 1 do
+   begin
+      SegArrayGetSegment(FItems, k, buf, first, count);
+      for i := first to first + count - 1 do
+      begin
+         if pred.Test(buf^.Items[i]) then
+            Inc(Result);
+      end;
+   end;
+end;
+
+function TSegDeque.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   buf : TDynamicBuffer;
+   k, i, first, segments : IndexType;
+   count : SizeType;
+   r, w : IndexType;
+   aitem : ItemType;
+begin
+   r := 0;
+   w := 0;
+   try
+      { the items are read one segment at a time; the write index
+        never overtakes the read index, so the segments stay valid
+        until the items are removed at the end }
+      segments := SegArraySegmentCount(FItems);
+      for k := 0 to segments - 1 do
+      begin
+         SegArrayGetSegment(FItems, k, buf, first, count);
+         for i := first to first + count - 1 do
+         begin
+            aitem := buf^.Items[i];
+            if pred.Test(aitem) then { may raise }
+            begin
+               Inc(r);
+               DisposeItem(aitem);
+            end else
+            begin
+               if w <> r then
+                  SegArraySetItem(FItems, w, aitem);
+               Inc(w);
+               Inc(r);
+            end;
+         end;
+      end;
+   finally
+      { [w, r) holds the deleted items }
+      Result := r - w;
+      if r <> w then
+         SegArrayRemoveItems(FItems, w, r - w);
+   end;
+end;
+
+function TSegDeque.GetSlice(index : IndexType; n : SizeType) : TSlice;
+var
+   segment, offset : IndexType;
+begin
+   Assert((index >= 0) and (index + n <= FItems^.Size), msgInvalidIndex);
+
+   SegArrayLogicalToSegOff(FItems, index, segment, offset);
+   Result.Items :=
+      @TDynamicBuffer(FItems^.Segments^.Items[segment])^.Items[offset];
+   Result.Count := FItems^.SegMask + 1 - offset;
+   if n < Result.Count then
+      Result.Count := n;
+end;
+
+procedure TSegDeque.InsertBlock(index : IndexType;
+                                const buffer : array of ItemType;
+                                n : SizeType);
+begin
+   Assert((n >= 0) and (n <= Length(buffer)), msgInvalidArgument);
+   Assert((index >= 0) and (index <= FItems^.Size), msgInvalidIndex);
+
+   if n <> 0 then
+   begin
+      SegArrayReserveItems(FItems, index, n);
+      StoreBlock(index, buffer, n);
+   end;
+end;
+
 { --------------------- TSegDequeIterator members ----------------------- }
 
 function TSegDequeIterator.CopySelf : TIterator;
@@ -534,7 +916,6 @@ var
    seg1, seg2, off1, off2 : IndexType;
    items1 : TSegArray;
    buff1, buff2 : TDynamicBuffer;
-   aitem : ItemType;
 begin
    items1 := TSegDeque(FCont).FItems;
          
@@ -544,8 +925,6 @@ begin
    buff1 := TDynamicBuffer(items1^.Segments^.Items[seg1]);
    buff2 := TDynamicBuffer(items1^.Segments^.Items[seg2]);
       
-   aitem := buff1^.Items[off1];
-   buff1^.Items[off1] := buff2^.Items[off2];
-   buff2^.Items[off2] := aitem;
+   adtutils.ExchangeItem(buff1^.Items[off1], buff2^.Items[off2]);
 end;
 
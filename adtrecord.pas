@@ -0,0 +1,41 @@
+(* This file is a part of the PascalAdt library, which provides
+   commonly used algorithms and data structures for FPC and Delphi
+   compilers.
+   
+   Copyright (C) 2004 by Lukasz Czajka
+   
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public License
+   as published by the Free Software Foundation; either version 2.1 of
+   the License, or (at your option) any later version.
+   
+   This library is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+   
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+   02110-1301 USA *)
+
+unit adtrecord;
+
+{ This unit declares the example record type for which the
+  instantiations of the library are generated when the MCP_RECORD mcp
+  define is given. Replace it with your own unit and adjust
+  adtrecord.inc accordingly. }
+
+interface
+
+type
+   { an item identified by a 64-bit number; the items are ordered and
+     hashed by the Id field only }
+   TIdRecord = record
+      Id : Int64;
+      Value : Double;
+   end;
+
+implementation
+
+end.
@@ -29,14 +29,23 @@
 
 type
    { This is a segmented array. Each segment has a capacity of
-     saSegmentCapacity. The segment at Segments[FirstSegIndex] is
-     guaranteed to be always valid (allocated). }
+     1 shl SegShift, which is saSegmentCapacity by default. The
+     segment at Segments[FirstSegIndex] is guaranteed to be always
+     valid (allocated). }
    TSegArrayRec = record
       Size : SizeType;
       FirstSegIndex, LastSegIndex : IndexType;
       InnerStartIndex : IndexType;
       ItemsInLastSeg : SizeType;
       Segments : &<TPointerDynamicArray>; { this is a dynamic array of @<TDynamicBuffer>s  }
+      { the capacity of a segment is 1 shl SegShift; SegMask is the
+        capacity minus one }
+      SegShift : IndexType;
+      SegMask : IndexType;
+      { segments freed by the array and kept to be reused instead of
+        allocating new ones }
+      SpareSegments : array[0..saMaxSpareSegments - 1] of TDynamicBuffer;
+      SpareCount : SizeType;
    end;
    { @see TSegArrayRec }
    TSegArray = ^TSegArrayRec;
@@ -49,6 +58,13 @@ procedure SegArrayAllocate(var a : TSegArray;
                            segments : SizeType;
                            StartIndex1, StartIndex2 : IndexType); overload;
 
+{ The same as above, but the segments have the capacity of
+  1 shl <segShift> items instead of saSegmentCapacity. }
+procedure SegArrayAllocate(var a : TSegArray;
+                           segments : SizeType;
+                           StartIndex1, StartIndex2 : IndexType;
+                           segShift : IndexType); overload;
+
 { Deallocates a segmented array. If <a> is nil then nothing
   happens. The argument <a> is set to nil. }
 procedure SegArrayDeallocate(var a : TSegArray); overload;
@@ -107,3 +123,36 @@ procedure SegArrayCopy(const src : TSegArray; var dest : TSegArray); overload;
 procedure SegArrayApplyFunctor(a : TSegArray;
                                const proc : IUnaryFunctor); overload;
 
+{ Writes all the items to <stream>, one segment at a time, using
+  StreamWriteItems. The size of the array is not written. }
+procedure SegArrayWriteItems(const a : TSegArray; stream : TStream;
+                             const streamer : IStreamer); overload;
+
+{ Reads <n> items written by SegArrayWriteItems and appends them at
+  the back, filling one segment at a time and allocating new segments
+  when necessary. If an exception is raised the items read so far
+  remain in the array, except for the ones from the segment being
+  read, which are lost. }
+procedure SegArrayReadItems(a : TSegArray; stream : TStream;
+                            n : SizeType; const streamer : IStreamer); overload;
+
+{ Returns the number of segments holding the items of <a>. }
+function SegArraySegmentCount(const a : TSegArray) : SizeType; overload;
+
+{ Returns the items of the <k>-th segment holding the items of <a>
+  (counting from 0): these are <buf>^.Items[first..first+count-1].
+  This allows to scan the array one segment at a time, without
+  converting the index of every item into a (segment,offset) pair. }
+procedure SegArrayGetSegment(const a : TSegArray; k : IndexType;
+                             var buf : TDynamicBuffer;
+                             var first : IndexType; var count : SizeType); overload;
+
+{ Pushes <items> at the back, filling one segment at a time. }
+procedure SegArrayPushBackItems(a : TSegArray;
+                                const items : array of ItemType); overload;
+
+{ Pops at most Length(<items>) items from the front, one segment at a
+  time, and stores them in <items>. Returns the number of items
+  popped. }
+function SegArrayPopFrontItems(a : TSegArray;
+                               var items : array of ItemType) : SizeType; overload;
@@ -40,7 +40,7 @@ begin
    Assert(a^.Segments <> nil);
    if a^.LastSegIndex <> a^.FirstSegIndex then
    begin
-      shouldBe := (a^.LastSegIndex - a^.FirstSegIndex) * saSegmentCapacity -
+      shouldBe := (a^.LastSegIndex - a^.FirstSegIndex) * (a^.SegMask + 1) -
          a^.InnerStartIndex + a^.ItemsInLastSeg;
    end else
    begin
@@ -49,12 +49,82 @@ begin
    Result := shouldBe = a^.Size;
 end;
 
+{ returns a segment for <a>, taken from the spare segments if there
+  are any }
+function SegArrayNewSegment(a : TSegArray) : TDynamicBuffer;
+begin
+   with a^ do
+   begin
+      if SpareCount <> 0 then
+      begin
+         Dec(SpareCount);
+         Result := SpareSegments[SpareCount];
+      end else
+         BufferAllocate(Result, SegMask + 1);
+   end;
+end;
+
+{ puts <db> among the spare segments of <a>, or deallocates it if
+  there are already saMaxSpareSegments of them; sets <db> to nil }
+procedure SegArrayReleaseSegment(a : TSegArray; var db : TDynamicBuffer);
+begin
+   with a^ do
+   begin
+      if SpareCount < saMaxSpareSegments then
+      begin
+&if (&_mcp_is_plain_data(&ItemType&))
+&else
+         { do not keep the references to the removed items }
+         Finalize(db^.Items[0], SegMask + 1);
+&endif
+         SpareSegments[SpareCount] := db;
+         Inc(SpareCount);
+         db := nil;
+      end else
+         BufferDeallocate(db);
+   end;
+end;
+
+{ appends a new segment at the back of a^.Segments; if there is no
+  room at the back, but at least half of a^.Segments is unused at the
+  front, then the segments are moved to the middle instead of
+  expanding a^.Segments, so that the array does not grow when used as
+  a FIFO queue }
+procedure SegArrayAppendSegment(a : TSegArray);
+var
+   diff : IndexType;
+begin
+   diff := 0;
+   with a^.Segments^ do
+   begin
+      if (StartIndex + Size = Capacity) and (StartIndex >= Size) then
+      begin
+         diff := StartIndex - StartIndex div 2;
+         SafeMove(Items[StartIndex], Items[StartIndex - diff], Size);
+         Dec(StartIndex, diff);
+      end;
+   end;
+   Dec(a^.FirstSegIndex, diff);
+   Dec(a^.LastSegIndex, diff);
+   ArrayPushBack(a^.Segments, SegArrayNewSegment(a));
+end;
+
 procedure SegArrayAllocate(var a : TSegArray;
                            segments : SizeType;
                            StartIndex1, StartIndex2 : IndexType);
+begin
+   SegArrayAllocate(a, segments, StartIndex1, StartIndex2, saSegmentShift);
+end;
+
+procedure SegArrayAllocate(var a : TSegArray;
+                           segments : SizeType;
+                           StartIndex1, StartIndex2 : IndexType;
+                           segShift : IndexType);
 var
    db : TDynamicBuffer;
 begin
+   Assert((StartIndex2 >= 0) and (StartIndex2 < 1 shl segShift), msgInvalidIndex);
+   
    if segments <= 0 then
       segments := 1;
    
@@ -65,8 +135,11 @@ begin
    a^.Size := 0;
    a^.ItemsInLastSeg := 0;
    a^.LastSegIndex := a^.FirstSegIndex;
+   a^.SegShift := segShift;
+   a^.SegMask := (1 shl segShift) - 1;
+   a^.SpareCount := 0;
    
-   BufferAllocate(db, saSegmentCapacity);
+   db := SegArrayNewSegment(a);
    with a^.Segments^ do
    begin
       Items[a^.FirstSegIndex] := db;
@@ -89,6 +162,8 @@ begin
          for i := StartIndex to StartIndex + Size - 1 do
             BufferDeallocate(TDynamicBuffer(Items[i]));
       end;
+      for i := 0 to a^.SpareCount - 1 do
+         BufferDeallocate(a^.SpareSegments[i]);
       ArrayDeallocate(a^.Segments);
       Dispose(a);
       a := nil;
@@ -109,7 +184,7 @@ begin
    with a^.Segments^ do
    begin
       for i := StartIndex + 1 to StartIndex + Size - 1 do
-         BufferDeallocate(TDynamicBuffer(Items[i]));
+         SegArrayReleaseSegment(a, TDynamicBuffer(Items[i]));
       db := Items[StartIndex];
    end;
    ArrayClear(a^.Segments, segments, segments div 2);
@@ -126,7 +201,7 @@ begin
       LastSegIndex := FirstSegIndex;
       Size := 0;
       ItemsInLastSeg := 0;
-      InnerStartIndex := saSegmentCapacity div 2;
+      InnerStartIndex := (a^.SegMask + 1) div 2;
    end;
 end;
 
@@ -141,7 +216,7 @@ begin
    
    with a^.Segments^ do
    begin
-      newSegs := n div saSegmentCapacity + 1;
+      newSegs := n shr a^.SegShift + 1;
       segsToAlloc := StartIndex + Size + newSegs - Capacity;
    end;
    
@@ -151,7 +226,7 @@ begin
    with a^.Segments^ do
    begin
       for i := StartIndex + Size to StartIndex + Size + newSegs - 1 do
-         BufferAllocate(TDynamicBuffer(Items[i]), saSegmentCapacity);
+         Items[i] := SegArrayNewSegment(a);
       Inc(Size, NewSegs);
    end;
 end;
@@ -166,7 +241,7 @@ begin
    
    with a^.Segments^ do
    begin
-      newSegs := n div saSegmentCapacity + 1;
+      newSegs := n shr a^.SegShift + 1;
       SegsToAlloc := newSegs - StartIndex; { (StartIndex - newSegs) - StartIndex }
    end;
    if SegsToAlloc > 0 then
@@ -187,7 +262,7 @@ begin
    with a^.Segments^ do
    begin
       for i := StartIndex - 1 downto StartIndex - newSegs do
-         BufferAllocate(TDynamicBuffer(Items[i]), saSegmentCapacity);
+         Items[i] := SegArrayNewSegment(a);
       Inc(Size, NewSegs);
       Dec(StartIndex, newSegs);
    end;
@@ -203,13 +278,13 @@ begin
    
    with a^ do
    begin
-      segment := index div saSegmentCapacity + FirstSegIndex;
-      offset := index mod saSegmentCapacity + InnerStartIndex;
+      segment := index shr a^.SegShift + FirstSegIndex;
+      offset := index and a^.SegMask + InnerStartIndex;
 
-      if offset >= saSegmentCapacity then
+      if offset > a^.SegMask then
       begin
          Inc(segment);
-         Dec(offset, saSegmentCapacity);
+         Dec(offset, a^.SegMask + 1);
       end;
    end;
 end;
@@ -259,12 +334,12 @@ begin
    Dec(a^.InnerStartIndex);
    if (a^.InnerStartIndex < 0) then
    begin
-      a^.InnerStartIndex := saSegmentCapacity - 1;
+      a^.InnerStartIndex := a^.SegMask;
       Dec(a^.FirstSegIndex);
       if a^.FirstSegIndex < a^.Segments^.StartIndex then
       begin
          diff := a^.Segments^.StartIndex - 1;
-         BufferAllocate(db, saSegmentCapacity);
+         db := SegArrayNewSegment(a);
          { true - may change StartIndex, i.e. move items to some other
            location - we need to adjust FirstSegIndex and LastSegIndex }
          ArrayPushFront(a^.Segments, db, true); 
@@ -297,14 +372,11 @@ begin
       else
          InnerStart := InnerStartIndex;
       
-      if InnerStart + ItemsInLastSeg = saSegmentCapacity then
+      if InnerStart + ItemsInLastSeg = a^.SegMask + 1 then
       begin
 	 Inc(LastSegIndex);
 	 if LastSegIndex >= Segments^.StartIndex + Segments^.Size then
-	 begin
-	    BufferAllocate(lastSeg, saSegmentCapacity);
-	    ArrayPushBack(Segments, lastSeg);
-	 end;
+	    SegArrayAppendSegment(a);
 	 ItemsInLastSeg := 0;
          InnerStart := 0;
       end;
@@ -334,13 +406,14 @@ begin
          Dec(ItemsInLastSeg);
       
       Inc(InnerStartIndex);
-      if InnerStartIndex = saSegmentCapacity then
+      if InnerStartIndex = a^.SegMask + 1 then
       begin
          if FirstSegIndex <> LastSegIndex then
          begin
             if Segments^.StartIndex < FirstSegIndex then
             begin
-               BufferDeallocate(TDynamicBuffer(Segments^.Items[Segments^.StartIndex]));
+               SegArrayReleaseSegment(a,
+                  TDynamicBuffer(Segments^.Items[Segments^.StartIndex]));
                Inc(Segments^.StartIndex);
                Dec(Segments^.Size);
             end;
@@ -350,7 +423,7 @@ begin
          begin
             { set the InnerStartIndex to some sensible value, we may
               do it becuase the array is now empty }
-            InnerStartIndex := saSegmentCapacity div 2; 
+            InnerStartIndex := (a^.SegMask + 1) div 2; 
          end;
       end;
       Dec(a^.Size);
@@ -385,17 +458,17 @@ begin
             if lastSegIndex < Segments^.StartIndex + Segments^.Size - 1 then
             begin
                with Segments^ do
-                  BufferDeallocate(TDynamicBuffer(Items[StartIndex + Size - 1]));
+                  SegArrayReleaseSegment(a, TDynamicBuffer(Items[StartIndex + Size - 1]));
                Dec(Segments^.Size);
             end;
             Dec(lastSegIndex);
             if LastSegIndex <> FirstSegIndex then
-               ItemsInLastSeg := saSegmentCapacity
+               ItemsInLastSeg := a^.SegMask + 1
             else
-               ItemsInLastSeg := saSegmentCapacity - InnerStartIndex;
+               ItemsInLastSeg := a^.SegMask + 1 - InnerStartIndex;
          end else
          begin
-            InnerStartIndex := saSegmentCapacity div 2;
+            InnerStartIndex := (a^.SegMask + 1) div 2;
          end;
       end;
       
@@ -412,14 +485,14 @@ procedure SegArrayReserveItems(a : TSegArray; index : IndexType; n : SizeType);
       with a^ do
       begin
          Result := (Segments^.Size -
-                (FirstSegIndex - Segments^.StartIndex)) * saSegmentCapacity -
+                (FirstSegIndex - Segments^.StartIndex)) * (a^.SegMask + 1) -
                (a^.Size + a^.InnerStartIndex) >= n;
       end;
    end;
 
 var
    destSeg, destOff, srcSeg, srcOff, FirstSrcSeg, FirstSrcOff : IndexType;
-   InnerStart : IndexType;
+   InnerStart, chunk : IndexType;
    freeSpaceInLastSeg : SizeType;
    destBuf, srcBuf : TDynamicBuffer;
 begin
@@ -436,7 +509,7 @@ begin
    begin
       with a^ do
       begin
-         if n > (FirstSegIndex - Segments^.startIndex) * saSegmentCapacity +
+         if n > (FirstSegIndex - Segments^.startIndex) * (a^.SegMask + 1) +
                InnerStartIndex then
          begin
             SegArrayExpandLeft(a, n);
@@ -450,10 +523,10 @@ begin
          if n > InnerStartIndex then
          begin
             Dec(n, InnerStartIndex);
-            Dec(firstSegIndex, n div saSegmentCapacity);
-            if (n mod saSegmentCapacity) <> 0 then
+            Dec(firstSegIndex, n shr a^.SegShift);
+            if (n and a^.SegMask) <> 0 then
             begin
-               InnerStartIndex := saSegmentCapacity - (n mod saSegmentCapacity);
+               InnerStartIndex := a^.SegMask + 1 - (n and a^.SegMask);
                Dec(FirstSegIndex);
             end else
             begin
@@ -477,19 +550,17 @@ begin
          
          Inc(a^.Size, n);
          
-         freeSpaceInLastSeg := saSegmentCapacity - ItemsInLastSeg;
+         freeSpaceInLastSeg := a^.SegMask + 1 - ItemsInLastSeg;
          if FirstSegIndex = LastSegIndex then
             Dec(freeSpaceInLastSeg, InnerStartIndex);
          
          if n > freeSpaceInLastSeg then
          begin
             Dec(n, freeSpaceInLastSeg);
-            Inc(LastSegIndex, n div saSegmentCapacity);
-            ItemsInLastSeg := n mod saSegmentCapacity;
-            if ItemsInLastSeg <> 0 then
-            begin
-               Inc(LastSegIndex);
-            end;
+            { the last segment is full if n is a multiple of the
+              segment capacity }
+            Inc(LastSegIndex, ((n - 1) shr a^.SegShift) + 1);
+            ItemsInLastSeg := ((n - 1) and a^.SegMask) + 1;
          end else
          begin
             Inc(ItemsInLastSeg, n);
@@ -512,33 +583,42 @@ begin
          
          SegArrayLogicalToSegOff(a, index - 1, FirstSrcSeg, FirstSrcOff);
          
-         destSeg := srcSeg + (n div saSegmentCapacity);
-         destOff := srcOff + (n mod saSegmentCapacity);
-         if destOff >= saSegmentCapacity then
+         destSeg := srcSeg + (n shr a^.SegShift);
+         destOff := srcOff + (n and a^.SegMask);
+         if destOff > a^.SegMask then
          begin
             Inc(destSeg);
-            Dec(destOff, saSegmentCapacity);
+            Dec(destOff, a^.SegMask + 1);
          end;
          
          destBuf := TDynamicBuffer(Segments^.Items[destSeg]);
          srcBuf := TDynamicBuffer(Segments^.Items[srcSeg]);
          
+         { items are relocated in chunks which do not cross a segment
+           boundary in either the source or the destination }
          while (srcSeg <> firstSrcSeg) or (srcOff <> FirstSrcOff) do
          begin
-            destBuf^.Items[destOff] := srcBuf^.Items[srcOff];
+            chunk := srcOff + 1;
+            if destOff + 1 < chunk then
+               chunk := destOff + 1;
+            if (srcSeg = FirstSrcSeg) and (srcOff - FirstSrcOff < chunk) then
+               chunk := srcOff - FirstSrcOff;
+            
+            RelocateItems(srcBuf^.Items[srcOff - chunk + 1],
+                          destBuf^.Items[destOff - chunk + 1], chunk);
             
-            Dec(destOff);
+            Dec(destOff, chunk);
             if DestOff < 0 then
             begin
-               DestOff := saSegmentCapacity - 1;
+               DestOff := a^.SegMask;
                Dec(destSeg);
                destBuf := TDynamicBuffer(Segments^.Items[destSeg]);
             end;
             
-            Dec(srcOff);
+            Dec(srcOff, chunk);
             if srcOff < 0 then
             begin
-               srcOff := saSegmentCapacity - 1;
+               srcOff := a^.SegMask;
                Dec(srcSeg);
                srcBuf := TDynamicBuffer(Segments^.Items[srcSeg]);
             end;
@@ -555,24 +635,24 @@ begin
          Inc(ItemsInLastSeg, n); { now ItemsInLastSeg > 0 }
          { this -1 is necessary, because otherwise LastSegIndex would
            be increased 1 too much when ItemsInLastSeg + InnerStart =
-           saSegmentCapacity (after increasing ItemsInLastSeg) }
+           the segment capacity (after increasing ItemsInLastSeg) }
          { ItemsInLastSeg has valid values from 1 to saSegCapacity -
            it denotes the size of the last segnent - the _number_ of
            items, but the mod operation is correct for _indicies_,
            which are 0-based }
-         Inc(LastSegIndex, (ItemsInLastSeg + InnerStart - 1) div saSegmentCapacity);
+         Inc(LastSegIndex, (ItemsInLastSeg + InnerStart - 1) shr a^.SegShift);
          { we just convert ItemsInLastSeg into "index to last item in
            seg", and then back to the _number_ of items; we refrain
            from doing this if LastSegIndex was not actually increased,
            because it would require taking into account InnerStart
            when converting back }
-         if ItemsInLastSeg + InnerStart > saSegmentCapacity then
-            ItemsInLastSeg := ((ItemsInLastSeg + InnerStart - 1) mod saSegmentCapacity) + 1;
+         if ItemsInLastSeg + InnerStart > a^.SegMask + 1 then
+            ItemsInLastSeg := ((ItemsInLastSeg + InnerStart - 1) and a^.SegMask) + 1;
          // this was an imperfect guard against the situation mentioned above, but it failed
 {         if ItemsInLastSeg = 0 then
          begin
             Dec(LastSegIndex);
-            ItemsInLastSeg := saSegmentCapacity;
+            ItemsInLastSeg := a^.SegMask + 1;
          end;}
       end;
       Inc(a^.Size, n);
@@ -583,7 +663,7 @@ procedure SegArrayRemoveItems(a : TSegArray; index : IndexType; n : SizeType);
 var
    destBuf, srcBuf : TDynamicBuffer;
    destSeg, srcSeg, destOff, srcOff, finishOff, finishSeg : IndexType;
-   i : IndexType;
+   i, chunk : IndexType;
 begin
    Assert(a <> nil, msgNilArray);
    Assert(IsValidIndex(index, a^.Size), msgInvalidIndex);
@@ -602,28 +682,28 @@ begin
          Dec(a^.Size, n);         
          Inc(innerStartIndex, n);
          
-         if InnerStartIndex >= saSegmentCapacity then
+         if InnerStartIndex > a^.SegMask then
          begin
-            Inc(FirstSegIndex, InnerStartIndex div saSegmentCapacity);
-            InnerStartIndex := InnerStartIndex mod saSegmentCapacity;
+            Inc(FirstSegIndex, InnerStartIndex shr a^.SegShift);
+            InnerStartIndex := InnerStartIndex and a^.SegMask;
             
             { may happen when removing all items }
             if LastSegIndex < FirstSegIndex then
             begin
                Assert(a^.Size = 0, msgInternalError);
                FirstSegIndex := LastSegIndex;
-               InnerStartIndex := saSegmentCapacity div 2;
+               InnerStartIndex := (a^.SegMask + 1) div 2;
             end;
             
             if LastSegIndex = FirstSegIndex then
             begin
-               Assert(Size <= saSegmentCapacity - InnerStartIndex);
-               ItemsInLastSeg := Size; // Min(saSegmentCapacity - InnerStartIndex, Size) ???;
+               Assert(Size <= a^.SegMask + 1 - InnerStartIndex);
+               ItemsInLastSeg := Size; // Min(a^.SegMask + 1 - InnerStartIndex, Size) ???;
             end;
             
             for i := Segments^.StartIndex to FirstSegIndex - 2 do
             begin
-               BufferDeallocate(TDynamicBuffer(Segments^.Items[i]));
+               SegArrayReleaseSegment(a, TDynamicBuffer(Segments^.Items[i]));
                Dec(Segments^.Size);
                Inc(Segments^.StartIndex);
             end;
@@ -651,7 +731,7 @@ begin
          if LastSegIndex = FirstSegIndex then
             finishOff := finishOff + InnerStartIndex;
          
-         if finishOff = saSegmentCapacity then
+         if finishOff = a^.SegMask + 1 then
          begin
             finishOff := 0;
             finishSeg := lastSegIndex + 1;
@@ -666,18 +746,24 @@ begin
            start of this loop }
          while (srcSeg <> finishSeg) or (srcOff <> finishOff) do
          begin
-            destBuf^.Items[destOff] := srcBuf^.Items[srcOff];
+            chunk := a^.SegMask + 1 - srcOff;
+            if a^.SegMask + 1 - destOff < chunk then
+               chunk := a^.SegMask + 1 - destOff;
+            if (srcSeg = finishSeg) and (finishOff - srcOff < chunk) then
+               chunk := finishOff - srcOff;
+            
+            RelocateItems(srcBuf^.Items[srcOff], destBuf^.Items[destOff], chunk);
             
-            Inc(destOff);
-            if DestOff >= saSegmentCapacity then
+            Inc(destOff, chunk);
+            if DestOff > a^.SegMask then
             begin
                DestOff := 0;
                Inc(destSeg);
                destBuf := TDynamicBuffer(Segments^.Items[destSeg]);
             end;
             
-            Inc(srcOff);
-            if srcOff >= saSegmentCapacity then
+            Inc(srcOff, chunk);
+            if srcOff > a^.SegMask then
             begin
                srcOff := 0;
                Inc(srcSeg);
@@ -692,19 +778,19 @@ begin
          begin   
             ItemsInLastSeg := 0;
             LastSegIndex := FirstSegIndex;
-            InnerStartIndex := saSegmentCapacity div 2;
+            InnerStartIndex := (a^.SegMask + 1) div 2;
          end else if ItemsInLastSeg <= 0 then
          begin
-            Dec(LastSegIndex, (-ItemsInLastSeg div saSegmentCapacity) + 1);
-            ItemsInLastSeg := saSegmentCapacity -
-               (-ItemsinLastSeg mod saSegmentCapacity);
+            Dec(LastSegIndex, ((-ItemsInLastSeg) shr a^.SegShift) + 1);
+            ItemsInLastSeg := a^.SegMask + 1 -
+               ((-ItemsinLastSeg) and a^.SegMask);
             if LastSegIndex = FirstSegIndex then
                Dec(ItemsInLastSeg, InnerStartIndex);
          end;
          
          for i := LastSegIndex + 2 to Segments^.StartIndex + Segments^.Size - 1 do
          begin
-            BufferDeallocate(TDynamicBuffer(Segments^.Items[i]));
+            SegArrayReleaseSegment(a, TDynamicBuffer(Segments^.Items[i]));
             Dec(Segments^.Size);
          end;
          
@@ -728,6 +814,9 @@ begin
    with dest^ do
    begin
       Size := src^.Size;
+      SegShift := src^.SegShift;
+      SegMask := src^.SegMask;
+      SpareCount := 0;
       FirstSegIndex := src^.FirstSegIndex;
       LastSegIndex := src^.LastSegIndex;
       InnerStartIndex := src^.InnerStartIndex;
@@ -761,7 +850,7 @@ begin
    begin
       db := TDynamicBuffer(Segments^.Items[FirstSegIndex]);
       for j := InnerStartIndex to Min(InnerStartIndex + a^.Size,
-                                      saSegmentCapacity) - 1 do
+                                      a^.SegMask + 1) - 1 do
       begin
          db^.Items[j] := proc.Perform(db^.Items[j]);
       end;
@@ -769,7 +858,7 @@ begin
       for i := FirstSegIndex + 1 to LastSegIndex - 1 do
       begin
          db := TDynamicBuffer(Segments^.Items[i]);
-         for j := 0 to saSegmentCapacity - 1 do
+         for j := 0 to a^.SegMask do
             db^.Items[j] := proc.Perform(db^.Items[j]);
       end;
       
@@ -782,3 +871,201 @@ begin
    end;
 end;
 
+procedure SegArrayWriteItems(const a : TSegArray; stream : TStream;
+                             const streamer : IStreamer);
+var
+   db : TDynamicBuffer;
+   i : IndexType;
+   n : SizeType;
+begin
+   Assert(a <> nil, msgNilArray);
+   Assert(SegArrayValid(a));
+
+   with a^ do
+   begin
+      db := TDynamicBuffer(Segments^.Items[FirstSegIndex]);
+      n := Min(InnerStartIndex + a^.Size, a^.SegMask + 1) - InnerStartIndex;
+      if n <> 0 then
+         StreamWriteItems(stream, db^.Items[InnerStartIndex], n, streamer);
+
+      for i := FirstSegIndex + 1 to LastSegIndex - 1 do
+      begin
+         db := TDynamicBuffer(Segments^.Items[i]);
+         StreamWriteItems(stream, db^.Items[0], a^.SegMask + 1, streamer);
+      end;
+
+      if (FirstSegIndex <> LastSegIndex) and (ItemsInLastSeg <> 0) then
+      begin
+         db := TDynamicBuffer(Segments^.Items[LastSegIndex]);
+         StreamWriteItems(stream, db^.Items[0], ItemsInLastSeg, streamer);
+      end;
+   end;
+end;
+
+procedure SegArrayReadItems(a : TSegArray; stream : TStream;
+                            n : SizeType; const streamer : IStreamer);
+var
+   lastSeg : TDynamicBuffer;
+   InnerStart : IndexType;
+   k : SizeType;
+begin
+   Assert(a <> nil, msgNilArray);
+   Assert(SegArrayValid(a));
+
+   with a^ do
+   begin
+      while n <> 0 do
+      begin
+         if LastSegIndex <> FirstSegIndex then
+            InnerStart := 0
+         else
+            InnerStart := InnerStartIndex;
+
+         if InnerStart + ItemsInLastSeg = a^.SegMask + 1 then
+         begin
+            Inc(LastSegIndex);
+            if LastSegIndex >= Segments^.StartIndex + Segments^.Size then
+               SegArrayAppendSegment(a);
+            ItemsInLastSeg := 0;
+            InnerStart := 0;
+         end;
+         lastSeg := TDynamicBuffer(Segments^.Items[LastSegIndex]);
+
+         k := Min(n, a^.SegMask + 1 - InnerStart - ItemsInLastSeg);
+         StreamReadItems(stream, lastSeg^.Items[InnerStart + ItemsInLastSeg],
+                         k, streamer);
+         Inc(ItemsInLastSeg, k);
+         Inc(a^.Size, k);
+         Dec(n, k);
+      end;
+   end;
+end;
+
+function SegArraySegmentCount(const a : TSegArray) : SizeType;
+begin
+   Assert(a <> nil, msgNilArray);
+   Assert(SegArrayValid(a));
+   
+   if a^.Size = 0 then
+      Result := 0
+   else
+      Result := a^.LastSegIndex - a^.FirstSegIndex + 1;
+end;
+
+procedure SegArrayGetSegment(const a : TSegArray; k : IndexType;
+                             var buf : TDynamicBuffer;
+                             var first : IndexType; var count : SizeType);
+begin
+   Assert(a <> nil, msgNilArray);
+   Assert(IsValidIndex(k, SegArraySegmentCount(a)), msgInvalidIndex);
+   
+   with a^ do
+   begin
+      buf := TDynamicBuffer(Segments^.Items[FirstSegIndex + k]);
+      if k = 0 then
+         first := InnerStartIndex
+      else
+         first := 0;
+      
+      if FirstSegIndex + k = LastSegIndex then
+         count := ItemsInLastSeg
+      else
+         count := SegMask + 1 - first;
+   end;
+end;
+
+procedure SegArrayPushBackItems(a : TSegArray; const items : array of ItemType);
+var
+   lastSeg : TDynamicBuffer;
+   InnerStart, i, j : IndexType;
+   n, k : SizeType;
+begin
+   Assert(a <> nil, msgNilArray);
+   Assert(SegArrayValid(a));
+   
+   i := Low(items);
+   n := Length(items);
+   with a^ do
+   begin
+      while n <> 0 do
+      begin
+         if LastSegIndex <> FirstSegIndex then
+            InnerStart := 0
+         else
+            InnerStart := InnerStartIndex;
+         
+         if InnerStart + ItemsInLastSeg = SegMask + 1 then
+         begin
+            Inc(LastSegIndex);
+            if LastSegIndex >= Segments^.StartIndex + Segments^.Size then
+               SegArrayAppendSegment(a);
+            ItemsInLastSeg := 0;
+            InnerStart := 0;
+         end;
+         lastSeg := TDynamicBuffer(Segments^.Items[LastSegIndex]);
+         
+         k := Min(n, SegMask + 1 - InnerStart - ItemsInLastSeg);
+         for j := InnerStart + ItemsInLastSeg to InnerStart + ItemsInLastSeg + k - 1 do
+         begin
+            lastSeg^.Items[j] := items[i];
+            Inc(i);
+         end;
+         Inc(ItemsInLastSeg, k);
+         Inc(a^.Size, k);
+         Dec(n, k);
+      end;
+   end;
+end;
+
+function SegArrayPopFrontItems(a : TSegArray;
+                               var items : array of ItemType) : SizeType;
+var
+   db : TDynamicBuffer;
+   i, j : IndexType;
+   n, k : SizeType;
+begin
+   Assert(a <> nil, msgNilArray);
+   Assert(SegArrayValid(a));
+   
+   n := Min(Length(items), a^.Size);
+   Result := n;
+   i := Low(items);
+   with a^ do
+   begin
+      while n <> 0 do
+      begin
+         db := TDynamicBuffer(Segments^.Items[FirstSegIndex]);
+         k := Min(n, SegMask + 1 - InnerStartIndex);
+         for j := InnerStartIndex to InnerStartIndex + k - 1 do
+         begin
+            items[i] := db^.Items[j];
+            Inc(i);
+         end;
+         
+         if FirstSegIndex = LastSegIndex then
+            Dec(ItemsInLastSeg, k);
+         Dec(a^.Size, k);
+         Dec(n, k);
+         
+         Inc(InnerStartIndex, k);
+         if InnerStartIndex = SegMask + 1 then
+         begin
+            if FirstSegIndex <> LastSegIndex then
+            begin
+               { keep one free segment before the first one, as in
+                 SegArrayPopFront }
+               if Segments^.StartIndex < FirstSegIndex then
+               begin
+                  SegArrayReleaseSegment(a,
+                     TDynamicBuffer(Segments^.Items[Segments^.StartIndex]));
+                  Inc(Segments^.StartIndex);
+                  Dec(Segments^.Size);
+               end;
+               Inc(FirstSegIndex);
+               InnerStartIndex := 0;
+            end else
+               InnerStartIndex := (SegMask + 1) div 2;
+         end;
+      end;
+   end;
+end;
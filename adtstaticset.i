@@ -0,0 +1,238 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtstaticset.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtstaticset.defs
+
+type
+   TStaticSortedSetItems = array of ItemType;
+
+   { a sorted set kept in an array in the Eytzinger order: the root of
+     an implicit complete binary search tree is in slot 1 and the
+     children of the node in slot k are in slots 2*k and 2*k+1; the
+     items are thus laid out level by level, so the first levels of
+     every search share a few cache lines and the nodes of the next
+     levels may be prefetched before they are needed; @<LowerBound>,
+     @<UpperBound>, @<Has> and the other look-ups take O(log(n)) time
+     without any unpredictable branches; insertions and deletions
+     rebuild the whole array in O(n) time, so the set should be built
+     with @<Build> (or the constructor taking a range) and then only
+     queried. }
+   { The items are identified by their slots - the numbers 1..Size; 0
+     denotes no item (the finish position). The slot of an item does
+     not change as long as the set is not modified, so slots may be
+     used to index arrays of data associated with the items. }
+   TStaticSortedSet = class (TSortedSetAdt)
+   private
+      { the items in the Eytzinger order; FItems[0] is unused }
+      FItems : TStaticSortedSetItems;
+      FSize : SizeType;
+
+      { returns the slot of the first item in the in-order sequence, or
+        0 if the set is empty }
+      function FirstSlot : SizeType;
+      { returns the slot of the last item, or 0 if the set is empty }
+      function LastSlot : SizeType;
+      { returns the slot of the item following the one in <slot>, or 0
+        if it is the last one }
+      function NextSlot(slot : SizeType) : SizeType;
+      { returns the slot of the item preceding the one in <slot>, or
+        the last slot if <slot> is 0 }
+      function PrevSlot(slot : SizeType) : SizeType;
+      { returns the slot of the first item > aitem, or 0 if there is no
+        such item }
+      function UpperBoundSlot(aitem : ItemType) : SizeType;
+      { sorts the first n items of <items> stably with ItemComparer }
+      procedure SortItems(var items : TStaticSortedSetItems; n : SizeType);
+      { stores the first n items of <sorted> (which must be sorted) as
+        the contents of the set; returns the slot of the item sorted[track],
+        or 0 if track is not in 0..n-1 }
+      function Rebuild(const sorted : TStaticSortedSetItems; n : SizeType;
+                       track : IndexType) : SizeType;
+      { inserts aitem into the set unless RepeatedItems is false and an
+        equal item is already there; assigns the slot of the inserted
+        item to <slot> }
+      function InsertAt(aitem : ItemType; var slot : SizeType) : Boolean;
+      { removes the items from <first> up to (but not including) <last>
+        and stores them in <removed> without disposing them; assigns the
+        new slot of the item which was in <last> to <next>; returns the
+        number of removed items }
+      function RemoveSlots(first, last : SizeType; var next : SizeType;
+                           var removed : TStaticSortedSetItems) : SizeType;
+      { the same as RemoveSlots, but disposes the removed items }
+      function DeleteSlots(first, last : SizeType; var next : SizeType) : SizeType;
+      { assigns the slots of the first items >= aitems[first + i] to
+        slots[i] for i in 0..count-1; count <= ssBatchSize }
+      procedure LowerBoundBatch(const aitems : array of ItemType;
+                                first, count : SizeType;
+                                var slots : TStaticSetSlotBatch);
+
+   public
+      { creates an empty set }
+      constructor Create; overload;
+      { creates a set with the items from the range <start, finish);
+        equal items are dropped unless RepeatedItems is set - which is
+        possible only after creation, so use @<Build> to create a set
+        with repeated items or with a non-default ItemComparer;
+        @complexity O(n*log(n)), or O(n) if the range is sorted }
+      constructor Create(start, finish : TForwardIterator); overload;
+      { creates a copy of cont with all the items copied with
+        itemCopier; if itemCopier is nil then creates an empty set with
+        the same properties as cont; @complexity O(n) }
+      constructor CreateCopy(const cont : TStaticSortedSet;
+                             const itemCopier : IUnaryFunctor); overload;
+      destructor Destroy; override;
+
+      { returns a copy of self; @complexity O(n) }
+      function CopySelf(const ItemCopier :
+                           IUnaryFunctor) : TContainerAdt; override;
+      { @see TContainerAdt.Swap }
+      procedure Swap(cont : TContainerAdt); override;
+      { replaces the contents of the set with the items from the range
+        <start, finish), ordered with ItemComparer; if RepeatedItems is
+        false, only the first of each run of equal items is inserted and
+        the others are neither owned nor disposed by the set; the
+        previous items are disposed; the range must not be a part of
+        the set; @complexity O(n*log(n)), or O(n)
+        if the range is already sorted }
+      procedure Build(start, finish : TForwardIterator);
+      { returns the start iterator }
+      function Start : TSetIterator; override;
+      { returns the finish iterator }
+      function Finish : TSetIterator; override;
+&if (&_mcp_accepts_nil)
+      { if RepeatedItems is false and there is an item equal to aitem in
+        the set, then returns this item; in all other cases inserts
+        aitem into the set and returns nil; @complexity O(n) }
+      function FindOrInsert(aitem : ItemType) : ItemType; override;
+      { returns the first item equal to aitem, or nil if not found;
+        @complexity O(log(n)) }
+      function Find(aitem : ItemType) : ItemType; override;
+&endif &# end &_mcp_accepts_nil
+      { returns true if the given item is present in the set;
+        @complexity O(log(n)) }
+      function Has(aitem : ItemType) : Boolean; override;
+      { returns the number of items in the set equal to aitem;
+        @complexity O(log(n) + m), where m is the result }
+      function Count(aitem : ItemType) : SizeType; override;
+      { the same as below; the hint is ignored }
+      function Insert(pos : TSetIterator;
+                      aitem : ItemType) : Boolean; overload; override;
+      { inserts aitem into the set; returns true if it was inserted,
+        or false if it cannot be inserted (this happens for non-multi
+        (without repeated items) set when item equal to aitem is already
+        in the set); if the item is not inserted it is not owned by
+        the container and not disposed! @complexity O(n) }
+      function Insert(aitem : ItemType) : Boolean; overload; override;
+      { removes the item at pos from the set; @complexity O(n) }
+      procedure Delete(pos : TSetIterator); overload; override;
+      { removes all items equal to aitem from the set; returns the
+        number of deleted items; @complexity O(n) }
+      function Delete(aitem : ItemType) : SizeType; overload; override;
+      { returns the first item >= aitem; @complexity O(log(n)) }
+      function LowerBound(aitem : ItemType) : TSetIterator; override;
+      { returns the first item > aitem; @complexity O(log(n)) }
+      function UpperBound(aitem : ItemType) : TSetIterator; override;
+      { returns a range <LowerBound, UpperBound); @complexity
+        O(log(n)) }
+      function EqualRange(aitem : ItemType) : TSetIteratorRange; override;
+      { walks the slots in sorted order; @complexity O(n) }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      { tests all the items first and rebuilds the array only once; if
+        pred raises an exception the set is not changed; @complexity
+        O(n) }
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      { returns the first item according to ItemComparer; @complexity
+        O(log(n)) }
+      function First : ItemType; override;
+      { removes the first item from the set and returns it;
+        @complexity O(n) }
+      function ExtractFirst : ItemType; override;
+      { clears the container - removes all items; @complexity O(n) }
+      procedure Clear; override;
+      { returns true if container is empty; equivalent to Size = 0,
+        but may be faster }
+      function Empty : Boolean; override;
+      { returns number of items; @complexity O(1) }
+      function Size : SizeType; override;
+
+      { returns the slot of the first item >= aitem, or 0 if there is
+        no such item; @complexity O(log(n)) }
+      function LowerBoundSlot(aitem : ItemType) : SizeType;
+      { assigns LowerBoundSlot(aitems[i]) to slots[i] for every i;
+        slots must be at least as long as aitems; the searches are
+        interleaved in groups of ssBatchSize, so that the memory
+        accesses of different searches overlap; @complexity
+        O(m*log(n)), where m is the number of items in aitems }
+      procedure LowerBoundSlots(const aitems : array of ItemType;
+                                var slots : array of SizeType);
+      { assigns Has(aitems[i]) to results[i] for every i; results must
+        be at least as long as aitems; @complexity O(m*log(n)), where m
+        is the number of items in aitems }
+      procedure HasMany(const aitems : array of ItemType;
+                        var results : array of Boolean);
+      { returns the item in <slot>; slot must be in 1..Size;
+        @complexity O(1) }
+      function ItemAt(slot : SizeType) : ItemType;
+      { returns an iterator to the item in <slot>, or the finish
+        iterator if slot is 0; @complexity O(1) }
+      function SlotIterator(slot : SizeType) : TSetIterator;
+   end;
+
+   { an iterator into a TStaticSortedSet; it is invalidated by every
+     change to the set not made through it }
+   TStaticSortedSetIterator = class (TSetIterator)
+   private
+      FSet : TStaticSortedSet;
+      { the slot of the item; 0 for the finish iterator }
+      FSlot : SizeType;
+
+   public
+      constructor Create(aset : TStaticSortedSet; slot : SizeType);
+      function CopySelf : TIterator; override;
+      function Equal(const Pos : TIterator) : Boolean; override;
+      function GetItem : ItemType; override;
+      { replaces the item with a newly inserted one; if aitem cannot be
+        inserted then it is disposed and the iterator is moved to the
+        finish position; @complexity O(n) }
+      procedure SetItem(aitem : ItemType); override;
+      procedure ResetItem; override;
+      procedure Advance; overload; override;
+      procedure Retreat; override;
+      { @complexity O(n) }
+      procedure Insert(aitem : ItemType); override;
+      { @complexity O(n) }
+      function Extract : ItemType; override;
+      { @complexity O(n) }
+      function Delete(finish : TForwardIterator) : SizeType; overload; override;
+      function Owner : TContainerAdt; override;
+      function IsStart : Boolean; override;
+      function IsFinish : Boolean; override;
+      { the slot of the item at the iterator; 0 for the finish
+        iterator }
+      property Slot : SizeType read FSlot;
+   end;
@@ -0,0 +1,916 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adtstaticset_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adtstaticset.defs
+&include adtstaticset_impl.mcp
+
+{$R-}
+
+{ ========================================================================== }
+{              Notes on the implementation of TStaticSortedSet              }
+{ -------------------------------------------------------------------------- }
+{ A search starts at the root (slot 1) and goes to the slot 2*k if the
+  item in slot k is not less than the searched one, and to 2*k+1
+  otherwise; the comparison only computes the next slot, so there is
+  no branch to mispredict. The search ends below the leaves, and the
+  binary representation of the final slot records all the turns taken.
+  The result is the last node at which the search turned left, so the
+  trailing 1-bits (the right turns after it) and then the left turn
+  itself are shifted out; a result of 0 means that the search never
+  turned left, i.e. all the items are less than the searched one. }
+{ The 16 descendants of a node at the fourth level below it occupy
+  consecutive slots starting at 16*k, which is usually one or two
+  cache lines, so they are prefetched when the node is visited. }
+{ All the changes gather the items in order, modify this sequence and
+  lay it out again. The item comparer is called only before anything
+  is changed, so an exception raised by it leaves the set intact. }
+{ ========================================================================== }
+
+{ ------------------------- TStaticSortedSet ------------------------------- }
+
+constructor TStaticSortedSet.Create;
+begin
+   inherited Create;
+   FItems := nil;
+   FSize := 0;
+end;
+
+constructor TStaticSortedSet.Create(start, finish : TForwardIterator);
+begin
+   inherited Create;
+   FItems := nil;
+   FSize := 0;
+   Build(start, finish);
+end;
+
+constructor TStaticSortedSet.CreateCopy(const cont : TStaticSortedSet;
+                                        const itemCopier : IUnaryFunctor);
+var
+   i : IndexType;
+begin
+   inherited CreateCopy(TSetAdt(cont));
+   FItems := nil;
+   FSize := 0;
+   if itemCopier <> nil then
+   begin
+      SetLength(FItems, cont.FSize + 1);
+      { FSize is increased one by one, so that only the items already
+        copied are disposed if itemCopier raises an exception }
+      for i := 1 to cont.FSize do
+      begin
+         FItems[i] := itemCopier.Perform(cont.FItems[i]);
+         FSize := i;
+      end;
+   end;
+end;
+
+destructor TStaticSortedSet.Destroy;
+begin
+   Clear;
+   inherited;
+end;
+
+function TStaticSortedSet.FirstSlot : SizeType;
+begin
+   if FSize = 0 then
+   begin
+      Result := 0;
+   end else
+   begin
+      Result := 1;
+      while 2*Result <= FSize do
+         Result := 2*Result;
+   end;
+end;
+
+function TStaticSortedSet.LastSlot : SizeType;
+begin
+   if FSize = 0 then
+   begin
+      Result := 0;
+   end else
+   begin
+      Result := 1;
+      while 2*Result + 1 <= FSize do
+         Result := 2*Result + 1;
+   end;
+end;
+
+function TStaticSortedSet.NextSlot(slot : SizeType) : SizeType;
+begin
+   Assert((slot > 0) and (slot <= FSize), msgAdvancingFinishIterator);
+
+   if 2*slot + 1 <= FSize then
+   begin
+      { the leftmost node of the right sub-tree }
+      slot := 2*slot + 1;
+      while 2*slot <= FSize do
+         slot := 2*slot;
+   end else
+   begin
+      { go up until coming from a left child }
+      while Odd(slot) do
+         slot := slot shr 1;
+      slot := slot shr 1;
+   end;
+   Result := slot;
+end;
+
+function TStaticSortedSet.PrevSlot(slot : SizeType) : SizeType;
+begin
+   Assert((slot >= 0) and (slot <= FSize), msgInvalidIterator);
+
+   if slot = 0 then
+   begin
+      Result := LastSlot;
+   end else if 2*slot <= FSize then
+   begin
+      { the rightmost node of the left sub-tree }
+      slot := 2*slot;
+      while 2*slot + 1 <= FSize do
+         slot := 2*slot + 1;
+      Result := slot;
+   end else
+   begin
+      { go up until coming from a right child }
+      while not Odd(slot) do
+         slot := slot shr 1;
+      Result := slot shr 1;
+   end;
+end;
+
+function TStaticSortedSet.LowerBoundSlot(aitem : ItemType) : SizeType;
+var
+   comp : IBinaryComparer;
+   k : SizeType;
+begin
+   comp := ItemComparer;
+   k := 1;
+   while k <= FSize do
+   begin
+      &_mcp_prefetch(FItems[16*k]);
+      k := 2*k + SizeType(Ord(&_mcp_lt(FItems[k], aitem, comp)));
+   end;
+   while Odd(k) do
+      k := k shr 1;
+   Result := k shr 1;
+end;
+
+function TStaticSortedSet.UpperBoundSlot(aitem : ItemType) : SizeType;
+var
+   comp : IBinaryComparer;
+   k : SizeType;
+begin
+   comp := ItemComparer;
+   k := 1;
+   while k <= FSize do
+   begin
+      &_mcp_prefetch(FItems[16*k]);
+      k := 2*k + SizeType(Ord(&_mcp_lte(FItems[k], aitem, comp)));
+   end;
+   while Odd(k) do
+      k := k shr 1;
+   Result := k shr 1;
+end;
+
+procedure TStaticSortedSet.LowerBoundBatch(const aitems : array of ItemType;
+                                           first, count : SizeType;
+                                           var slots : TStaticSetSlotBatch);
+var
+   comp : IBinaryComparer;
+   level, levels, i, k : SizeType;
+begin
+   Assert(count <= ssBatchSize, msgInvalidArgument);
+
+   if FSize = 0 then
+   begin
+      for i := 0 to count - 1 do
+         slots[i] := 0;
+      Exit;
+   end;
+
+   comp := ItemComparer;
+   for i := 0 to count - 1 do
+      slots[i] := 1;
+   { all the levels above the last one are complete, so the searches
+     need not be checked for running off the tree there; the steps of
+     different searches are independent and their memory accesses
+     overlap }
+   levels := FloorLog2(FSize);
+   for level := 1 to levels do
+   begin
+      for i := 0 to count - 1 do
+      begin
+         k := slots[i];
+         &_mcp_prefetch(FItems[16*k]);
+         slots[i] := 2*k +
+            SizeType(Ord(&_mcp_lt(FItems[k], aitems[first + i], comp)));
+      end;
+   end;
+   for i := 0 to count - 1 do
+   begin
+      k := slots[i];
+      if k <= FSize then
+         k := 2*k + SizeType(Ord(&_mcp_lt(FItems[k], aitems[first + i], comp)));
+      while Odd(k) do
+         k := k shr 1;
+      slots[i] := k shr 1;
+   end;
+end;
+
+procedure TStaticSortedSet.SortItems(var items : TStaticSortedSetItems;
+                                     n : SizeType);
+var
+   buffer, tmp : TStaticSortedSetItems;
+   comp : IBinaryComparer;
+   width, lo, mid, hi, i, j, k : SizeType;
+begin
+   comp := ItemComparer;
+   SetLength(buffer, n);
+   width := 1;
+   { a bottom-up merge sort; it is stable and needs no iterators }
+   while width < n do
+   begin
+      lo := 0;
+      while lo < n do
+      begin
+         mid := lo + width;
+         if mid > n then
+            mid := n;
+         hi := mid + width;
+         if hi > n then
+            hi := n;
+         i := lo;
+         j := mid;
+         k := lo;
+         while (i < mid) and (j < hi) do
+         begin
+            if &_mcp_lte(items[i], items[j], comp) then
+            begin
+               buffer[k] := items[i];
+               Inc(i);
+            end else
+            begin
+               buffer[k] := items[j];
+               Inc(j);
+            end;
+            Inc(k);
+         end;
+         while i < mid do
+         begin
+            buffer[k] := items[i];
+            Inc(i);
+            Inc(k);
+         end;
+         while j < hi do
+         begin
+            buffer[k] := items[j];
+            Inc(j);
+            Inc(k);
+         end;
+         lo := hi;
+      end;
+      tmp := items;
+      items := buffer;
+      buffer := tmp;
+      width := 2*width;
+   end;
+end;
+
+function TStaticSortedSet.Rebuild(const sorted : TStaticSortedSetItems;
+                                  n : SizeType; track : IndexType) : SizeType;
+var
+   i : IndexType;
+   k : SizeType;
+begin
+   SetLength(FItems, n + 1);
+   FSize := n;
+   Result := 0;
+   k := FirstSlot;
+   for i := 0 to n - 1 do
+   begin
+      FItems[k] := sorted[i];
+      if i = track then
+         Result := k;
+      k := NextSlot(k);
+   end;
+end;
+
+function TStaticSortedSet.InsertAt(aitem : ItemType; var slot : SizeType) : Boolean;
+var
+   sorted : TStaticSortedSetItems;
+   i, r : IndexType;
+   k, j : SizeType;
+begin
+   { aitem goes before the item in slot k (or at the end if k = 0) }
+   k := UpperBoundSlot(aitem);
+   if not RepeatedItems then
+   begin
+      j := PrevSlot(k);
+      if (j <> 0) and _mcp_equal(FItems[j], aitem) then
+      begin
+         slot := j;
+         Result := false;
+         Exit;
+      end;
+   end;
+
+   SetLength(sorted, FSize + 1);
+   i := 0;
+   r := -1;
+   j := FirstSlot;
+   while j <> 0 do
+   begin
+      if j = k then
+      begin
+         sorted[i] := aitem;
+         r := i;
+         Inc(i);
+      end;
+      sorted[i] := FItems[j];
+      Inc(i);
+      j := NextSlot(j);
+   end;
+   if r = -1 then
+   begin
+      sorted[i] := aitem;
+      r := i;
+   end;
+   slot := Rebuild(sorted, FSize + 1, r);
+   Result := true;
+end;
+
+function TStaticSortedSet.RemoveSlots(first, last : SizeType; var next : SizeType;
+                                      var removed : TStaticSortedSetItems) : SizeType;
+var
+   sorted : TStaticSortedSetItems;
+   i, r : IndexType;
+   j : SizeType;
+   inRange, passedLast : Boolean;
+begin
+   Result := 0;
+   if first = last then
+   begin
+      next := last;
+      Exit;
+   end;
+
+   SetLength(sorted, FSize);
+   SetLength(removed, FSize);
+   i := 0;
+   r := -1;
+   inRange := false;
+   passedLast := false;
+   j := FirstSlot;
+   while j <> 0 do
+   begin
+      if j = first then
+      begin
+         Assert(not passedLast, msgInvalidRange);
+         inRange := true;
+      end;
+      if j = last then
+      begin
+         inRange := false;
+         passedLast := true;
+         r := i;
+      end;
+      if inRange then
+      begin
+         removed[Result] := FItems[j];
+         Inc(Result);
+      end else
+      begin
+         sorted[i] := FItems[j];
+         Inc(i);
+      end;
+      j := NextSlot(j);
+   end;
+   next := Rebuild(sorted, i, r);
+end;
+
+function TStaticSortedSet.DeleteSlots(first, last : SizeType;
+                                      var next : SizeType) : SizeType;
+var
+   removed : TStaticSortedSetItems;
+   aitem : ItemType;
+   i : IndexType;
+begin
+   removed := nil;
+   Result := RemoveSlots(first, last, next, removed);
+   for i := 0 to Result - 1 do
+   begin
+      aitem := removed[i];
+      DisposeItem(aitem);
+   end;
+end;
+
+function TStaticSortedSet.CopySelf(const ItemCopier :
+                                      IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TStaticSortedSet.CreateCopy(self, itemCopier);
+end;
+
+procedure TStaticSortedSet.Swap(cont : TContainerAdt);
+var
+   items : TStaticSortedSetItems;
+   n : SizeType;
+begin
+   if cont is TStaticSortedSet then
+   begin
+      BasicSwap(cont);
+      items := FItems;
+      FItems := TStaticSortedSet(cont).FItems;
+      TStaticSortedSet(cont).FItems := items;
+      n := FSize;
+      FSize := TStaticSortedSet(cont).FSize;
+      TStaticSortedSet(cont).FSize := n;
+   end else
+      inherited;
+end;
+
+procedure TStaticSortedSet.Build(start, finish : TForwardIterator);
+var
+   sorted : TStaticSortedSetItems;
+   iter : TForwardIterator;
+   comp : IBinaryComparer;
+   n, m, i : IndexType;
+   isSorted : Boolean;
+begin
+   n := 0;
+   SetLength(sorted, 16);
+   iter := CopyOf(start);
+   while not iter.Equal(finish) do
+   begin
+      if n = Length(sorted) then
+         SetLength(sorted, 2*n);
+      sorted[n] := iter.Item;
+      Inc(n);
+      iter.Advance;
+   end;
+   iter.Destroy;
+
+   comp := ItemComparer;
+   isSorted := true;
+   i := 1;
+   while isSorted and (i < n) do
+   begin
+      isSorted := &_mcp_lte(sorted[i - 1], sorted[i], comp);
+      Inc(i);
+   end;
+   if not isSorted then
+      SortItems(sorted, n);
+
+   if not RepeatedItems then
+   begin
+      { keep the first item of every run of equal items }
+      m := 0;
+      for i := 0 to n - 1 do
+      begin
+         if (m = 0) or not _mcp_equal(sorted[m - 1], sorted[i], comp) then
+         begin
+            sorted[m] := sorted[i];
+            Inc(m);
+         end;
+      end;
+      n := m;
+   end;
+
+   Clear;
+   Rebuild(sorted, n, -1);
+end;
+
+function TStaticSortedSet.Start : TSetIterator;
+begin
+   Result := TStaticSortedSetIterator.Create(self, FirstSlot);
+end;
+
+function TStaticSortedSet.Finish : TSetIterator;
+begin
+   Result := TStaticSortedSetIterator.Create(self, 0);
+end;
+
+&if (&_mcp_accepts_nil)
+function TStaticSortedSet.FindOrInsert(aitem : ItemType) : ItemType;
+var
+   slot : SizeType;
+begin
+   slot := 0; { to avoid a warning }
+   if InsertAt(aitem, slot) then
+      Result := nil
+   else
+      Result := FItems[slot];
+end;
+
+function TStaticSortedSet.Find(aitem : ItemType) : ItemType;
+var
+   slot : SizeType;
+begin
+   slot := LowerBoundSlot(aitem);
+   Result := nil;
+   if (slot <> 0) and _mcp_equal(FItems[slot], aitem) then
+      Result := FItems[slot];
+end;
+&endif &# end &_mcp_accepts_nil
+
+function TStaticSortedSet.Has(aitem : ItemType) : Boolean;
+var
+   slot : SizeType;
+begin
+   slot := LowerBoundSlot(aitem);
+   Result := (slot <> 0) and _mcp_equal(FItems[slot], aitem);
+end;
+
+function TStaticSortedSet.Count(aitem : ItemType) : SizeType;
+var
+   slot, last : SizeType;
+begin
+   slot := LowerBoundSlot(aitem);
+   last := UpperBoundSlot(aitem);
+   Result := 0;
+   while slot <> last do
+   begin
+      Inc(Result);
+      slot := NextSlot(slot);
+   end;
+end;
+
+function TStaticSortedSet.Insert(pos : TSetIterator; aitem : ItemType) : Boolean;
+begin
+   Assert(pos is TStaticSortedSetIterator, msgInvalidIterator);
+   Result := Insert(aitem);
+end;
+
+function TStaticSortedSet.Insert(aitem : ItemType) : Boolean;
+var
+   slot : SizeType;
+begin
+   slot := 0; { to avoid a warning }
+   Result := InsertAt(aitem, slot);
+end;
+
+procedure TStaticSortedSet.Delete(pos : TSetIterator);
+var
+   slot, next : SizeType;
+begin
+   Assert(pos is TStaticSortedSetIterator, msgInvalidIterator);
+   Assert(not pos.IsFinish, msgDeletingInvalidIterator);
+
+   slot := TStaticSortedSetIterator(pos).FSlot;
+   next := 0; { to avoid a warning }
+   DeleteSlots(slot, NextSlot(slot), next);
+end;
+
+function TStaticSortedSet.Delete(aitem : ItemType) : SizeType;
+var
+   next : SizeType;
+begin
+   next := 0; { to avoid a warning }
+   Result := DeleteSlots(LowerBoundSlot(aitem), UpperBoundSlot(aitem), next);
+end;
+
+function TStaticSortedSet.LowerBound(aitem : ItemType) : TSetIterator;
+begin
+   Result := TStaticSortedSetIterator.Create(self, LowerBoundSlot(aitem));
+end;
+
+function TStaticSortedSet.UpperBound(aitem : ItemType) : TSetIterator;
+begin
+   Result := TStaticSortedSetIterator.Create(self, UpperBoundSlot(aitem));
+end;
+
+function TStaticSortedSet.EqualRange(aitem : ItemType) : TSetIteratorRange;
+begin
+   Result := TSetIteratorRange.Create(
+      TStaticSortedSetIterator.Create(self, LowerBoundSlot(aitem)),
+      TStaticSortedSetIterator.Create(self, UpperBoundSlot(aitem)));
+end;
+
+function TStaticSortedSet.FindIf(const pred : IUnaryPredicate;
+                                 var aitem : ItemType) : Boolean;
+var
+   j : SizeType;
+begin
+   j := FirstSlot;
+   while j <> 0 do
+   begin
+      if pred.Test(FItems[j]) then
+      begin
+         aitem := FItems[j];
+         Result := true;
+         Exit;
+      end;
+      j := NextSlot(j);
+   end;
+   Result := false;
+end;
+
+function TStaticSortedSet.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   sorted, removed : TStaticSortedSetItems;
+   aitem : ItemType;
+   i : IndexType;
+   j : SizeType;
+begin
+   Result := 0;
+   SetLength(sorted, FSize);
+   SetLength(removed, FSize);
+   i := 0;
+   j := FirstSlot;
+   while j <> 0 do
+   begin
+      if pred.Test(FItems[j]) then
+      begin
+         removed[Result] := FItems[j];
+         Inc(Result);
+      end else
+      begin
+         sorted[i] := FItems[j];
+         Inc(i);
+      end;
+      j := NextSlot(j);
+   end;
+
+   if Result <> 0 then
+   begin
+      Rebuild(sorted, i, -1);
+      for i := 0 to Result - 1 do
+      begin
+         aitem := removed[i];
+         DisposeItem(aitem);
+      end;
+   end;
+end;
+
+function TStaticSortedSet.First : ItemType;
+begin
+   Assert(FSize <> 0, msgReadEmpty);
+   Result := FItems[FirstSlot];
+end;
+
+function TStaticSortedSet.ExtractFirst : ItemType;
+var
+   removed : TStaticSortedSetItems;
+   slot, next : SizeType;
+begin
+   Assert(FSize <> 0, msgReadEmpty);
+
+   removed := nil;
+   next := 0; { to avoid a warning }
+   slot := FirstSlot;
+   RemoveSlots(slot, NextSlot(slot), next, removed);
+   Result := removed[0];
+end;
+
+procedure TStaticSortedSet.Clear;
+var
+   aitem : ItemType;
+   i : IndexType;
+begin
+   if OwnsItems then
+   begin
+      for i := 1 to FSize do
+      begin
+         aitem := FItems[i];
+         DisposeItem(aitem);
+      end;
+   end;
+   FItems := nil;
+   FSize := 0;
+   GrabageCollector.FreeObjects;
+end;
+
+function TStaticSortedSet.Empty : Boolean;
+begin
+   Result := FSize = 0;
+end;
+
+function TStaticSortedSet.Size : SizeType;
+begin
+   Result := FSize;
+end;
+
+procedure TStaticSortedSet.LowerBoundSlots(const aitems : array of ItemType;
+                                           var slots : array of SizeType);
+var
+   batch : TStaticSetSlotBatch;
+   first, count, i : SizeType;
+begin
+   Assert(Length(slots) >= Length(aitems), msgInvalidArgument);
+
+   first := 0;
+   while first < Length(aitems) do
+   begin
+      count := Length(aitems) - first;
+      if count > ssBatchSize then
+         count := ssBatchSize;
+      LowerBoundBatch(aitems, first, count, batch);
+      for i := 0 to count - 1 do
+         slots[first + i] := batch[i];
+      Inc(first, count);
+   end;
+end;
+
+procedure TStaticSortedSet.HasMany(const aitems : array of ItemType;
+                                   var results : array of Boolean);
+var
+   batch : TStaticSetSlotBatch;
+   first, count, i : SizeType;
+begin
+   Assert(Length(results) >= Length(aitems), msgInvalidArgument);
+
+   first := 0;
+   while first < Length(aitems) do
+   begin
+      count := Length(aitems) - first;
+      if count > ssBatchSize then
+         count := ssBatchSize;
+      LowerBoundBatch(aitems, first, count, batch);
+      for i := 0 to count - 1 do
+      begin
+         results[first + i] := (batch[i] <> 0) and
+            _mcp_equal(FItems[batch[i]], aitems[first + i]);
+      end;
+      Inc(first, count);
+   end;
+end;
+
+function TStaticSortedSet.ItemAt(slot : SizeType) : ItemType;
+begin
+   Assert((slot > 0) and (slot <= FSize), msgInvalidIndex);
+   Result := FItems[slot];
+end;
+
+function TStaticSortedSet.SlotIterator(slot : SizeType) : TSetIterator;
+begin
+   Assert((slot >= 0) and (slot <= FSize), msgInvalidIndex);
+   Result := TStaticSortedSetIterator.Create(self, slot);
+end;
+
+{ --------------------- TStaticSortedSetIterator --------------------------- }
+
+constructor TStaticSortedSetIterator.Create(aset : TStaticSortedSet;
+                                            slot : SizeType);
+begin
+   inherited Create(aset);
+   FSet := aset;
+   FSlot := slot;
+end;
+
+function TStaticSortedSetIterator.CopySelf : TIterator;
+begin
+   Result := TStaticSortedSetIterator.Create(FSet, FSlot);
+end;
+
+function TStaticSortedSetIterator.Equal(const Pos : TIterator) : Boolean;
+begin
+   Assert(pos is TStaticSortedSetIterator, msgInvalidIterator);
+
+   Result := FSlot = TStaticSortedSetIterator(pos).FSlot;
+end;
+
+function TStaticSortedSetIterator.GetItem : ItemType;
+begin
+   Assert(FSlot <> 0, msgInvalidIterator);
+
+   Result := FSet.FItems[FSlot];
+end;
+
+procedure TStaticSortedSetIterator.SetItem(aitem : ItemType);
+var
+   slot : SizeType;
+begin
+   Assert(FSlot <> 0, msgInvalidIterator);
+
+   FSet.DeleteSlots(FSlot, FSet.NextSlot(FSlot), FSlot);
+   slot := 0; { to avoid a warning }
+   try
+      if FSet.InsertAt(aitem, slot) then
+      begin
+         FSlot := slot;
+      end else
+      begin
+         FSlot := 0;
+         with FSet do
+            DisposeItem(aitem);
+      end;
+   except
+      FSlot := 0;
+      with FSet do
+         DisposeItem(aitem);
+      raise;
+   end;
+end;
+
+procedure TStaticSortedSetIterator.ResetItem;
+var
+   aitem : ItemType;
+   removed : TStaticSortedSetItems;
+   slot : SizeType;
+begin
+   Assert(FSlot <> 0, msgInvalidIterator);
+
+   removed := nil;
+   FSet.RemoveSlots(FSlot, FSet.NextSlot(FSlot), FSlot, removed);
+   aitem := removed[0];
+   slot := 0; { to avoid a warning }
+   try
+      if FSet.InsertAt(aitem, slot) then
+      begin
+         FSlot := slot;
+      end else
+      begin
+         FSlot := 0;
+         with FSet do
+            DisposeItem(aitem);
+      end;
+   except
+      FSlot := 0;
+      with FSet do
+         DisposeItem(aitem);
+      raise;
+   end;
+end;
+
+procedure TStaticSortedSetIterator.Advance;
+begin
+   FSlot := FSet.NextSlot(FSlot);
+end;
+
+procedure TStaticSortedSetIterator.Retreat;
+begin
+   Assert(not IsStart, msgRetreatingStartIterator);
+
+   FSlot := FSet.PrevSlot(FSlot);
+end;
+
+procedure TStaticSortedSetIterator.Insert(aitem : ItemType);
+var
+   slot : SizeType;
+begin
+   slot := 0; { to avoid a warning }
+   if FSet.InsertAt(aitem, slot) then
+      FSlot := slot
+   else
+      FSlot := 0;
+end;
+
+function TStaticSortedSetIterator.Extract : ItemType;
+var
+   removed : TStaticSortedSetItems;
+begin
+   Assert(FSlot <> 0, msgDeletingInvalidIterator);
+
+   removed := nil;
+   FSet.RemoveSlots(FSlot, FSet.NextSlot(FSlot), FSlot, removed);
+   Result := removed[0];
+end;
+
+function TStaticSortedSetIterator.Delete(finish : TForwardIterator) : SizeType;
+begin
+   Assert(finish is TStaticSortedSetIterator, msgInvalidIterator);
+   Assert(finish.Owner = FSet, msgWrongOwner);
+
+   Result := FSet.DeleteSlots(FSlot, TStaticSortedSetIterator(finish).FSlot, FSlot);
+   { the item at finish has moved together with the others }
+   TStaticSortedSetIterator(finish).FSlot := FSlot;
+end;
+
+function TStaticSortedSetIterator.Owner : TContainerAdt;
+begin
+   Result := FSet;
+end;
+
+function TStaticSortedSetIterator.IsStart : Boolean;
+begin
+   Result := FSlot = FSet.FirstSlot;
+end;
+
+function TStaticSortedSetIterator.IsFinish : Boolean;
+begin
+   Result := FSlot = 0;
+end;
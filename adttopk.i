@@ -0,0 +1,105 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adttopk.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adttopk.defs
+
+type
+   { a priority queue holding at most @<Capacity> items - the greatest
+     ones (according to ItemComparer) among all the items inserted
+     since it was created or cleared; when the queue is full, an
+     inserted item either replaces the smallest item kept or, if it is
+     not greater than that item, is rejected; the replaced and
+     rejected items are disposed, like the items removed with
+     DeleteFirst; @<First> returns the smallest item kept, i.e. the
+     threshold an item must exceed to be kept; the items are kept in
+     a binary heap in a single array; to collect the smallest items
+     use a comparer with the reverse order; to collect the items
+     written to an output iterator use TBasicInserter from adtalgs
+     with the queue as the container. }
+   TTopK = class (TPriorityQueueAdt)
+   private
+      { a binary min-heap of the items }
+      FItems : array of ItemType;
+      FSize : SizeType;
+      FCapacity : SizeType;
+
+      procedure SiftUp(i : IndexType);
+      procedure SiftDown(i : IndexType);
+      { replaces the smallest item kept with aitem; returns the
+        replaced item }
+      function ReplaceFirst(aitem : ItemType) : ItemType;
+
+   public
+      { creates a queue holding at most acapacity items }
+      constructor Create(acapacity : SizeType); overload;
+      constructor CreateCopy(const cont : TTopK;
+                             const itemCopier : IUnaryFunctor); overload;
+      destructor Destroy; override;
+      function CopySelf(const ItemCopier :
+                           IUnaryFunctor) : TContainerAdt; override;
+      { @see TContainerAdt.Swap }
+      procedure Swap(cont : TContainerAdt); override;
+      { inserts aitem if the queue is not full or aitem is greater than
+        First, removing and disposing First in the latter case;
+        otherwise disposes aitem; @complexity O(log(k)), where k is
+        Capacity }
+      procedure Insert(aitem : ItemType); override;
+      { returns true if aitem would be kept by Insert, i.e. the queue
+        is not full or aitem is greater than First; may be used to
+        avoid creating items which would be rejected; @complexity O(1) }
+      function Accepts(aitem : ItemType) : Boolean;
+      { inserts the items of the range [start,finish) which are kept,
+        copied with itemCopier; the items which are not kept are not
+        copied; if itemCopier is nil then the items themselves are
+        inserted and become owned by the queue if they are kept;
+        @complexity O(n*log(k)), where k is Capacity }
+      procedure InsertRange(const start, finish : TForwardIterator;
+                            const itemCopier : IUnaryFunctor);
+      { returns the smallest item kept; @complexity O(1) }
+      function First : ItemType; override;
+      { removes the smallest item kept and returns it; @complexity
+        O(log(k)) }
+      function ExtractFirst : ItemType; override;
+      { writes all the items to dest starting from the greatest one and
+        removes them from the queue without disposing them; this is the
+        usual way to get the result; @complexity O(k*log(k)) }
+      procedure ExtractSorted(dest : TOutputIterator);
+      { inserts the items of aqueue into self, keeping at most Capacity
+        of them; <aqueue> must be a TTopK; it is _destroyed_;
+        @complexity O(m*log(k)), where m is the size of aqueue }
+      procedure Merge(aqueue : TPriorityQueueAdt); override;
+      { scan the array of the heap; DeleteIf compacts the kept items
+        and restores the heap property once; @complexity O(n) }
+      function FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean; override;
+      function DeleteIf(const pred : IUnaryPredicate) : SizeType; override;
+      procedure Clear; override;
+      function Empty : Boolean; override;
+      function Size : SizeType; override;
+      { the maximal number of items kept }
+      property Capacity : SizeType read FCapacity;
+   end;
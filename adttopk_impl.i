@@ -0,0 +1,324 @@
+{@discard
+ 
+  This file is a part of the PascalAdt library, which provides
+  commonly used algorithms and data structures for the FPC and Delphi
+  compilers.
+  
+  Copyright (C) 2004, 2005 by Lukasz Czajka
+  
+  This library is free software; you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation; either version 2.1 of the
+  License, or (at your option) any later version.
+  
+  This library is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+  USA }
+
+{@discard
+ adttopk_impl.i::prefix=&_mcp_prefix&::item_type=&ItemType&
+ }
+
+&include adttopk.defs
+&include adttopk_impl.mcp
+
+{ ------------------------------ TTopK ------------------------------------- }
+
+constructor TTopK.Create(acapacity : SizeType);
+begin
+   inherited Create;
+   Assert(acapacity >= 0, msgInvalidArgument);
+   FItems := nil;
+   FSize := 0;
+   FCapacity := acapacity;
+end;
+
+constructor TTopK.CreateCopy(const cont : TTopK; const itemCopier : IUnaryFunctor);
+var
+   i : IndexType;
+begin
+   inherited CreateCopy(TPriorityQueueAdt(cont));
+   FItems := nil;
+   FSize := 0;
+   FCapacity := cont.FCapacity;
+   if itemCopier <> nil then
+   begin
+      SetLength(FItems, cont.FSize);
+      { the copies form a heap in the same layout }
+      for i := 0 to cont.FSize - 1 do
+      begin
+         FItems[i] := itemCopier.Perform(cont.FItems[i]);
+         FSize := i + 1;
+      end;
+   end;
+end;
+
+destructor TTopK.Destroy;
+begin
+   Clear;
+   inherited;
+end;
+
+procedure TTopK.SiftUp(i : IndexType);
+var
+   aitem : ItemType;
+   p : IndexType;
+begin
+   aitem := FItems[i];
+   while i > 0 do
+   begin
+      p := (i - 1) div 2;
+      if not _mcp_lt(aitem, FItems[p]) then
+         break;
+      FItems[i] := FItems[p];
+      i := p;
+   end;
+   FItems[i] := aitem;
+end;
+
+procedure TTopK.SiftDown(i : IndexType);
+var
+   aitem : ItemType;
+   c : IndexType;
+begin
+   aitem := FItems[i];
+   c := 2*i + 1;
+   while c < FSize do
+   begin
+      if (c + 1 < FSize) and _mcp_lt(FItems[c + 1], FItems[c]) then
+         Inc(c);
+      if not _mcp_lt(FItems[c], aitem) then
+         break;
+      FItems[i] := FItems[c];
+      i := c;
+      c := 2*i + 1;
+   end;
+   FItems[i] := aitem;
+end;
+
+function TTopK.ReplaceFirst(aitem : ItemType) : ItemType;
+begin
+   Result := FItems[0];
+   FItems[0] := aitem;
+   SiftDown(0);
+end;
+
+function TTopK.CopySelf(const ItemCopier : IUnaryFunctor) : TContainerAdt;
+begin
+   Result := TTopK.CreateCopy(self, itemCopier);
+end;
+
+procedure TTopK.Swap(cont : TContainerAdt);
+begin
+   if cont is TTopK then
+   begin
+      BasicSwap(cont);
+      ExchangePtr(FItems, TTopK(cont).FItems);
+      ExchangeData(FSize, TTopK(cont).FSize, SizeOf(SizeType));
+      ExchangeData(FCapacity, TTopK(cont).FCapacity, SizeOf(SizeType));
+   end else
+      inherited;
+end;
+
+procedure TTopK.Insert(aitem : ItemType);
+begin
+   if FSize < FCapacity then
+   begin
+      if FSize = Length(FItems) then
+      begin
+         { the array grows with the number of items, so a large
+           capacity costs nothing until it is used }
+         if FCapacity - FSize > FSize + 16 then
+            SetLength(FItems, 2*FSize + 16)
+         else
+            SetLength(FItems, FCapacity);
+      end;
+      FItems[FSize] := aitem;
+      Inc(FSize);
+      SiftUp(FSize - 1);
+   end else if (FSize <> 0) and _mcp_gt(aitem, FItems[0]) then
+   begin
+      aitem := ReplaceFirst(aitem);
+      DisposeItem(aitem);
+   end else
+      DisposeItem(aitem);
+end;
+
+function TTopK.Accepts(aitem : ItemType) : Boolean;
+begin
+   Result := (FSize < FCapacity) or
+      ((FSize <> 0) and _mcp_gt(aitem, FItems[0]));
+end;
+
+procedure TTopK.InsertRange(const start, finish : TForwardIterator;
+                            const itemCopier : IUnaryFunctor);
+var
+   iter : TForwardIterator;
+   aitem : ItemType;
+begin
+   iter := CopyOf(start);
+   while not iter.Equal(finish) do
+   begin
+      aitem := iter.Item;
+      if Accepts(aitem) then
+      begin
+         if itemCopier <> nil then
+            aitem := itemCopier.Perform(aitem);
+         Insert(aitem);
+      end;
+      iter.Advance;
+   end;
+   iter.Destroy;
+end;
+
+function TTopK.First : ItemType;
+begin
+   Assert(FSize <> 0, msgReadEmpty);
+   Result := FItems[0];
+end;
+
+function TTopK.ExtractFirst : ItemType;
+begin
+   Assert(FSize <> 0, msgReadEmpty);
+
+   Result := FItems[0];
+   Dec(FSize);
+   if FSize <> 0 then
+   begin
+      FItems[0] := FItems[FSize];
+      SiftDown(0);
+   end;
+end;
+
+procedure TTopK.ExtractSorted(dest : TOutputIterator);
+var
+   aitem : ItemType;
+   n, i : IndexType;
+begin
+   { heap-sort the items into the descending order }
+   n := FSize;
+   while FSize > 1 do
+   begin
+      aitem := FItems[0];
+      Dec(FSize);
+      FItems[0] := FItems[FSize];
+      FItems[FSize] := aitem;
+      SiftDown(0);
+   end;
+   FSize := 0;
+   for i := 0 to n - 1 do
+      dest.Write(FItems[i]);
+   FItems := nil;
+end;
+
+procedure TTopK.Merge(aqueue : TPriorityQueueAdt);
+var
+   other : TTopK;
+   aitem : ItemType;
+   owns : Boolean;
+begin
+   Assert(aqueue is TTopK, msgInvalidArgument);
+   other := TTopK(aqueue);
+   owns := other.OwnsItems;
+   other.OwnsItems := false;
+   try
+      while other.FSize <> 0 do
+      begin
+         aitem := other.ExtractFirst;
+         Insert(aitem);
+      end;
+   finally
+      other.OwnsItems := owns;
+   end;
+   other.Destroy;
+end;
+
+function TTopK.FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean;
+var
+   i : IndexType;
+begin
+   for i := 0 to FSize - 1 do
+   begin
+      if pred.Test(FItems[i]) then
+      begin
+         aitem := FItems[i];
+         Result := true;
+         Exit;
+      end;
+   end;
+   Result := false;
+end;
+
+function TTopK.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   aitem : ItemType;
+   i, kept : IndexType;
+begin
+   Result := 0;
+   kept := 0;
+   i := 0;
+   try
+      { the items which are kept are moved to the beginning of the
+        array; [kept, i) is free }
+      while i < FSize do
+      begin
+         aitem := FItems[i];
+         Inc(i);
+         if pred.Test(aitem) then { may raise }
+         begin
+            Inc(Result);
+            DisposeItem(aitem);
+         end else
+         begin
+            FItems[kept] := aitem;
+            Inc(kept);
+         end;
+      end;
+   finally
+      { keep the items not yet tested if pred raised an exception }
+      while i < FSize do
+      begin
+         FItems[kept] := FItems[i];
+         Inc(kept);
+         Inc(i);
+      end;
+      FSize := kept;
+      for i := FSize div 2 - 1 downto 0 do
+         SiftDown(i);
+   end;
+end;
+
+procedure TTopK.Clear;
+var
+   aitem : ItemType;
+   i : IndexType;
+begin
+   if OwnsItems then
+   begin
+      for i := 0 to FSize - 1 do
+      begin
+         aitem := FItems[i];
+         DisposeItem(aitem);
+      end;
+   end;
+   FItems := nil;
+   FSize := 0;
+   GrabageCollector.FreeObjects;
+end;
+
+function TTopK.Empty : Boolean;
+begin
+   Result := FSize = 0;
+end;
+
+function TTopK.Size : SizeType;
+begin
+   Result := FSize;
+end;
@@ -644,6 +644,17 @@ begin
       inherited;
 end;
 
+{$ifdef PASCAL_ADT_STATS }
+procedure TTree.GetStats(var stats : TContainerStats);
+begin
+   inherited;
+   stats.Nodes := stats.Items;
+   Inc(stats.Bytes, stats.Nodes * SizeOf(TTreeNode));
+   if FRoot <> nil then
+      stats.Height := NodeHeight(FRoot) + 1;
+end;
+{$endif PASCAL_ADT_STATS }
+
 function TTree.Root : TTreeIterator;
 begin
    Result := TTreeIterator.Create(FRoot, self);
@@ -857,6 +868,45 @@ begin
    Result := false;
 end;
 
+function TTree.FindIf(const pred : IUnaryPredicate;
+                      var aitem : ItemType) : Boolean;
+var
+   node : PTreeNode;
+begin
+   node := FRoot;
+   while node <> nil do
+   begin
+      if pred.Test(node^.Item) then
+      begin
+         aitem := node^.Item;
+         Result := true;
+         Exit;
+      end;
+      node := NextPreOrderNode(node);
+   end;
+   Result := false;
+end;
+
+function TTree.DeleteIf(const pred : IUnaryPredicate) : SizeType;
+var
+   node : PTreeNode;
+   aitem : ItemType;
+begin
+   Result := 0;
+   node := FRoot;
+   while node <> nil do
+   begin
+      aitem := node^.Item;
+      if pred.Test(aitem) then
+      begin
+         ExtractNodePreOrder(node, true); { updates FSize }
+         Inc(Result);
+         DisposeItem(aitem);
+      end else
+         node := NextPreOrderNode(node);
+   end;
+end;
+
 procedure TTree.InsertNode(var node : PTreeNode; parent, rsibling : PTreeNode;
                            aitem : ItemType);
 begin
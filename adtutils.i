@@ -38,3 +38,31 @@ type
 procedure ExchangeItem(var item1, item2 : ItemType); overload; &_mcp_inline&
 { this is needed to correctly move AnsiStrings/interfaces/records containing them }   
 procedure SafeMove(var src, dest : ItemType; num : SizeType); overload;
+{ moves <num> items from <src> to <dest> bit by bit, without adjusting
+  any reference counts; the items previously at <dest> which are not
+  overwritten by the source items are finalized and the source slots
+  not covered by <dest> are zeroed, so that they may be safely
+  overwritten or freed afterwards; the ranges may overlap; for types
+  that need no finalization this is the same as SafeMove }
+procedure RelocateItems(var src, dest : ItemType; num : SizeType); overload;
+
+{ writes <aitem> to <stream> using <streamer>; if <streamer> is nil
+  the default binary representation of the item is written; for
+  TObject items <streamer> must not be nil }
+procedure StreamWriteItem(stream : TStream; aitem : ItemType;
+                          const streamer : IStreamer); overload;
+{ reads an item written by StreamWriteItem with the same streamer and
+  stores it in <aitem> }
+procedure StreamReadItem(stream : TStream; var aitem : ItemType;
+                         const streamer : IStreamer); overload;
+{ writes <num> consecutive items starting at <items>; if <streamer>
+  is nil and the items may be copied bit-by-bit this is done with a
+  single write }
+procedure StreamWriteItems(stream : TStream; var items : ItemType;
+                           num : SizeType; const streamer : IStreamer); overload;
+{ reads <num> items written by StreamWriteItems into the memory
+  starting at <items>; the memory must already be initialized (e.g.
+  zeroed); if an exception is raised some of the items may already
+  have been read }
+procedure StreamReadItems(stream : TStream; var items : ItemType;
+                          num : SizeType; const streamer : IStreamer); overload;
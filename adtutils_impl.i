@@ -30,16 +30,25 @@
 
 procedure ExchangeItem(var item1, item2 : ItemType); &_mcp_inline
 var
+&if (&_mcp_is_plain_data(&ItemType&))
    temp : ItemType;
 begin
    temp := item1;
    item1 := item2;
    item2 := temp;
 end;
+&else
+   { exchanging bit by bit leaves the reference counts intact }
+   temp : array[0..SizeOf(ItemType) - 1] of Byte;
+begin
+   system.Move(item1, temp, SizeOf(ItemType));
+   system.Move(item2, item1, SizeOf(ItemType));
+   system.Move(temp, item2, SizeOf(ItemType));
+end;
+&endif
 
 procedure SafeMove(var src, dest : ItemType; num : SizeType);
-&if (&ItemType == TObject || &ItemType == Integer || &ItemType == Pointer ||
-        &ItemType == Cardinal || &ItemType == Real)
+&if (&_mcp_is_plain_data(&ItemType&))
 begin
    system.Move(src, dest, num*SizeOf(ItemType));
 end;
@@ -76,3 +85,165 @@ begin
    end;
 end;
 &endif
+
+procedure RelocateItems(var src, dest : ItemType; num : SizeType);
+&if (&_mcp_is_plain_data(&ItemType&))
+begin
+   system.Move(src, dest, num*SizeOf(ItemType));
+end;
+&else
+var
+   psrc, pdest, pfree : PItemType;
+   gap : SizeType;
+begin
+   psrc := @src;
+   pdest := @dest;
+   if (psrc <> pdest) and (num > 0) then
+   begin
+      { gap is the number of slots by which the ranges are shifted;
+        only the first or last min(num, gap) slots of each range are
+        not shared by the other range }
+      if PointerValueType(psrc) < PointerValueType(pdest) then
+         gap := (PointerValueType(pdest) - PointerValueType(psrc)) div SizeOf(ItemType)
+      else
+         gap := (PointerValueType(psrc) - PointerValueType(pdest)) div SizeOf(ItemType);
+      if gap > num then
+         gap := num;
+      
+      if PointerValueType(psrc) < PointerValueType(pdest) then
+      begin
+         pfree := pdest;
+         Inc(pfree, num - gap);
+         Finalize(pfree^, gap);
+         system.Move(psrc^, pdest^, num*SizeOf(ItemType));
+         FillChar(psrc^, gap*SizeOf(ItemType), 0);
+      end else
+      begin
+         Finalize(pdest^, gap);
+         system.Move(psrc^, pdest^, num*SizeOf(ItemType));
+         pfree := psrc;
+         Inc(pfree, num - gap);
+         FillChar(pfree^, gap*SizeOf(ItemType), 0);
+      end;
+   end;
+end;
+&endif
+
+procedure StreamWriteItem(stream : TStream; aitem : ItemType;
+                          const streamer : IStreamer);
+&if (&ItemType == String)
+var
+   len : LongInt;
+&endif
+begin
+&if (&ItemType == TObject)
+   if streamer = nil then
+      raise EInvalidArgument.Create(msgNilFunctor);
+&elseif (&_mcp_is_record(&ItemType&))
+&ifdef MCP_RECORD_MANAGED
+   if streamer = nil then
+      raise EInvalidArgument.Create(msgNilFunctor);
+&endif
+&endif
+   if streamer <> nil then
+      streamer.WriteItem(stream, aitem)
+   else
+   begin
+&if (&ItemType == String)
+      len := Length(aitem);
+      stream.WriteBuffer(len, SizeOf(LongInt));
+      if len > 0 then
+         stream.WriteBuffer(aitem[1], len);
+&elseif (&ItemType != TObject)
+      stream.WriteBuffer(aitem, SizeOf(ItemType));
+&endif
+   end;
+end;
+
+procedure StreamReadItem(stream : TStream; var aitem : ItemType;
+                         const streamer : IStreamer);
+&if (&ItemType == String)
+var
+   len, done, chunk : LongInt;
+&endif
+begin
+&if (&ItemType == TObject)
+   if streamer = nil then
+      raise EInvalidArgument.Create(msgNilFunctor);
+&elseif (&_mcp_is_record(&ItemType&))
+&ifdef MCP_RECORD_MANAGED
+   if streamer = nil then
+      raise EInvalidArgument.Create(msgNilFunctor);
+&endif
+&endif
+   if streamer <> nil then
+      aitem := streamer.ReadItem(stream)
+   else
+   begin
+&if (&ItemType == String)
+      stream.ReadBuffer(len, SizeOf(LongInt));
+      if len < 0 then
+         raise EInvalidStreamFormat.Create(msgStreamCorrupted);
+      { the size of the stream is not used to check len, because it is
+        not known for every stream; the string is read in chunks instead }
+      aitem := '';
+      done := 0;
+      while done < len do
+      begin
+         chunk := len - done;
+         if chunk > StreamStringChunk then
+            chunk := StreamStringChunk;
+         SetLength(aitem, done + chunk);
+         stream.ReadBuffer(aitem[done + 1], chunk);
+         Inc(done, chunk);
+      end;
+&elseif (&ItemType != TObject)
+      stream.ReadBuffer(aitem, SizeOf(ItemType));
+&endif
+   end;
+end;
+
+procedure StreamWriteItems(stream : TStream; var items : ItemType;
+                           num : SizeType; const streamer : IStreamer);
+var
+   pitem : PItemType;
+begin
+&if (&ItemType == TObject)
+&elseif (&_mcp_is_plain_data(&ItemType&))
+   if (streamer = nil) and (num > 0) then
+   begin
+      stream.WriteBuffer(items, num*SizeOf(ItemType));
+      Exit;
+   end;
+&endif
+   pitem := @items;
+   while num > 0 do
+   begin
+      StreamWriteItem(stream, pitem^, streamer);
+      Inc(pitem);
+      Dec(num);
+   end;
+end;
+
+procedure StreamReadItems(stream : TStream; var items : ItemType;
+                          num : SizeType; const streamer : IStreamer);
+var
+   pitem : PItemType;
+begin
+&if (&ItemType == TObject)
+&elseif (&_mcp_is_plain_data(&ItemType&))
+   if (streamer = nil) and (num > 0) then
+   begin
+      stream.ReadBuffer(items, num*SizeOf(ItemType));
+      Exit;
+   end;
+&endif
+   pitem := @items;
+   while num > 0 do
+   begin
+      StreamReadItem(stream, pitem^, streamer);
+      Inc(pitem);
+      Dec(num);
+   end;
+end;
+
@@ -193,6 +193,26 @@ echo
 if [ "$REPLY" == "y" ]; then
     MCPOPTS="-dMCP_REAL $MCPOPTS"
 fi
+read -n 1 -p "Generate template instantiations for Int64? (n/y) "
+echo
+if [ "$REPLY" == "y" ]; then
+    MCPOPTS="-dMCP_INT64 $MCPOPTS"
+fi
+read -n 1 -p "Generate template instantiations for QWord? (n/y) "
+echo
+if [ "$REPLY" == "y" ]; then
+    MCPOPTS="-dMCP_QWORD $MCPOPTS"
+fi
+read -n 1 -p "Generate template instantiations for Double? (n/y) "
+echo
+if [ "$REPLY" == "y" ]; then
+    MCPOPTS="-dMCP_DOUBLE $MCPOPTS"
+fi
+read -n 1 -p "Generate template instantiations for the record type from adtrecord.inc? (n/y) "
+echo
+if [ "$REPLY" == "y" ]; then
+    MCPOPTS="-dMCP_RECORD $MCPOPTS"
+fi
 
 if [ $SRCDOC_PRESENT == 1 ]; then
     read -n 1 -p "Make documentation? (y/n) "
@@ -0,0 +1,146 @@
+program benchblocks;
+
+{ compares moving integers in and out of random access containers one
+  item at a time (PushBack, GetItem) with the block transfers
+  (AppendBlock, ReadBlock); also checks that both give the same
+  results }
+
+{$apptype console }
+
+uses
+   SysUtils, adtcont, adtarray, adtqueue;
+
+const
+   { the size of a single block, like a buffer received from the
+     network }
+   BLOCK = 4096;
+   ITEMS = BLOCK * 2500;
+   REPEATS = 3;
+
+type
+   TContainerKind = (ckArray, ckCircularDeque, ckSegDeque);
+
+const
+   ContainerNames : array[TContainerKind] of String = (
+      'TIntegerArray', 'TIntegerCircularDeque', 'TIntegerSegDeque'
+   );
+
+var
+   buffer : array of Integer;
+
+function MSecs : Comp;
+begin
+   Result := TimeStampToMSecs(DateTimeToTimeStamp(Now));
+end;
+
+function CreateContainer(kind : TContainerKind) : TIntegerRandomAccessContainerAdt;
+begin
+   case kind of
+      ckArray: Result := TIntegerArray.Create;
+      ckCircularDeque: Result := TIntegerCircularDeque.Create;
+   else
+      Result := TIntegerSegDeque.Create;
+   end;
+end;
+
+{ appends ITEMS items to <cont> in blocks of BLOCK items, one at a time
+  if <blocks> is false }
+procedure Fill(cont : TIntegerRandomAccessContainerAdt; blocks : Boolean);
+var
+   i, j : Integer;
+begin
+   i := 0;
+   while i < ITEMS do
+   begin
+      for j := 0 to BLOCK - 1 do
+         buffer[j] := i + j;
+      if blocks then
+         cont.AppendBlock(buffer, BLOCK)
+      else
+         for j := 0 to BLOCK - 1 do
+            cont.PushBack(buffer[j]);
+      Inc(i, BLOCK);
+   end;
+end;
+
+{ reads all the items from <cont> in blocks of BLOCK items, one at a
+  time if <blocks> is false; returns their sum }
+function Drain(cont : TIntegerRandomAccessContainerAdt; blocks : Boolean) : Int64;
+var
+   i, j : Integer;
+begin
+   Result := 0;
+   i := 0;
+   while i < cont.Size do
+   begin
+      if blocks then
+         cont.ReadBlock(i, buffer, BLOCK)
+      else
+         for j := 0 to BLOCK - 1 do
+            buffer[j] := cont.GetItem(i + j);
+      for j := 0 to BLOCK - 1 do
+         Inc(Result, buffer[j]);
+      Inc(i, BLOCK);
+   end;
+end;
+
+{ returns the best times of REPEATS runs of filling and draining a
+  container of the given kind, in milliseconds; stores the sum of the
+  items in <res> }
+procedure Measure(kind : TContainerKind; blocks : Boolean;
+                  var fillTime, drainTime : Comp; var res : Int64);
+var
+   i : Integer;
+   cont : TIntegerRandomAccessContainerAdt;
+   tm : Comp;
+begin
+   fillTime := -1;
+   drainTime := -1;
+   for i := 1 to REPEATS do
+   begin
+      cont := CreateContainer(kind);
+      try
+         tm := MSecs;
+         Fill(cont, blocks);
+         tm := MSecs - tm;
+         if (fillTime < 0) or (tm < fillTime) then
+            fillTime := tm;
+
+         tm := MSecs;
+         res := Drain(cont, blocks);
+         tm := MSecs - tm;
+         if (drainTime < 0) or (tm < drainTime) then
+            drainTime := tm;
+      finally
+         cont.Free;
+      end;
+   end;
+   if fillTime = 0 then
+      fillTime := 1;
+   if drainTime = 0 then
+      drainTime := 1;
+end;
+
+var
+   kind : TContainerKind;
+   itemFill, itemDrain, blockFill, blockDrain : Comp;
+   itemResult, blockResult : Int64;
+
+begin
+   SetLength(buffer, BLOCK);
+   WriteLn(ITEMS, ' items in blocks of ', BLOCK);
+
+   for kind := Low(TContainerKind) to High(TContainerKind) do
+   begin
+      Measure(kind, false, itemFill, itemDrain, itemResult);
+      Measure(kind, true, blockFill, blockDrain, blockResult);
+      Write(ContainerNames[kind], ': PushBack ', itemFill :0:0,
+            ' ms, AppendBlock ', blockFill :0:0, ' ms (speedup ',
+            itemFill / blockFill :0:2, '); GetItem ', itemDrain :0:0,
+            ' ms, ReadBlock ', blockDrain :0:0, ' ms (speedup ',
+            itemDrain / blockDrain :0:2, ')');
+      if blockResult <> itemResult then
+         Write(' - FAILED: results differ');
+      WriteLn;
+   end;
+end.
@@ -0,0 +1,191 @@
+program benchdispatch;
+
+{ compares the generic iterator-based algorithms from adtalgs with the
+  container-specific fast paths they dispatch to (see algUseFastPaths)
+  and checks that both give the same results }
+
+{$apptype console }
+
+uses
+   SysUtils, adtfunct, adtcontbase, adtcont, adtiters, adtarray, adtqueue,
+   adtlist, adtavltree, adtalgs;
+
+const
+   ITEMS = 1000000;
+   REPEATS = 3;
+
+type
+   { true for multiples of 7 }
+   TIsMultiple = class (TFunctor, IIntegerUnaryPredicate)
+   public
+      function Test(aitem : Integer) : Boolean;
+   end;
+
+   TAlgorithm = (alCopyArray, alCountList, alCountTree, alFindTree,
+                 alRotateDeque, alReverseList);
+
+function TIsMultiple.Test(aitem : Integer) : Boolean;
+begin
+   Result := aitem mod 7 = 0;
+end;
+
+const
+   AlgorithmNames : array[TAlgorithm] of String = (
+      'Copy (array)', 'Count (list)', 'Count (tree)', 'Find (tree)',
+      'Rotate (deque)', 'Reverse (list)'
+   );
+
+var
+   arr : TIntegerArray;
+   deque : TIntegerCircularDeque;
+   list : TIntegerDoubleList;
+   tree : TIntegerAvlTree;
+   isMultiple : IIntegerUnaryPredicate;
+
+function MSecs : Comp;
+begin
+   Result := TimeStampToMSecs(DateTimeToTimeStamp(Now));
+end;
+
+{ fills the containers with the same items every time }
+procedure FillContainers;
+var
+   i : Integer;
+begin
+   arr.Clear;
+   deque.Clear;
+   list.Clear;
+   for i := 0 to ITEMS - 1 do
+   begin
+      arr.PushBack(i);
+      deque.PushBack(i);
+      list.PushBack(i);
+   end;
+   { make the deque wrap around the end of its buffer }
+   for i := 1 to ITEMS div 3 do
+   begin
+      deque.PopFront;
+      deque.PushBack(ITEMS + i);
+   end;
+end;
+
+{ returns a checksum of the first, the middle and the last items in
+  [start,finish) }
+function Checksum(start, finish : TIntegerForwardIterator) : Int64;
+var
+   i : Integer;
+begin
+   Result := 0;
+   i := 0;
+   start := CopyOf(start);
+   while not start.Equal(finish) do
+   begin
+      if (i = 0) or (i = ITEMS div 2) or (i = ITEMS - 1) then
+         Result := Result * 31 + start.Item;
+      start.Advance;
+      Inc(i);
+   end;
+   start.Destroy;
+end;
+
+{ runs <alg> once; returns a number identifying the result }
+function RunAlgorithm(alg : TAlgorithm) : Int64;
+var
+   iter : TIntegerForwardIterator;
+   i : Integer;
+begin
+   Result := 0;
+   case alg of
+      alCopyArray:
+      begin
+         Copy(arr.RandomAccessStart,
+              Advance(arr.RandomAccessStart, ITEMS div 2),
+              Advance(arr.RandomAccessStart, ITEMS div 4), IntegerIdentity);
+         Result := Checksum(arr.ForwardStart, arr.ForwardFinish);
+      end;
+      alCountList:
+         Result := Count(list.ForwardStart, list.ForwardFinish, isMultiple);
+      alCountTree:
+         Result := Count(tree.Start, tree.Finish, isMultiple);
+      alFindTree:
+      begin
+         for i := 0 to 99 do
+         begin
+            iter := Find(tree.Start, tree.Finish, i * (ITEMS div 100),
+                         tree.ItemComparer);
+            if not iter.IsFinish then
+               Result := Result + iter.Item;
+            iter.Destroy;
+         end;
+      end;
+      alRotateDeque:
+      begin
+         Rotate(deque.RandomAccessStart,
+                Advance(deque.RandomAccessStart, ITEMS div 3),
+                deque.RandomAccessFinish);
+         Result := Checksum(deque.ForwardStart, deque.ForwardFinish);
+      end;
+      alReverseList:
+      begin
+         Reverse(list.BidirectionalStart, list.BidirectionalFinish);
+         Result := Checksum(list.ForwardStart, list.ForwardFinish);
+      end;
+   end;
+end;
+
+{ returns the best time of REPEATS runs of <alg>, in milliseconds;
+  stores the result of the last run in <res> }
+function Measure(alg : TAlgorithm; var res : Int64) : Comp;
+var
+   i : Integer;
+   tm : Comp;
+begin
+   Result := -1;
+   for i := 1 to REPEATS do
+   begin
+      FillContainers;
+      tm := MSecs;
+      res := RunAlgorithm(alg);
+      tm := MSecs - tm;
+      if (Result < 0) or (tm < Result) then
+         Result := tm;
+   end;
+   if Result = 0 then
+      Result := 1;
+end;
+
+var
+   alg : TAlgorithm;
+   i : Integer;
+   genericTime, fastTime : Comp;
+   genericResult, fastResult : Int64;
+
+begin
+   isMultiple := TIsMultiple.Create;
+   arr := TIntegerArray.Create;
+   deque := TIntegerCircularDeque.Create;
+   list := TIntegerDoubleList.Create;
+   tree := TIntegerAvlTree.Create;
+   for i := 0 to ITEMS - 1 do
+      tree.Insert(i);
+   WriteLn(ITEMS, ' items');
+
+   for alg := Low(TAlgorithm) to High(TAlgorithm) do
+   begin
+      algUseFastPaths := false;
+      genericTime := Measure(alg, genericResult);
+      algUseFastPaths := true;
+      fastTime := Measure(alg, fastResult);
+      Write(AlgorithmNames[alg], ': generic ', genericTime :0:0,
+            ' ms, fast path ', fastTime :0:0, ' ms, speedup ',
+            genericTime / fastTime :0:2);
+      if fastResult <> genericResult then
+         Write(' - FAILED: results differ');
+      WriteLn;
+   end;
+
+   arr.Free;
+   deque.Free;
+   list.Free;
+   tree.Free;
+end.
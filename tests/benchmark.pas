@@ -1,7 +1,8 @@
 program benchmark;
 
 uses
-   adtcont, adthash, adtavltree, adtbstree, adtsplaytree, adt23tree, testsetspeed, adtlog;
+   adtcont, adthash, adtavltree, adtbstree, adtsplaytree, adt23tree, adtfilter,
+   adtcuckoo, adtperfhash, testsetspeed, adtlog;
 
 procedure DoBenchmark(aset : TStringSetAdt; className : String);
 begin
@@ -9,14 +10,35 @@ begin
    aset.Destroy;   
 end;
 
+procedure DoBenchmarkHashTail(aset : TIntegerHashSetAdt; className : String);
+begin
+   BenchmarkHashTail(aset, className);
+   aset.Destroy;
+end;
+
 begin
    OpenLogStream;
    DoBenchmark(TStringHashTable.Create, 'TStringHashTable');
    DoBenchmark(TStringScatterTable.Create, 'TStringScatterTable');
+   DoBenchmark(TStringCuckooHashTable.Create, 'TStringCuckooHashTable');
    DoBenchmark(TStringAvlTree.Create, 'TStringAvlTree');
    DoBenchmark(TStringSplayTree.Create, 'TStringSplayTree');
    DoBenchmark(TString23Tree.Create, 'TString23Tree');
    DoBenchmark(TStringBinarySearchTree.Create, 'TStringBinarySearchTree');
+   DoBenchmark(TStringFilteredSet.Create(TStringAvlTree.Create,
+                                         TStringBloomFilter.Create(1000000)),
+               'TStringFilteredSet (TStringAvlTree, TStringBloomFilter)');
+   DoBenchmark(TStringFilteredSet.Create(TStringHashTable.Create,
+                                         TStringCuckooFilter.Create(1000000)),
+               'TStringFilteredSet (TStringHashTable, TStringCuckooFilter)');
+   BenchmarkFilter(fkBloom8);
+   BenchmarkFilter(fkBloom10);
+   BenchmarkFilter(fkBloom16);
+   BenchmarkFilter(fkCuckoo);
+   DoBenchmarkHashTail(TIntegerHashTable.Create, 'TIntegerHashTable');
+   DoBenchmarkHashTail(TIntegerCuckooHashTable.Create, 'TIntegerCuckooHashTable');
+   BenchmarkPerfectHash;
+   BenchmarkStaticSet;
    WriteLn;
    WriteLn('Done. See the log file for details (pascaladt.log).');
 end.
@@ -0,0 +1,205 @@
+program benchparalgs;
+
+{ measures how the parallel algorithms from adtparalgs scale with the
+  number of threads on a large array of integers and compares them
+  with the sequential algorithms from adtalgs; also checks that both
+  give the same results }
+
+{$apptype console }
+
+uses
+{$ifdef unix }
+   cthreads,
+{$endif }
+   SysUtils, Classes, adtfunct, adtcontbase, adtiters, adtarray, adtalgs,
+   adtparalgs;
+
+const
+   ITEMS = 20000000;
+   { the item searched for by Find is at this position }
+   FIND_POSITION = ITEMS div 4 * 3;
+   REPEATS = 3;
+
+type
+   { true for multiples of 7 }
+   TIsMultiple = class (TFunctor, IIntegerUnaryPredicate)
+   public
+      function Test(aitem : Integer) : Boolean;
+   end;
+
+   { true for the item placed at FIND_POSITION }
+   TIsNegative = class (TFunctor, IIntegerUnaryPredicate)
+   public
+      function Test(aitem : Integer) : Boolean;
+   end;
+
+   { a cheap arithmetic transformation of an item }
+   TScramble = class (TFunctor, IIntegerUnaryFunctor)
+   public
+      function Perform(aitem : Integer) : Integer;
+   end;
+
+   TAlgorithm = (alFind, alCount, alMinimal, alForEach);
+
+function TIsMultiple.Test(aitem : Integer) : Boolean;
+begin
+   Result := aitem mod 7 = 0;
+end;
+
+function TIsNegative.Test(aitem : Integer) : Boolean;
+begin
+   Result := aitem < 0;
+end;
+
+function TScramble.Perform(aitem : Integer) : Integer;
+begin
+   Result := (aitem xor (aitem shr 7)) and $3FFFFFFF;
+end;
+
+const
+   AlgorithmNames : array[TAlgorithm] of String = (
+      'Find', 'Count', 'Minimal', 'ForEach'
+   );
+
+var
+   arr : TIntegerArray;
+   isMultiple, isNegative : IIntegerUnaryPredicate;
+   scramble : IIntegerUnaryFunctor;
+
+function MSecs : Comp;
+begin
+   Result := TimeStampToMSecs(DateTimeToTimeStamp(Now));
+end;
+
+{ runs <alg> once, sequentially if <pool> is nil; returns a number
+  identifying the result }
+function RunAlgorithm(alg : TAlgorithm; pool : TTaskPool) : Int64;
+var
+   iter : TIntegerForwardIterator;
+begin
+   Result := 0;
+   case alg of
+      alFind:
+      begin
+         if pool = nil then
+            iter := Find(arr.ForwardStart, arr.ForwardFinish, isNegative)
+         else
+            iter := ParallelFind(arr.RandomAccessStart, arr.RandomAccessFinish,
+                                 isNegative, pool);
+         Result := TIntegerRandomAccessIterator(iter).Index;
+         iter.Free;
+      end;
+      alCount:
+      begin
+         if pool = nil then
+            Result := Count(arr.ForwardStart, arr.ForwardFinish, isMultiple)
+         else
+            Result := ParallelCount(arr.RandomAccessStart, arr.RandomAccessFinish,
+                                    isMultiple, pool);
+      end;
+      alMinimal:
+      begin
+         if pool = nil then
+            iter := Minimal(arr.ForwardStart, arr.ForwardFinish, nil)
+         else
+            iter := ParallelMinimal(arr.RandomAccessStart,
+                                    arr.RandomAccessFinish, nil, pool);
+         Result := TIntegerRandomAccessIterator(iter).Index;
+         iter.Free;
+      end;
+      alForEach:
+      begin
+         if pool = nil then
+            ForEach(arr.ForwardStart, arr.ForwardFinish, scramble)
+         else
+            ParallelForEach(arr.RandomAccessStart, arr.RandomAccessFinish,
+                            scramble, pool);
+         Result := arr[FIND_POSITION div 2];
+      end;
+   end;
+end;
+
+{ fills the array with the same pseudo-random items every time }
+procedure FillArray;
+var
+   i : Integer;
+   x : Cardinal;
+begin
+   arr.Clear;
+   x := 2463534242;
+   for i := 0 to ITEMS - 1 do
+   begin
+      { xorshift }
+      x := x xor (x shl 13);
+      x := x xor (x shr 17);
+      x := x xor (x shl 5);
+      arr.PushBack(Integer(x and $3FFFFFFF));
+   end;
+   arr[FIND_POSITION] := -1;
+end;
+
+{ returns the best time of REPEATS runs of <alg>, in milliseconds;
+  stores the result in <res> }
+function Measure(alg : TAlgorithm; pool : TTaskPool; var res : Int64) : Comp;
+var
+   i : Integer;
+   tm : Comp;
+begin
+   Result := -1;
+   for i := 1 to REPEATS do
+   begin
+      if alg = alForEach then
+         FillArray;
+      tm := MSecs;
+      res := RunAlgorithm(alg, pool);
+      tm := MSecs - tm;
+      if (Result < 0) or (tm < Result) then
+         Result := tm;
+   end;
+   if Result = 0 then
+      Result := 1;
+end;
+
+var
+   alg : TAlgorithm;
+   pool : TTaskPool;
+   threads, maxThreads : Integer;
+   seqTime, tm : Comp;
+   seqResult, parResult : Int64;
+
+begin
+   isMultiple := TIsMultiple.Create;
+   isNegative := TIsNegative.Create;
+   scramble := TScramble.Create;
+   arr := TIntegerArray.Create;
+   maxThreads := TThread.ProcessorCount;
+   WriteLn(ITEMS, ' items, ', maxThreads, ' processors');
+
+   for alg := Low(TAlgorithm) to High(TAlgorithm) do
+   begin
+      FillArray;
+      seqTime := Measure(alg, nil, seqResult);
+      WriteLn(AlgorithmNames[alg], ', sequential: ', seqTime :0:0, ' ms');
+
+      threads := 1;
+      while threads <= maxThreads do
+      begin
+         pool := TTaskPool.Create(threads);
+         FillArray;
+         tm := Measure(alg, pool, parResult);
+         pool.Free;
+         Write(AlgorithmNames[alg], ', ', threads, ' thread(s): ', tm :0:0,
+               ' ms, speedup ', seqTime / tm :0:2);
+         if parResult <> seqResult then
+            Write(' - FAILED: results differ');
+         WriteLn;
+
+         if (threads < maxThreads) and (threads*2 > maxThreads) then
+            threads := maxThreads
+         else
+            threads := threads*2;
+      end;
+   end;
+
+   arr.Free;
+end.
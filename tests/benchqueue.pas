@@ -0,0 +1,401 @@
+program benchqueue;
+
+{ measures the throughput and the round-trip latency of the lock-free
+  queues from adtconcqueue with different numbers of threads and
+  compares them with a TCircularDeque guarded by a critical section;
+  also checks that every item pushed is popped exactly once }
+
+{$apptype console }
+
+uses
+{$ifdef unix }
+   cthreads,
+{$endif }
+   SysUtils, Classes, SyncObjs, adtcont, adtqueue, adtconcqueue;
+
+const
+   ITEMS = 4000000;
+   ROUND_TRIPS = 200000;
+   QUEUE_CAPACITY = 4096;
+   BATCH_SIZE = 64;
+   MAX_THREADS = 4;
+
+type
+   TBatch = array[0..BATCH_SIZE - 1] of Integer;
+
+   { the queue shared by the threads of one run }
+   TBenchQueue = class
+   public
+      { pushes as many items from the beginning of <aitems> as there
+        is room for; returns their number }
+      function Push(const aitems : array of Integer) : SizeType; virtual; abstract;
+      { pops at most Length(<aitems>) items; returns their number }
+      function Pop(var aitems : array of Integer) : SizeType; virtual; abstract;
+   end;
+
+   TLockedQueue = class (TBenchQueue)
+   private
+      FDeque : TIntegerCircularDeque;
+      FLock : TCriticalSection;
+   public
+      constructor Create;
+      destructor Destroy; override;
+      function Push(const aitems : array of Integer) : SizeType; override;
+      function Pop(var aitems : array of Integer) : SizeType; override;
+   end;
+
+   TSpscBenchQueue = class (TBenchQueue)
+   private
+      FQueue : TIntegerSpscQueue;
+   public
+      constructor Create;
+      destructor Destroy; override;
+      function Push(const aitems : array of Integer) : SizeType; override;
+      function Pop(var aitems : array of Integer) : SizeType; override;
+   end;
+
+   TMpmcBenchQueue = class (TBenchQueue)
+   private
+      FQueue : TIntegerMpmcQueue;
+   public
+      constructor Create;
+      destructor Destroy; override;
+      function Push(const aitems : array of Integer) : SizeType; override;
+      function Pop(var aitems : array of Integer) : SizeType; override;
+   end;
+
+   { pushes the numbers first..first+count-1 in batches of <batch> }
+   TProducer = class (TThread)
+   private
+      FQueue : TBenchQueue;
+      FFirst, FCount, FBatch : Integer;
+   protected
+      procedure Execute; override;
+   public
+      constructor Create(q : TBenchQueue; first, count, batch : Integer);
+   end;
+
+   { pops <count> numbers in batches of <batch> and sums them }
+   TConsumer = class (TThread)
+   private
+      FQueue : TBenchQueue;
+      FCount, FBatch : Integer;
+      FSum : Int64;
+   protected
+      procedure Execute; override;
+   public
+      constructor Create(q : TBenchQueue; count, batch : Integer);
+   end;
+
+   { pops items from one queue and pushes them to another, one at a
+     time, spinning while waiting }
+   TEcho = class (TThread)
+   private
+      FIn, FOut : TBenchQueue;
+   protected
+      procedure Execute; override;
+   public
+      constructor Create(qin, qout : TBenchQueue);
+   end;
+
+{ ---------------------------- queues ------------------------------- }
+
+constructor TLockedQueue.Create;
+begin
+   inherited Create;
+   FDeque := TIntegerCircularDeque.Create;
+   FLock := TCriticalSection.Create;
+end;
+
+destructor TLockedQueue.Destroy;
+begin
+   FDeque.Free;
+   FLock.Free;
+   inherited;
+end;
+
+function TLockedQueue.Push(const aitems : array of Integer) : SizeType;
+begin
+   Result := 0;
+   FLock.Enter;
+   try
+      while (Result < Length(aitems)) and (FDeque.Size < QUEUE_CAPACITY) do
+      begin
+         FDeque.PushBack(aitems[Result]);
+         Inc(Result);
+      end;
+   finally
+      FLock.Leave;
+   end;
+end;
+
+function TLockedQueue.Pop(var aitems : array of Integer) : SizeType;
+begin
+   Result := 0;
+   FLock.Enter;
+   try
+      while (Result < Length(aitems)) and not FDeque.Empty do
+      begin
+         aitems[Result] := FDeque.Front;
+         FDeque.PopFront;
+         Inc(Result);
+      end;
+   finally
+      FLock.Leave;
+   end;
+end;
+
+constructor TSpscBenchQueue.Create;
+begin
+   inherited Create;
+   FQueue := TIntegerSpscQueue.Create(QUEUE_CAPACITY);
+end;
+
+destructor TSpscBenchQueue.Destroy;
+begin
+   FQueue.Free;
+   inherited;
+end;
+
+function TSpscBenchQueue.Push(const aitems : array of Integer) : SizeType;
+begin
+   if Length(aitems) = 1 then
+      Result := Ord(FQueue.TryPushBack(aitems[0]))
+   else
+      Result := FQueue.PushMany(aitems);
+end;
+
+function TSpscBenchQueue.Pop(var aitems : array of Integer) : SizeType;
+begin
+   if Length(aitems) = 1 then
+      Result := Ord(FQueue.TryPopFront(aitems[0]))
+   else
+      Result := FQueue.PopMany(aitems);
+end;
+
+constructor TMpmcBenchQueue.Create;
+begin
+   inherited Create;
+   FQueue := TIntegerMpmcQueue.Create(QUEUE_CAPACITY);
+end;
+
+destructor TMpmcBenchQueue.Destroy;
+begin
+   FQueue.Free;
+   inherited;
+end;
+
+function TMpmcBenchQueue.Push(const aitems : array of Integer) : SizeType;
+begin
+   if Length(aitems) = 1 then
+      Result := Ord(FQueue.TryPushBack(aitems[0]))
+   else
+      Result := FQueue.PushMany(aitems);
+end;
+
+function TMpmcBenchQueue.Pop(var aitems : array of Integer) : SizeType;
+begin
+   if Length(aitems) = 1 then
+      Result := Ord(FQueue.TryPopFront(aitems[0]))
+   else
+      Result := FQueue.PopMany(aitems);
+end;
+
+{ ---------------------------- threads ------------------------------- }
+
+constructor TProducer.Create(q : TBenchQueue; first, count, batch : Integer);
+begin
+   FQueue := q;
+   FFirst := first;
+   FCount := count;
+   FBatch := batch;
+   inherited Create(true);
+end;
+
+procedure TProducer.Execute;
+var
+   buf : TBatch;
+   next, last, n, i, pushed : Integer;
+begin
+   next := FFirst;
+   last := FFirst + FCount;
+   while next < last do
+   begin
+      n := FBatch;
+      if n > last - next then
+         n := last - next;
+      for i := 0 to n - 1 do
+         buf[i] := next + i;
+      pushed := FQueue.Push(Slice(buf, n));
+      if pushed = 0 then
+         Sleep(0);
+      Inc(next, pushed);
+   end;
+end;
+
+constructor TConsumer.Create(q : TBenchQueue; count, batch : Integer);
+begin
+   FQueue := q;
+   FCount := count;
+   FBatch := batch;
+   FSum := 0;
+   inherited Create(true);
+end;
+
+procedure TConsumer.Execute;
+var
+   buf : TBatch;
+   got, n, i, popped : Integer;
+begin
+   got := 0;
+   while got < FCount do
+   begin
+      n := FBatch;
+      if n > FCount - got then
+         n := FCount - got;
+      popped := FQueue.Pop(Slice(buf, n));
+      if popped = 0 then
+         Sleep(0);
+      for i := 0 to popped - 1 do
+         Inc(FSum, buf[i]);
+      Inc(got, popped);
+   end;
+end;
+
+constructor TEcho.Create(qin, qout : TBenchQueue);
+begin
+   FIn := qin;
+   FOut := qout;
+   inherited Create(true);
+end;
+
+procedure TEcho.Execute;
+var
+   buf : TBatch;
+   i : Integer;
+begin
+   for i := 1 to ROUND_TRIPS do
+   begin
+      while FIn.Pop(Slice(buf, 1)) = 0 do
+         ;
+      while FOut.Push(Slice(buf, 1)) = 0 do
+         ;
+   end;
+end;
+
+{ ---------------------------- measurements ------------------------------- }
+
+function MSecs : Comp;
+begin
+   Result := TimeStampToMSecs(DateTimeToTimeStamp(Now));
+end;
+
+procedure MeasureThroughput(const name : String; q : TBenchQueue;
+                            threads, batch : Integer);
+var
+   producers : array[1..MAX_THREADS] of TProducer;
+   consumers : array[1..MAX_THREADS] of TConsumer;
+   i : Integer;
+   sum : Int64;
+   tm : Comp;
+begin
+   for i := 1 to threads do
+   begin
+      producers[i] := TProducer.Create(q, 1 + (i - 1)*(ITEMS div threads),
+                                       ITEMS div threads, batch);
+      consumers[i] := TConsumer.Create(q, ITEMS div threads, batch);
+   end;
+
+   tm := MSecs;
+   for i := 1 to threads do
+   begin
+      consumers[i].Start;
+      producers[i].Start;
+   end;
+   sum := 0;
+   for i := 1 to threads do
+   begin
+      producers[i].WaitFor;
+      consumers[i].WaitFor;
+      Inc(sum, consumers[i].FSum);
+   end;
+   tm := MSecs - tm;
+   if tm = 0 then
+      tm := 1;
+
+   for i := 1 to threads do
+   begin
+      producers[i].Free;
+      consumers[i].Free;
+   end;
+   q.Free;
+
+   Write(name, ', ', threads, ' producer(s) + ', threads,
+         ' consumer(s), batch ', batch, ': ',
+         ITEMS / tm / 1000 :0:2, ' M items/s');
+   if sum <> Int64(ITEMS)*(ITEMS + 1) div 2 then
+      Write(' - FAILED: items lost or duplicated');
+   WriteLn;
+end;
+
+procedure MeasureLatency(const name : String; q1, q2 : TBenchQueue);
+var
+   echo : TEcho;
+   buf : TBatch;
+   i : Integer;
+   ok : Boolean;
+   tm : Comp;
+begin
+   echo := TEcho.Create(q1, q2);
+   ok := true;
+   tm := MSecs;
+   echo.Start;
+   for i := 1 to ROUND_TRIPS do
+   begin
+      buf[0] := i;
+      while q1.Push(Slice(buf, 1)) = 0 do
+         ;
+      while q2.Pop(Slice(buf, 1)) = 0 do
+         ;
+      if buf[0] <> i then
+         ok := false;
+   end;
+   echo.WaitFor;
+   tm := MSecs - tm;
+
+   echo.Free;
+   q1.Free;
+   q2.Free;
+
+   Write(name, ': ', tm * 1000000 / ROUND_TRIPS :0:0, ' ns per round trip');
+   if not ok then
+      Write(' - FAILED: wrong item received');
+   WriteLn;
+end;
+
+var
+   threads : Integer;
+
+begin
+   WriteLn('Throughput:');
+   threads := 1;
+   while threads <= MAX_THREADS do
+   begin
+      MeasureThroughput('locked TCircularDeque', TLockedQueue.Create, threads, 1);
+      MeasureThroughput('locked TCircularDeque', TLockedQueue.Create,
+                        threads, BATCH_SIZE);
+      MeasureThroughput('TMpmcQueue', TMpmcBenchQueue.Create, threads, 1);
+      MeasureThroughput('TMpmcQueue', TMpmcBenchQueue.Create,
+                        threads, BATCH_SIZE);
+      threads := threads * 2;
+   end;
+   MeasureThroughput('TSpscQueue', TSpscBenchQueue.Create, 1, 1);
+   MeasureThroughput('TSpscQueue', TSpscBenchQueue.Create, 1, BATCH_SIZE);
+
+   WriteLn;
+   WriteLn('Latency:');
+   MeasureLatency('locked TCircularDeque', TLockedQueue.Create,
+                  TLockedQueue.Create);
+   MeasureLatency('TMpmcQueue', TMpmcBenchQueue.Create, TMpmcBenchQueue.Create);
+   MeasureLatency('TSpscQueue', TSpscBenchQueue.Create, TSpscBenchQueue.Create);
+end.
@@ -0,0 +1,325 @@
+program benchskiplist;
+
+{ measures the throughput of TConcurrentSkipList under a mixed
+  workload of lookups, insertions, deletions and short range scans
+  with different numbers of threads and compares it with a TAvlTree
+  guarded by a critical section; also checks that the size of the set
+  agrees with the numbers of successful insertions and deletions }
+
+{$apptype console }
+
+uses
+{$ifdef unix }
+   cthreads,
+{$endif }
+   SysUtils, Classes, SyncObjs, adtcont, adtavltree, adtconcskiplist;
+
+const
+   { the keys are drawn from 0..KEY_RANGE-1 }
+   KEY_RANGE = 100000;
+   OPERATIONS = 2000000;
+   { the percentages of operations of each kind; the rest are lookups }
+   INSERT_PERCENT = 10;
+   DELETE_PERCENT = 10;
+   SCAN_PERCENT = 5;
+   SCAN_LENGTH = 20;
+   MAX_THREADS = 8;
+
+type
+   { the set shared by the threads of one run }
+   TBenchSet = class
+   public
+      function Has(key : Integer) : Boolean; virtual; abstract;
+      function Insert(key : Integer) : Boolean; virtual; abstract;
+      function Delete(key : Integer) : Boolean; virtual; abstract;
+      { returns the sum of at most <count> keys starting from the first
+        key >= <key> }
+      function Scan(key, count : Integer) : Int64; virtual; abstract;
+      function Size : SizeType; virtual; abstract;
+   end;
+
+   TLockedSet = class (TBenchSet)
+   private
+      FTree : TIntegerAvlTree;
+      FLock : TCriticalSection;
+   public
+      constructor Create;
+      destructor Destroy; override;
+      function Has(key : Integer) : Boolean; override;
+      function Insert(key : Integer) : Boolean; override;
+      function Delete(key : Integer) : Boolean; override;
+      function Scan(key, count : Integer) : Int64; override;
+      function Size : SizeType; override;
+   end;
+
+   TSkipListSet = class (TBenchSet)
+   private
+      FList : TIntegerConcurrentSkipList;
+   public
+      constructor Create;
+      destructor Destroy; override;
+      function Has(key : Integer) : Boolean; override;
+      function Insert(key : Integer) : Boolean; override;
+      function Delete(key : Integer) : Boolean; override;
+      function Scan(key, count : Integer) : Int64; override;
+      function Size : SizeType; override;
+   end;
+
+   { performs <count> random operations on the set }
+   TWorker = class (TThread)
+   private
+      FSet : TBenchSet;
+      FCount : Integer;
+      FRandom : Cardinal;
+      FInserted, FDeleted : Integer;
+      FSum : Int64;
+      function NextRandom : Cardinal;
+   protected
+      procedure Execute; override;
+   public
+      constructor Create(aset : TBenchSet; count : Integer; seed : Cardinal);
+   end;
+
+{ ---------------------------- sets ------------------------------- }
+
+constructor TLockedSet.Create;
+begin
+   inherited Create;
+   FTree := TIntegerAvlTree.Create;
+   FTree.RepeatedItems := false;
+   FLock := TCriticalSection.Create;
+end;
+
+destructor TLockedSet.Destroy;
+begin
+   FTree.Free;
+   FLock.Free;
+   inherited;
+end;
+
+function TLockedSet.Has(key : Integer) : Boolean;
+begin
+   FLock.Enter;
+   try
+      Result := FTree.Has(key);
+   finally
+      FLock.Leave;
+   end;
+end;
+
+function TLockedSet.Insert(key : Integer) : Boolean;
+begin
+   FLock.Enter;
+   try
+      Result := FTree.Insert(key);
+   finally
+      FLock.Leave;
+   end;
+end;
+
+function TLockedSet.Delete(key : Integer) : Boolean;
+begin
+   FLock.Enter;
+   try
+      Result := FTree.Delete(key) <> 0;
+   finally
+      FLock.Leave;
+   end;
+end;
+
+function TLockedSet.Scan(key, count : Integer) : Int64;
+var
+   iter : TIntegerSetIterator;
+begin
+   Result := 0;
+   FLock.Enter;
+   try
+      iter := FTree.LowerBound(key);
+      while (count > 0) and not iter.IsFinish do
+      begin
+         Inc(Result, iter.Item);
+         iter.Advance;
+         Dec(count);
+      end;
+      iter.Free;
+   finally
+      FLock.Leave;
+   end;
+end;
+
+function TLockedSet.Size : SizeType;
+begin
+   Result := FTree.Size;
+end;
+
+constructor TSkipListSet.Create;
+begin
+   inherited Create;
+   FList := TIntegerConcurrentSkipList.Create;
+   FList.RepeatedItems := false;
+end;
+
+destructor TSkipListSet.Destroy;
+begin
+   FList.Free;
+   inherited;
+end;
+
+function TSkipListSet.Has(key : Integer) : Boolean;
+begin
+   Result := FList.Has(key);
+end;
+
+function TSkipListSet.Insert(key : Integer) : Boolean;
+begin
+   Result := FList.Insert(key);
+end;
+
+function TSkipListSet.Delete(key : Integer) : Boolean;
+begin
+   Result := FList.Delete(key) <> 0;
+end;
+
+function TSkipListSet.Scan(key, count : Integer) : Int64;
+var
+   iter : TIntegerSetIterator;
+   scan : SizeType;
+begin
+   Result := 0;
+   scan := FList.BeginScan;
+   try
+      iter := FList.LowerBound(key);
+      while (count > 0) and not iter.IsFinish do
+      begin
+         Inc(Result, iter.Item);
+         iter.Advance;
+         Dec(count);
+      end;
+      iter.Free;
+   finally
+      FList.EndScan(scan);
+   end;
+end;
+
+function TSkipListSet.Size : SizeType;
+begin
+   Result := FList.Size;
+end;
+
+{ ---------------------------- threads ------------------------------- }
+
+constructor TWorker.Create(aset : TBenchSet; count : Integer; seed : Cardinal);
+begin
+   FSet := aset;
+   FCount := count;
+   FRandom := seed;
+   FInserted := 0;
+   FDeleted := 0;
+   FSum := 0;
+   inherited Create(true);
+end;
+
+function TWorker.NextRandom : Cardinal;
+begin
+   { xorshift }
+   FRandom := FRandom xor (FRandom shl 13);
+   FRandom := FRandom xor (FRandom shr 17);
+   FRandom := FRandom xor (FRandom shl 5);
+   Result := FRandom;
+end;
+
+procedure TWorker.Execute;
+var
+   i, key, kind : Integer;
+begin
+   for i := 1 to FCount do
+   begin
+      key := NextRandom mod KEY_RANGE;
+      kind := NextRandom mod 100;
+      if kind < INSERT_PERCENT then
+      begin
+         if FSet.Insert(key) then
+            Inc(FInserted);
+      end else if kind < INSERT_PERCENT + DELETE_PERCENT then
+      begin
+         if FSet.Delete(key) then
+            Inc(FDeleted);
+      end else if kind < INSERT_PERCENT + DELETE_PERCENT + SCAN_PERCENT then
+      begin
+         Inc(FSum, FSet.Scan(key, SCAN_LENGTH));
+      end else
+      begin
+         if FSet.Has(key) then
+            Inc(FSum, key);
+      end;
+   end;
+end;
+
+{ ---------------------------- measurements ------------------------------- }
+
+function MSecs : Comp;
+begin
+   Result := TimeStampToMSecs(DateTimeToTimeStamp(Now));
+end;
+
+procedure Measure(const name : String; aset : TBenchSet; threads : Integer);
+var
+   workers : array[1..MAX_THREADS] of TWorker;
+   i, initial, inserted, deleted : Integer;
+   tm : Comp;
+begin
+   { fill half of the key range so that lookups succeed about half of
+     the time }
+   initial := 0;
+   i := 0;
+   while i < KEY_RANGE do
+   begin
+      if aset.Insert(i) then
+         Inc(initial);
+      Inc(i, 2);
+   end;
+
+   for i := 1 to threads do
+      workers[i] := TWorker.Create(aset, OPERATIONS div threads, 7919 * i);
+
+   tm := MSecs;
+   for i := 1 to threads do
+      workers[i].Start;
+   inserted := 0;
+   deleted := 0;
+   for i := 1 to threads do
+   begin
+      workers[i].WaitFor;
+      Inc(inserted, workers[i].FInserted);
+      Inc(deleted, workers[i].FDeleted);
+   end;
+   tm := MSecs - tm;
+   if tm = 0 then
+      tm := 1;
+
+   Write(name, ', ', threads, ' thread(s): ',
+         OPERATIONS / tm / 1000 :0:2, ' M ops/s');
+   if aset.Size <> initial + inserted - deleted then
+      Write(' - FAILED: wrong size');
+   WriteLn;
+
+   for i := 1 to threads do
+      workers[i].Free;
+   aset.Free;
+end;
+
+var
+   threads : Integer;
+
+begin
+   WriteLn('Mixed workload: ', 100 - INSERT_PERCENT - DELETE_PERCENT - SCAN_PERCENT,
+           '% lookups, ', INSERT_PERCENT, '% insertions, ', DELETE_PERCENT,
+           '% deletions, ', SCAN_PERCENT, '% scans of ', SCAN_LENGTH, ' items');
+   threads := 1;
+   while threads <= MAX_THREADS do
+   begin
+      Measure('locked TAvlTree', TLockedSet.Create, threads);
+      Measure('TConcurrentSkipList', TSkipListSet.Create, threads);
+      threads := threads * 2;
+   end;
+end.
@@ -6,6 +6,7 @@
 ./testallconts | tee testallconts.log
 ./testallalgs | tee testallalgs.log
 ./teststralgs | tee teststralgs.log
+./testinstances | tee testinstances.log
 
 grep FAILED *.log
 exit 0
@@ -3,6 +3,9 @@ program testallalgs;
 {$apptype console }
 
 uses
+{$ifdef unix }
+   cthreads,
+{$endif }
    testalgs, testutils, adtcont, adtcontbase, adtlist, adtqueue, adtarray;
 
 var
@@ -43,4 +46,16 @@ begin
    a.Destroy;
    FinishDestruction;
    FinishTest;
+
+   StartTest('External sort');
+   testalgs.TestExternalSort;
+   FinishTest;
+
+   StartTest('Parallel algorithms');
+   testalgs.TestParallelAlgs;
+   FinishTest;
+
+   StartTest('Algorithm fast paths');
+   testalgs.TestFastPaths;
+   FinishTest;
 end.
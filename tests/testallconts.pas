@@ -3,9 +3,14 @@ program testallconts;
 {$apptype console }
 
 uses
-   SysUtils, testutils, tester, testcont, testbintree, testtree, adtcont,
-   adt23tree, adtavltree, adtbinomqueue, adtbintree, adttree, adtbstree, adthash,
-   adtlist, adtarray, adtqueue, adtsplaytree;
+{$ifdef unix }
+   cthreads,
+{$endif }
+   SysUtils, testutils, tester, testcont, testbintree, testtree, teststrpool,
+   testconcqueue, testperfhash, adtcont, adt23tree, adtavltree, adtbinomqueue,
+   adtbintree, adttree, adtbstree, adthash, adtlist, adtarray, adtqueue,
+   adtconcqueue, adtconcskiplist, adtpersistent, adtsplaytree, adtfilter,
+   adtcuckoo, adtstaticset;
 
 procedure TestUsing(t : TTester); overload;
 begin
@@ -43,12 +48,19 @@ begin
    { ----------------- queues & arrays ---------------------- }
    TestUsing(TRandomAccessContainerTester.Create('TArray', 'TArrayIterator',
                                                  TArray.Create));
+   TestUsing(TRandomAccessContainerTester.Create('TTieredVector',
+                                                 'TTieredVectorIterator',
+                                                 TTieredVector.Create));
    TestUsing(TRandomAccessContainerTester.Create('TSegDeque',
                                                  'TSegDequeIterator',
                                                  TSegDeque.Create));
    TestUsing(TRandomAccessContainerTester.Create('TCircularDeque',
                                                  'TCircularDequeIterator',
                                                  TCircularDeque.Create));
+   TestUsing(TConcurrentQueueTester.Create('TSpscQueue', '',
+                                           TSpscQueue.Create(4096)));
+   TestUsing(TConcurrentQueueTester.Create('TMpmcQueue', '',
+                                           TMpmcQueue.Create(4096)));
 
    { ------------------- basic trees ------------------------ }
    TestUsing(TTreeTester.Create('TTree', 'TTreeIterator', TTree.Create));
@@ -60,16 +72,42 @@ begin
                                    THashTable.Create));
    TestUsing(THashSetTester.Create('TScatterTable', 'TScatterTableIterator',
                                    TScatterTable.Create));
+   TestUsing(THashSetTester.Create('TCuckooHashTable', 'TCuckooHashTableIterator',
+                                   TCuckooHashTable.Create));
 
    { -------------------- string hash sets -------------------------- }
    TestUsing(TStringHashSetTester.Create('TStringHashTable', 'TStringHashTableIterator',
                                    TStringHashTable.Create));
    TestUsing(TStringHashSetTester.Create('TStringScatterTable', 'TStringScatterTableIterator',
                                    TStringScatterTable.Create));
+   TestUsing(TStringHashSetTester.Create('TStringCuckooHashTable',
+                                         'TStringCuckooHashTableIterator',
+                                         TStringCuckooHashTable.Create));
+
+   { -------------------- string pool -------------------------- }
+   TestStringPool;
+
+   { ------------------ perfect hash index ---------------------- }
+   TestPerfectHash;
 
    { -------------------- integer hash sets -------------------------- }
    TestUsing(TIntegerSetTester.Create('TIntegerHashTable', 'TIntegerHashTableIterator',
                                       TIntegerHashTable.Create));
+   TestUsing(TIntegerSetTester.Create('TIntegerCuckooHashTable',
+                                      'TIntegerCuckooHashTableIterator',
+                                      TIntegerCuckooHashTable.Create));
+
+   { -------------------- filtered sets -------------------------- }
+   TestUsing(TFilteredSetTester.Create('TFilteredSet', 'TFilteredSetIterator',
+                                       TFilteredSet.Create(TAvlTree.Create,
+                                                           TBloomFilter.Create(4096, 10,
+                                                              TTestObjectHasher.Create))));
+   TestUsing(TStringSetTester.Create('TStringFilteredSet', 'TStringFilteredSetIterator',
+                                     TStringFilteredSet.Create(TStringHashTable.Create,
+                                                               TStringCuckooFilter.Create(4096))));
+   TestUsing(TIntegerSetTester.Create('TIntegerFilteredSet', 'TIntegerFilteredSetIterator',
+                                      TIntegerFilteredSet.Create(TIntegerHashTable.Create,
+                                                                 TIntegerCuckooFilter.Create(4096))));
 
    { ---------------- sets based on trees --------------------- }
    TestUsing(TSortedSetTester.Create('TSplayTree', 'TBinaryTreeIterator',
@@ -82,6 +120,15 @@ begin
    TestUsing(TConcatenableSortedSetTester.Create('T23Tree',
                                                  'T23TreeIterator',
                                                  T23Tree.Create));
+   TestUsing(TPersistentSortedSetTester.Create('TPersistentAvlTree',
+                                               'TPersistentAvlTreeIterator',
+                                               TPersistentAvlTree.Create));
+   TestUsing(TSortedSetTester.Create('TConcurrentSkipList',
+                                     'TConcurrentSkipListIterator',
+                                     TConcurrentSkipList.Create));
+   TestUsing(TSortedSetTester.Create('TStaticSortedSet',
+                                     'TStaticSortedSetIterator',
+                                     TStaticSortedSet.Create));
 
    { ---------------- string sets based on trees --------------------- }
    TestUsing(TStringSetTester.Create('TStringSplayTree', 'TStringBinaryTreeIterator',
@@ -93,6 +140,15 @@ begin
                                      TStringBinarySearchTree.Create));
    TestUsing(TStringSetTester.Create('TString23Tree', 'TString23TreeIterator',
                                                  TString23Tree.Create));
+   TestUsing(TStringSetTester.Create('TStringPersistentAvlTree',
+                                     'TStringPersistentAvlTreeIterator',
+                                     TStringPersistentAvlTree.Create));
+   TestUsing(TStringSetTester.Create('TStringConcurrentSkipList',
+                                     'TStringConcurrentSkipListIterator',
+                                     TStringConcurrentSkipList.Create));
+   TestUsing(TStringSetTester.Create('TStringStaticSortedSet',
+                                     'TStringStaticSortedSetIterator',
+                                     TStringStaticSortedSet.Create));
 
    { ---------------- integer sets based on trees --------------------- }
    TestUsing(TIntegerSetTester.Create('TIntegerSplayTree', 'TIntegerBinaryTreeIterator',
@@ -104,6 +160,15 @@ begin
                                       TIntegerBinarySearchTree.Create));
    TestUsing(TIntegerSetTester.Create('TInteger23Tree', 'TInteger23TreeIterator',
                                       TInteger23Tree.Create));
+   TestUsing(TIntegerSetTester.Create('TIntegerPersistentAvlTree',
+                                      'TIntegerPersistentAvlTreeIterator',
+                                      TIntegerPersistentAvlTree.Create));
+   TestUsing(TIntegerSetTester.Create('TIntegerConcurrentSkipList',
+                                      'TIntegerConcurrentSkipListIterator',
+                                      TIntegerConcurrentSkipList.Create));
+   TestUsing(TIntegerSetTester.Create('TIntegerStaticSortedSet',
+                                      'TIntegerStaticSortedSetIterator',
+                                      TIntegerStaticSortedSet.Create));
 
    { --------------------- priority queues -------------------- }
    TestUsing(TPriorityQueueTester.Create('TBinomialQueue',
@@ -498,8 +498,59 @@ begin
    FinishTest;
 end;
 
+procedure TestStringDynamicArray;
+var
+   da : TStringDynamicArray;
+   i : IndexType;
+   s : String;
+   ok : Boolean;
+begin
+   StartTest('TStringDynamicArray (relocation)');
+   
+   da := nil;
+   ArrayAllocate(da, 10, 0);
+   for i := 0 to 99 do
+      ArrayPushBack(da, IntToStr(i));
+   
+   { ---------------- Test: ArrayReserveItems -------------------- }
+   ArrayReserveItems(da, 10, 5);
+   ok := da^.Size = 105;
+   for i := 0 to 104 do
+   begin
+      if i < 10 then
+         ok := ok and (da^.Items[da^.StartIndex + i] = IntToStr(i))
+      else if i < 15 then
+         ok := ok and (da^.Items[da^.StartIndex + i] = '')
+      else
+         ok := ok and (da^.Items[da^.StartIndex + i] = IntToStr(i - 5));
+   end;
+   Test(ok, 'ArrayReserveItems', 'items not relocated properly');
+   
+   for i := 10 to 14 do
+      da^.Items[da^.StartIndex + i] := 'new';
+   
+   { ---------------- Test: ArrayRemoveItems -------------------- }
+   ArrayRemoveItems(da, 10, 5);
+   ok := da^.Size = 100;
+   for i := 0 to 99 do
+      ok := ok and (da^.Items[da^.StartIndex + i] = IntToStr(i));
+   Test(ok, 'ArrayRemoveItems', 'items not relocated properly');
+   
+   { ---------------- Test: ArrayPushFront / ArrayPopFront (move) --------- }
+   ArrayPushFront(da, 'front', true);
+   s := ArrayPopFront(da, true);
+   ok := (s = 'front') and (da^.Size = 100);
+   for i := 0 to 99 do
+      ok := ok and (da^.Items[da^.StartIndex + i] = IntToStr(i));
+   Test(ok, 'ArrayPushFront / ArrayPopFront (move)');
+   
+   ArrayDeallocate(da);
+   FinishTest;
+end;
+
 begin
    TestDynamicArray;
    TestCircularArray;
    TestDynamicBuffer;
+   TestStringDynamicArray;
 end.
@@ -0,0 +1,151 @@
+program testinstances;
+
+{ tests the containers instantiated for the item types which are not
+  generated by default - Int64, QWord, Double and the record type from
+  adtrecord.inc; they are only compiled when the library is made with
+  `make instances', otherwise this program does nothing }
+
+uses
+   testutils, SysUtils, adtfunct, adtiters, adtcont, adtarray, adt23tree,
+   adtalgs;
+
+{$ifdef PASCAL_ADT_INSTANCES }
+
+const
+   ITEMS = 1000;
+
+function IdRecord(id : Int64; value : Double) : TIdRecord;
+begin
+   Result.Id := id;
+   Result.Value := value;
+end;
+
+procedure TestNumbers;
+var
+   arr : TInt64Array;
+   qtree : TQWord23Tree;
+   dtree : TDouble23Tree;
+   i : IndexType;
+   ok : Boolean;
+begin
+   StartTest('Int64, QWord and Double instantiations');
+
+   { values which do not fit in IndexType and whose differences
+     overflow it }
+   arr := TInt64Array.Create;
+   try
+      for i := 0 to ITEMS - 1 do
+      begin
+         if Odd(i) then
+            arr.PushBack(High(Int64) - i)
+         else
+            arr.PushBack(Low(Int64) + i);
+      end;
+      Sort(arr.RandomAccessStart, arr.RandomAccessFinish, arr.ItemComparer);
+      ok := true;
+      for i := 1 to ITEMS - 1 do
+      begin
+         if arr[i - 1] >= arr[i] then
+            ok := false;
+      end;
+      Test(ok, 'Sort (Int64)', 'items not sorted');
+   finally
+      arr.Free;
+   end;
+
+   qtree := TQWord23Tree.Create;
+   try
+      for i := 0 to ITEMS - 1 do
+         qtree.Insert(QWord(High(Int64)) + QWord(i));
+      Test(qtree.Size = ITEMS, 'Insert (QWord)');
+      Test(qtree.Has(QWord(High(Int64)) + ITEMS - 1), 'Has (QWord)');
+      Test(not qtree.Has(QWord(High(Int64)) + ITEMS), 'Has (QWord)',
+           'non-existent item found');
+      Test(qtree.Start.Item = QWord(High(Int64)), 'Start (QWord)',
+           'not the smallest item');
+   finally
+      qtree.Free;
+   end;
+
+   dtree := TDouble23Tree.Create;
+   try
+      { differences below 1 must not be truncated to 0 }
+      for i := ITEMS - 1 downto 0 do
+         dtree.Insert(i / ITEMS);
+      Test(dtree.Size = ITEMS, 'Insert (Double)');
+      Test(dtree.Has(0.5), 'Has (Double)');
+      Test(not dtree.Has(0.0005), 'Has (Double)', 'non-existent item found');
+      Test(dtree.Delete(0.001) = 1, 'Delete (Double)');
+   finally
+      dtree.Free;
+   end;
+
+   FinishTest;
+end;
+
+procedure TestRecords;
+var
+   tree : TIdRecord23Tree;
+   iter : TIdRecordSetIterator;
+   i : IndexType;
+   ok : Boolean;
+begin
+   StartTest('record instantiations');
+
+   tree := TIdRecord23Tree.Create;
+   try
+      { the records are ordered by Id only, so there are runs of equal
+        records differing in Value; the iterators must point at the
+        very record inserted, not at one equal to it }
+      tree.RepeatedItems := true;
+      ok := true;
+      for i := 0 to ITEMS - 1 do
+      begin
+         iter := tree.Start;
+         iter.Insert(IdRecord(i mod 100, i));
+         if iter.Item.Value <> i then
+            ok := false;
+      end;
+      Test(ok, 'Insert (iterator)', 'the iterator points at another record');
+      Test(tree.Size = ITEMS, 'Insert (iterator)');
+      Test(tree.Count(IdRecord(7, 0)) = ITEMS div 100, 'Count');
+
+      { delete the records with odd values through an iterator }
+      iter := tree.Start;
+      while not iter.IsFinish do
+      begin
+         if Odd(Round(iter.Item.Value)) then
+            iter.Delete
+         else
+            iter.Advance;
+      end;
+      Test(tree.Size = ITEMS div 2, 'Delete (iterator)');
+      ok := true;
+      iter := tree.Start;
+      while not iter.IsFinish do
+      begin
+         if Odd(Round(iter.Item.Value)) then
+            ok := false;
+         iter.Advance;
+      end;
+      Test(ok, 'Delete (iterator)', 'wrong records deleted');
+
+      Test(tree.Delete(IdRecord(8, 0)) = ITEMS div 100, 'Delete');
+      Test(not tree.Has(IdRecord(8, 0)), 'Has', 'deleted record found');
+   finally
+      tree.Free;
+   end;
+
+   FinishTest;
+end;
+
+{$endif PASCAL_ADT_INSTANCES }
+
+begin
+{$ifdef PASCAL_ADT_INSTANCES }
+   TestNumbers;
+   TestRecords;
+{$else }
+   WriteLn('The library was not made with `make instances'' - nothing to test.');
+{$endif }
+end.
@@ -386,7 +386,88 @@ begin
    FinishTest;
 end;
 
+procedure TestSmallSegments;
+var
+   sa : TStringSegArray;
+   i, j, first : IndexType;
+   count : SizeType;
+   buf : TStringDynamicBuffer;
+   items : array[0..20] of String;
+   ok : Boolean;
+begin
+   StartTest('TStringSegArray with small segments');
+
+   { ------------------- SegArrayAllocate ---------------------- }
+   SegArrayAllocate(sa, 4, 2, 2, 2);
+   Test((sa^.Size = 0) and (sa^.SegMask = 3) and (sa^.InnerStartIndex = 2),
+        'SegArrayAllocate');
+
+   { ------------- SegArrayPushBack + SegArrayPopFront ---------------- }
+   ok := true;
+   for i := 0 to 999 do
+   begin
+      SegArrayPushBack(sa, IntToStr(i));
+      if SegArrayPopFront(sa) <> IntToStr(i) then
+         ok := false;
+   end;
+   Test(ok and (sa^.Size = 0), 'SegArrayPopFront', 'returns wrong items');
+   Test(sa^.Segments^.Capacity = 4, 'SegArrayPushBack',
+        'the array of segments grows when used as a queue');
+
+   { ---------------------- SegArrayPushBackItems ------------------ }
+   for i := 0 to High(items) do
+      items[i] := IntToStr(i);
+   SegArrayPushBackItems(sa, items);
+   SegArrayPushBackItems(sa, items);
+   Test(sa^.Size = 2*Length(items), 'SegArrayPushBackItems', 'wrong Size');
+   ok := true;
+   for i := 0 to sa^.Size - 1 do
+   begin
+      if SegArrayGetItem(sa, i) <> IntToStr(i mod Length(items)) then
+         ok := false;
+   end;
+   Test(ok, 'SegArrayPushBackItems', 'wrong items');
+
+   { ---------------------- SegArrayGetSegment ------------------ }
+   i := 0;
+   ok := true;
+   for j := 0 to SegArraySegmentCount(sa) - 1 do
+   begin
+      SegArrayGetSegment(sa, j, buf, first, count);
+      while count <> 0 do
+      begin
+         if buf^.Items[first] <> IntToStr(i mod Length(items)) then
+            ok := false;
+         Inc(first);
+         Dec(count);
+         Inc(i);
+      end;
+   end;
+   Test(ok and (i = sa^.Size), 'SegArrayGetSegment');
+
+   { ---------------------- SegArrayPopFrontItems ------------------ }
+   Test(SegArrayPopFrontItems(sa, items) = Length(items),
+        'SegArrayPopFrontItems', 'wrong number of items');
+   ok := true;
+   for i := 0 to High(items) do
+   begin
+      if items[i] <> IntToStr(i) then
+         ok := false;
+   end;
+   Test(ok and (sa^.Size = Length(items)), 'SegArrayPopFrontItems',
+        'wrong items');
+   SegArrayPopBack(sa);
+   Test(SegArrayPopFrontItems(sa, items) = Length(items) - 1,
+        'SegArrayPopFrontItems', 'wrong number of items when too few');
+   Test(sa^.Size = 0, 'SegArrayPopFrontItems', 'wrong Size');
+
+   SegArrayDeallocate(sa);
+
+   FinishTest;
+end;
+
 begin
    TestTSegArray;
    TestTStringSegArray;
+   TestSmallSegments;
 end.
@@ -26,13 +26,22 @@ procedure TestSortedRangeAlgs(list : TListAdt); overload;
 procedure TestSortedRangeAlgs(list : TDoubleListAdt); overload;
 procedure TestSortedRangeAlgs(cont : TRandomAccessContainerAdt); overload;
 procedure TestSetAlgs(set1, set2 : TSetAdt); overload;
+{ tests TIntegerExternalSorter from adtextsort }
+procedure TestExternalSort;
+{ tests the algorithms from adtparalgs }
+procedure TestParallelAlgs;
+{ checks that the container-specific fast paths of the algorithms
+  (see adtalgs.algUseFastPaths) give the same results as the generic
+  code }
+procedure TestFastPaths;
 
 
 implementation
 
 uses
    adtalgs, testutils, adtfunct, adtcontbase, adtiters, adtmsg,
-   SysUtils, adtlist;
+   SysUtils, Classes, adtlist, adttopk, adtextsort, adtarray, adtparalgs,
+   adtqueue, adtavltree, adthash, adtutils;
 
 type
    TChanger = class (TFunctor, IUnaryFunctor)
@@ -42,11 +51,27 @@ type
       function Perform(obj : TObject) : TObject;
    end;
 
+   { negates the value of the object; safe to use from many threads }
+   TNegator = class (TFunctor, IUnaryFunctor)
+   public
+      function Perform(obj : TObject) : TObject;
+   end;
+
    TTestSum = class (TFunctor, IBinaryFunctor)
    public
       function Perform(obj1, obj2 : TObject) : TObject;
    end;
 
+   TIsOddInteger = class (TFunctor, IIntegerUnaryPredicate)
+   public
+      function Test(aitem : Integer) : Boolean;
+   end;
+
+   TIntegerNegation = class (TFunctor, IIntegerUnaryFunctor)
+   public
+      function Perform(aitem : Integer) : Integer;
+   end;
+
    TPartitionFunctor = class
    public
       function Partition(start, finish : TForwardIterator;
@@ -123,12 +148,28 @@ begin
    Result := obj;
 end;
 
+function TNegator.Perform(obj : TObject) : TObject;
+begin
+   TTestObject(obj).Value := -TTestObject(obj).Value;
+   Result := obj;
+end;
+
 function TTestSum.Perform(obj1, obj2 : TObject) : TObject;
 begin
    Result := TTestObject.Create(TTestObject(obj1).Value +
                                    TTestObject(obj2).Value);
 end;
 
+function TIsOddInteger.Test(aitem : Integer) : Boolean;
+begin
+   Result := Odd(aitem);
+end;
+
+function TIntegerNegation.Perform(aitem : Integer) : Integer;
+begin
+   Result := -aitem;
+end;
+
 function TNormalPartition.Partition(start, finish : TForwardIterator;
                                     const pred : IUnaryPredicate) : TForwardIterator;
 begin
@@ -670,6 +711,11 @@ var
    obj : TObject;
    m, n, count : SizeType;
    perc : Double;
+   list : TSingleList;
+   topk : TTopK;
+   pred : IUnaryPredicate;
+   found : TObject;
+   ok : Boolean;
 begin
    TestMutatingAlgs(TDoubleListAdt(cont));
 
@@ -717,11 +763,58 @@ begin
    CheckRange(cont.RandomAccessStart,cont.RandomAccessFinish,
               true, 1, cont.Size, 'MergeSort');
 
+   InsertRandomItems(cont);
+   TimSort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
+   CheckRange(cont.RandomAccessStart,cont.RandomAccessFinish,
+              true, 1, cont.Size, 'TimSort');
+
+   { nearly sorted: a few items swapped with their neighbours }
+   for i := 1 to 10 do
+   begin
+      j := (i * 97) mod (cont.Size - 1);
+      cont.RandomAccessStart.ExchangeItemsAt(j, j + 1);
+   end;
+   TimSort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
+   CheckRange(cont.RandomAccessStart,cont.RandomAccessFinish,
+              true, 1, cont.Size, 'TimSort (nearly sorted)');
+
+   Reverse(cont.RandomAccessStart, cont.RandomAccessFinish);
+   StableSort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
+   CheckRange(cont.RandomAccessStart,cont.RandomAccessFinish,
+              true, 1, cont.Size, 'StableSort (reversed)');
+
    InsertRandomItems(cont);
    QuickSort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
    CheckRange(cont.RandomAccessStart, cont.RandomAccessFinish,
               true, 1, cont.Size, 'QuickSort');
 
+   InsertRandomItems(cont);
+   PdqSort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
+   CheckRange(cont.RandomAccessStart, cont.RandomAccessFinish,
+              true, 1, cont.Size, 'PdqSort');
+
+   PdqSort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
+   CheckRange(cont.RandomAccessStart, cont.RandomAccessFinish,
+              true, 1, cont.Size, 'PdqSort (sorted)');
+
+   Reverse(cont.RandomAccessStart, cont.RandomAccessFinish);
+   PdqSort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
+   CheckRange(cont.RandomAccessStart, cont.RandomAccessFinish,
+              true, 1, cont.Size, 'PdqSort (reversed)');
+
+   cont.Clear;
+   for j := 0 to 999 do
+      cont.PushBack(TTestObject.Create((j * 7) mod 5));
+   PdqSort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
+   ok := true;
+   for j := 1 to cont.Size - 1 do
+   begin
+      if TTestObject(cont.GetItem(j - 1)).Value >
+            TTestObject(cont.GetItem(j)).Value then
+         ok := false;
+   end;
+   Test(ok, 'PdqSort (many duplicates)');
+
    InsertRandomItems(cont);
    Sort(cont.RandomAccessStart, cont.RandomAccessFinish, cmp);
    CheckRange(cont.RandomAccessStart, cont.RandomAccessFinish,
@@ -756,6 +849,93 @@ begin
               ' instead of ' + IntToStr(k));
    end;
 
+   { ------------------------- PartialSort ------------------------- }
+   StartSilentMode;
+   for i := 1 to 100 do
+   begin
+      if i = 100 then
+         StopSilentMode;
+      InsertRandomItems(cont);
+      k := Random(cont.Size + 1);
+      PartialSort(cont.RandomAccessStart, Advance(cont.RandomAccessStart, k),
+                  cont.RandomAccessFinish, cmp);
+      CheckRange(cont.RandomAccessStart, Advance(cont.RandomAccessStart, k),
+                 true, 1, k, 'PartialSort');
+   end;
+
+   { ------------------------- NthElement -------------------------- }
+   StartSilentMode;
+   for i := 1 to 100 do
+   begin
+      if i = 100 then
+         StopSilentMode;
+      InsertRandomItems(cont);
+      k := Random(cont.Size);
+      NthElement(cont.RandomAccessStart, Advance(cont.RandomAccessStart, k),
+                 cont.RandomAccessFinish, cmp);
+      ok := TTestObject(cont.GetItem(k)).Value = k + 1;
+      for j := 0 to cont.Size - 1 do
+      begin
+         if (j < k) and (TTestObject(cont.GetItem(j)).Value > k + 1) then
+            ok := false;
+         if (j > k) and (TTestObject(cont.GetItem(j)).Value < k + 1) then
+            ok := false;
+      end;
+      Test(ok, 'NthElement', 'wrong item at ' + IntToStr(k) +
+              ' or the range not partitioned around it');
+   end;
+
+   { ----------------------- PartialSortCopy ----------------------- }
+   list := TSingleList.Create;
+   try
+      InsertRandomItems(cont);
+      n := PartialSortCopy(cont.ForwardStart, cont.ForwardFinish,
+                           list.ForwardStart, 100, cmp, TestObjectCopier);
+      Test(n = 100, 'PartialSortCopy', 'wrong number of items written');
+      CheckRange(list.ForwardStart, list.ForwardFinish,
+                 true, 1, 100, 'PartialSortCopy');
+   finally
+      list.Free;
+   end;
+
+   { ---------------------------- TTopK ---------------------------- }
+   list := TSingleList.Create;
+   list.OwnsItems := false;
+   topk := TTopK.Create(100);
+   topk.ItemComparer := cmp;
+   topk.OwnsItems := false;
+   try
+      InsertRandomItems(cont);
+      topk.InsertRange(cont.ForwardStart, cont.ForwardFinish, nil);
+      Test(topk.Size = 100, 'TTopK', 'wrong number of items kept');
+      Test(TTestObject(topk.First).Value = cont.Size - 99, 'TTopK.First');
+      topk.ExtractSorted(list.ForwardStart);
+      Test(topk.Empty, 'TTopK.ExtractSorted', 'items left in the queue');
+      CheckRange(list.ForwardStart, list.ForwardFinish,
+                 false, cont.Size, 100, 'TTopK.ExtractSorted');
+
+      { delete the 50 smallest of the items kept }
+      topk.InsertRange(cont.ForwardStart, cont.ForwardFinish, nil);
+      obj := TTestObject.Create(cont.Size - 49);
+      pred := TLessBinder.Create(cmp, obj);
+      Test(topk.FindIf(pred, found) and
+              (TTestObject(found).Value < cont.Size - 49), 'TTopK.FindIf');
+      Test(topk.DeleteIf(pred) = 50, 'TTopK.DeleteIf',
+           'returns wrong number of items');
+      Test(not topk.FindIf(pred, found), 'TTopK.DeleteIf',
+           'not all items deleted');
+      Test(TTestObject(topk.First).Value = cont.Size - 49, 'TTopK.DeleteIf',
+           'wrong First');
+      pred := nil;
+      obj.Free;
+      list.Clear;
+      topk.ExtractSorted(list.ForwardStart);
+      CheckRange(list.ForwardStart, list.ForwardFinish,
+                 false, cont.Size, 50, 'TTopK.DeleteIf');
+   finally
+      topk.Free;
+      list.Free;
+   end;
 end;
 
 procedure TestDeletingAlgs(list : TListAdt);
@@ -801,8 +981,12 @@ begin
 end;
 
 procedure TestSortedRangeAlgs(list : TListAdt);
+const
+   MERGE_RANGES = 7;
 var
    list2, list3 : TSingleList;
+   lists        : array[0..MERGE_RANGES - 1] of TSingleList;
+   starts, finishes : array[0..MERGE_RANGES - 1] of TForwardIterator;
    cmp          : IBinaryComparer;
    copier       : IUnaryFunctor;
    i, j         : Indextype;
@@ -810,6 +994,8 @@ var
 begin
    list2 := nil;
    list3 := nil;
+   for i := 0 to MERGE_RANGES - 1 do
+      lists[i] := nil;
 
    try
       cmp := TestObjectComparer;
@@ -853,6 +1039,31 @@ begin
       Test(list.Empty, 'Merge', 'the second list not cleared');
       Test(list2.Empty, 'Merge', 'the first list not cleared');
 
+      { ------------------------ MergeMany ---------------------- }
+      for i := 0 to MERGE_RANGES - 1 do
+         lists[i] := TSingleList.Create;
+      { the last range stays empty }
+      for i := 1 to 1000 do
+         lists[i mod (MERGE_RANGES - 1)].PushBack(TTestObject.Create(i));
+      for i := 0 to MERGE_RANGES - 1 do
+      begin
+         starts[i] := lists[i].ForwardStart;
+         finishes[i] := lists[i].ForwardFinish;
+      end;
+
+      MergeManyCopy(starts, finishes, list3.ForwardStart, cmp, copier);
+      Test(list3.Size = 1000, 'MergeManyCopy', 'wrong size');
+      CheckRange(list3.ForwardStart, list3.ForwardFinish,
+                 true, 1, list3.Size, 'MergeManyCopy');
+      list3.Clear;
+
+      MergeMany(starts, finishes, list3.ForwardStart, cmp);
+      Test(list3.Size = 1000, 'MergeMany', 'wrong size');
+      CheckRange(list3.ForwardStart, list3.ForwardFinish,
+                 true, 1, list3.Size, 'MergeMany');
+      for i := 0 to MERGE_RANGES - 1 do
+         Test(lists[i].Empty, 'MergeMany', 'a source list not cleared');
+
       { ----------------- Unique -------------------------- }
       list.Clear;
       for i := 1 to 10000 do
@@ -872,6 +1083,8 @@ begin
    finally
       list2.Free;
       list3.Free;
+      for i := 0 to MERGE_RANGES - 1 do
+         lists[i].Free;
    end;
 end;
 
@@ -895,6 +1108,7 @@ const
    ITEMS_NUM = 1000;
 var
    set3, set4 : TSetAdt;
+   list       : TSingleList;
    i          : Indextype;
    obj        : TTestObject;
    copier     : IUnaryFunctor;
@@ -906,6 +1120,7 @@ begin
    cmp := TTestObjectComparer.Create;
    set3 := nil;
    set4 := nil;
+   list := nil;
    set1.Clear;
    set2.Clear;
    set1.Repeateditems := true;
@@ -1023,7 +1238,35 @@ begin
       end;
       StopSilentMode;
 
+      { ---------------------- MergeMany ----------------------- }
+      if (set1 is TSortedSetAdt) and (set2 is TSortedSetAdt) then
+      begin
+         set1.Clear;
+         set2.Clear;
+         for i := 1 to 2*ITEMS_NUM do
+         begin
+            if (i and $01) <> 0 then
+               set1.Insert(TTestObject.Create(i))
+            else
+               set2.Insert(TTestObject.Create(i));
+         end;
+         list := TSingleList.Create;
+         MergeManyCopy([TSortedSetAdt(set1), TSortedSetAdt(set2)],
+                       list.ForwardStart, copier);
+         Test(list.Size = 2*ITEMS_NUM, 'MergeManyCopy', 'wrong size');
+         CheckRange(list.ForwardStart, list.ForwardFinish,
+                    true, 1, 2*ITEMS_NUM, 'MergeManyCopy (sets)');
+         list.Clear;
+         MergeMany([TSortedSetAdt(set1), TSortedSetAdt(set2)],
+                   list.ForwardStart);
+         CheckRange(list.ForwardStart, list.ForwardFinish,
+                    true, 1, 2*ITEMS_NUM, 'MergeMany (sets)');
+         Test(set1.Empty and set2.Empty, 'MergeMany',
+              'the sets not cleared');
+      end;
+
    finally
+      list.Free;
       if set4 <> nil then
       begin
          StartDestruction(set4.Size, 'set4.Destroy');
@@ -1041,4 +1284,525 @@ begin
    WriteLn('** Finished testing general set algorithms.');
 end;
 
+{ sorts strings of different lengths with the default representation
+  (a nil streamer), which the runs have to read back }
+procedure TestStringExternalSort;
+const
+   ITEMS = 3000;
+var
+   sorter : TStringExternalSorter;
+   source, dest : TMemoryStream;
+   str, prev : String;
+   i, count : Integer;
+   ok : Boolean;
+begin
+   source := TMemoryStream.Create;
+   dest := TMemoryStream.Create;
+   sorter := TStringExternalSorter.Create(nil, nil);
+   try
+      for i := 1 to ITEMS do
+      begin
+         { the empty string and long ones among them }
+         str := StringOfChar(Chr(Ord('a') + Random(26)), Random(300));
+         StreamWriteItem(source, str, nil);
+      end;
+
+      sorter.RunSize := 250;
+      sorter.BufferSize := 50;
+      sorter.MaxFanIn := 3;
+      source.Position := 0;
+      sorter.Sort(source, dest);
+
+      dest.Position := 0;
+      ok := true;
+      count := 0;
+      prev := '';
+      while dest.Position < dest.Size do
+      begin
+         StreamReadItem(dest, str, nil);
+         if str < prev then
+            ok := false;
+         prev := str;
+         Inc(count);
+      end;
+      Test(ok, 'TStringExternalSorter.Sort', 'items not sorted');
+      Test(count = ITEMS, 'TStringExternalSorter.Sort', 'items lost');
+   finally
+      sorter.Free;
+      source.Free;
+      dest.Free;
+   end;
+end;
+
+procedure TestExternalSort;
+const
+   ITEMS = 10000;
+var
+   sorter : TIntegerExternalSorter;
+   source, dest : TMemoryStream;
+   i, x, prev, count : Integer;
+   sum1, sum2 : Int64;
+   overlap, ok : Boolean;
+begin
+   WriteLn('Testing TExternalSorter...');
+   source := TMemoryStream.Create;
+   dest := TMemoryStream.Create;
+   sorter := TIntegerExternalSorter.Create(nil, nil);
+   try
+      sum1 := 0;
+      for i := 1 to ITEMS do
+      begin
+         x := Random(ITEMS div 2);
+         source.WriteBuffer(x, SizeOf(Integer));
+         Inc(sum1, x);
+      end;
+
+      { small runs, buffers and fan-in, so that there are several
+        merge passes and the buffers are refilled many times }
+      sorter.RunSize := 300;
+      sorter.BufferSize := 100;
+      sorter.MaxFanIn := 4;
+      for overlap := false to true do
+      begin
+         sorter.OverlapIo := overlap;
+         source.Position := 0;
+         dest.Clear;
+         sorter.Sort(source, dest);
+
+         dest.Position := 0;
+         ok := true;
+         count := 0;
+         sum2 := 0;
+         prev := Low(Integer);
+         while dest.Position < dest.Size do
+         begin
+            dest.ReadBuffer(x, SizeOf(Integer));
+            if x < prev then
+               ok := false;
+            prev := x;
+            Inc(sum2, x);
+            Inc(count);
+         end;
+         Test(ok, 'TExternalSorter.Sort', 'items not sorted');
+         Test((count = ITEMS) and (sum1 = sum2), 'TExternalSorter.Sort',
+              'items lost or changed');
+      end;
+
+      { an empty source }
+      source.Clear;
+      dest.Clear;
+      sorter.Sort(source, dest);
+      Test(dest.Size = 0, 'TExternalSorter.Sort (empty)');
+   finally
+      sorter.Free;
+      source.Free;
+      dest.Free;
+   end;
+   TestStringExternalSort;
+end;
+
+procedure TestParallelAlgs;
+const
+   ITEMS = 10000;
+var
+   pool : TTaskPool;
+   arr, arr2 : TArray;
+   cmp : IBinaryComparer;
+   obj : TTestObject;
+   iter : TRandomAccessIterator;
+   pair : TForwardIteratorPair;
+   negator : IUnaryFunctor;
+   i, j, dups : IndexType;
+   ok : Boolean;
+begin
+   WriteLn('Testing parallel algorithms...');
+   { small chunks, so that there are many of them }
+   pool := TTaskPool.Create(4);
+   pool.ChunkSize := 100;
+   cmp := TestObjectComparer;
+   negator := TNegator.Create;
+   arr := TArray.Create;
+   arr2 := TArray.Create;
+   obj := TTestObject.Create(0);
+   try
+      for i := 1 to ITEMS do
+         arr.PushBack(TTestObject.Create(i));
+
+      { ------------------- ParallelForEach -------------------- }
+      StartDestruction(0, 'ParallelForEach');
+      ParallelForEach(arr.RandomAccessStart, arr.RandomAccessFinish,
+                      negator, pool);
+      FinishDestruction;
+      ok := true;
+      for i := 0 to ITEMS - 1 do
+      begin
+         if TTestObject(arr[i]).Value <> -(i + 1) then
+            ok := false;
+      end;
+      Test(ok, 'ParallelForEach', 'items not changed');
+      ParallelForEach(arr.RandomAccessStart, arr.RandomAccessFinish,
+                      negator, pool);
+      CheckRange(arr.ForwardStart, arr.ForwardFinish,
+                 true, 1, ITEMS, 'ParallelForEach');
+
+      { ------------------- ParallelFind -------------------- }
+      obj.Value := ITEMS div 2 + 17;
+      iter := ParallelFind(arr.RandomAccessStart, arr.RandomAccessFinish,
+                           EqualTo(cmp, obj), pool);
+      Test(iter.Index = ITEMS div 2 + 16, 'ParallelFind', 'wrong item found');
+      obj.Value := ITEMS + 1;
+      iter := ParallelFind(arr.RandomAccessStart, arr.RandomAccessFinish,
+                           obj, cmp, pool);
+      Test(iter.IsFinish, 'ParallelFind', 'non-existent item found');
+
+      { ------------------- ParallelCount -------------------- }
+      obj.Value := 1001;
+      Test(ParallelCount(arr.RandomAccessStart, arr.RandomAccessFinish,
+                         LessThan(cmp, obj), pool) = 1000, 'ParallelCount');
+
+      { ------------- ParallelMinimal, ParallelMaximal ------------- }
+      TTestObject(arr[ITEMS div 3]).Value := -1;
+      TTestObject(arr[ITEMS div 2]).Value := -1;
+      iter := ParallelMinimal(arr.RandomAccessStart, arr.RandomAccessFinish,
+                              cmp, pool);
+      Test(iter.Index = ITEMS div 3, 'ParallelMinimal',
+           'not the first minimal item');
+      iter := ParallelMaximal(arr.RandomAccessStart, arr.RandomAccessFinish,
+                              cmp, pool);
+      Test(iter.Index = ITEMS - 1, 'ParallelMaximal');
+      TTestObject(arr[ITEMS div 3]).Value := ITEMS div 3 + 1;
+      TTestObject(arr[ITEMS div 2]).Value := ITEMS div 2 + 1;
+
+      { ---------------------- ParallelCopy ------------------------ }
+      for i := 1 to ITEMS do
+         arr2.PushBack(TTestObject.Create(0));
+      StartDestruction(ITEMS, 'ParallelCopy');
+      ParallelCopy(arr.RandomAccessStart, arr.RandomAccessFinish,
+                   arr2.RandomAccessStart, TestObjectCopier, pool);
+      FinishDestruction;
+      CheckRange(arr2.ForwardStart, arr2.ForwardFinish,
+                 true, 1, ITEMS, 'ParallelCopy');
+
+      { --------------- ParallelEqual, ParallelMismatch ---------------- }
+      Test(ParallelEqual(arr.RandomAccessStart, arr.RandomAccessFinish,
+                         arr2.RandomAccessStart, EqualTest(cmp), pool),
+           'ParallelEqual');
+      TTestObject(arr2[7777]).Value := 0;
+      TTestObject(arr2[8888]).Value := 0;
+      Test(not ParallelEqual(arr.RandomAccessStart, arr.RandomAccessFinish,
+                             arr2.RandomAccessStart, EqualTest(cmp), pool),
+           'ParallelEqual');
+      pair := ParallelMismatch(arr.RandomAccessStart, arr.RandomAccessFinish,
+                               arr2.RandomAccessStart, EqualTest(cmp), pool);
+      Test(TTestObject(pair.First.Item).Value = 7778, 'ParallelMismatch');
+
+      { -------------------- ParallelGenerate ---------------------- }
+      StartDestruction(ITEMS, 'ParallelGenerate');
+      ParallelGenerate(arr2.RandomAccessStart, arr2.RandomAccessFinish,
+                       TestObjectCopier, pool);
+      FinishDestruction;
+      Test(arr2.Size = ITEMS, 'ParallelGenerate');
+
+      { -------------------- ParallelPartition ---------------------- }
+      RandomShuffle(arr.RandomAccessStart, arr.RandomAccessFinish);
+      obj.Value := ITEMS div 3;
+      iter := ParallelPartition(arr.RandomAccessStart, arr.RandomAccessFinish,
+                                LessThan(cmp, obj), pool);
+      Test(iter.Index = ITEMS div 3 - 1, 'ParallelPartition',
+           'wrong boundary returned');
+      ok := true;
+      for i := 0 to ITEMS - 1 do
+      begin
+         if (TTestObject(arr[i]).Value < ITEMS div 3) <> (i < iter.Index) then
+            ok := false;
+      end;
+      Test(ok, 'ParallelPartition', 'items on the wrong side');
+      Sort(arr.RandomAccessStart, arr.RandomAccessFinish, cmp);
+      CheckRange(arr.ForwardStart, arr.ForwardFinish,
+                 true, 1, ITEMS, 'ParallelPartition');
+
+      { --------------------- ParallelUnique ----------------------- }
+      { runs of 1 to 3 equal items, which cross the chunk boundaries,
+        followed by an item outside of the range }
+      StartDestruction(ITEMS, 'ParallelUnique');
+      arr2.Clear;
+      FinishDestruction;
+      dups := 0;
+      for i := 1 to ITEMS do
+      begin
+         for j := 0 to i mod 3 do
+            arr2.PushBack(TTestObject.Create(i));
+         Inc(dups, i mod 3);
+      end;
+      arr2.PushBack(TTestObject.Create(ITEMS + 1));
+      iter := arr2.RandomAccessFinish;
+      iter.Advance(-1);
+      StartDestruction(dups, 'ParallelUnique');
+      Test(ParallelUnique(arr2.RandomAccessStart, iter, cmp, pool) = dups,
+           'ParallelUnique', 'wrong number of duplicates returned');
+      FinishDestruction;
+      CheckRange(arr2.ForwardStart, arr2.ForwardFinish,
+                 true, 1, ITEMS + 1, 'ParallelUnique');
+      StartDestruction(0, 'ParallelUnique (no duplicates)');
+      Test(ParallelUnique(arr2.RandomAccessStart, arr2.RandomAccessFinish,
+                          cmp, pool) = 0, 'ParallelUnique (no duplicates)');
+      FinishDestruction;
+      Test(arr2.Size = ITEMS + 1, 'ParallelUnique (no duplicates)');
+
+      { ------------------------ empty range ------------------------- }
+      iter := ParallelMinimal(arr.RandomAccessFinish, arr.RandomAccessFinish,
+                              cmp, pool);
+      Test(iter.IsFinish, 'ParallelMinimal (empty)');
+   finally
+      obj.Free;
+      arr.Free;
+      arr2.Free;
+      pool.Free;
+   end;
+end;
+
+{ returns true if the ranges [start1,finish1) and [start2,finish2)
+  contain the same integers in the same order }
+function SameIntegers(start1, finish1,
+                      start2, finish2 : TIntegerForwardIterator) : Boolean;
+begin
+   start1 := CopyOf(start1);
+   start2 := CopyOf(start2);
+   while not (start1.Equal(finish1) or start2.Equal(finish2)) and
+            (start1.Item = start2.Item) do
+   begin
+      start1.Advance;
+      start2.Advance;
+   end;
+   Result := start1.Equal(finish1) and start2.Equal(finish2);
+   start1.Destroy;
+   start2.Destroy;
+end;
+
+{ checks that Copy into an array owning its TObject items disposes the
+  overwritten items on the fast path as well }
+procedure TestObjectCopyFastPath;
+const
+   ITEMS = 100;
+   N = 40;
+var
+   src, dest : TArray;
+   i : IndexType;
+   ok, fast : Boolean;
+begin
+   fast := algUseFastPaths;
+   src := TArray.Create;
+   dest := TArray.Create;
+   try
+      { src does not own its items, so that every object has exactly one
+        owner after the copy }
+      src.OwnsItems := false;
+      for i := 0 to N - 1 do
+         src.PushBack(TTestObject.Create(ITEMS + i));
+      for i := 0 to ITEMS - 1 do
+         dest.PushBack(TTestObject.Create(i));
+
+      algUseFastPaths := true;
+      StartDestruction(N, 'Copy (fast path, owned objects)');
+      Copy(src.RandomAccessStart, src.RandomAccessFinish,
+           Advance(dest.RandomAccessStart, ITEMS div 2), Identity);
+      FinishDestruction;
+      ok := dest.Size = ITEMS;
+      for i := 0 to ITEMS - 1 do
+      begin
+         if (i >= ITEMS div 2) and (i < ITEMS div 2 + N) then
+            ok := ok and (TTestObject(dest.Items[i]).Value = ITEMS + i - ITEMS div 2)
+         else
+            ok := ok and (TTestObject(dest.Items[i]).Value = i);
+      end;
+      Test(ok, 'Copy (fast path, owned objects)', 'wrong items');
+   finally
+      algUseFastPaths := fast;
+      src.Free;
+      StartDestruction(dest.Size, 'Copy (fast path, owned objects)');
+      dest.Free;
+      FinishDestruction;
+   end;
+end;
+
+procedure TestFastPaths;
+const
+   ITEMS = 1000;
+   { the source index, the destination index and the number of items
+     copied: no overlap, the destination inside the source, the
+     source inside the destination and a copy past the end }
+   CopyCases : array[0..3, 0..2] of IndexType = (
+      (0, 500, 400), (100, 150, 300), (300, 200, 300), (900, 950, 100)
+   );
+var
+   arr1, arr2 : TIntegerArray;
+   deque1, deque2 : TIntegerCircularDeque;
+   list1, list2 : TIntegerDoubleList;
+   sets : array[0..1] of TIntegerSetAdt;
+   iter1, iter2 : TIntegerForwardIterator;
+   dest : TIntegerRandomAccessIterator;
+   pred : IIntegerUnaryPredicate;
+   copier : IIntegerUnaryFunctor;
+   i, j, k, n : IndexType;
+   count1 : SizeType;
+   fast : Boolean;
+begin
+   WriteLn('Testing the fast paths of the algorithms...');
+   fast := algUseFastPaths;
+   arr1 := TIntegerArray.Create;
+   arr2 := TIntegerArray.Create;
+   deque1 := TIntegerCircularDeque.Create;
+   deque2 := TIntegerCircularDeque.Create;
+   list1 := TIntegerDoubleList.Create;
+   list2 := TIntegerDoubleList.Create;
+   sets[0] := TIntegerAvlTree.Create;
+   sets[1] := TIntegerHashTable.Create;
+   pred := TIsOddInteger.Create;
+   try
+      for i := 0 to ITEMS - 1 do
+      begin
+         arr1.PushBack(i);
+         arr2.PushBack(i);
+         deque1.PushBack(i);
+         deque2.PushBack(i);
+         list1.PushBack(i);
+         list2.PushBack(i);
+      end;
+      { make the items of the deques wrap around the end of the
+        circular buffer }
+      for i := 1 to ITEMS div 3 do
+      begin
+         deque1.PopFront;
+         deque1.PushBack(ITEMS + i);
+         deque2.PopFront;
+         deque2.PushBack(ITEMS + i);
+      end;
+      for k := 0 to High(sets) do
+      begin
+         sets[k].RepeatedItems := true;
+         for i := 0 to ITEMS - 1 do
+            sets[k].Insert(i div 2);
+      end;
+
+      { ------------------------- Copy ----------------------------- }
+      for k := 0 to 1 do
+      begin
+         if k = 0 then
+            copier := IntegerIdentity
+         else
+            copier := TIntegerNegation.Create;
+         for j := 0 to High(CopyCases) do
+         begin
+            n := CopyCases[j, 2];
+            algUseFastPaths := false;
+            Copy(Advance(arr1.RandomAccessStart, CopyCases[j, 0]),
+                 Advance(arr1.RandomAccessStart, CopyCases[j, 0] + n),
+                 Advance(arr1.RandomAccessStart, CopyCases[j, 1]), copier);
+            algUseFastPaths := true;
+            dest := Advance(arr2.RandomAccessStart, CopyCases[j, 1]);
+            Copy(Advance(arr2.RandomAccessStart, CopyCases[j, 0]),
+                 Advance(arr2.RandomAccessStart, CopyCases[j, 0] + n),
+                 dest, copier);
+            Test(dest.Index = CopyCases[j, 1] + n, 'Copy (fast path)',
+                 'the destination iterator not advanced');
+            Test(SameIntegers(arr1.ForwardStart, arr1.ForwardFinish,
+                              arr2.ForwardStart, arr2.ForwardFinish),
+                 'Copy (fast path)', 'different result (case ' +
+                    IntToStr(j) + ')');
+         end;
+      end;
+
+      { ------------------------- Count ---------------------------- }
+      for k := 0 to 3 do
+      begin
+         case k of
+            0: iter1 := arr1.ForwardStart;
+            1: iter1 := deque1.ForwardStart;
+            2: iter1 := list1.ForwardStart;
+            3: iter1 := sets[0].Start;
+         end;
+         iter2 := CopyOf(iter1);
+         while not iter2.IsFinish do
+            iter2.Advance;
+         algUseFastPaths := false;
+         count1 := Count(iter1, iter2, pred);
+         algUseFastPaths := true;
+         Test(Count(iter1, iter2, pred) = count1, 'Count (fast path)',
+              'different result (container ' + IntToStr(k) + ')');
+      end;
+
+      { ------------------------- Rotate --------------------------- }
+      for k := 0 to 6 do
+      begin
+         case k of
+            0: n := 0;
+            1: n := 1;
+            2: n := 17;
+            3: n := deque1.Size div 2;
+            4: n := deque1.Size - 5;
+            5: n := deque1.Size - 1;
+            6: n := deque1.Size;
+         end;
+         algUseFastPaths := false;
+         Rotate(deque1.RandomAccessStart,
+                Advance(deque1.RandomAccessStart, n), deque1.RandomAccessFinish);
+         algUseFastPaths := true;
+         Rotate(deque2.RandomAccessStart,
+                Advance(deque2.RandomAccessStart, n), deque2.RandomAccessFinish);
+         Test(SameIntegers(deque1.ForwardStart, deque1.ForwardFinish,
+                           deque2.ForwardStart, deque2.ForwardFinish),
+              'Rotate (fast path)', 'different result (n = ' +
+                 IntToStr(n) + ')');
+      end;
+
+      { ------------------------- Reverse -------------------------- }
+      for k := 0 to 2 do
+      begin
+         case k of
+            0: begin i := 0; n := list1.Size; end;
+            1: begin i := 10; n := 500; end;
+            2: begin i := 3; n := 1; end;
+         end;
+         algUseFastPaths := false;
+         Reverse(TIntegerBidirectionalIterator(Advance(list1.BidirectionalStart, i)),
+                 TIntegerBidirectionalIterator(Advance(list1.BidirectionalStart,
+                                                       i + n)));
+         algUseFastPaths := true;
+         Reverse(TIntegerBidirectionalIterator(Advance(list2.BidirectionalStart, i)),
+                 TIntegerBidirectionalIterator(Advance(list2.BidirectionalStart,
+                                                       i + n)));
+         Test(SameIntegers(list1.ForwardStart, list1.ForwardFinish,
+                           list2.ForwardStart, list2.ForwardFinish),
+              'Reverse (fast path)', 'different result');
+      end;
+
+      { -------------------------- Find ---------------------------- }
+      for k := 0 to High(sets) do
+      begin
+         for i := -1 to ITEMS div 2 do
+         begin
+            algUseFastPaths := false;
+            iter1 := Find(sets[k].Start, sets[k].Finish, i, sets[k].ItemComparer);
+            algUseFastPaths := true;
+            iter2 := Find(sets[k].Start, sets[k].Finish, i, sets[k].ItemComparer);
+            Test(iter1.Equal(iter2), 'Find (fast path)',
+                 'different result (item ' + IntToStr(i) + ')');
+            iter1.Destroy;
+            iter2.Destroy;
+         end;
+      end;
+   finally
+      algUseFastPaths := fast;
+      arr1.Free;
+      arr2.Free;
+      deque1.Free;
+      deque2.Free;
+      list1.Free;
+      list2.Free;
+      sets[0].Free;
+      sets[1].Free;
+   end;
+   TestObjectCopyFastPath;
+end;
+
 end.
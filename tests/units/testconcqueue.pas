@@ -0,0 +1,316 @@
+unit testconcqueue;
+
+{ tests the methods specific to the lock-free queues from adtconcqueue
+  and runs a few producer and consumer threads on them }
+
+interface
+
+uses
+   adtcontbase, testcont;
+
+type
+   { tests a TSpscQueue or a TMpmcQueue }
+   TConcurrentQueueTester = class (TQueueTester)
+   protected
+      procedure TestContainer(cont : TContainerAdt); override;
+   end;
+
+implementation
+
+uses
+   testutils, SysUtils, Classes, adtconcqueue;
+
+const
+   BATCH = 100;
+   { the number of items pushed by each producer thread }
+   THREAD_ITEMS = 50000;
+
+type
+   TItemArray = array of TObject;
+
+   { pushes the test objects first..first+count-1 }
+   TProducer = class (TThread)
+   private
+      FQueue : TContainerAdt;
+      FFirst, FCount : Integer;
+   protected
+      procedure Execute; override;
+   public
+      constructor Create(q : TContainerAdt; first, count : Integer);
+   end;
+
+   { pops items until <remaining> reaches 0 and stores them in Items }
+   TConsumer = class (TThread)
+   private
+      FQueue : TContainerAdt;
+      FRemaining : PLongInt;
+      FItems : TItemArray;
+      FCount : Integer;
+   protected
+      procedure Execute; override;
+   public
+      constructor Create(q : TContainerAdt; remaining : PLongInt);
+      property Items : TItemArray read FItems;
+      property Count : Integer read FCount;
+   end;
+
+{ the queues have no common ancestor providing the methods below }
+
+function TryPushBack(q : TContainerAdt; aitem : TObject) : Boolean;
+begin
+   if q is TSpscQueue then
+      Result := TSpscQueue(q).TryPushBack(aitem)
+   else
+      Result := (q as TMpmcQueue).TryPushBack(aitem);
+end;
+
+function TryPopFront(q : TContainerAdt; var aitem : TObject) : Boolean;
+begin
+   if q is TSpscQueue then
+      Result := TSpscQueue(q).TryPopFront(aitem)
+   else
+      Result := (q as TMpmcQueue).TryPopFront(aitem);
+end;
+
+function PushMany(q : TContainerAdt; const aitems : array of TObject) : SizeType;
+begin
+   if q is TSpscQueue then
+      Result := TSpscQueue(q).PushMany(aitems)
+   else
+      Result := (q as TMpmcQueue).PushMany(aitems);
+end;
+
+function PopMany(q : TContainerAdt; var aitems : array of TObject) : SizeType;
+begin
+   if q is TSpscQueue then
+      Result := TSpscQueue(q).PopMany(aitems)
+   else
+      Result := (q as TMpmcQueue).PopMany(aitems);
+end;
+
+function Capacity(q : TContainerAdt) : SizeType;
+begin
+   if q is TSpscQueue then
+      Result := TSpscQueue(q).Capacity
+   else
+      Result := (q as TMpmcQueue).Capacity;
+end;
+
+{ ----------------------------- threads -------------------------------- }
+
+constructor TProducer.Create(q : TContainerAdt; first, count : Integer);
+begin
+   FQueue := q;
+   FFirst := first;
+   FCount := count;
+   inherited Create(true);
+end;
+
+procedure TProducer.Execute;
+var
+   obj : TObject;
+   i : Integer;
+begin
+   for i := FFirst to FFirst + FCount - 1 do
+   begin
+      obj := TTestObject.Create(i);
+      while not TryPushBack(FQueue, obj) do
+         Sleep(0);
+   end;
+end;
+
+constructor TConsumer.Create(q : TContainerAdt; remaining : PLongInt);
+begin
+   FQueue := q;
+   FRemaining := remaining;
+   FCount := 0;
+   inherited Create(true);
+end;
+
+procedure TConsumer.Execute;
+var
+   obj : TObject;
+begin
+   { claim an item first, so that the consumers together pop exactly
+     as many items as were pushed }
+   while InterLockedDecrement(FRemaining^) >= 0 do
+   begin
+      while not TryPopFront(FQueue, obj) do
+         Sleep(0);
+      if FCount = Length(FItems) then
+         SetLength(FItems, 2*FCount + 16);
+      FItems[FCount] := obj;
+      Inc(FCount);
+   end;
+end;
+
+{ ----------------------- TConcurrentQueueTester ----------------------- }
+
+procedure TConcurrentQueueTester.TestContainer(cont : TContainerAdt);
+var
+   items, rest : TItemArray;
+   obj : TObject;
+   producers, consumers : array of TThread;
+   seen : array of Integer;
+   threads, total, i, j, value : Integer;
+   remaining : LongInt;
+   num, num2 : SizeType;
+   ok : Boolean;
+begin
+   inherited;
+
+   StartDestruction(cont.Size, 'Clear');
+   cont.Clear;
+   FinishDestruction;
+
+   { -------------------------- TryPopFront ----------------------- }
+   obj := nil;
+   testutils.Test(not TryPopFront(cont, obj), 'TryPopFront',
+                  'returns true for an empty queue');
+   testutils.Test((obj = nil) and (cont.Size = 0), 'TryPopFront',
+                  'modifies an empty queue');
+
+   { -------------------------- TryPushBack ----------------------- }
+   ok := true;
+   for i := 0 to Capacity(cont) - 1 do
+   begin
+      if not TryPushBack(cont, TTestObject.Create(i)) then
+         ok := false;
+   end;
+   testutils.Test(ok and (cont.Size = Capacity(cont)), 'TryPushBack',
+                  'cannot fill the queue');
+   obj := TTestObject.Create(-1);
+   testutils.Test(not TryPushBack(cont, obj), 'TryPushBack',
+                  'returns true for a full queue');
+   testutils.Test(cont.Size = Capacity(cont), 'TryPushBack',
+                  'modifies a full queue');
+   obj.Free;
+
+   { -------------------------- TryPopFront ----------------------- }
+   ok := true;
+   for i := 0 to Capacity(cont) - 1 do
+   begin
+      obj := nil;
+      if not TryPopFront(cont, obj) or (TestObjectValue(obj) <> i) then
+         ok := false;
+      obj.Free;
+   end;
+   testutils.Test(ok and cont.Empty, 'TryPopFront', 'wrong items popped');
+
+   { -------------------------- PushMany ----------------------- }
+   SetLength(items, BATCH);
+   for i := 0 to BATCH - 1 do
+      items[i] := TTestObject.Create(i);
+   testutils.Test(PushMany(cont, items) = BATCH, 'PushMany');
+   testutils.Test(cont.Size = BATCH, 'PushMany', 'wrong Size');
+
+   { -------------------------- PopMany ----------------------- }
+   for i := 0 to BATCH - 1 do
+      items[i] := nil;
+   SetLength(rest, BATCH div 2);
+   num := PopMany(cont, rest);
+   testutils.Test(num = BATCH div 2, 'PopMany', 'wrong number of items');
+   for i := 0 to num - 1 do
+      items[i] := rest[i];
+   { more room than items left }
+   SetLength(rest, BATCH);
+   num2 := PopMany(cont, rest);
+   for i := 0 to num2 - 1 do
+      items[num + i] := rest[i];
+   num := num + num2;
+   testutils.Test(num = BATCH, 'PopMany', 'wrong number of items');
+   testutils.Test(PopMany(cont, rest) = 0, 'PopMany',
+                  'pops from an empty queue');
+   testutils.Test(cont.Empty, 'PopMany', 'items left in the queue');
+   ok := true;
+   for i := 0 to BATCH - 1 do
+   begin
+      if (items[i] = nil) or (TestObjectValue(items[i]) <> i) then
+         ok := false;
+   end;
+   testutils.Test(ok, 'PopMany', 'wrong items or order');
+
+   { -------------------------- PushMany ----------------------- }
+   { only the items for which there is room are pushed }
+   for i := 0 to Capacity(cont) - BATCH div 2 - 1 do
+      TryPushBack(cont, TTestObject.Create(i));
+   num := PushMany(cont, items);
+   testutils.Test(num = BATCH div 2, 'PushMany (full queue)',
+                  'wrong number of items pushed');
+   testutils.Test(cont.Size = Capacity(cont), 'PushMany (full queue)',
+                  'wrong Size');
+   StartDestruction(BATCH - num, 'items not pushed');
+   for i := num to BATCH - 1 do
+      items[i].Free;
+   FinishDestruction;
+   StartDestruction(cont.Size, 'Clear');
+   cont.Clear;
+   FinishDestruction;
+
+   { -------------------- producers and consumers --------------------- }
+   if cont is TSpscQueue then
+      threads := 1
+   else
+      threads := 2;
+   total := threads * THREAD_ITEMS;
+   remaining := total;
+   SetLength(producers, threads);
+   SetLength(consumers, threads);
+   for i := 0 to threads - 1 do
+   begin
+      producers[i] := TProducer.Create(cont, i * THREAD_ITEMS, THREAD_ITEMS);
+      consumers[i] := TConsumer.Create(cont, @remaining);
+   end;
+   for i := 0 to threads - 1 do
+   begin
+      consumers[i].Start;
+      producers[i].Start;
+   end;
+   for i := 0 to threads - 1 do
+   begin
+      producers[i].WaitFor;
+      consumers[i].WaitFor;
+   end;
+
+   { every item must have been popped exactly once }
+   SetLength(seen, total);
+   for i := 0 to total - 1 do
+      seen[i] := 0;
+   num := 0;
+   ok := true;
+   for i := 0 to threads - 1 do
+   begin
+      for j := 0 to TConsumer(consumers[i]).Count - 1 do
+      begin
+         value := TestObjectValue(TConsumer(consumers[i]).Items[j]);
+         if (value < 0) or (value >= total) then
+            ok := false
+         else
+            Inc(seen[value]);
+      end;
+      num := num + TConsumer(consumers[i]).Count;
+   end;
+   for i := 0 to total - 1 do
+   begin
+      if seen[i] <> 1 then
+         ok := false;
+   end;
+   testutils.Test(num = total, 'producers and consumers',
+                  'wrong number of items popped');
+   testutils.Test(ok, 'producers and consumers',
+                  'an item lost or popped more than once');
+   testutils.Test(cont.Empty, 'producers and consumers',
+                  'items left in the queue');
+
+   StartDestruction(num, 'items popped by the consumers');
+   for i := 0 to threads - 1 do
+   begin
+      for j := 0 to TConsumer(consumers[i]).Count - 1 do
+         TConsumer(consumers[i]).Items[j].Free;
+      consumers[i].Free;
+      producers[i].Free;
+   end;
+   FinishDestruction;
+end;
+
+end.
@@ -46,9 +46,22 @@ type
       procedure TestContainer(cont : TContainerAdt); override;
    end;
 
+   { tests also snapshots of a TPersistentAvlTree }
+   TPersistentSortedSetTester = class (TSortedSetTester)
+   protected
+      procedure TestContainer(cont : TContainerAdt); override;
+   end;
+
    THashSetTester = class (TSetTester)
    protected
       function CreateContainer : TContainerAdt; override;
+      procedure TestContainer(cont : TContainerAdt); override;
+   end;
+
+   { tests also the iterators of a TFilteredSet }
+   TFilteredSetTester = class (TSetTester)
+   protected
+      procedure TestContainer(cont : TContainerAdt); override;
    end;
 
    TStringHashSetTester = class (TStringSetTester)
@@ -103,8 +116,127 @@ const
 implementation
 
 uses
-   testutils, testiters, testalgs, SysUtils, adtutils,
-   adtiters, adtlog, adtfunct;
+   testutils, testiters, testalgs, SysUtils, Classes, adtutils,
+   adtiters, adtlog, adtfunct, adthash, adtlist, adtpersistent, adtfilter,
+   adtexcept;
+
+type
+   { counts the items passed to it }
+   TItemCounter = class (TFunctor, IUnaryFunctor)
+   public
+      Count : SizeType;
+      function Perform(obj : TObject) : TObject;
+   end;
+
+   { returns its second argument, so that Fold gives the last item }
+   TLastItem = class (TFunctor, IBinaryFunctor)
+   public
+      function Perform(obj1, obj2 : TObject) : TObject;
+   end;
+
+   { true for test objects with odd values }
+   TOddValue = class (TFunctor, IUnaryPredicate)
+   public
+      function Test(obj : TObject) : Boolean;
+   end;
+
+   TIntegerItemCounter = class (TFunctor, IIntegerUnaryFunctor)
+   public
+      Count : SizeType;
+      function Perform(aitem : Integer) : Integer;
+   end;
+
+   TIntegerAdder = class (TFunctor, IIntegerBinaryFunctor)
+   public
+      function Perform(aitem1, aitem2 : Integer) : Integer;
+   end;
+
+   TIsEvenInteger = class (TFunctor, IIntegerUnaryPredicate)
+   public
+      function Test(aitem : Integer) : Boolean;
+   end;
+
+   { copies test objects like TTestObjectCopier, but raises instead of
+     copying any item after the first <alimit> ones }
+   TFailingCopier = class (TFunctor, IUnaryFunctor)
+   private
+      FLimit : SizeType;
+   public
+      constructor Create(alimit : SizeType);
+      function Perform(obj : TObject) : TObject;
+   end;
+
+function TItemCounter.Perform(obj : TObject) : TObject;
+begin
+   Inc(Count);
+   Result := obj;
+end;
+
+function TLastItem.Perform(obj1, obj2 : TObject) : TObject;
+begin
+   Result := obj2;
+end;
+
+function TOddValue.Test(obj : TObject) : Boolean;
+begin
+   Result := Odd(TTestObject(obj).Value);
+end;
+
+function TIntegerItemCounter.Perform(aitem : Integer) : Integer;
+begin
+   Inc(Count);
+   Result := aitem;
+end;
+
+function TIntegerAdder.Perform(aitem1, aitem2 : Integer) : Integer;
+begin
+   Result := aitem1 + aitem2;
+end;
+
+function TIsEvenInteger.Test(aitem : Integer) : Boolean;
+begin
+   Result := not Odd(aitem);
+end;
+
+constructor TFailingCopier.Create(alimit : SizeType);
+begin
+   inherited Create;
+   FLimit := alimit;
+end;
+
+function TFailingCopier.Perform(obj : TObject) : TObject;
+begin
+   if FLimit = 0 then
+      raise Exception.Create('TFailingCopier: copy limit reached');
+   Dec(FLimit);
+   Result := TTestObject.Create(TTestObject(obj).Value);
+end;
+
+{ tests FindIf and DeleteIf of cont with a predicate accepting the
+  test objects with odd values; cont must contain <count> such items;
+  <objs> objects are destroyed with every deleted item }
+procedure TestFindIfDeleteIf(cont : TContainerAdt; count, objs : SizeType);
+var
+   pred : IUnaryPredicate;
+   aitem : TObject;
+   lastSize : SizeType;
+begin
+   pred := TOddValue.Create;
+   aitem := nil;
+   testutils.Test(cont.FindIf(pred, aitem) = (count <> 0), 'FindIf',
+                  'wrong result');
+   testutils.Test((count = 0) or Odd(TTestObject(aitem).Value), 'FindIf',
+                  'returns wrong item');
+
+   lastSize := cont.Size;
+   StartDestruction(count * objs, 'DeleteIf');
+   testutils.Test(cont.DeleteIf(pred) = count, 'DeleteIf',
+                  'returns wrong number of items');
+   FinishDestruction;
+   testutils.Test(cont.Size = lastSize - count, 'DeleteIf', 'wrong size');
+   testutils.Test(not cont.FindIf(pred, aitem), 'DeleteIf',
+                  'not all items deleted');
+end;
 
 function TPriorityQueueTester.CreateContainer : TContainerAdt;
 begin
@@ -190,6 +322,23 @@ begin
 
    DeleteAll;
 
+   { ------------------------ FindIf + DeleteIf ------------------------ }
+   TestFindIfDeleteIf(pqueue2, (ITEMS_TO_INSERT + 1) div 2, 1);
+   StartSilentMode;
+   i := 0;
+   while not pqueue2.Empty do
+   begin
+      testutils.Test(TTestObject(pqueue2.First).Value = i, 'DeleteIf',
+                     'wrong order of the items kept');
+      StartDestruction(1, 'DeleteFirst');
+      pqueue2.DeleteFirst;
+      FinishDestruction;
+      Inc(i, 2);
+   end;
+   StopSilentMode;
+   testutils.Test(i = ITEMS_TO_INSERT + 2, 'DeleteIf', 'wrong items kept');
+
+   pqueue2.Insert(TTestObject.Create(0));
    StartDestruction(pqueue2.Size, 'Clear');
    pqueue2.Clear;
    FinishDestruction;
@@ -661,6 +810,7 @@ var
    lb, ub, iter : TStringSetIterator;
    range : TStringSetIteratorRange;
    set2 : TStringSetAdt;
+   stream : TMemoryStream;
 begin
    Assert(cont is TStringSetAdt);
    aset := TStringSetAdt(cont);
@@ -867,6 +1017,33 @@ begin
    testutils.Test(not aset.Has(str), 'Delete (with given position)',
         'Has(str) does not return false');
 
+   { -------------------- SaveToStream + LoadFromStream -------------------- }
+   stream := TMemoryStream.Create;
+   set2 := TStringSetAdt(aset.CopySelf(nil));
+   try
+      aset.SaveToStream(stream, nil);
+      stream.Position := 0;
+      set2.LoadFromStream(stream, nil);
+      testutils.Test(set2.Size = aset.Size, 'LoadFromStream', 'wrong size');
+      testutils.Test(stream.Position = stream.Size, 'LoadFromStream',
+                     'does not read the whole snapshot');
+
+      StartSilentMode;
+      iter := aset.Start;
+      while not iter.IsFinish do
+      begin
+         str := iter.Item;
+         testutils.Test(set2.Count(str) = aset.Count(str), 'LoadFromStream',
+                        'not all items restored');
+         iter.Advance;
+      end;
+      StopSilentMode;
+      iter.Destroy;
+   finally
+      set2.Destroy;
+      stream.Free;
+   end;
+
    { --------------------------- Clear -------------------------------------- }
    aset.Clear;
    testutils.Test(aset.Empty, 'Clear', 'still not empty');
@@ -964,6 +1141,17 @@ var
    lb, ub, iter : TIntegerSetIterator;
    range : TIntegerSetIteratorRange;
    set2 : TIntegerSetAdt;
+   stream : TMemoryStream;
+   ints : array of Integer;
+   found : array of Boolean;
+   counter : TIntegerItemCounter;
+   funct : IIntegerUnaryFunctor;
+   adder : IIntegerBinaryFunctor;
+   pred : IIntegerUnaryPredicate;
+   sum : Integer;
+{$ifdef PASCAL_ADT_STATS }
+   stats : TContainerStats;
+{$endif }
 begin
    Assert(cont is TIntegerSetAdt);
    aset := TIntegerSetAdt(cont);
@@ -1170,6 +1358,115 @@ begin
    testutils.Test(not aset.Has(int), 'Delete (with given position)',
         'Has(int) does not return false');
 
+   { ------------------------ HasMany + InsertMany ------------------------ }
+   if aset is TIntegerHashTable then
+   begin
+      SetLength(ints, 200);
+      SetLength(found, 200);
+      for i := 0 to Length(ints) - 1 do
+         ints[i] := Random(400);
+
+      count := TIntegerHashTable(aset).HasMany(ints, found);
+      s := 0;
+      StartSilentMode;
+      for i := 0 to Length(ints) - 1 do
+      begin
+         testutils.Test(found[i] = aset.Has(ints[i]), 'HasMany',
+                        'wrong result for an item');
+         if found[i] then
+            Inc(s);
+      end;
+      StopSilentMode;
+      testutils.Test(s = count, 'HasMany', 'wrong number of items found');
+
+      lastSize := aset.Size;
+      count := TIntegerHashTable(aset).InsertMany(ints, found);
+      testutils.Test(aset.Size = lastSize + count, 'InsertMany', 'wrong size');
+      StartSilentMode;
+      for i := 0 to Length(ints) - 1 do
+      begin
+         testutils.Test(aset.Has(ints[i]), 'InsertMany', 'item not inserted');
+      end;
+      StopSilentMode;
+   end;
+
+{$ifdef PASCAL_ADT_STATS }
+   { ------------------------------ GetStats -------------------------------- }
+   aset.GetStats(stats);
+   testutils.Test(stats.Items = aset.Size, 'GetStats', 'wrong number of items');
+   if aset is TIntegerHashSetAdt then
+   begin
+      s := 0;
+      for i := 0 to adtStatsHistogramSize - 1 do
+         Inc(s, stats.ProbeLengths[i]);
+      testutils.Test(s = aset.Size, 'GetStats',
+                     'probe lengths do not cover all items');
+      testutils.Test(stats.Capacity = TIntegerHashSetAdt(aset).Capacity,
+                     'GetStats', 'wrong capacity');
+   end;
+{$endif PASCAL_ADT_STATS }
+
+   { -------------------- SaveToStream + LoadFromStream -------------------- }
+   stream := TMemoryStream.Create;
+   set2 := TIntegerSetAdt(aset.CopySelf(nil));
+   try
+      aset.SaveToStream(stream, nil);
+      stream.Position := 0;
+      set2.LoadFromStream(stream, nil);
+      testutils.Test(set2.Size = aset.Size, 'LoadFromStream', 'wrong size');
+      testutils.Test(stream.Position = stream.Size, 'LoadFromStream',
+                     'does not read the whole snapshot');
+
+      StartSilentMode;
+      iter := aset.Start;
+      while not iter.IsFinish do
+      begin
+         int := iter.Item;
+         testutils.Test(set2.Count(int) = aset.Count(int), 'LoadFromStream',
+                        'not all items restored');
+         iter.Advance;
+      end;
+      StopSilentMode;
+      iter.Destroy;
+   finally
+      set2.Destroy;
+      stream.Free;
+   end;
+
+   { -------------- ForEach + Fold + FindIf + CountIf + DeleteIf ------------- }
+   counter := TIntegerItemCounter.Create;
+   funct := counter;
+   aset.ForEach(funct);
+   testutils.Test(counter.Count = aset.Size, 'ForEach',
+                  'wrong number of items visited');
+
+   count := 0;
+   sum := 0;
+   iter := aset.Start;
+   while not iter.IsFinish do
+   begin
+      if not Odd(iter.Item) then
+         Inc(count);
+      Inc(sum, iter.Item);
+      iter.Advance;
+   end;
+   iter.Destroy;
+
+   adder := TIntegerAdder.Create;
+   testutils.Test(aset.Fold(adder, 0) = sum, 'Fold', 'wrong result');
+   pred := TIsEvenInteger.Create;
+   testutils.Test(aset.CountIf(pred) = count, 'CountIf', 'wrong result');
+   int := 1;
+   testutils.Test(aset.FindIf(pred, int) = (count <> 0), 'FindIf', 'wrong result');
+   testutils.Test((count = 0) or (not Odd(int) and aset.Has(int)), 'FindIf',
+                  'returns wrong item');
+
+   lastSize := aset.Size;
+   testutils.Test(aset.DeleteIf(pred) = count, 'DeleteIf',
+                  'returns wrong number of items');
+   testutils.Test(aset.Size = lastSize - count, 'DeleteIf', 'wrong size');
+   testutils.Test(aset.CountIf(pred) = 0, 'DeleteIf', 'not all items deleted');
+
    { --------------------------- Clear -------------------------------------- }
    aset.Clear;
    testutils.Test(aset.Empty, 'Clear', 'still not empty');
@@ -1295,6 +1592,150 @@ end;
 
 
 
+{ ===================== TestPersistentSortedSet ======================= }
+
+
+procedure TPersistentSortedSetTester.TestContainer(cont : TContainerAdt);
+var
+   aset, snap : TPersistentAvlTree;
+   iter : TSetIterator;
+   i, half : IndexType;
+begin
+   inherited;
+   Assert(cont is TPersistentAvlTree);
+   aset := TPersistentAvlTree(cont);
+
+   StartDestruction(aset.Size, 'Clear');
+   aset.Clear;
+   FinishDestruction;
+
+   for i := 0 to ITEMS_TO_INSERT - 1 do
+      aset.Insert(TTestObject.Create(i));
+   half := ITEMS_TO_INSERT div 2;
+
+   { --------------------------- Snapshot ------------------------------ }
+   snap := aset.Snapshot;
+   testutils.Test(snap.Size = aset.Size, 'Snapshot', 'wrong size');
+   testutils.Test(snap.RepeatedItems = aset.RepeatedItems, 'Snapshot',
+        'RepeatedItems not copied');
+   CheckRange(snap.Start, snap.Finish, true, 0, ITEMS_TO_INSERT, 'Snapshot');
+
+   { the items still in the snapshot must not be disposed }
+   StartDestruction(0, 'Delete (items shared with a snapshot)');
+   for i := 0 to half - 1 do
+      aset.Delete(aset.Start);
+   FinishDestruction;
+
+   testutils.Test(aset.Size = ITEMS_TO_INSERT - half, 'Delete', 'wrong size');
+   CheckRange(aset.Start, aset.Finish, true, half, ITEMS_TO_INSERT - half,
+              'Delete');
+   testutils.Test(snap.Size = ITEMS_TO_INSERT, 'Snapshot',
+        'changed by Delete on the original set');
+   CheckRange(snap.Start, snap.Finish, true, 0, ITEMS_TO_INSERT,
+              'Snapshot (after Delete on the original set)');
+
+   { ---------------------- Insert (snapshot) -------------------------- }
+   snap.Insert(TTestObject.Create(ITEMS_TO_INSERT));
+   testutils.Test(snap.Size = ITEMS_TO_INSERT + 1, 'Insert (snapshot)',
+        'wrong size');
+   testutils.Test(aset.Size = ITEMS_TO_INSERT - half, 'Insert (snapshot)',
+        'changed the original set');
+
+   { -------------------------- Destroy -------------------------------- }
+   { only the items not in aset any more may be disposed }
+   StartDestruction(half + 1, 'Destroy (snapshot)');
+   snap.Destroy;
+   FinishDestruction;
+   CheckRange(aset.Start, aset.Finish, true, half, ITEMS_TO_INSERT - half,
+              'Destroy (snapshot)');
+
+   { -------------------- Delete (until empty) ----------------------- }
+   { removes leaves as well as inner nodes }
+   StartDestruction(aset.Size, 'Delete (until empty)');
+   while aset.Size <> 0 do
+   begin
+      iter := aset.Start;
+      Advance(iter, aset.Size div 2);
+      aset.Delete(iter);
+   end;
+   FinishDestruction;
+   testutils.Test(aset.Start.IsFinish, 'Delete (until empty)',
+        'items left in the set');
+
+   { the same with all the nodes shared with a snapshot }
+   for i := 0 to ITEMS_TO_INSERT - 1 do
+      aset.Insert(TTestObject.Create(i));
+   snap := aset.Snapshot;
+   StartDestruction(0, 'Delete (shared, until empty)');
+   while aset.Size <> 0 do
+   begin
+      iter := aset.Finish;
+      iter.Retreat;
+      aset.Delete(iter);
+   end;
+   FinishDestruction;
+   testutils.Test(aset.Start.IsFinish, 'Delete (shared, until empty)',
+        'items left in the set');
+   CheckRange(snap.Start, snap.Finish, true, 0, ITEMS_TO_INSERT,
+              'Snapshot (after deleting all items of the original set)');
+   StartDestruction(ITEMS_TO_INSERT, 'Destroy (snapshot)');
+   snap.Destroy;
+   FinishDestruction;
+
+   StartDestruction(aset.Size, 'Clear');
+   aset.Clear;
+   FinishDestruction;
+end;
+
+
+
+{ ======================== TFilteredSetTester ======================= }
+
+procedure TFilteredSetTester.TestContainer(cont : TContainerAdt);
+var
+   aset : TFilteredSet;
+   iter : TSetIterator;
+   probe : TTestObject;
+begin
+   inherited;
+   aset := cont as TFilteredSet;
+
+   StartDestruction(aset.Size, 'Clear');
+   aset.Clear;
+   FinishDestruction;
+   probe := TTestObject.Create(0);
+   try
+      { ---------------------- Insert (iterator) ------------------------ }
+      iter := aset.Finish;
+      testutils.Test(iter.Owner = aset, 'Finish',
+           'the iterator is not owned by the filtered set');
+      iter.Insert(TTestObject.Create(1));
+      probe.Value := 1;
+      testutils.Test(aset.Has(probe), 'Insert (iterator)',
+           'the item inserted is not in the filter');
+
+      { ---------------------- SetItem (iterator) ----------------------- }
+      StartDestruction(1, 'SetItem (iterator)');
+      iter.Item := TTestObject.Create(2);
+      FinishDestruction;
+      probe.Value := 2;
+      testutils.Test(aset.Has(probe), 'SetItem (iterator)',
+           'the item set is not in the filter');
+
+      { --------------------- LowerBound, Extract ----------------------- }
+      iter := aset.LowerBound(probe);
+      testutils.Test(iter.Owner = aset, 'LowerBound',
+           'the iterator is not owned by the filtered set');
+      testutils.Test(TTestObject(iter.Item).Value = 2, 'LowerBound');
+      StartDestruction(1, 'Delete (iterator)');
+      iter.Delete;
+      FinishDestruction;
+      testutils.Test(not aset.Has(probe) and aset.Empty, 'Delete (iterator)');
+   finally
+      probe.Free;
+   end;
+end;
+
 { ========================== THashSetTester ========================= }
 
 function THashSetTester.CreateContainer : TContainerAdt;
@@ -1303,6 +1744,82 @@ begin
    (Result as THashSetAdt).Hasher := TTestObjectHasher.Create;
 end;
 
+procedure THashSetTester.TestContainer(cont : TContainerAdt);
+const
+   ITEMS = 100;
+var
+   aset : THashSetAdt;
+   objs, res : array of TObject;
+   found : array of Boolean;
+   i, count, inserted : SizeType;
+   ok : Boolean;
+begin
+   inherited;
+   aset := cont as THashSetAdt;
+   if not ((aset is THashTable) or (aset is TScatterTable)) then
+      Exit;
+
+   StartDestruction(aset.Size, 'Clear');
+   aset.Clear;
+   FinishDestruction;
+   aset.RepeatedItems := false;
+   for i := 0 to ITEMS - 1 do
+      aset.Insert(TTestObject.Create(i));
+
+   { the objects 0 .. 2*ITEMS - 1, the first half of which is in the
+     set }
+   SetLength(objs, 2*ITEMS);
+   SetLength(res, 2*ITEMS);
+   SetLength(found, 2*ITEMS);
+   for i := 0 to 2*ITEMS - 1 do
+      objs[i] := TTestObject.Create(i);
+
+   { ------------------------ HasMany ------------------------------ }
+   if aset is THashTable then
+      count := THashTable(aset).HasMany(objs, found)
+   else
+      count := TScatterTable(aset).HasMany(objs, found);
+   ok := count = ITEMS;
+   for i := 0 to 2*ITEMS - 1 do
+      ok := ok and (found[i] = (i < ITEMS));
+   testutils.Test(ok, 'HasMany', 'wrong items found');
+
+   { ------------------------ FindMany ----------------------------- }
+   if aset is THashTable then
+      count := THashTable(aset).FindMany(objs, res)
+   else
+      count := TScatterTable(aset).FindMany(objs, res);
+   ok := count = ITEMS;
+   for i := 0 to 2*ITEMS - 1 do
+   begin
+      if i < ITEMS then
+         ok := ok and (res[i] <> nil) and (res[i] <> objs[i]) and
+                  (TTestObject(res[i]).Value = i)
+      else
+         ok := ok and (res[i] = nil);
+   end;
+   testutils.Test(ok, 'FindMany', 'wrong items returned');
+
+   { ----------------------- InsertMany ---------------------------- }
+   { only the second half is inserted; the objects not inserted stay
+     owned by the caller }
+   if aset is THashTable then
+      inserted := THashTable(aset).InsertMany(objs, found)
+   else
+      inserted := TScatterTable(aset).InsertMany(objs, found);
+   ok := (inserted = ITEMS) and (aset.Size = 2*ITEMS);
+   for i := 0 to 2*ITEMS - 1 do
+      ok := ok and (found[i] = (i >= ITEMS)) and
+               (aset.Count(objs[i]) = 1);
+   testutils.Test(ok, 'InsertMany', 'wrong items inserted');
+
+   for i := 0 to ITEMS - 1 do
+      objs[i].Free;
+   StartDestruction(aset.Size, 'Clear');
+   aset.Clear;
+   FinishDestruction;
+end;
+
 { ========================== THashSetTester ========================= }
 
 function TStringHashSetTester.CreateContainer : TStringContainerAdt;
@@ -1637,6 +2154,19 @@ begin
 
    TestMapIterator(map.Start, map.Finish, map.IsSorted);
 
+   { ------------------ FindIf + DeleteIf ---------------------- }
+   { the item associated with every key i in 0..Size-1 is i }
+   lastSize := map.Size;
+   TestFindIfDeleteIf(map, lastSize div 2, 2);
+   StartSilentMode;
+   for i := 0 to lastSize - 1 do
+   begin
+      key := TTestObject.Create(i);
+      testutils.Test(map.Has(key) = not Odd(i), 'DeleteIf',
+                     'wrong keys deleted');
+      TTestObject(key).Destroy;
+   end;
+   StopSilentMode;
 end;
 
 
@@ -1824,6 +2354,23 @@ begin
       Inc(i);
    end;
    StopSilentMode;
+   fiter.Destroy;
+   fiter2.Destroy;
+
+   { -------------------------- FindIf + DeleteIf ------------------------ }
+   TestFindIfDeleteIf(tree2, 10000, 1);
+   fiter := tree2.PreOrderIterator;
+   i := 0;
+   StartSilentMode;
+   while not fiter.Equal(tree2.Finish) do
+   begin
+      testutils.Test(TTestObject(fiter.GetItem).Value = i, 'DeleteIf',
+           'wrong pre-order of the items kept');
+      fiter.Advance;
+      Inc(i, 2);
+   end;
+   StopSilentMode;
+   fiter.Destroy;
 
    { -------------------------- Destroy -------------------- }
    StartDestruction(tree2.Size, 'destructor');
@@ -1843,6 +2390,8 @@ var
    lastSize : SizeType;
    queue2 : TQueueAdt;
    copier : IUnaryFunctor;
+   stream : TMemoryStream;
+   ok : Boolean;
 begin
    Assert(cont is TQueueAdt);
    queue := TQueueAdt(cont);
@@ -1967,10 +2516,45 @@ begin
    queue2.Destroy;
    FinishDestruction;
 
+   { ----------------------- FindIf + DeleteIf ----------------------- }
+   copier := TTestObjectCopier.Create;
+   queue2 := TQueueAdt(queue.CopySelf(copier));
+
+   TestFindIfDeleteIf(queue2, (ITEMS_TO_INSERT + 1) div 2, 1);
+   StartSilentMode;
+   i := 0;
+   while not queue2.Empty do
+   begin
+      testutils.Test(TTestObject(queue2.Front).Value = i, 'DeleteIf',
+           'wrong order of the items kept');
+      StartDestruction(1, 'PopFront');
+      queue2.PopFront;
+      FinishDestruction;
+      Inc(i, 2);
+   end;
+   StopSilentMode;
+   testutils.Test(i = ITEMS_TO_INSERT + 2, 'DeleteIf', 'wrong items kept');
+   queue2.Destroy;
+
    { -------------------------- Clear ----------------------- }
    copier := TTestObjectCopier.Create;
    queue2 := TQueueAdt(queue.CopySelf(copier));
 
+   { objects have no default representation }
+   stream := TMemoryStream.Create;
+   ok := false;
+   try
+      queue2.SaveToStream(stream, nil);
+   except
+      on EInvalidArgument do
+         ok := true;
+   end;
+   stream.Free;
+   testutils.Test(ok, 'SaveToStream (nil streamer)',
+                  'EInvalidArgument not raised');
+   testutils.Test(queue2.Size = ITEMS_TO_INSERT + 1,
+                  'SaveToStream (nil streamer)', 'the queue modified');
+
    StartDestruction(ITEMS_TO_INSERT + 1, 'Clear');
    queue2.Clear;
    FinishDestruction;
@@ -2078,6 +2662,13 @@ var
    list2 : TListAdt;
    obj : TTestObject;
    copier : IUnaryFunctor;
+   counter : TItemCounter;
+   funct : IUnaryFunctor;
+   joiner : IBinaryFunctor;
+   pred : IUnaryPredicate;
+   aitem, firstOdd : TObject;
+   kept : array of TObject;
+   count : SizeType;
 begin
    inherited;
    Assert(cont is TListAdt);
@@ -2351,12 +2942,108 @@ begin
    list2.Destroy;
    FinishDestruction;
 
+   { ---------------------------- Sort ---------------------------- }
+   if (list is TSingleList) or (list is TDoubleList) or (list is TXorList) then
+   begin
+      lastSize := list.Size;
+      for i := 0 to lastSize - 1 do
+      begin
+         iter := list.ForwardStart;
+         Advance(iter, (i * 7) mod lastSize);
+         list.Move(iter, list.ForwardStart);
+      end;
+      if list is TSingleList then
+         TSingleList(list).Sort(TestObjectComparer)
+      else if list is TDoubleList then
+         TDoubleList(list).Sort(TestObjectComparer)
+      else
+         TXorList(list).Sort(TestObjectComparer);
+      testutils.Test(list.Size = lastSize, 'Sort', 'wrong size');
+      CheckRange(list.ForwardStart, list.ForwardFinish, true, 0, lastSize,
+                 'Sort');
+
+      { move a few items out of place and sort the nearly sorted list }
+      for i := 1 to 5 do
+      begin
+         iter := list.ForwardStart;
+         Advance(iter, (i * 37) mod lastSize);
+         list.Move(iter, list.ForwardStart);
+      end;
+      if list is TSingleList then
+         TSingleList(list).StableSort(TestObjectComparer)
+      else if list is TDoubleList then
+         TDoubleList(list).StableSort(TestObjectComparer)
+      else
+         TXorList(list).StableSort(TestObjectComparer);
+      testutils.Test(list.Size = lastSize, 'StableSort', 'wrong size');
+      CheckRange(list.ForwardStart, list.ForwardFinish, true, 0, lastSize,
+                 'StableSort (nearly sorted list)');
+   end;
+
    { ---------------------- test algorithms ---------------------- }
    if testAlgorithms then
    begin
       TestAllAlgs(list);
    end;
 
+   { -------------- ForEach + Fold + FindIf + CountIf + DeleteIf ------------- }
+   counter := TItemCounter.Create;
+   funct := counter;
+   list.ForEach(funct);
+   testutils.Test(counter.Count = list.Size, 'ForEach',
+                  'wrong number of items visited');
+
+   joiner := TLastItem.Create;
+   testutils.Test((list.Empty and (list.Fold(joiner, nil) = nil)) or
+                     (not list.Empty and (list.Fold(joiner, nil) = list.Back)),
+                  'Fold', 'does not visit the items in order');
+
+   { remember the items which should survive DeleteIf, in order }
+   SetLength(kept, list.Size);
+   count := 0;
+   firstOdd := nil;
+   iter := list.ForwardStart;
+   while not iter.IsFinish do
+   begin
+      if Odd(TTestObject(iter.Item).Value) then
+      begin
+         if firstOdd = nil then
+            firstOdd := iter.Item;
+      end else
+      begin
+         kept[count] := iter.Item;
+         Inc(count);
+      end;
+      iter.Advance;
+   end;
+   lastSize := list.Size;
+
+   pred := TOddValue.Create;
+   testutils.Test(list.CountIf(pred) = lastSize - count, 'CountIf', 'wrong result');
+   aitem := nil;
+   testutils.Test(list.FindIf(pred, aitem) = (firstOdd <> nil), 'FindIf',
+                  'wrong result');
+   testutils.Test(aitem = firstOdd, 'FindIf', 'returns wrong item');
+
+   StartDestruction(lastSize - count, 'DeleteIf');
+   testutils.Test(list.DeleteIf(pred) = lastSize - count, 'DeleteIf',
+                  'returns wrong number of items');
+   FinishDestruction;
+   testutils.Test(list.Size = count, 'DeleteIf', 'wrong size');
+   testutils.Test(list.CountIf(pred) = 0, 'DeleteIf', 'not all items deleted');
+
+   StartSilentMode;
+   i := 0;
+   iter := list.ForwardStart;
+   while not iter.IsFinish and (i < count) do
+   begin
+      testutils.Test(iter.Item = kept[i], 'DeleteIf',
+                     'does not preserve the order of items');
+      iter.Advance;
+      Inc(i);
+   end;
+   StopSilentMode;
+
    StartDestruction(list.Size, 'Clear');
    list.Clear;
    FinishDestruction;
@@ -2406,9 +3093,13 @@ procedure TRandomAccessContainerTester.TestContainer(cont : TContainerAdt);
 var
    ra : TRandomAccessContainerAdt;
    i, cs : IndexType;
-   lastSize, newSize, lastcapacity : SizeType;
+   lastSize, newSize, lastcapacity, n, total : SizeType;
    iter, iter2 : TRandomAccessIterator;
    obj : TTestObject;
+   buf : array of TObject;
+   slice : TSlice;
+   copier : IUnaryFunctor;
+   ok : Boolean;
 begin
    inherited;
    Assert(cont is TRandomAccessContainerAdt);
@@ -2493,6 +3184,78 @@ begin
               IntToStr(i - ra.LowIndex + 1) + 'th step');
    end;
 
+   { -------------------------- GetSlice --------------------------- }
+   i := ra.LowIndex;
+   total := 0;
+   ok := true;
+   while ok and (i <= ra.HighIndex) do
+   begin
+      slice := ra.GetSlice(i, ra.HighIndex - i + 1);
+      ok := (slice.Count > 0) and (slice.Items^ = ra.GetItem(i));
+      Inc(total, slice.Count);
+      Inc(i, slice.Count);
+   end;
+   testutils.Test(ok and (total = ra.Size), 'GetSlice',
+                  'the slices do not cover the container');
+
+   { -------------------------- ReadBlock -------------------------- }
+   SetLength(buf, ra.Size);
+   ra.ReadBlock(ra.LowIndex, buf, ra.Size);
+   ok := true;
+   for i := 0 to ra.Size - 1 do
+      ok := ok and (TTestObject(buf[i]).Value = i);
+   testutils.Test(ok, 'ReadBlock', 'wrong items read');
+
+   { -------------------------- WriteBlock ------------------------- }
+   cs := ra.Size div 3;
+   n := ra.Size div 2;
+   for i := 0 to n - 1 do
+      buf[i] := TTestObject.Create(cs + i);
+   StartDestruction(n, 'WriteBlock');
+   ra.WriteBlock(ra.LowIndex + cs, buf, n);
+   FinishDestruction;
+   CheckRange(ra.RandomAccessStart, ra.RandomAccessFinish, true, 0,
+              ra.Size, 'WriteBlock');
+
+   { ------------------------- InsertBlock ------------------------- }
+   { inserts the items 10000 .. 10000 + n - 1 in the middle }
+   cs := ra.Size div 2;
+   n := 1000;
+   lastSize := ra.Size;
+   SetLength(buf, n);
+   for i := 0 to n - 1 do
+      buf[i] := TTestObject.Create(10000 + i);
+   ra.InsertBlock(ra.LowIndex + cs, buf, n);
+   testutils.Test(ra.Size = lastSize + n, 'InsertBlock', 'wrong Size');
+   SetLength(buf, ra.Size);
+   ra.ReadBlock(ra.LowIndex, buf, ra.Size);
+   ok := true;
+   for i := 0 to ra.Size - 1 do
+   begin
+      if i < cs then
+         ok := ok and (TTestObject(buf[i]).Value = i)
+      else if i < cs + n then
+         ok := ok and (TTestObject(buf[i]).Value = 10000 + i - cs)
+      else
+         ok := ok and (TTestObject(buf[i]).Value = i - n);
+   end;
+   testutils.Test(ok, 'InsertBlock', 'wrong items after insertion');
+
+   StartDestruction(n, 'Delete (n items)');
+   ra.Delete(ra.LowIndex + cs, n);
+   FinishDestruction;
+   CheckRange(ra.RandomAccessStart, ra.RandomAccessFinish, true, 0,
+              ra.Size, 'InsertBlock');
+
+   { ------------------------- AppendBlock ------------------------- }
+   cs := ra.Size;
+   n := 700;
+   for i := 0 to n - 1 do
+      buf[i] := TTestObject.Create(cs + i);
+   ra.AppendBlock(buf, n);
+   CheckRange(ra.RandomAccessStart, ra.RandomAccessFinish, true, 0,
+              cs + n, 'AppendBlock');
+
    { ------------------ Delete (n items) --------------------------- }
    newSize := ra.Size - (ra.Size div 2);
    StartDestruction(ra.Size div 2, 'Delete (n items)');
@@ -2500,8 +3263,26 @@ begin
    FinishDestruction;
    testutils.Test(ra.Size = newSize, 'Delete (n items)', 'wrong size');
 
+   { ------------------ CopySelf (failing copier) ------------------ }
+   { the items copied before the exception must be destroyed }
+   copier := TFailingCopier.Create(ra.Size div 2);
+   ok := false;
+   StartDestruction(ra.Size div 2, 'CopySelf (failing copier)');
+   try
+      ra.CopySelf(copier).Free;
+   except
+      on Exception do
+         ok := true;
+   end;
+   FinishDestruction;
+   testutils.Test(ok, 'CopySelf (failing copier)', 'exception not propagated');
+   testutils.Test(ra.Size = newSize, 'CopySelf (failing copier)',
+                  'the source container modified');
+
    { -------------------------- Clear ------------------------------ }
+   StartDestruction(ra.Size, 'Clear');
    ra.Clear;
+   FinishDestruction;
    testutils.Test(ra.Size = 0, 'Clear', 'wrong Size');
 
    { -------------------------- Capacity ------------------------------ }
@@ -0,0 +1,238 @@
+unit testperfhash;
+
+{ tests TPerfectHashFunction and the instantiations of
+  TPerfectHashIndex from adtperfhash }
+
+interface
+
+procedure TestPerfectHash;
+
+implementation
+
+uses
+   testutils, SysUtils, Classes, adtfunct, adthash, adtarray, adtexcept,
+   adtperfhash;
+
+const
+   STRINGS = 20000;
+   INTEGERS = 4000;
+
+type
+   { gives the same hash to every four consecutive numbers, so that
+     most of the items of an index are stored after the ones numbered
+     by the function }
+   TQuarterHasher = class (TFunctor, IIntegerHasher)
+   public
+      function Hash(aitem : Integer) : UnsignedType;
+   end;
+
+function TQuarterHasher.Hash(aitem : Integer) : UnsignedType;
+begin
+   Result := UnsignedType(aitem div 4);
+end;
+
+function TestString(i : Integer) : String;
+begin
+   Result := 'perfect ' + IntToStr(i);
+end;
+
+{ checks that each of the first <num> test strings has its own number in
+  <index> and that none of the next <num> ones is found }
+procedure CheckStrings(index : TStringPerfectHashIndex; num : Integer;
+                       title : String);
+var
+   used : array of Boolean;
+   i, n : Integer;
+   ok : Boolean;
+begin
+   SetLength(used, index.Count);
+   for i := 0 to index.Count - 1 do
+      used[i] := false;
+   ok := index.Count = num;
+   for i := 0 to num - 1 do
+   begin
+      n := index.IndexOf(TestString(i));
+      if (n < 0) or (n >= index.Count) then
+         ok := false
+      else
+      begin
+         if used[n] or (index.Items[n] <> TestString(i)) then
+            ok := false;
+         used[n] := true;
+      end;
+   end;
+   Test(ok, title, 'wrong numbers');
+
+   ok := true;
+   for i := num to 2*num - 1 do
+   begin
+      if (index.IndexOf(TestString(i)) <> -1) or index.Has(TestString(i)) then
+         ok := false;
+   end;
+   Test(ok, title + ' (not in the set)', 'non-existent item found');
+end;
+
+procedure TestStringIndex;
+var
+   table : TStringHashTable;
+   index, loaded : TStringPerfectHashIndex;
+   func : TPerfectHashFunction;
+   strm : TMemoryStream;
+   i, n : Integer;
+   ok : Boolean;
+begin
+   table := TStringHashTable.Create;
+   strm := TMemoryStream.Create;
+   index := nil;
+   loaded := nil;
+   func := nil;
+   try
+      { ---------------------- empty index ------------------------ }
+      index := TStringPerfectHashIndex.Create(table);
+      Test(index.Count = 0, 'Create (empty set)');
+      Test(index.IndexOf(TestString(0)) = -1, 'IndexOf (empty set)',
+           'non-existent item found');
+      index.Free;
+      index := nil;
+
+      { ------------------------- Create ------------------------- }
+      for i := 0 to STRINGS - 1 do
+         table.Insert(TestString(i));
+      index := TStringPerfectHashIndex.Create(table);
+      CheckStrings(index, STRINGS, 'IndexOf');
+
+      { ---------------------- SaveToStream ----------------------- }
+      index.SaveToStream(strm, nil);
+      strm.Position := 0;
+      loaded := TStringPerfectHashIndex.CreateFromStream(strm, nil, nil, nil);
+      CheckStrings(loaded, STRINGS, 'CreateFromStream');
+      ok := true;
+      for i := 0 to STRINGS - 1 do
+      begin
+         if loaded.IndexOf(TestString(i)) <> index.IndexOf(TestString(i)) then
+            ok := false;
+      end;
+      Test(ok, 'CreateFromStream', 'different numbers');
+
+      { -------------------- CreateFromMemory --------------------- }
+      strm.Clear;
+      index.HashFunction.SaveToStream(strm);
+      { the image follows its size }
+      func := TPerfectHashFunction.CreateFromMemory(PChar(strm.Memory) + SizeOf(Int64),
+                                                    strm.Size - SizeOf(Int64));
+      Test(func.Count = index.HashFunction.Count, 'CreateFromMemory',
+           'wrong Count');
+      ok := true;
+      for i := 0 to STRINGS - 1 do
+      begin
+         n := index.IndexOf(TestString(i));
+         if (n < func.Count) and
+               (func.IndexOf(index.Hasher.Hash(TestString(i))) <> n) then
+         begin
+            ok := false;
+         end;
+      end;
+      Test(ok, 'CreateFromMemory', 'different numbers');
+
+      { ----------------- corrupted streams ------------------------ }
+      strm.Size := strm.Size div 2;
+      strm.Position := 0;
+      ok := false;
+      try
+         TPerfectHashFunction.CreateFromStream(strm).Free;
+      except
+         on EInvalidStreamFormat do
+            ok := true;
+      end;
+      Test(ok, 'CreateFromStream (truncated stream)',
+           'EInvalidStreamFormat not raised');
+   finally
+      func.Free;
+      loaded.Free;
+      index.Free;
+      strm.Free;
+      table.Free;
+   end;
+end;
+
+procedure TestEqualHashes;
+var
+   arr : TIntegerArray;
+   index : TIntegerPerfectHashIndex;
+   used : array of Boolean;
+   hashes : array of UnsignedType;
+   i, n : Integer;
+   ok : Boolean;
+begin
+   arr := TIntegerArray.Create;
+   index := nil;
+   try
+      { every item twice, so that the duplicates have to be dropped }
+      for i := 0 to INTEGERS - 1 do
+         arr.PushBack(i);
+      for i := INTEGERS - 1 downto 0 do
+         arr.PushBack(i);
+      index := TIntegerPerfectHashIndex.Create(arr.ForwardStart,
+                                               arr.ForwardFinish, nil,
+                                               TQuarterHasher.Create);
+      Test(index.Count = INTEGERS, 'Create (range)',
+           'equal items not dropped');
+      Test(index.HashFunction.Count = INTEGERS div 4,
+           'Create (equal hashes)', 'wrong number of items in the function');
+
+      SetLength(used, index.Count);
+      for i := 0 to index.Count - 1 do
+         used[i] := false;
+      ok := true;
+      for i := 0 to INTEGERS - 1 do
+      begin
+         n := index.IndexOf(i);
+         if (n < 0) or (n >= index.Count) then
+            ok := false
+         else
+         begin
+            if used[n] or (index.Items[n] <> i) then
+               ok := false;
+            used[n] := true;
+         end;
+      end;
+      Test(ok, 'IndexOf (equal hashes)', 'wrong numbers');
+
+      ok := true;
+      for i := INTEGERS to 2*INTEGERS - 1 do
+      begin
+         if index.Has(i) or index.Has(-i - 1) then
+            ok := false;
+      end;
+      Test(ok, 'IndexOf (equal hashes, not in the set)',
+           'non-existent item found');
+   finally
+      index.Free;
+      arr.Free;
+   end;
+
+   { the function cannot tell equal hashes apart }
+   SetLength(hashes, 3);
+   hashes[0] := 1;
+   hashes[1] := 2;
+   hashes[2] := 1;
+   ok := false;
+   try
+      TPerfectHashFunction.Create(hashes).Free;
+   except
+      on EInvalidArgument do
+         ok := true;
+   end;
+   Test(ok, 'TPerfectHashFunction.Create (equal hashes)',
+        'EInvalidArgument not raised');
+end;
+
+procedure TestPerfectHash;
+begin
+   StartTest('TPerfectHashIndex');
+   TestStringIndex;
+   TestEqualHashes;
+   FinishTest;
+end;
+
+end.
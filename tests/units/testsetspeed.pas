@@ -1,18 +1,58 @@
 unit testsetspeed;
 
-{ this unit provides utilities to benchmark sets; it inserts words
-  from /usr/share/dict/words and measures running times of functions;
-  writes output to to the log stream }
+{ this unit provides utilities to benchmark sets and filters; it
+  inserts words from /usr/share/dict/words and measures running times
+  of functions; writes output to to the log stream }
 
 interface
 
 uses
-   SysUtils, Classes, adtcont, adtlog, adtfunct, adthashfunct, adtdarray;
+   SysUtils, Classes, adtcontbase, adtcont, adtiters, adtlog, adtfunct,
+   adthashfunct, adtdarray, adtfilter, adthash, adtperfhash, adtavltree,
+   adtstaticset;
+
+type
+   { the filters benchmarked by BenchmarkFilter }
+   TFilterKind = (fkBloom8, fkBloom10, fkBloom16, fkCuckoo);
 
 procedure BenchmarkSet(aset : TStringSetAdt; className : String);
+{ creates a filter of the given kind for the number of words in the
+  dictionary, adds every word to it once and measures the times of
+  Add and MayContain, the false positive rate and the memory used per
+  word }
+procedure BenchmarkFilter(kind : TFilterKind);
+{ inserts integers which are multiples of 4096 into <aset> using a
+  hasher returning the integer itself (a common choice which
+  clusters such keys) and measures the times of Has; with
+  PASCAL_ADT_STATS defined also logs the longest probe sequence and
+  the one not exceeded by 99.9% of the items, which bound the tail of
+  the latency of lookups }
+procedure BenchmarkHashTail(aset : TIntegerHashSetAdt; className : String);
+{ builds a TStringPerfectHashIndex of the words in the dictionary and
+  compares the times of its IndexOf with the times of Has of a
+  TStringHashTable containing the same words; also logs the memory
+  used by the function per word }
+procedure BenchmarkPerfectHash;
+{ builds a TStringStaticSortedSet of the words in the dictionary and
+  compares the times of its Has and HasMany with the times of Has of a
+  TStringAvlTree containing the same words; also checks that both sets
+  contain the same words in the same order and that the batched and
+  the single look-ups agree }
+procedure BenchmarkStaticSet;
 
 implementation
 
+type
+   TIdentityIntegerHasher = class (TFunctor, IIntegerHasher)
+   public
+      function Hash(aitem : Integer) : UnsignedType;
+   end;
+
+function TIdentityIntegerHasher.Hash(aitem : Integer) : UnsignedType;
+begin
+   Result := UnsignedType(aitem);
+end;
+
 var
    lastByte : Byte;
    lastByteLeft : Boolean;
@@ -34,6 +74,20 @@ begin
    lastByteLeft := true;
 end;
 
+{ appends every word in <dict> <copies> times to <words> }
+procedure ReadWords(dict : TStream; words : TStringDynamicArray; copies : Integer);
+var
+   ln : String;
+   i : IndexType;
+begin
+   lastByteLeft := false;
+   repeat
+      ln := ReadToken(dict);
+      for i := 1 to copies do
+         ArrayPushBack(words, ln);
+   until dict.Position >= dict.Size;
+end;
+
 procedure BenchmarkSet(aset : TStringSetAdt; className : String);
 var
    dict    : TFileStream;
@@ -41,11 +95,13 @@ var
    tm, timeSearchFound, timeSearchNotFound, timeInsert, timeDelete : Comp;
    words   : TStringDynamicArray;
    i, maxi : IndexType;
+{$ifdef PASCAL_ADT_STATS }
+   stats   : TContainerStats;
+{$endif }
 
 begin
    WriteLn('Benchmarking ', className, '...');
    dict := TFileStream.Create('/usr/share/dict/words', fmOpenRead);
-   lastByteLeft := false;
 
    WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
    WriteLogStream('Benchmark for ' + className);
@@ -56,11 +112,7 @@ begin
       aset.Clear;
       aset.RepeatedItems := true;
 
-      repeat
-         ln := ReadToken(dict);
-         for i := 1 to 2 do
-            ArrayPushBack(words, ln);
-      until dict.Position >= dict.Size;
+      ReadWords(dict, words, 2);
 
       maxi := words^.Size - 1;
 
@@ -70,6 +122,10 @@ begin
          aset.Insert(words^.Items[i]);
       end;
       timeInsert := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeInsert;
+{$ifdef PASCAL_ADT_STATS }
+      { the statistics are taken when all words are in the set }
+      aset.GetStats(stats);
+{$endif }
 
       timeSearchFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
       for i := 0 to maxi do
@@ -142,11 +198,401 @@ begin
                                       (words^.Size * 1.5)));
       WriteLogStream('Time per item for Delete (ms): ' +
                         FloatToStr(Double(timeDelete) / words^.Size));
+{$ifdef PASCAL_ADT_STATS }
+      WriteLogStream('');
+      WriteLogStream('Statistics after inserting all words:');
+      WriteLogStream(FormatContainerStats(stats));
+{$endif }
+      WriteLogStream('');
+      WriteLogStream('End Of Benchmark');
+      WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
+
+   finally
+      ArrayDeallocate(words);
+      dict.Free;
+   end;
+end;
+
+procedure BenchmarkFilter(kind : TFilterKind);
+var
+   dict    : TFileStream;
+   filter  : TStringSetFilter;
+   className, ln : String;
+   timeAdd, timeFound, timeNotFound : Comp;
+   words   : TStringDynamicArray;
+   i, maxi : IndexType;
+   falseNegatives, falsePositives : SizeType;
+begin
+   case kind of
+      fkBloom8: className := 'TStringBloomFilter (8 bits per item)';
+      fkBloom10: className := 'TStringBloomFilter (10 bits per item)';
+      fkBloom16: className := 'TStringBloomFilter (16 bits per item)';
+   else
+      className := 'TStringCuckooFilter';
+   end;
+   WriteLn('Benchmarking ', className, '...');
+   dict := TFileStream.Create('/usr/share/dict/words', fmOpenRead);
+   filter := nil;
+
+   WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
+   WriteLogStream('Benchmark for ' + className);
+
+   ArrayAllocate(words, 100000, 0);
+
+   try
+      ReadWords(dict, words, 1);
+      maxi := words^.Size - 1;
+
+      case kind of
+         fkBloom8: filter := TStringBloomFilter.Create(words^.Size, 8, nil);
+         fkBloom10: filter := TStringBloomFilter.Create(words^.Size, 10, nil);
+         fkBloom16: filter := TStringBloomFilter.Create(words^.Size, 16, nil);
+      else
+         filter := TStringCuckooFilter.Create(words^.Size);
+      end;
+
+      timeAdd := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+      begin
+         filter.Add(words^.Items[i]);
+      end;
+      timeAdd := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeAdd;
+
+      falseNegatives := 0;
+      timeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+      begin
+         if not filter.MayContain(words^.Items[i]) then
+            Inc(falseNegatives);
+      end;
+      timeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeFound;
+
+      { none of these strings is a word }
+      falsePositives := 0;
+      ln := 'AAAAAAAAAAXXXXXXXXXX';
+      timeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+      begin
+         if filter.MayContain(ln) then
+            Inc(falsePositives);
+
+         Inc(ln[(i mod 20) + 1]);
+      end;
+      timeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeNotFound;
+
+      WriteLogStream('');
+      WriteLogStream('*******************************************');
+      WriteLogStream('Benchmark for ' + className + ' results:');
+      WriteLogStream('Total number of words added: ' + IntToStr(words^.Size));
+      WriteLogStream('Number of words in the filter: ' + IntToStr(filter.Count));
+      WriteLogStream('Memory used (bytes): ' + IntToStr(filter.MemoryUsage));
+      WriteLogStream('Memory used per word (bits): ' +
+                        FloatToStr(filter.MemoryUsage * 8.0 / words^.Size));
+      WriteLogStream('False positive rate (%): ' +
+                        FloatToStr(falsePositives * 100.0 / words^.Size));
+      if falseNegatives <> 0 then
+         WriteLogStream('ERROR: false negatives: ' + IntToStr(falseNegatives));
+      WriteLogStream('Time per item for Add (ms): ' +
+                        FloatToStr(Double(timeAdd) / words^.Size));
+      WriteLogStream('Time per item for MayContain (added, ms): ' +
+                        FloatToStr(Double(timeFound) / words^.Size));
+      WriteLogStream('Time per item for MayContain (not added, ms): ' +
+                        FloatToStr(Double(timeNotFound) / words^.Size));
+      WriteLogStream('');
+      WriteLogStream('End Of Benchmark');
+      WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
+
+   finally
+      filter.Free;
+      ArrayDeallocate(words);
+      dict.Free;
+   end;
+end;
+
+procedure BenchmarkHashTail(aset : TIntegerHashSetAdt; className : String);
+const
+   KEYS = 20000;
+   STRIDE = 4096;
+var
+   timeInsert, timeFound, timeNotFound : Comp;
+   i : IndexType;
+{$ifdef PASCAL_ADT_STATS }
+   stats : TContainerStats;
+   total, tail : SizeType;
+{$endif }
+begin
+   WriteLn('Benchmarking ', className, ' with clustered keys...');
+   WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
+   WriteLogStream('Clustered keys benchmark for ' + className);
+
+   aset.Clear;
+   aset.RepeatedItems := false;
+   aset.Hasher := TIdentityIntegerHasher.Create;
+
+   timeInsert := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+   for i := 0 to KEYS - 1 do
+      aset.Insert(i * STRIDE);
+   timeInsert := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeInsert;
+
+   timeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+   for i := 0 to KEYS - 1 do
+      aset.Has(i * STRIDE);
+   timeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeFound;
+
+   timeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+   for i := 0 to KEYS - 1 do
+      aset.Has(i * STRIDE + STRIDE div 2);
+   timeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeNotFound;
+
+   WriteLogStream('');
+   WriteLogStream('*******************************************');
+   WriteLogStream('Clustered keys benchmark for ' + className + ' results:');
+   WriteLogStream('Number of keys: ' + IntToStr(aset.Size));
+   WriteLogStream('Time per item for Insert (ms): ' +
+                     FloatToStr(Double(timeInsert) / KEYS));
+   WriteLogStream('Time per item for Has (existing, ms): ' +
+                     FloatToStr(Double(timeFound) / KEYS));
+   WriteLogStream('Time per item for Has (non-existing, ms): ' +
+                     FloatToStr(Double(timeNotFound) / KEYS));
+{$ifdef PASCAL_ADT_STATS }
+   aset.GetStats(stats);
+   total := 0;
+   tail := 0;
+   while (tail < adtStatsHistogramSize) and
+            (total * 1000 < SizeType(stats.Items) * 999) do
+   begin
+      Inc(total, stats.ProbeLengths[tail]);
+      Inc(tail);
+   end;
+   WriteLogStream('Max probe length: ' + IntToStr(stats.MaxProbeLength));
+   WriteLogStream('99.9th percentile of probe lengths: ' + IntToStr(tail));
+{$endif }
+   WriteLogStream('');
+   WriteLogStream('End Of Benchmark');
+   WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
+
+   aset.Clear;
+end;
+
+procedure BenchmarkPerfectHash;
+var
+   dict    : TFileStream;
+   table   : TStringHashTable;
+   index   : TStringPerfectHashIndex;
+   ln      : String;
+   timeBuild, timeTableFound, timeTableNotFound, timeFound, timeNotFound : Comp;
+   words   : TStringDynamicArray;
+   i, maxi : IndexType;
+begin
+   WriteLn('Benchmarking TStringPerfectHashIndex...');
+   dict := TFileStream.Create('/usr/share/dict/words', fmOpenRead);
+   table := TStringHashTable.Create;
+   index := nil;
+
+   WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
+   WriteLogStream('Benchmark for TStringPerfectHashIndex');
+
+   ArrayAllocate(words, 100000, 0);
+
+   try
+      ReadWords(dict, words, 1);
+      maxi := words^.Size - 1;
+
+      table.RepeatedItems := false;
+      for i := 0 to maxi do
+         table.Insert(words^.Items[i]);
+
+      timeBuild := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      index := TStringPerfectHashIndex.Create(table);
+      timeBuild := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeBuild;
+
+      timeTableFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+         table.Has(words^.Items[i]);
+      timeTableFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeTableFound;
+
+      timeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+         index.IndexOf(words^.Items[i]);
+      timeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeFound;
+
+      { none of these strings is a word }
+      ln := 'AAAAAAAAAAXXXXXXXXXX';
+      timeTableNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+      begin
+         table.Has(ln);
+         Inc(ln[(i mod 20) + 1]);
+      end;
+      timeTableNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeTableNotFound;
+
+      ln := 'AAAAAAAAAAXXXXXXXXXX';
+      timeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+      begin
+         index.IndexOf(ln);
+         Inc(ln[(i mod 20) + 1]);
+      end;
+      timeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeNotFound;
+
+      WriteLogStream('');
+      WriteLogStream('*******************************************');
+      WriteLogStream('Benchmark for TStringPerfectHashIndex results:');
+      WriteLogStream('Number of distinct words: ' + IntToStr(index.Count));
+      WriteLogStream('Words with the hash of another word: ' +
+                        IntToStr(index.Count - index.HashFunction.Count));
+      WriteLogStream('Memory used by the function per word (bits): ' +
+                        FloatToStr(index.HashFunction.MemoryUsage * 8.0 /
+                                      index.HashFunction.Count));
+      WriteLogStream('Total time for building the index (ms): ' +
+                        FloatToStr(timeBuild));
+      WriteLogStream('Time per item for TStringHashTable.Has (existing, ms): ' +
+                        FloatToStr(Double(timeTableFound) / words^.Size));
+      WriteLogStream('Time per item for IndexOf (existing, ms): ' +
+                        FloatToStr(Double(timeFound) / words^.Size));
+      WriteLogStream('Time per item for TStringHashTable.Has (non-existing, ms): ' +
+                        FloatToStr(Double(timeTableNotFound) / words^.Size));
+      WriteLogStream('Time per item for IndexOf (non-existing, ms): ' +
+                        FloatToStr(Double(timeNotFound) / words^.Size));
+      WriteLogStream('');
+      WriteLogStream('End Of Benchmark');
+      WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
+
+   finally
+      index.Free;
+      table.Free;
+      ArrayDeallocate(words);
+      dict.Free;
+   end;
+end;
+
+procedure BenchmarkStaticSet;
+const
+   batchSize = 256;
+var
+   dict    : TFileStream;
+   tree    : TStringAvlTree;
+   aset    : TStringStaticSortedSet;
+   iter1, iter2 : TStringSetIterator;
+   ln      : String;
+   timeBuild, timeTreeFound, timeTreeNotFound, timeFound, timeNotFound,
+      timeBatchFound : Comp;
+   words   : TStringDynamicArray;
+   batch   : array[0..batchSize - 1] of String;
+   results : array[0..batchSize - 1] of Boolean;
+   i, j, maxi : IndexType;
+   errors  : SizeType;
+begin
+   WriteLn('Benchmarking TStringStaticSortedSet...');
+   dict := TFileStream.Create('/usr/share/dict/words', fmOpenRead);
+   tree := TStringAvlTree.Create;
+   aset := nil;
+
+   WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
+   WriteLogStream('Benchmark for TStringStaticSortedSet');
+
+   ArrayAllocate(words, 100000, 0);
+
+   try
+      ReadWords(dict, words, 1);
+      maxi := words^.Size - 1;
+
+      tree.RepeatedItems := false;
+      for i := 0 to maxi do
+         tree.Insert(words^.Items[i]);
+
+      timeBuild := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      aset := TStringStaticSortedSet.Create(tree.Start, tree.Finish);
+      timeBuild := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeBuild;
+
+      timeTreeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+         tree.Has(words^.Items[i]);
+      timeTreeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeTreeFound;
+
+      timeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+         aset.Has(words^.Items[i]);
+      timeFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeFound;
+
+      errors := 0;
+      timeBatchFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      i := 0;
+      while i <= maxi - batchSize + 1 do
+      begin
+         for j := 0 to batchSize - 1 do
+            batch[j] := words^.Items[i + j];
+         aset.HasMany(batch, results);
+         for j := 0 to batchSize - 1 do
+         begin
+            if not results[j] then
+               Inc(errors);
+         end;
+         Inc(i, batchSize);
+      end;
+      timeBatchFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeBatchFound;
+
+      { none of these strings is a word }
+      ln := 'AAAAAAAAAAXXXXXXXXXX';
+      timeTreeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+      begin
+         tree.Has(ln);
+         Inc(ln[(i mod 20) + 1]);
+      end;
+      timeTreeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeTreeNotFound;
+
+      ln := 'AAAAAAAAAAXXXXXXXXXX';
+      timeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time));
+      for i := 0 to maxi do
+      begin
+         if aset.Has(ln) then
+            Inc(errors);
+         Inc(ln[(i mod 20) + 1]);
+      end;
+      timeNotFound := TimeStampToMSecs(DateTimeToTimeStamp(Time)) - timeNotFound;
+
+      if aset.Size <> tree.Size then
+         Inc(errors);
+      iter1 := tree.Start;
+      iter2 := aset.Start;
+      while not iter1.IsFinish and not iter2.IsFinish do
+      begin
+         if iter1.Item <> iter2.Item then
+            Inc(errors);
+         iter1.Advance;
+         iter2.Advance;
+      end;
+      if not (iter1.IsFinish and iter2.IsFinish) then
+         Inc(errors);
+      iter1.Destroy;
+      iter2.Destroy;
+
+      WriteLogStream('');
+      WriteLogStream('*******************************************');
+      WriteLogStream('Benchmark for TStringStaticSortedSet results:');
+      WriteLogStream('Number of distinct words: ' + IntToStr(aset.Size));
+      if errors <> 0 then
+         WriteLogStream('ERROR: wrong results: ' + IntToStr(errors));
+      WriteLogStream('Total time for building the set (ms): ' +
+                        FloatToStr(timeBuild));
+      WriteLogStream('Time per item for TStringAvlTree.Has (existing, ms): ' +
+                        FloatToStr(Double(timeTreeFound) / words^.Size));
+      WriteLogStream('Time per item for Has (existing, ms): ' +
+                        FloatToStr(Double(timeFound) / words^.Size));
+      WriteLogStream('Time per item for HasMany (existing, ms): ' +
+                        FloatToStr(Double(timeBatchFound) / words^.Size));
+      WriteLogStream('Time per item for TStringAvlTree.Has (non-existing, ms): ' +
+                        FloatToStr(Double(timeTreeNotFound) / words^.Size));
+      WriteLogStream('Time per item for Has (non-existing, ms): ' +
+                        FloatToStr(Double(timeNotFound) / words^.Size));
       WriteLogStream('');
       WriteLogStream('End Of Benchmark');
       WriteLogStream('^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^');
 
    finally
+      aset.Free;
+      tree.Free;
       ArrayDeallocate(words);
       dict.Free;
    end;
@@ -0,0 +1,233 @@
+unit teststrpool;
+
+{ tests TStringPool, TInternedStringSet and TInternedStringMap from
+  adtstrpool }
+
+interface
+
+procedure TestStringPool;
+
+implementation
+
+uses
+   testutils, SysUtils, adthashfunct, adtstrpool;
+
+const
+   STRINGS = 2000;
+
+{ returns the number of bytes currently allocated on the heap; the
+  objects of the pool are not TTestObjects, so this is the only way to
+  see if they are freed }
+function HeapUsed : PtrUInt;
+begin
+{$ifdef FPC }
+   Result := GetFPCHeapStatus.CurrHeapUsed;
+{$else }
+   Result := GetHeapStatus.TotalAllocated;
+{$endif }
+end;
+
+{ returns a new copy of the <i>-th test string, so that equal strings
+  never share memory }
+function TestString(i : Integer) : String;
+begin
+   Result := 'interned string ' + IntToStr(i);
+   UniqueString(Result);
+end;
+
+{ interns the first STRINGS test strings and the empty string; this is
+  a separate routine so that no temporary strings are left behind when
+  the memory used is measured }
+procedure InternAll(pool : TStringPool);
+var
+   i : Integer;
+begin
+   for i := 0 to STRINGS - 1 do
+      pool.Intern(TestString(i));
+   pool.Intern('');
+end;
+
+procedure CheckPool;
+var
+   pool : TStringPool;
+   strs : array of TInternedString;
+   istr : TInternedString;
+   i : Integer;
+   ok : Boolean;
+   used : PtrUInt;
+begin
+   pool := TStringPool.Create;
+
+   { ------------------------- Intern --------------------------- }
+   SetLength(strs, STRINGS);
+   ok := true;
+   for i := 0 to STRINGS - 1 do
+   begin
+      strs[i] := pool.Intern(TestString(i));
+      if (strs[i] = nil) or (strs[i].Str <> TestString(i)) or
+            (strs[i].Hash <> AnsiStringHasher.Hash(TestString(i))) then
+         ok := false;
+   end;
+   Test(ok, 'TStringPool.Intern', 'wrong string or hash');
+   Test(pool.Size = STRINGS, 'TStringPool.Size');
+
+   ok := true;
+   for i := 0 to STRINGS - 1 do
+   begin
+      if pool.Intern(TestString(i)) <> strs[i] then
+         ok := false;
+   end;
+   Test(ok, 'TStringPool.Intern (identity)',
+        'an equal string interned as another object');
+   Test(pool.Size = STRINGS, 'TStringPool.Intern (identity)',
+        'an equal string added again');
+
+   { -------------------------- Find ---------------------------- }
+   ok := true;
+   for i := 0 to STRINGS - 1 do
+   begin
+      if (pool.Find(TestString(i)) <> strs[i]) or
+            not pool.Has(TestString(i)) then
+         ok := false;
+   end;
+   Test(ok, 'TStringPool.Find');
+
+   ok := true;
+   for i := STRINGS to 2*STRINGS - 1 do
+   begin
+      if (pool.Find(TestString(i)) <> nil) or pool.Has(TestString(i)) then
+         ok := false;
+   end;
+   Test(ok, 'TStringPool.Find (not in the pool)', 'non-existent string found');
+   Test(pool.Find('') = nil, 'TStringPool.Find (empty string)',
+        'non-existent string found');
+   Test(pool.Size = STRINGS, 'TStringPool.Find (not in the pool)',
+        'the pool modified');
+
+   istr := pool.Intern('');
+   Test((istr <> nil) and (istr.Str = '') and (pool.Find('') = istr),
+        'TStringPool.Intern (empty string)');
+
+   { -------------------------- Clear --------------------------- }
+   pool.Clear;
+   Test(pool.Size = 0, 'TStringPool.Clear');
+   Test(pool.Find(TestString(0)) = nil, 'TStringPool.Clear',
+        'string found after Clear');
+
+   { interning the same strings again after Clear must not use more
+     memory than before if Clear freed them }
+   InternAll(pool);
+   used := HeapUsed;
+   pool.Clear;
+   InternAll(pool);
+   Test(HeapUsed <= used, 'TStringPool.Clear', 'strings leaked');
+
+   pool.Free;
+end;
+
+procedure TestPool;
+var
+   used : PtrUInt;
+begin
+   used := HeapUsed;
+   CheckPool;
+   Test(HeapUsed <= used, 'TStringPool.Destroy', 'strings leaked');
+end;
+
+procedure TestSetAndMap;
+var
+   pool : TStringPool;
+   aset : TInternedStringSet;
+   map : TInternedStringMap;
+   i : Integer;
+   ok : Boolean;
+begin
+   pool := TStringPool.Create;
+   aset := TInternedStringSet.Create;
+   map := TInternedStringMap.Create;
+
+   { ------------------------- TInternedStringSet ---------------------- }
+   ok := true;
+   for i := 0 to STRINGS - 1 do
+   begin
+      if not aset.Insert(pool.Intern(TestString(i))) then
+         ok := false;
+   end;
+   Test(ok and (aset.Size = STRINGS), 'TInternedStringSet.Insert');
+   Test(not aset.Insert(pool.Intern(TestString(0))),
+        'TInternedStringSet.Insert', 'the same string inserted twice');
+
+   ok := true;
+   for i := 0 to STRINGS - 1 do
+   begin
+      if not aset.Has(pool.Intern(TestString(i))) then
+         ok := false;
+   end;
+   Test(ok, 'TInternedStringSet.Has');
+   Test(not aset.Has(pool.Intern(TestString(STRINGS))),
+        'TInternedStringSet.Has', 'non-existent string found');
+
+   for i := 0 to STRINGS div 2 - 1 do
+      aset.Delete(pool.Find(TestString(2*i)));
+   Test(aset.Size = STRINGS div 2, 'TInternedStringSet.Delete');
+   Test(pool.Size = STRINGS + 1, 'TInternedStringSet.Delete',
+        'the pool modified');
+   Test(pool.Find(TestString(0)).Str = TestString(0),
+        'TInternedStringSet.Delete', 'a string of the pool destroyed');
+
+   aset.Clear;
+   Test(aset.Size = 0, 'TInternedStringSet.Clear');
+   Test(pool.Size = STRINGS + 1, 'TInternedStringSet.Clear',
+        'the pool modified');
+
+   { ------------------------- TInternedStringMap ---------------------- }
+   ok := true;
+   for i := 0 to STRINGS - 1 do
+   begin
+      if not map.Insert(pool.Intern(TestString(i)), TTestObject.Create(i)) then
+         ok := false;
+   end;
+   Test(ok and (map.Size = STRINGS), 'TInternedStringMap.Insert');
+
+   ok := true;
+   for i := 0 to STRINGS - 1 do
+   begin
+      if TestObjectValue(map.Find(pool.Intern(TestString(i)))) <> i then
+         ok := false;
+   end;
+   Test(ok, 'TInternedStringMap.Find');
+   Test(not map.Has(pool.Intern(TestString(STRINGS + 1))),
+        'TInternedStringMap.Has', 'non-existent key found');
+
+   StartDestruction(1, 'TInternedStringMap.Delete');
+   map.Delete(pool.Find(TestString(0)));
+   FinishDestruction;
+   Test(not map.Has(pool.Find(TestString(0))), 'TInternedStringMap.Delete');
+
+   StartDestruction(STRINGS - 1, 'TInternedStringMap.Clear');
+   map.Clear;
+   FinishDestruction;
+   Test(pool.Size = STRINGS + 2, 'TInternedStringMap.Clear',
+        'the pool modified');
+
+   for i := 0 to STRINGS - 1 do
+      map.Insert(pool.Intern(TestString(i)), TTestObject.Create(i));
+   StartDestruction(STRINGS, 'TInternedStringMap.Destroy');
+   map.Free;
+   FinishDestruction;
+
+   aset.Free;
+   Test(pool.Find(TestString(1)).Str = TestString(1),
+        'TInternedStringMap.Destroy', 'a string of the pool destroyed');
+   pool.Free;
+end;
+
+procedure TestStringPool;
+begin
+   StartTest('TStringPool');
+   TestPool;
+   TestSetAndMap;
+   FinishTest;
+end;
+
+end.
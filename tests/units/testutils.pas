@@ -80,6 +80,9 @@ function TestObjectCopier : IUnaryFunctor;
 implementation
 
 uses
+{$ifdef DELPHI }
+   Windows,
+{$endif }
    SysUtils, adthashfunct;
 
 var
@@ -92,12 +95,14 @@ var
 constructor TTestObject.Create(int : Integer);
 begin
    FField := int;
-   Inc(objectCount);
+   { the parallel algorithms create and destroy objects from many
+     threads at once }
+   InterLockedIncrement(LongInt(objectCount));
 end;
 
 destructor TTestObject.Destroy;
 begin
-   Dec(objectCount);
+   InterLockedDecrement(LongInt(objectCount));
 end;
 
 function TTestObjectCopier.Perform(aitem : TObject) : TObject;